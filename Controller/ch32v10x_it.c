@@ -12,24 +12,93 @@
  * @date  11.02.2022
  * @date  17.02.2022  Added SysTick dummy handler
  * @date  03.03.2022  Added optimisation hint attributes
+ * @date  18.10.2026  Added RAMFUNC placement tags
+ * @date  18.10.2026  Added crash capture to hard fault handler
+ * @date  18.10.2026  Added DMA memory-to-memory channel handler
+ * @date  18.10.2026  Added interrupt profiling
+ * @date  18.10.2026  Added DMA ADC capture channel handler
+ * @date  18.10.2026  Added TIM3 handler for control loop
+ * @date  18.10.2026  Added USART3 transmit handler; latency test vector moved
+ *                    to TIM4
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
 #include "ch32v10x.h"
+#include "hw_ramfunc.h"
+#include "hw_adc.h"
+#include "hw_tim3.h"
+#include "hw_usart.h"
+#include "crash.h"
+#include "offload.h"
+#include "irqprof.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Stringify macro value for use in inline assembly
+ *  @{                                                                        */
+#define STR(x)                        #x
+#define XSTR(x)                       STR(x)
+/*! @}                                                                        */
 
 
 /*!****************************************************************************
  * @brief
  * Hard fault handler
  *
+ * Stores the register file into the crash record, switches to the fault
+ * handler stack and continues in vCaptureCrash(), which resets the system.
+ *
  * @date  11.02.2022
  * @date  03.03.2022  Added optimisation hint attribute
+ * @date  18.10.2026  Added crash record capture and reset
  ******************************************************************************/
-RV_INTERRUPT void HardFault_Handler(void)
+__attribute__((naked)) void HardFault_Handler(void)
 {
-  while (1)
-  {
-  }
+  __asm volatile (
+    /* Free t0 as base pointer, original value in mscratch */
+    "csrw mscratch, t0\n"
+    "la   t0, sCrashRecord\n"
+    "sw   x1,  " XSTR(CRASH_REGS_OFFSET) "+0(t0)\n"
+    "sw   x2,  " XSTR(CRASH_REGS_OFFSET) "+4(t0)\n"
+    "sw   x3,  " XSTR(CRASH_REGS_OFFSET) "+8(t0)\n"
+    "sw   x4,  " XSTR(CRASH_REGS_OFFSET) "+12(t0)\n"
+    "sw   x6,  " XSTR(CRASH_REGS_OFFSET) "+20(t0)\n"
+    "sw   x7,  " XSTR(CRASH_REGS_OFFSET) "+24(t0)\n"
+    "sw   x8,  " XSTR(CRASH_REGS_OFFSET) "+28(t0)\n"
+    "sw   x9,  " XSTR(CRASH_REGS_OFFSET) "+32(t0)\n"
+    "sw   x10, " XSTR(CRASH_REGS_OFFSET) "+36(t0)\n"
+    "sw   x11, " XSTR(CRASH_REGS_OFFSET) "+40(t0)\n"
+    "sw   x12, " XSTR(CRASH_REGS_OFFSET) "+44(t0)\n"
+    "sw   x13, " XSTR(CRASH_REGS_OFFSET) "+48(t0)\n"
+    "sw   x14, " XSTR(CRASH_REGS_OFFSET) "+52(t0)\n"
+    "sw   x15, " XSTR(CRASH_REGS_OFFSET) "+56(t0)\n"
+    "sw   x16, " XSTR(CRASH_REGS_OFFSET) "+60(t0)\n"
+    "sw   x17, " XSTR(CRASH_REGS_OFFSET) "+64(t0)\n"
+    "sw   x18, " XSTR(CRASH_REGS_OFFSET) "+68(t0)\n"
+    "sw   x19, " XSTR(CRASH_REGS_OFFSET) "+72(t0)\n"
+    "sw   x20, " XSTR(CRASH_REGS_OFFSET) "+76(t0)\n"
+    "sw   x21, " XSTR(CRASH_REGS_OFFSET) "+80(t0)\n"
+    "sw   x22, " XSTR(CRASH_REGS_OFFSET) "+84(t0)\n"
+    "sw   x23, " XSTR(CRASH_REGS_OFFSET) "+88(t0)\n"
+    "sw   x24, " XSTR(CRASH_REGS_OFFSET) "+92(t0)\n"
+    "sw   x25, " XSTR(CRASH_REGS_OFFSET) "+96(t0)\n"
+    "sw   x26, " XSTR(CRASH_REGS_OFFSET) "+100(t0)\n"
+    "sw   x27, " XSTR(CRASH_REGS_OFFSET) "+104(t0)\n"
+    "sw   x28, " XSTR(CRASH_REGS_OFFSET) "+108(t0)\n"
+    "sw   x29, " XSTR(CRASH_REGS_OFFSET) "+112(t0)\n"
+    "sw   x30, " XSTR(CRASH_REGS_OFFSET) "+116(t0)\n"
+    "sw   x31, " XSTR(CRASH_REGS_OFFSET) "+120(t0)\n"
+    "csrr t1, mscratch\n"
+    "sw   t1, " XSTR(CRASH_REGS_OFFSET) "+16(t0)\n"
+
+    /* Restore global pointer and switch to handler stack */
+    ".option push\n"
+    ".option norelax\n"
+    "la   gp, __global_pointer$\n"
+    ".option pop\n"
+    "la   sp, aulCrashHandlerStack+" XSTR(CRASH_HANDLER_STACK_WORDS) "*4\n"
+    "j    vCaptureCrash\n"
+  );
 }
 
 /*!****************************************************************************
@@ -38,7 +107,91 @@ RV_INTERRUPT void HardFault_Handler(void)
  *
  * @date  17.02.2022
  * @date  03.03.2022  Added optimisation hint attribute
+ * @date  18.10.2026  Added RAMFUNC placement tag
+ ******************************************************************************/
+RV_INTERRUPT RAMFUNC void SysTick_Handler(void)
+{
+}
+
+/*!****************************************************************************
+ * @brief
+ * DMA1 channel 2 interrupt handler (memory-to-memory transfers)
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added interrupt profiling
+ ******************************************************************************/
+RV_INTERRUPT void DMA1_Channel2_IRQHandler(void)
+{
+  IRQPROF_ENTER();
+  vHandleOffloadIrq();
+  IRQPROF_EXIT(IRQPROF_DMA_M2M);
+}
+
+/*!****************************************************************************
+ * @brief
+ * DMA1 channel 1 interrupt handler (ADC capture)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+RV_INTERRUPT void DMA1_Channel1_IRQHandler(void)
+{
+  IRQPROF_ENTER();
+  vHW_HandleAdcDmaIrq();
+  IRQPROF_EXIT(IRQPROF_DMA_ADC);
+}
+
+/*!****************************************************************************
+ * @brief
+ * TIM3 interrupt handler (control loop)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+RV_INTERRUPT void TIM3_IRQHandler(void)
+{
+  IRQPROF_ENTER();
+  vHW_TIM3_HandleIrq();
+  IRQPROF_EXIT(IRQPROF_TIM3);
+}
+
+#ifdef USE_USART3
+/*!****************************************************************************
+ * @brief
+ * USART3 interrupt handler: interrupt transmission
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+RV_INTERRUPT void USART3_IRQHandler(void)
+{
+  vHW_USART_IrqHandler(HW_USART3);
+}
+#endif /* USE_USART3 */
+
+#ifdef USE_IRQ_PROFILE
+/*!****************************************************************************
+ * @brief
+ * Software interrupt handler, latency test vector using the hardware stack
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+RV_INTERRUPT void SW_Handler(void)
+{
+  IRQPROF_ENTER();
+  vHandleIrqProfTest(IRQPROF_TEST_FAST, ulIrqProfStart);
+  IRQPROF_EXIT(IRQPROF_TEST_FAST);
+}
+
+/*!****************************************************************************
+ * @brief
+ * TIM4 interrupt handler (TIM4 unused), latency test vector using a
+ * standard compiler-generated prologue
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Moved from USART3 to TIM4 vector
  ******************************************************************************/
-RV_INTERRUPT void SysTick_Handler(void)
+__attribute__((interrupt)) void TIM4_IRQHandler(void)
 {
+  IRQPROF_ENTER();
+  vHandleIrqProfTest(IRQPROF_TEST_STD, ulIrqProfStart);
+  IRQPROF_EXIT(IRQPROF_TEST_STD);
 }
+#endif /* USE_IRQ_PROFILE */
@@ -0,0 +1,672 @@
+/*!****************************************************************************
+ * @file
+ * bench.c
+ *
+ * @brief
+ * Benchmark suite for firmware hot paths
+ *
+ * Each benchmark case runs a fixed number of operations and is timed using the
+ * SysTick counter (HCLK/8). Results are printed as a table, followed by a
+ * single JSON line which can be captured from the serial monitor and compared
+ * against a stored baseline using tools/bench_check.py.
+ *
+ * The suite is only compiled in with the USE_BENCH CMake option turned on
+ * (off by default, see CMakeLists.txt).
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added event queue benchmark
+ * @date  18.10.2026  Added EEPROM volume write benchmark
+ * @date  18.10.2026  Added FFT benchmarks
+ * @date  18.10.2026  Added PID step benchmark
+ * @date  18.10.2026  Serial benchmark writes to shell output channel
+ * @date  18.10.2026  Added serial message copy vs. scatter-gather benchmark
+ * @date  18.10.2026  Added C library vs. word-oriented memory function
+ *                    benchmarks
+ * @date  18.10.2026  EEPROM benchmarks write to reserved scratch space
+ * @date  18.10.2026  Pool benchmark only with USE_POOLS
+ * @date  18.10.2026  Made optional
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ch32v10x.h"
+#include "hw_adc.h"
+#include "dbgser.h"
+#include "mux.h"
+#include "hexdump.h"
+#include "eeprom.h"
+#include "eeprom_layout.h"
+#include "eevol.h"
+#include "shell.h"
+#include "pool.h"
+#include "rpc.h"
+#include "offload.h"
+#include "memfunc.h"
+#include "event.h"
+#include "fft.h"
+#include "control.h"
+#include "bench.h"
+
+#ifdef USE_BENCH
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Length of serial output benchmark line in bytes                    */
+#define BENCH_SERIAL_LEN              64
+
+/*! @brief Serial message header, payload and trailer lengths in bytes
+ *  @{                                                                        */
+#define BENCH_MSG_HDR_LEN             4
+#define BENCH_MSG_DATA_LEN            (BENCH_SERIAL_LEN - 2)
+#define BENCH_MSG_TRL_LEN             2
+#define BENCH_MSG_LEN                 (BENCH_MSG_HDR_LEN + BENCH_MSG_DATA_LEN + BENCH_MSG_TRL_LEN)
+/*! @}                                                                        */
+
+/*! @brief Number of bytes per hexdump benchmark operation                    */
+#define BENCH_HEXDUMP_LEN             64
+
+/*! @brief Block size for allocator benchmarks                                */
+#define BENCH_ALLOC_SIZE              32
+
+/*! @brief Command keys used for command dispatch benchmark                   */
+#define BENCH_DISPATCH_KEYS           "?aeirbx"
+
+/*! @brief Data length of RPC memory read benchmark                           */
+#define BENCH_RPC_LEN                 240
+
+/*! @brief RPC memory read request: header, address, length, CRC             */
+#define BENCH_RPC_REQ_LEN             (RPC_HDR_LEN + 6 + RPC_CRC_LEN)
+
+/*! @brief Block sizes for CPU vs. DMA/CRC unit comparison                    */
+#define BENCH_BLOCK_SMALL             64
+#define BENCH_BLOCK_LARGE             1024
+
+/*! @brief Block size for short memory copies                                 */
+#define BENCH_BLOCK_TINY              8
+
+/*! @brief Source offset for misaligned memory copies                         */
+#define BENCH_MISALIGN                1
+
+/*! @brief FFT sizes (log2); the largest fits the block buffer as Q15 re/im   */
+#define BENCH_FFT_LOG2_SMALL          6
+#define BENCH_FFT_LOG2_LARGE          8
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Benchmark case descriptor                                          */
+typedef struct
+{
+  const char* pszName;                /*!< Case name (JSON key)               */
+  void (*pvRun)(void);                /*!< Single operation                   */
+  unsigned uBytesPerOp;               /*!< Bytes processed per operation      */
+  unsigned uIterations;               /*!< Number of operations per run       */
+} BenchCaseTypeDef;
+
+/*! @brief Benchmark case result                                              */
+typedef struct
+{
+  uint32_t ulNsPerOp;                 /*!< Average duration per op in ns      */
+  uint32_t ulBytesPerSec;             /*!< Throughput in bytes/s              */
+} BenchResultTypeDef;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Serial output benchmark line                                              */
+static const unsigned char aucSerialLine[BENCH_SERIAL_LEN] =
+  "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\r\n";
+
+/*! Serial message header and trailer                                         */
+static const unsigned char aucMsgHdr[BENCH_MSG_HDR_LEN] = { 'm', 's', 'g', ' ' };
+static const unsigned char aucMsgTrl[BENCH_MSG_TRL_LEN] = { '\r', '\n' };
+
+/*! Staging buffers for copied serial messages, one per queue slot            */
+static unsigned char aucMsgCopy[DBGSER_MSG_QUEUE_LEN][BENCH_MSG_LEN];
+
+/*! Next serial message staging buffer                                        */
+static unsigned uMsgSlot;
+
+#ifdef USE_EEPROM_DEMO
+/*! Scratch buffer for EEPROM benchmarks                                      */
+static unsigned char aucEepromBuf[EEPROM_PAGE_SIZE];
+
+/*! Next EEPROM volume scratch stripe                                         */
+static unsigned uEeVolStripe;
+#endif /* USE_EEPROM_DEMO */
+
+/*! Encoded RPC memory read request                                           */
+static uint8_t aucRpcReq[FRAME_COBS_MAX_LEN(BENCH_RPC_REQ_LEN)];
+
+/*! Encoded RPC memory read request length                                    */
+static unsigned uRpcReqLen;
+
+/*! RPC request working copy (decoded in place)                               */
+static uint8_t aucRpcIn[sizeof(aucRpcReq)];
+
+/*! RPC response output                                                       */
+static uint8_t aucRpcOut[RPC_MAX_ENC_FRAME];
+
+/*! Destination buffer for memory copy/fill benchmarks                         */
+static uint32_t aulBlockBuf[BENCH_BLOCK_LARGE / sizeof(uint32_t)];
+
+/*! Short copy length, read at runtime so that the copy is not inlined        */
+static volatile size_t uTinyLen = BENCH_BLOCK_TINY;
+
+/*! String for string length benchmarks, read through a volatile pointer so
+ *  that the length is not computed at compile time                          */
+static const char acBenchStr[BENCH_BLOCK_SMALL] =
+  "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ.";
+static const char* volatile pszBenchStr = acBenchStr;
+
+/*! Result sink to keep computations from being optimised out                 */
+static volatile uint32_t ulSink;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Serial output path: write one line to the shell output channel
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Written via multiplexer
+ ******************************************************************************/
+static void vBenchSerialWrite(void)
+{
+  uWriteMux(MUX_CH_SHELL, aucSerialLine, BENCH_SERIAL_LEN);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Framed serial message (header, payload, trailer) queued for transmission:
+ * assembled in a staging buffer (BENCH_MSG_LEN bytes copied) vs. sent from
+ * the original buffers as segments (no copy)
+ *
+ * Both cases measure the time until the message is queued; the queue is
+ * empty at the start, and each case queues DBGSER_MSG_QUEUE_LEN messages.
+ * The messages are written to the port directly, so nothing is sent while
+ * multiplexed output is enabled.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchSerialMsgCopy(void)
+{
+  if (bIsMuxEnabled()) return;
+  unsigned char* pucMsg = aucMsgCopy[uMsgSlot];
+  uMsgSlot = (uMsgSlot + 1) % DBGSER_MSG_QUEUE_LEN;
+  memcpy(pucMsg, aucMsgHdr, BENCH_MSG_HDR_LEN);
+  memcpy(&pucMsg[BENCH_MSG_HDR_LEN], aucSerialLine, BENCH_MSG_DATA_LEN);
+  memcpy(&pucMsg[BENCH_MSG_HDR_LEN + BENCH_MSG_DATA_LEN], aucMsgTrl, BENCH_MSG_TRL_LEN);
+  const DbgSerSegTypeDef sSeg = { pucMsg, BENCH_MSG_LEN };
+  bWriteVDbgSer(&sSeg, 1, NULL, NULL);
+}
+
+static void vBenchSerialMsgSg(void)
+{
+  if (bIsMuxEnabled()) return;
+  const DbgSerSegTypeDef asSegs[] = {
+    { aucMsgHdr, BENCH_MSG_HDR_LEN },
+    { aucSerialLine, BENCH_MSG_DATA_LEN },
+    { aucMsgTrl, BENCH_MSG_TRL_LEN }
+  };
+  bWriteVDbgSer(asSegs, sizeof(asSegs) / sizeof(asSegs[0]), NULL, NULL);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Hexdump formatting: dump serial line buffer through printf()
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchHexDump(void)
+{
+  vPrintHexDump(aucSerialLine, BENCH_HEXDUMP_LEN, 0);
+}
+
+#ifdef USE_EEPROM_DEMO
+/*!****************************************************************************
+ * @brief
+ * EEPROM read path: read one page
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchEepromRead(void)
+{
+  vReadEeprom(aucEepromBuf, EEPROM_BENCH_DEV_ADDR, EEPROM_PAGE_SIZE);
+}
+
+/*!****************************************************************************
+ * @brief
+ * EEPROM write path: write one page and wait for internal write cycle
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchEepromWrite(void)
+{
+  vWriteEeprom(aucEepromBuf, EEPROM_BENCH_DEV_ADDR, EEPROM_PAGE_SIZE);
+  vWaitEepromWriteCycle();
+}
+
+/*!****************************************************************************
+ * @brief
+ * EEPROM volume write path: write one stripe, cycling through the devices.
+ * The wait for a device's write cycle overlaps the writes to the others. The
+ * stripes are taken from the benchmark scratch of the system area, which uses
+ * the same striped write path as the volume.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Write to benchmark scratch of the system area
+ ******************************************************************************/
+static void vBenchEeVolWrite(void)
+{
+  unsigned uAddress = uGetEepromSysAreaSize() -
+    (EEPROM_BENCH_STRIPES - uEeVolStripe) * EEVOL_STRIPE_SIZE;
+  bWriteEepromSysArea(aucEepromBuf, uAddress, EEVOL_STRIPE_SIZE);
+  uEeVolStripe = (uEeVolStripe + 1) % EEPROM_BENCH_STRIPES;
+}
+#endif /* USE_EEPROM_DEMO */
+
+/*!****************************************************************************
+ * @brief
+ * ADC conversion math: convert full raw value range
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchAdcMath(void)
+{
+  uint32_t ulSum = 0;
+  for (uint16_t uiRaw = 0; uiRaw < 4096; uiRaw += 16)
+  {
+    ulSum += uiHW_ConvertAdcValue_mV(uiRaw);
+  }
+  ulSink = ulSum;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Command dispatch: look up a set of known and unknown command keys
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchDispatch(void)
+{
+  const char* pcKey = BENCH_DISPATCH_KEYS;
+  while (*pcKey != '\0') ulSink = (uint32_t)psFindShellCmd(*pcKey++);
+}
+
+#ifdef USE_POOLS
+/*!****************************************************************************
+ * @brief
+ * Pool allocator: allocate and release one small block
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchPoolAlloc(void)
+{
+  void* pvBlock = pvPoolAlloc(BENCH_ALLOC_SIZE);
+  ulSink = (uint32_t)pvBlock;
+  vPoolFree(pvBlock);
+}
+#endif /* USE_POOLS */
+
+/*!****************************************************************************
+ * @brief
+ * Heap allocator: allocate and release one small block using malloc()
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchMalloc(void)
+{
+  void* pvBlock = malloc(BENCH_ALLOC_SIZE);
+  ulSink = (uint32_t)pvBlock;
+  free(pvBlock);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Prepare RPC memory read request for BENCH_RPC_LEN bytes at start of flash
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vInitBenchRpc(void)
+{
+  uint8_t aucReq[BENCH_RPC_REQ_LEN] = {
+    0x00, RPC_OP_MEM_READ,
+    (uint8_t)FLASH_BASE, (uint8_t)(FLASH_BASE >> 8),
+    (uint8_t)(FLASH_BASE >> 16), (uint8_t)(FLASH_BASE >> 24),
+    (uint8_t)BENCH_RPC_LEN, (uint8_t)(BENCH_RPC_LEN >> 8)
+  };
+  uint16_t uiCrc = uiCalcCrc16(aucReq, BENCH_RPC_REQ_LEN - RPC_CRC_LEN, FRAME_CRC16_INIT);
+  aucReq[BENCH_RPC_REQ_LEN - 2] = uiCrc;
+  aucReq[BENCH_RPC_REQ_LEN - 1] = uiCrc >> 8;
+  uRpcReqLen = uEncodeCobs(aucReq, BENCH_RPC_REQ_LEN, aucRpcReq);
+}
+
+/*!****************************************************************************
+ * @brief
+ * RPC protocol path: decode, verify and execute a memory read request and
+ * encode its response, without the serial transfer
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchRpcMemRead(void)
+{
+  memcpy(aucRpcIn, aucRpcReq, uRpcReqLen);
+  ulSink = uProcessRpcFrame(aucRpcIn, uRpcReqLen, aucRpcOut);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Verify that CRC unit and software CRC-32 produce identical results for
+ * aligned and unaligned lengths
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vCheckCrc32(void)
+{
+  static const unsigned auLen[] = { 0, 1, 3, 4, BENCH_BLOCK_LARGE - 1, BENCH_BLOCK_LARGE };
+  for (unsigned i = 0; i < sizeof(auLen) / sizeof(auLen[0]); ++i)
+  {
+    const void* pvData = (const void*)FLASH_BASE;
+    uint32_t ulHw = ulCalcCrc32(pvData, auLen[i]);
+    uint32_t ulSw = ulCalcCrc32Sw(pvData, auLen[i], OFFLOAD_CRC32_INIT);
+    if (ulHw != ulSw)
+    {
+      fprintf(stderr, "CRC-32 mismatch for %u bytes: hw %08lX, sw %08lX\r\n", auLen[i], ulHw, ulSw);
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * CRC-32 of flash blocks: software table vs. CRC unit fed by DMA
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchCrc32SwSmall(void)
+{
+  ulSink = ulCalcCrc32Sw((const void*)FLASH_BASE, BENCH_BLOCK_SMALL, OFFLOAD_CRC32_INIT);
+}
+
+static void vBenchCrc32HwSmall(void)
+{
+  ulSink = ulCalcCrc32((const void*)FLASH_BASE, BENCH_BLOCK_SMALL);
+}
+
+static void vBenchCrc32SwLarge(void)
+{
+  ulSink = ulCalcCrc32Sw((const void*)FLASH_BASE, BENCH_BLOCK_LARGE, OFFLOAD_CRC32_INIT);
+}
+
+static void vBenchCrc32HwLarge(void)
+{
+  ulSink = ulCalcCrc32((const void*)FLASH_BASE, BENCH_BLOCK_LARGE);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Copy flash block to RAM / fill RAM block: memcpy()/memset() vs. DMA
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchMemCpyCpuSmall(void)
+{
+  memcpy(aulBlockBuf, (const void*)FLASH_BASE, BENCH_BLOCK_SMALL);
+}
+
+static void vBenchMemCpyDmaSmall(void)
+{
+  vDmaMemCpy(aulBlockBuf, (const void*)FLASH_BASE, BENCH_BLOCK_SMALL);
+}
+
+static void vBenchMemCpyCpuLarge(void)
+{
+  memcpy(aulBlockBuf, (const void*)FLASH_BASE, BENCH_BLOCK_LARGE);
+}
+
+static void vBenchMemCpyDmaLarge(void)
+{
+  vDmaMemCpy(aulBlockBuf, (const void*)FLASH_BASE, BENCH_BLOCK_LARGE);
+}
+
+static void vBenchMemSetCpuLarge(void)
+{
+  memset(aulBlockBuf, 0x55, BENCH_BLOCK_LARGE);
+}
+
+static void vBenchMemSetDmaLarge(void)
+{
+  vDmaMemSet(aulBlockBuf, 0x55, BENCH_BLOCK_LARGE);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Memory copy, fill and string length by length bucket: C library vs. word-
+ * oriented functions (identical if USE_FAST_MEMFUNC replaces the C library
+ * functions)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchMemCpyCpuTiny(void)
+{
+  memcpy(aulBlockBuf, (const void*)FLASH_BASE, uTinyLen);
+}
+
+static void vBenchMemCpyFastTiny(void)
+{
+  pvFastMemCpy(aulBlockBuf, (const void*)FLASH_BASE, uTinyLen);
+}
+
+static void vBenchMemCpyFastSmall(void)
+{
+  pvFastMemCpy(aulBlockBuf, (const void*)FLASH_BASE, BENCH_BLOCK_SMALL);
+}
+
+static void vBenchMemCpyFastLarge(void)
+{
+  pvFastMemCpy(aulBlockBuf, (const void*)FLASH_BASE, BENCH_BLOCK_LARGE);
+}
+
+static void vBenchMemCpyCpuMisaligned(void)
+{
+  memcpy(aulBlockBuf, (const void*)(FLASH_BASE + BENCH_MISALIGN), BENCH_BLOCK_LARGE);
+}
+
+static void vBenchMemCpyFastMisaligned(void)
+{
+  pvFastMemCpy(aulBlockBuf, (const void*)(FLASH_BASE + BENCH_MISALIGN), BENCH_BLOCK_LARGE);
+}
+
+static void vBenchMemSetFastLarge(void)
+{
+  pvFastMemSet(aulBlockBuf, 0x55, BENCH_BLOCK_LARGE);
+}
+
+static void vBenchStrLenCpu(void)
+{
+  ulSink = strlen(pszBenchStr);
+}
+
+static void vBenchStrLenFast(void)
+{
+  ulSink = uFastStrLen(pszBenchStr);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Publish an event and dispatch it to its subscriber
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchEventRoundTrip(void)
+{
+  bPublishEvent(EVENT_TOPIC_BENCH, 0, ulSink);
+  bDispatchEvent();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Q15 FFT in place on the block buffer (timing does not depend on the data)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchFftSmall(void)
+{
+  int16_t* piData = (int16_t*)aulBlockBuf;
+  vFftQ15(piData, &piData[1U << BENCH_FFT_LOG2_SMALL], BENCH_FFT_LOG2_SMALL);
+}
+
+static void vBenchFftLarge(void)
+{
+  int16_t* piData = (int16_t*)aulBlockBuf;
+  vFftQ15(piData, &piData[1U << BENCH_FFT_LOG2_LARGE], BENCH_FFT_LOG2_LARGE);
+}
+
+/*!****************************************************************************
+ * @brief
+ * PID iteration with all terms active and the feedback varying, so that the
+ * integral term is updated on every call
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBenchPidStep(void)
+{
+  static const ControlCfgTypeDef sCfg = {
+    .lKp = CONTROL_GAIN_ONE,
+    .lKi = 10 * CONTROL_GAIN_ONE,
+    .lKd = CONTROL_GAIN_ONE / 1000,
+    .uiRate = 1000
+  };
+  static ControlPidTypeDef sPid;
+  if (sPid.lKp == 0) vInitPid(&sPid, &sCfg);
+  ulSink += lStepPid(&sPid, 16384, 16384 + (int32_t)(ulSink & 0xFF) - 128);
+}
+
+/*! Benchmark case table                                                      */
+static const BenchCaseTypeDef asBenchCases[] = {
+  { "serial_write",    vBenchSerialWrite,           BENCH_SERIAL_LEN,      16  },
+  { "serial_copy",     vBenchSerialMsgCopy,         BENCH_MSG_LEN,         DBGSER_MSG_QUEUE_LEN },
+  { "serial_sg",       vBenchSerialMsgSg,           BENCH_MSG_LEN,         DBGSER_MSG_QUEUE_LEN },
+  { "hexdump",         vBenchHexDump,               BENCH_HEXDUMP_LEN,     4   },
+#ifdef USE_EEPROM_DEMO
+  { "eeprom_read",     vBenchEepromRead,            EEPROM_PAGE_SIZE,      16  },
+  { "eeprom_write",    vBenchEepromWrite,           EEPROM_PAGE_SIZE,      4   },
+  { "eevol_write",     vBenchEeVolWrite,            EEVOL_STRIPE_SIZE,     16  },
+#endif /* USE_EEPROM_DEMO */
+  { "adc_math",        vBenchAdcMath,               0,                     64  },
+  { "dispatch",        vBenchDispatch,              0,                     256 },
+#ifdef USE_POOLS
+  { "pool_alloc",      vBenchPoolAlloc,             0,                     256 },
+#endif /* USE_POOLS */
+  { "malloc",          vBenchMalloc,                0,                     256 },
+  { "rpc_mem_read",    vBenchRpcMemRead,            BENCH_RPC_LEN,         64  },
+  { "crc32_sw_64",     vBenchCrc32SwSmall,          BENCH_BLOCK_SMALL,     64  },
+  { "crc32_hw_64",     vBenchCrc32HwSmall,          BENCH_BLOCK_SMALL,     64  },
+  { "crc32_sw_1k",     vBenchCrc32SwLarge,          BENCH_BLOCK_LARGE,     16  },
+  { "crc32_hw_1k",     vBenchCrc32HwLarge,          BENCH_BLOCK_LARGE,     16  },
+  { "memcpy_cpu_8",    vBenchMemCpyCpuTiny,         BENCH_BLOCK_TINY,      256 },
+  { "memcpy_fast_8",   vBenchMemCpyFastTiny,        BENCH_BLOCK_TINY,      256 },
+  { "memcpy_cpu_64",   vBenchMemCpyCpuSmall,        BENCH_BLOCK_SMALL,     64  },
+  { "memcpy_fast_64",  vBenchMemCpyFastSmall,       BENCH_BLOCK_SMALL,     64  },
+  { "memcpy_dma_64",   vBenchMemCpyDmaSmall,        BENCH_BLOCK_SMALL,     64  },
+  { "memcpy_cpu_1k",   vBenchMemCpyCpuLarge,        BENCH_BLOCK_LARGE,     16  },
+  { "memcpy_fast_1k",  vBenchMemCpyFastLarge,       BENCH_BLOCK_LARGE,     16  },
+  { "memcpy_cpu_u1k",  vBenchMemCpyCpuMisaligned,   BENCH_BLOCK_LARGE,     16  },
+  { "memcpy_fast_u1k", vBenchMemCpyFastMisaligned,  BENCH_BLOCK_LARGE,     16  },
+  { "memcpy_dma_1k",   vBenchMemCpyDmaLarge,        BENCH_BLOCK_LARGE,     16  },
+  { "memset_cpu_1k",   vBenchMemSetCpuLarge,        BENCH_BLOCK_LARGE,     16  },
+  { "memset_fast_1k",  vBenchMemSetFastLarge,       BENCH_BLOCK_LARGE,     16  },
+  { "memset_dma_1k",   vBenchMemSetDmaLarge,        BENCH_BLOCK_LARGE,     16  },
+  { "strlen_cpu_64",   vBenchStrLenCpu,             BENCH_BLOCK_SMALL - 1, 64  },
+  { "strlen_fast_64",  vBenchStrLenFast,            BENCH_BLOCK_SMALL - 1, 64  },
+  { "event_rtrip",     vBenchEventRoundTrip,        0,                     256 },
+  { "fft_q15_64",      vBenchFftSmall,              0,                     16  },
+  { "fft_q15_256",     vBenchFftLarge,              0,                     4   },
+  { "pid_step",        vBenchPidStep,               0,                     256 }
+};
+
+/*! Number of benchmark cases                                                 */
+#define BENCH_NUM_CASES               (sizeof(asBenchCases) / sizeof(asBenchCases[0]))
+
+/*!****************************************************************************
+ * @brief
+ * Run a single benchmark case
+ *
+ * @param[in] *psCase     Benchmark case
+ * @param[out] *psResult  Measurement result
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vRunCase(const BenchCaseTypeDef* psCase, BenchResultTypeDef* psResult)
+{
+  uint32_t ulStart = SysTick_GetValueLow();
+  for (unsigned i = 0; i < psCase->uIterations; ++i) psCase->pvRun();
+  uint32_t ulTicks = SysTick_GetValueLow() - ulStart;
+  if (ulTicks == 0) ulTicks = 1;
+
+  /* SysTick runs at HCLK/8                               */
+  uint32_t ulTickFreq = SystemCoreClock / 8;
+  psResult->ulNsPerOp = (uint32_t)(((uint64_t)ulTicks * 1000000000ULL) /
+    ulTickFreq / psCase->uIterations);
+  psResult->ulBytesPerSec = (uint32_t)(((uint64_t)psCase->uBytesPerOp *
+    psCase->uIterations * ulTickFreq) / ulTicks);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Subscriber for benchmark events
+ *
+ * @param[in] *psEvent    Event
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHandleBenchEvent(const EventTypeDef* psEvent)
+{
+  ulSink = psEvent->ulData + 1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run all benchmark cases and print results
+ *
+ * @note
+ * Output-path benchmarks print their test data to the terminal.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vRunBenchmarks(void)
+{
+  BenchResultTypeDef asResults[BENCH_NUM_CASES];
+  vInitBenchRpc();
+  vCheckCrc32();
+
+  /* Flush pending output so it does not count towards the
+   * serial output measurements                           */
+  fflush(stdout);
+  for (unsigned i = 0; i < BENCH_NUM_CASES; ++i)
+  {
+    vFlushDbgSer();
+    vRunCase(&asBenchCases[i], &asResults[i]);
+    fflush(stdout);
+  }
+
+  /* Result table                                         */
+  printf(
+    "\r\n-- Benchmark results -----------------------------\r\n"
+  );
+  for (unsigned i = 0; i < BENCH_NUM_CASES; ++i)
+  {
+    printf("%-15s %10lu ns/op %10lu B/s\r\n", asBenchCases[i].pszName,
+      asResults[i].ulNsPerOp, asResults[i].ulBytesPerSec);
+  }
+
+  /* Machine-readable result line                         */
+  printf("{\"hclk\":%lu,\"results\":{", SystemCoreClock);
+  for (unsigned i = 0; i < BENCH_NUM_CASES; ++i)
+  {
+    printf("%s\"%s\":{\"ns_op\":%lu,\"bytes_s\":%lu}", (i > 0) ? "," : "",
+      asBenchCases[i].pszName, asResults[i].ulNsPerOp,
+      asResults[i].ulBytesPerSec);
+  }
+  printf("}}\r\n");
+}
+
+#endif /* USE_BENCH */
@@ -0,0 +1,30 @@
+/*!****************************************************************************
+ * @file
+ * bench.h
+ *
+ * @brief
+ * Benchmark suite for firmware hot paths
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added event subscriber
+ * @date  18.10.2026  Made optional
+ ******************************************************************************/
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include "event.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Include the benchmark suite and its shell command (normally set by
+ *  the USE_BENCH CMake option)                                               */
+//#define USE_BENCH
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vRunBenchmarks(void);
+void vHandleBenchEvent(const EventTypeDef* psEvent);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,235 @@
+/*!****************************************************************************
+ * @file
+ * boot.c
+ *
+ * @brief
+ * Boot sequencer with init dependencies and deferred initialisation
+ *
+ * Initialisation steps are given as a static table to vRunBoot(). Each step
+ * declares the steps it depends on, and is started as soon as these are
+ * ready. A step may complete in the background (e.g. a peripheral power-on
+ * delay), reported by its ready check; the sequencer starts other steps in
+ * the meantime instead of busy-waiting.
+ *
+ * vRunBoot() returns once all early steps are ready. Deferred steps are run
+ * from the main loop by bPollBoot() after the first prompt has been printed,
+ * one step started per call, so that they overlap the prompt transmission.
+ *
+ * Start and ready times of all steps, the end of the early phase, the first
+ * prompt and the end of the deferred phase are recorded as SysTick counts,
+ * i.e. relative to the SysTick start in vInitHW(). A step whose dependencies
+ * cannot be met in its phase (a missing or deferred step for an early step,
+ * or a dependency cycle) is not run, and reported by vPrintBootInfo().
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include "ch32v10x.h"
+#include "hw_stk.h"
+#include "dbgser.h"
+#include "boot.h"
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Step table                                                                */
+static const BootStepTypeDef* psStepTable;
+
+/*! Number of step table entries                                              */
+static unsigned uNumStepEntries;
+
+/*! Steps started, ready and not run, as BOOT_DEP() masks                     */
+static uint32_t ulStarted, ulReady, ulNotRun;
+
+/*! Step start and ready times in SysTick counts                              */
+static uint32_t aulStartTicks[BOOT_MAX_STEPS], aulReadyTicks[BOOT_MAX_STEPS];
+
+/*! Phase times in SysTick counts
+ *  @{                                                                        */
+static uint32_t ulEarlyDoneTicks, ulPromptTicks, ulDeferredDoneTicks;
+/*! @}                                                                        */
+
+/*! SysTick counts per millisecond during boot                                */
+static uint32_t ulTicksPerMs;
+
+/*! Deferred phase completed                                                  */
+static bool bDeferredDone;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Run one pass over the steps of a phase: check started steps for readiness,
+ * and start steps whose dependencies are ready
+ *
+ * @param[in] ePhase      Boot phase
+ * @param[in] uMaxStarts  Maximum number of steps to be started
+ * @return  (bool)  true if the phase has not completed yet
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bRunPass(BootPhaseTypeDef ePhase, unsigned uMaxStarts)
+{
+  bool bPending = false;
+  bool bProgress = false;
+  for (unsigned i = 0; i < uNumStepEntries; ++i)
+  {
+    const BootStepTypeDef* psStep = &psStepTable[i];
+    uint32_t ulMask = BOOT_DEP(i);
+    if ((psStep->ePhase != ePhase) || ((ulReady | ulNotRun) & ulMask)) continue;
+
+    if (ulStarted & ulMask)
+    {
+      /* Waiting in the background                        */
+      if (psStep->pbIsReady())
+      {
+        aulReadyTicks[i] = SysTick_GetValueLow();
+        ulReady |= ulMask;
+        bProgress = true;
+      }
+      else
+      {
+        bPending = true;
+      }
+      continue;
+    }
+
+    if (((psStep->ulDeps & ulReady) != psStep->ulDeps) || (uMaxStarts == 0))
+    {
+      bPending = true;
+      continue;
+    }
+
+    aulStartTicks[i] = SysTick_GetValueLow();
+    ulStarted |= ulMask;
+    psStep->pvStart();
+    --uMaxStarts;
+    bProgress = true;
+    if ((psStep->pbIsReady == NULL) || psStep->pbIsReady())
+    {
+      aulReadyTicks[i] = SysTick_GetValueLow();
+      ulReady |= ulMask;
+    }
+    else
+    {
+      bPending = true;
+    }
+  }
+
+  /* Remaining steps can never be started if nothing has
+   * changed and no step is waiting in the background     */
+  if (bPending && !bProgress && ((ulStarted & ~ulReady) == 0))
+  {
+    for (unsigned i = 0; i < uNumStepEntries; ++i)
+    {
+      if (psStepTable[i].ePhase == ePhase) ulNotRun |= BOOT_DEP(i) & ~ulReady;
+    }
+    bPending = false;
+  }
+  return bPending;
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Run early boot phase
+ *
+ * Returns once all early steps are ready. Table entries without a start
+ * function are treated as ready.
+ *
+ * @note
+ * SysTick shall be running, see vInitHW().
+ *
+ * @param[in] *psSteps    Step table
+ * @param[in] uNumSteps   Number of table entries, at most BOOT_MAX_STEPS
+ * @date  18.10.2026
+ ******************************************************************************/
+void vRunBoot(const BootStepTypeDef* psSteps, unsigned uNumSteps)
+{
+  psStepTable = psSteps;
+  uNumStepEntries = (uNumSteps > BOOT_MAX_STEPS) ? BOOT_MAX_STEPS : uNumSteps;
+  ulStarted = 0;
+  ulReady = 0;
+  ulNotRun = 0;
+  ulPromptTicks = 0;
+  bDeferredDone = false;
+  ulTicksPerMs = ulHW_STK_MsToTicks(1);
+
+  for (unsigned i = 0; i < uNumStepEntries; ++i)
+  {
+    if (psSteps[i].pvStart == NULL) ulReady |= BOOT_DEP(i);
+  }
+
+  while (bRunPass(BOOT_PHASE_EARLY, BOOT_MAX_STEPS));
+  ulEarlyDoneTicks = SysTick_GetValueLow();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Record first prompt time
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vMarkBootPrompt(void)
+{
+  if (ulPromptTicks == 0) ulPromptTicks = SysTick_GetValueLow();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run deferred boot phase, at most one step started per call
+ *
+ * @return  (bool)  true while deferred steps are pending; modules initialised
+ *                  by deferred steps shall not be used until false is returned
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bPollBoot(void)
+{
+  if (bDeferredDone) return false;
+  if (bRunPass(BOOT_PHASE_DEFERRED, 1)) return true;
+
+  ulDeferredDoneTicks = SysTick_GetValueLow();
+  bDeferredDone = true;
+  return false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print boot step and phase times
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPrintBootInfo(void)
+{
+  printf(
+    "-- Boot ------------------------------------------\r\n"
+    "Step       Phase     Start us  Ready us   Time us\r\n"
+  );
+  for (unsigned i = 0; i < uNumStepEntries; ++i)
+  {
+    const BootStepTypeDef* psStep = &psStepTable[i];
+    if (psStep->pvStart == NULL) continue;
+
+    printf("%-10s %-8s ", psStep->pszName, (psStep->ePhase == BOOT_PHASE_EARLY) ? "early" : "deferred");
+    if (ulReady & BOOT_DEP(i))
+    {
+      uint32_t ulStart = (uint64_t)aulStartTicks[i] * 1000 / ulTicksPerMs;
+      uint32_t ulDone = (uint64_t)aulReadyTicks[i] * 1000 / ulTicksPerMs;
+      printf("%9lu %9lu %9lu\r\n", ulStart, ulDone, ulDone - ulStart);
+    }
+    else
+    {
+      printf(VT100_COLOR_FGRED "%s\r\n" VT100_COLOR_RESET,
+        (ulNotRun & BOOT_DEP(i)) ? "not run, dependency not ready" : "pending");
+    }
+  }
+
+  printf("Early phase done at %lu us, first prompt at %lu us\r\n",
+    (uint32_t)((uint64_t)ulEarlyDoneTicks * 1000 / ulTicksPerMs),
+    (uint32_t)((uint64_t)ulPromptTicks * 1000 / ulTicksPerMs));
+  if (bDeferredDone)
+  {
+    printf("Deferred phase done at %lu us\r\n",
+      (uint32_t)((uint64_t)ulDeferredDoneTicks * 1000 / ulTicksPerMs));
+  }
+}
@@ -0,0 +1,61 @@
+/*!****************************************************************************
+ * @file
+ * boot.h
+ *
+ * @brief
+ * Boot sequencer with init dependencies and deferred initialisation
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef BOOT_H_
+#define BOOT_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Maximum number of boot steps                                       */
+#define BOOT_MAX_STEPS                32
+
+/*! @brief Dependency mask bit of a step, by table index                      */
+#define BOOT_DEP(idx)                 (1UL << (idx))
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Boot phases                                                        */
+typedef enum
+{
+  BOOT_PHASE_EARLY = 0,               /*!< Before the first prompt            */
+  BOOT_PHASE_DEFERRED                 /*!< From the main loop, after the first
+                                           prompt                             */
+} BootPhaseTypeDef;
+
+/*! @brief Boot step table entry
+ *
+ * A step is started once all steps in its dependency mask are ready. Steps
+ * with a ready check complete in the background, e.g. a peripheral power-on
+ * delay, while other steps are started. Entries without a start function are
+ * skipped, so that the table may be indexed by a step enumeration with some
+ * steps disabled by configuration.                                          */
+typedef struct
+{
+  const char* pszName;                /*!< Step name                          */
+  void (*pvStart)(void);              /*!< Start function                     */
+  bool (*pbIsReady)(void);            /*!< Ready check, NULL if the step is
+                                           complete when pvStart returns      */
+  uint32_t ulDeps;                    /*!< Steps to be ready before the start,
+                                           as BOOT_DEP() mask                 */
+  BootPhaseTypeDef ePhase;            /*!< Boot phase                         */
+} BootStepTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vRunBoot(const BootStepTypeDef* psSteps, unsigned uNumSteps);
+void vMarkBootPrompt(void);
+bool bPollBoot(void);
+void vPrintBootInfo(void);
+
+#endif /* BOOT_H_ */
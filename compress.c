@@ -0,0 +1,301 @@
+/*!****************************************************************************
+ * @file
+ * compress.c
+ *
+ * @brief
+ * Compression stage for serial link data
+ *
+ * Data blocks sent over the serial link can be compressed per channel. Each
+ * block is coded independently, so that blocks may be requested in any order
+ * and lost responses do not affect other blocks. Two encodings are available:
+ *
+ * Delta: the block is a sequence of little-endian 16-bit samples. The first
+ * sample and then the difference to the previous sample are zig-zag mapped
+ * (0, -1, 1, -2, ... to 0, 1, 2, 3, ...) and written as LEB128 varints, so
+ * slowly changing signals take one byte per sample.
+ *
+ * LZ: LZSS with a window of 256 bytes. A flag byte precedes each group of up
+ * to 8 items, with bit n (LSB first) set if item n is a match. A literal is
+ * one byte; a match is two bytes, distance - 1 and length - 3. Matches are
+ * found through a 64-entry hash table of 3-byte sequences (128 bytes of
+ * stack), keeping only the most recent position per hash.
+ *
+ * On a channel with compression enabled, uCompressBlock() prefixes the coded
+ * data with the encoding actually used. Blocks which do not get smaller are
+ * sent uncompressed with COMPRESS_NONE. tools/compress.py contains the
+ * matching decoders.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "ch32v10x.h"
+#include "hw_stk.h"
+#include "compress.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Number of hash table entries                                       */
+#define LZ_HASH_SIZE                  (1 << COMPRESS_LZ_HASH_BITS)
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Selected encoding per channel                                             */
+static CompressModeTypeDef aeModes[COMPRESS_NUM_CHANNELS];
+
+/*! Statistics per channel                                                    */
+static CompressStatsTypeDef asStats[COMPRESS_NUM_CHANNELS];
+
+/*! Channel names                                                             */
+static const char* const apszChannels[COMPRESS_NUM_CHANNELS] = {
+  [COMPRESS_CH_LOG] = "log",
+  [COMPRESS_CH_ADC] = "adc"
+};
+
+/*! Encoding names                                                            */
+static const char* const apszModes[COMPRESS_NUM_MODES] = {
+  [COMPRESS_NONE]  = "none",
+  [COMPRESS_DELTA] = "delta",
+  [COMPRESS_LZ]    = "lz"
+};
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Hash of the 3 bytes at a position
+ *
+ * @param[in] *pucData    Data
+ * @return  (unsigned)  Hash table index
+ * @date  18.10.2026
+ ******************************************************************************/
+static unsigned uHashLz(const uint8_t* pucData)
+{
+  uint32_t ulKey = pucData[0] | ((uint32_t)pucData[1] << 8) | ((uint32_t)pucData[2] << 16);
+  return (uint32_t)(ulKey * 2654435761UL) >> (32 - COMPRESS_LZ_HASH_BITS);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Delta and zig-zag varint encoding of 16-bit samples
+ *
+ * @param[in] *pucIn      Little-endian 16-bit samples
+ * @param[in] uLen        Input length in bytes (even)
+ * @param[out] *pucOut    Output buffer
+ * @param[in] uOutMax     Output buffer size
+ * @return  (unsigned)  Output length, 0 if the output does not fit
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uEncodeDeltaVarint(const uint8_t* pucIn, unsigned uLen, uint8_t* pucOut, unsigned uOutMax)
+{
+  unsigned uOut = 0;
+  int32_t lPrev = 0;
+  for (unsigned i = 0; i + 1 < uLen; i += 2)
+  {
+    int32_t lSample = pucIn[i] | (pucIn[i + 1] << 8);
+    int32_t lDelta = lSample - lPrev;
+    lPrev = lSample;
+
+    uint32_t ulZigZag = ((uint32_t)lDelta << 1) ^ (uint32_t)(lDelta >> 31);
+    do
+    {
+      if (uOut >= uOutMax) return 0;
+      uint8_t ucByte = ulZigZag & 0x7F;
+      ulZigZag >>= 7;
+      pucOut[uOut++] = (ulZigZag != 0) ? (ucByte | 0x80) : ucByte;
+    } while (ulZigZag != 0);
+  }
+  return uOut;
+}
+
+/*!****************************************************************************
+ * @brief
+ * LZSS compression of a data block
+ *
+ * @param[in] *pucIn      Input data
+ * @param[in] uLen        Input length in bytes
+ * @param[out] *pucOut    Output buffer
+ * @param[in] uOutMax     Output buffer size
+ * @return  (unsigned)  Output length, 0 if the output does not fit
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uCompressLz(const uint8_t* pucIn, unsigned uLen, uint8_t* pucOut, unsigned uOutMax)
+{
+  /* Most recent position + 1 per hash, 0 if none         */
+  uint16_t auiHead[LZ_HASH_SIZE];
+  memset(auiHead, 0, sizeof(auiHead));
+
+  unsigned uOut = 0;
+  unsigned uFlagPos = 0;
+  unsigned uItem = 8;
+  unsigned uPos = 0;
+  while (uPos < uLen)
+  {
+    /* Start new item group                               */
+    if (uItem == 8)
+    {
+      if (uOut >= uOutMax) return 0;
+      uFlagPos = uOut;
+      pucOut[uOut++] = 0;
+      uItem = 0;
+    }
+
+    /* Look up most recent candidate                      */
+    unsigned uMatchLen = 0;
+    unsigned uDist = 0;
+    if (uPos + COMPRESS_LZ_MIN_MATCH <= uLen)
+    {
+      unsigned uHash = uHashLz(&pucIn[uPos]);
+      unsigned uCand = auiHead[uHash];
+      auiHead[uHash] = uPos + 1;
+      if ((uCand > 0) && (uPos - (uCand - 1) <= COMPRESS_LZ_WINDOW))
+      {
+        uCand -= 1;
+        unsigned uMax = uLen - uPos;
+        if (uMax > COMPRESS_LZ_MAX_MATCH) uMax = COMPRESS_LZ_MAX_MATCH;
+        while ((uMatchLen < uMax) && (pucIn[uCand + uMatchLen] == pucIn[uPos + uMatchLen])) ++uMatchLen;
+        uDist = uPos - uCand;
+      }
+    }
+
+    if (uMatchLen >= COMPRESS_LZ_MIN_MATCH)
+    {
+      if (uOut + 2 > uOutMax) return 0;
+      pucOut[uFlagPos] |= 1 << uItem;
+      pucOut[uOut++] = uDist - 1;
+      pucOut[uOut++] = uMatchLen - COMPRESS_LZ_MIN_MATCH;
+
+      /* Enter skipped positions into hash table            */
+      for (unsigned i = 1; (i < uMatchLen) && (uPos + i + COMPRESS_LZ_MIN_MATCH <= uLen); ++i)
+      {
+        auiHead[uHashLz(&pucIn[uPos + i])] = uPos + i + 1;
+      }
+      uPos += uMatchLen;
+    }
+    else
+    {
+      if (uOut >= uOutMax) return 0;
+      pucOut[uOut++] = pucIn[uPos++];
+    }
+    ++uItem;
+  }
+  return uOut;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Select channel encoding
+ *
+ * @param[in] eChannel    Data channel
+ * @param[in] eMode       Encoding
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSetCompressMode(CompressChannelTypeDef eChannel, CompressModeTypeDef eMode)
+{
+  if ((eChannel < COMPRESS_NUM_CHANNELS) && (eMode < COMPRESS_NUM_MODES)) aeModes[eChannel] = eMode;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get channel encoding
+ *
+ * @param[in] eChannel    Data channel
+ * @return  (CompressModeTypeDef)  Selected encoding
+ * @date  18.10.2026
+ ******************************************************************************/
+CompressModeTypeDef eGetCompressMode(CompressChannelTypeDef eChannel)
+{
+  return aeModes[eChannel];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Code a data block for a channel
+ *
+ * Without compression, the block is copied. Otherwise, the output starts with
+ * the encoding used, followed by the coded data.
+ *
+ * @param[in] eChannel    Data channel
+ * @param[in] *pvIn       Input data
+ * @param[in] uLen        Input length in bytes
+ * @param[out] *pucOut    Output buffer
+ * @param[in] uOutMax     Output buffer size
+ * @return  (unsigned)  Output length, 0 if the output does not fit
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uCompressBlock(CompressChannelTypeDef eChannel, const void* pvIn, unsigned uLen, uint8_t* pucOut, unsigned uOutMax)
+{
+  uint32_t ulStart = SysTick_GetValueLow();
+  CompressModeTypeDef eMode = aeModes[eChannel];
+  unsigned uOut = 0;
+
+  if (eMode == COMPRESS_NONE)
+  {
+    if (uLen > uOutMax) return 0;
+    memcpy(pucOut, pvIn, uLen);
+    uOut = uLen;
+  }
+  else if (uOutMax > 0)
+  {
+    unsigned uCoded = 0;
+    if ((eMode == COMPRESS_DELTA) && ((uLen % 2) == 0)) uCoded = uEncodeDeltaVarint(pvIn, uLen, &pucOut[1], uOutMax - 1);
+    else if (eMode == COMPRESS_LZ) uCoded = uCompressLz(pvIn, uLen, &pucOut[1], uOutMax - 1);
+
+    /* Fall back to uncompressed block                    */
+    if ((uCoded == 0) || (uCoded >= uLen))
+    {
+      if (uLen + 1 > uOutMax) return 0;
+      eMode = COMPRESS_NONE;
+      memcpy(&pucOut[1], pvIn, uLen);
+      uCoded = uLen;
+    }
+    pucOut[0] = eMode;
+    uOut = 1 + uCoded;
+  }
+
+  CompressStatsTypeDef* psStats = &asStats[eChannel];
+  ++psStats->ulBlocks;
+  psStats->ulBytesIn += uLen;
+  psStats->ulBytesOut += uOut;
+  psStats->ulTicks += SysTick_GetValueLow() - ulStart;
+  return uOut;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get channel statistics
+ *
+ * @param[in] eChannel    Data channel
+ * @param[out] *psStats   Statistics
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetCompressStats(CompressChannelTypeDef eChannel, CompressStatsTypeDef* psStats)
+{
+  *psStats = asStats[eChannel];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print encoding, compression ratio and processing time per channel
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPrintCompressStats(void)
+{
+  printf(
+    "-- Compression -----------------------------------\r\n"
+  );
+  for (unsigned i = 0; i < COMPRESS_NUM_CHANNELS; ++i)
+  {
+    const CompressStatsTypeDef* psStats = &asStats[i];
+    uint32_t ulRatio = (psStats->ulBytesIn > 0) ?
+      (uint32_t)((uint64_t)psStats->ulBytesOut * 1000 / psStats->ulBytesIn) : 0;
+    uint32_t ulUs = (uint32_t)((uint64_t)psStats->ulTicks * 1000 / ulHW_STK_MsToTicks(1));
+    printf("%-4s %-5s %6lu blocks, %8lu -> %8lu bytes (%lu.%lu%%), %lu us\r\n",
+      apszChannels[i], apszModes[aeModes[i]], psStats->ulBlocks,
+      psStats->ulBytesIn, psStats->ulBytesOut, ulRatio / 10, ulRatio % 10, ulUs);
+  }
+}
@@ -0,0 +1,70 @@
+/*!****************************************************************************
+ * @file
+ * compress.h
+ *
+ * @brief
+ * Compression stage for serial link data
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef COMPRESS_H_
+#define COMPRESS_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Shortest LZ match length                                           */
+#define COMPRESS_LZ_MIN_MATCH         3
+
+/*! @brief Longest LZ match length                                            */
+#define COMPRESS_LZ_MAX_MATCH         (COMPRESS_LZ_MIN_MATCH + 255)
+
+/*! @brief LZ window size (maximum match distance)                            */
+#define COMPRESS_LZ_WINDOW            256
+
+/*! @brief LZ match finder hash table size in bits                            */
+#define COMPRESS_LZ_HASH_BITS         6
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Encodings                                                          */
+typedef enum
+{
+  COMPRESS_NONE = 0,                  /*!< Uncompressed                       */
+  COMPRESS_DELTA,                     /*!< 16-bit sample deltas, zig-zag
+                                           varint coded                       */
+  COMPRESS_LZ,                        /*!< LZSS with 256-byte window          */
+  COMPRESS_NUM_MODES
+} CompressModeTypeDef;
+
+/*! @brief Data channels with selectable compression                          */
+typedef enum
+{
+  COMPRESS_CH_LOG = 0,                /*!< Flash log pages (RPC LOG_READ)     */
+  COMPRESS_CH_ADC,                    /*!< ADC samples (RPC ADC_CAPTURE)      */
+  COMPRESS_NUM_CHANNELS
+} CompressChannelTypeDef;
+
+/*! @brief Per-channel statistics                                             */
+typedef struct
+{
+  uint32_t ulBlocks;                  /*!< Blocks processed                   */
+  uint32_t ulBytesIn;                 /*!< Input bytes                        */
+  uint32_t ulBytesOut;                /*!< Output bytes incl. headers         */
+  uint32_t ulTicks;                   /*!< Processing time in SysTick counts  */
+} CompressStatsTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+unsigned uEncodeDeltaVarint(const uint8_t* pucIn, unsigned uLen, uint8_t* pucOut, unsigned uOutMax);
+unsigned uCompressLz(const uint8_t* pucIn, unsigned uLen, uint8_t* pucOut, unsigned uOutMax);
+void vSetCompressMode(CompressChannelTypeDef eChannel, CompressModeTypeDef eMode);
+CompressModeTypeDef eGetCompressMode(CompressChannelTypeDef eChannel);
+unsigned uCompressBlock(CompressChannelTypeDef eChannel, const void* pvIn, unsigned uLen, uint8_t* pucOut, unsigned uOutMax);
+void vGetCompressStats(CompressChannelTypeDef eChannel, CompressStatsTypeDef* psStats);
+void vPrintCompressStats(void);
+
+#endif /* COMPRESS_H_ */
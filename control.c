@@ -0,0 +1,572 @@
+/*!****************************************************************************
+ * @file
+ * control.c
+ *
+ * @brief
+ * Closed-loop PWM control with ADC feedback
+ *
+ * The loop runs in the TIM3 update interrupt, so its timing is derived from
+ * the PWM period rather than from main loop polling. At every loop rate
+ * divider'th update, the handler
+ *
+ *  - fetches the result of the injected conversion started by the previous
+ *    iteration; if none is available, the sample is counted as missed and
+ *    the last value is used again
+ *  - starts the next injected conversion of the feedback input, so sampling
+ *    takes place at a fixed point in time within each iteration
+ *  - calculates the PID output and writes the TIM3 channel 1 compare value
+ *
+ * The channel output is active low for the LED, so the PA6 pin is high for
+ * CONTROL_PWM_COUNTS minus the compare value in each period. The compare
+ * value is inverted accordingly, and the controller output sets the pin high
+ * time, i.e. the mean voltage of an RC filter on PA6.
+ *
+ * The PID works on Q15 setpoint and feedback values. Gains are configured in
+ * Q16.16 (Ki in 1/s, Kd in s) and scaled to one iteration when the loop rate
+ * is set. The derivative term acts on the feedback only, so setpoint steps do
+ * not cause output spikes. The integral term is only updated while the output
+ * is not limited in the direction of the error (conditional integration), and
+ * is itself limited to the output range.
+ *
+ * While the loop is running, the TIM3 channel 1 output is not available to
+ * the LED animation, and a sample record is sent on the telemetry output
+ * channel every CONTROL_TELEMETRY_MS.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added telemetry output
+ * @date  18.10.2026  PWM period of HW_TIM3_PWM_PERIOD counts
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "ch32v10x.h"
+#include "hw_adc.h"
+#include "hw_iodefs.h"
+#include "hw_stk.h"
+#include "mux.h"
+#include "shell.h"
+#include "control.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Maximum proportional and integral gain                             */
+#define CONTROL_GAIN_MAX              (1000 * CONTROL_GAIN_ONE)
+
+/*! @brief Maximum derivative gain in s                                       */
+#define CONTROL_KD_MAX                CONTROL_GAIN_ONE
+
+/*! @brief PWM counter clock cycles per period (auto-reload value + 1)        */
+#define CONTROL_PWM_COUNTS            HW_TIM3_PWM_PERIOD
+
+/*! @brief Shift from 12-bit conversion value to Q15                          */
+#define CONTROL_ADC_SHIFT             3
+
+/*! @brief Integral term limit (Q23)                                          */
+#define CONTROL_INT_MAX               ((int32_t)CONTROL_OUT_MAX << 8)
+
+/*! @brief Shell command line length                                          */
+#define CONTROL_LINE_LEN              24
+
+/*! @brief Number of fractional digits for gain input                         */
+#define CONTROL_FRAC_DIGITS           4
+
+/*! @brief Telemetry record interval                                          */
+#define CONTROL_TELEMETRY_MS          10
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Configuration                                                             */
+static ControlCfgTypeDef sCfg = {
+  .lKp = CONTROL_DEFAULT_KP,
+  .lKi = CONTROL_DEFAULT_KI,
+  .lKd = CONTROL_DEFAULT_KD,
+  .uiSetpoint = CONTROL_DEFAULT_SETPOINT_MV,
+  .uiRate = CONTROL_DEFAULT_RATE
+};
+
+/*! PID state, updated in interrupt context                                   */
+static ControlPidTypeDef sPid;
+
+/*! Setpoint, Q15                                                             */
+static int32_t lSetpoint;
+
+/*! Update interrupt divider for the loop rate                                */
+static unsigned uDivider;
+
+/*! Update interrupts since last iteration                                    */
+static unsigned uDivCount;
+
+/*! SysTick count at start of last iteration                                  */
+static uint32_t ulLastStart;
+
+/*! Loop statistics                                                           */
+static ControlStatsTypeDef sStats;
+
+/*! Loop running                                                              */
+static volatile bool bRunning;
+
+/*! SysTick count at last telemetry record                                    */
+static uint32_t ulLastTelemetry;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Scale configured gains to one loop iteration
+ *
+ * @param[out] *psPid     PID state
+ * @param[in] *psCfg      Configuration
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vScalePidGains(ControlPidTypeDef* psPid, const ControlCfgTypeDef* psCfg)
+{
+  psPid->lKp = psCfg->lKp;
+  psPid->lKi = psCfg->lKi / psCfg->uiRate;
+  psPid->lKd = psCfg->lKd * psCfg->uiRate;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Loop iteration (TIM3 update interrupt context)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vRunControlStep(void)
+{
+  if (++uDivCount < uDivider) return;
+  uDivCount = 0;
+  uint32_t ulStart = SysTick_GetValueLow();
+
+  /* Feedback sampled during the last interval            */
+  uint16_t uiConvVal;
+  if (bHW_GetAdcInjectedValue(&uiConvVal)) sStats.uiFeedback = uiConvVal;
+  else ++sStats.ulMissed;
+  vHW_StartAdcInjected();
+
+  /* Controller output to inverted PWM compare value      */
+  int32_t lOut = lStepPid(&sPid, lSetpoint, (int32_t)sStats.uiFeedback << CONTROL_ADC_SHIFT);
+  TIM_SetCompare1(TIM3, (uint16_t)(CONTROL_PWM_COUNTS - ((lOut * CONTROL_PWM_COUNTS + (1L << 14)) >> 15)));
+  sStats.uiOutput = lOut;
+  if (sPid.bSaturated) ++sStats.ulSaturated;
+
+  /* Interval and execution time                          */
+  if (sStats.ulSteps > 0)
+  {
+    uint32_t ulPeriod = ulStart - ulLastStart;
+    if (ulPeriod < sStats.ulPeriodMin) sStats.ulPeriodMin = ulPeriod;
+    if (ulPeriod > sStats.ulPeriodMax) sStats.ulPeriodMax = ulPeriod;
+  }
+  ulLastStart = ulStart;
+  ++sStats.ulSteps;
+  uint32_t ulExec = SysTick_GetValueLow() - ulStart;
+  sStats.ulExecSum += ulExec;
+  if (ulExec > sStats.ulExecMax) sStats.ulExecMax = ulExec;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reset loop statistics
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vResetStats(void)
+{
+  __disable_irq();
+  uint16_t uiFeedback = sStats.uiFeedback;
+  memset(&sStats, 0, sizeof(sStats));
+  sStats.uiFeedback = uiFeedback;
+  sStats.ulPeriodMin = UINT32_MAX;
+  __enable_irq();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Parse non-negative decimal number into Q16.16
+ *
+ * @param[in] *psz        Number, up to CONTROL_FRAC_DIGITS fractional digits
+ * @param[out] *plValue   Value, Q16.16
+ * @return  (bool)  true if valid and below 32768
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bParseGain(const char* psz, int32_t* plValue)
+{
+  uint32_t ulInt = 0;
+  uint32_t ulFrac = 0;
+  unsigned uDigits = 0;
+  bool bFrac = false;
+  if (*psz == '\0') return false;
+  for (; *psz != '\0'; ++psz)
+  {
+    if ((*psz == '.') && !bFrac)
+    {
+      bFrac = true;
+    }
+    else if ((*psz < '0') || (*psz > '9'))
+    {
+      return false;
+    }
+    else if (!bFrac)
+    {
+      ulInt = 10 * ulInt + (*psz - '0');
+      if (ulInt > INT16_MAX) return false;
+    }
+    else if (uDigits < CONTROL_FRAC_DIGITS)
+    {
+      ulFrac = 10 * ulFrac + (*psz - '0');
+      ++uDigits;
+    }
+  }
+  for (; uDigits < CONTROL_FRAC_DIGITS; ++uDigits) ulFrac *= 10;
+  *plValue = (int32_t)((ulInt << 16) + ((ulFrac << 16) + 5000) / 10000);
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Parse unsigned decimal integer
+ *
+ * @param[in] *psz        Number
+ * @param[out] *puValue   Value
+ * @return  (bool)  true if valid and below 65536
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bParseUnsigned(const char* psz, unsigned* puValue)
+{
+  unsigned uValue = 0;
+  if (*psz == '\0') return false;
+  for (; *psz != '\0'; ++psz)
+  {
+    if ((*psz < '0') || (*psz > '9')) return false;
+    uValue = 10 * uValue + (*psz - '0');
+    if (uValue > UINT16_MAX) return false;
+  }
+  *puValue = uValue;
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print Q16.16 gain with three decimals
+ *
+ * @param[in] lValue      Gain, Q16.16
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vPrintGain(int32_t lValue)
+{
+  uint32_t ulMilli = (uint32_t)(((uint64_t)lValue * 1000 + (1UL << 15)) >> 16);
+  printf("%lu.%03lu", ulMilli / 1000, ulMilli % 1000);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print configuration and loop statistics
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vPrintControlInfo(void)
+{
+  ControlStatsTypeDef sInfo;
+  vGetControlStats(&sInfo);
+  uint32_t ulTicksMs = ulHW_STK_MsToTicks(1);
+  uint32_t ulNominal = ulHW_STK_UsToTicks(1000000UL / sCfg.uiRate);
+
+  printf(
+    "-- Control loop ----------------------------------\r\n"
+    "State: %s, %u Hz, feedback PA1, output PA6\r\n"
+    "Setpoint: %u mV, Kp ",
+    bRunning ? "running" : "stopped", sCfg.uiRate, sCfg.uiSetpoint
+  );
+  vPrintGain(sCfg.lKp);
+  printf(", Ki ");
+  vPrintGain(sCfg.lKi);
+  printf(" /s, Kd ");
+  vPrintGain(sCfg.lKd);
+  printf(" s\r\n");
+  printf("Feedback: %u mV, output %lu.%lu %%\r\n",
+    uiHW_ConvertAdcValue_mV(sInfo.uiFeedback),
+    (sInfo.uiOutput * 1000UL >> 15) / 10, (sInfo.uiOutput * 1000UL >> 15) % 10);
+  printf("Steps: %lu, %lu missed samples, %lu saturated\r\n",
+    sInfo.ulSteps, sInfo.ulMissed, sInfo.ulSaturated);
+  if (sInfo.ulSteps < 2) return;
+
+  /* Times in us; jitter relative to nominal interval     */
+  printf("Interval: %lu..%lu us (jitter -%lu/+%lu us)\r\n",
+    sInfo.ulPeriodMin * 1000 / ulTicksMs, sInfo.ulPeriodMax * 1000 / ulTicksMs,
+    (sInfo.ulPeriodMin < ulNominal) ? (ulNominal - sInfo.ulPeriodMin) * 1000 / ulTicksMs : 0,
+    (sInfo.ulPeriodMax > ulNominal) ? (sInfo.ulPeriodMax - ulNominal) * 1000 / ulTicksMs : 0);
+  printf("Execution: %lu cycles avg, %lu max\r\n",
+    sInfo.ulExecSum / sInfo.ulSteps * HW_STK_HCLK_DIV, sInfo.ulExecMax * HW_STK_HCLK_DIV);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Execute control shell command line
+ *
+ * @param[in] *pszLine    Command and argument
+ * @return  (bool)  true if successful
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bExecControlCmd(char* pszLine)
+{
+  char* pszArg = strchr(pszLine, ' ');
+  if (pszArg != NULL) *pszArg++ = '\0';
+  else pszArg = "";
+
+  ControlCfgTypeDef sNew = sCfg;
+  unsigned uValue;
+  if (strcmp(pszLine, "on") == 0)
+  {
+    vStartControl();
+    return true;
+  }
+  else if (strcmp(pszLine, "off") == 0)
+  {
+    vStopControl();
+    return true;
+  }
+  else if (strcmp(pszLine, "reset") == 0)
+  {
+    vResetStats();
+    return true;
+  }
+  else if (strcmp(pszLine, "sp") == 0)
+  {
+    if (!bParseUnsigned(pszArg, &uValue)) return false;
+    sNew.uiSetpoint = uValue;
+  }
+  else if (strcmp(pszLine, "rate") == 0)
+  {
+    if (!bParseUnsigned(pszArg, &uValue)) return false;
+    sNew.uiRate = uValue;
+  }
+  else if (strcmp(pszLine, "kp") == 0)
+  {
+    if (!bParseGain(pszArg, &sNew.lKp)) return false;
+  }
+  else if (strcmp(pszLine, "ki") == 0)
+  {
+    if (!bParseGain(pszArg, &sNew.lKi)) return false;
+  }
+  else if (strcmp(pszLine, "kd") == 0)
+  {
+    if (!bParseGain(pszArg, &sNew.lKd)) return false;
+  }
+  else
+  {
+    return false;
+  }
+  return bSetControlCfg(&sNew);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Reset PID state and scale gains to the loop rate
+ *
+ * @param[out] *psPid     PID state
+ * @param[in] *psCfg      Configuration
+ * @date  18.10.2026
+ ******************************************************************************/
+void vInitPid(ControlPidTypeDef* psPid, const ControlCfgTypeDef* psCfg)
+{
+  memset(psPid, 0, sizeof(*psPid));
+  vScalePidGains(psPid, psCfg);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Calculate PID output for one iteration
+ *
+ * @param[in,out] *psPid  PID state
+ * @param[in] lSetpoint   Setpoint, Q15
+ * @param[in] lFeedback   Feedback, Q15
+ * @return  (int32_t)  Output, Q15 [0 .. CONTROL_OUT_MAX]
+ * @date  18.10.2026
+ ******************************************************************************/
+int32_t lStepPid(ControlPidTypeDef* psPid, int32_t lSetpoint, int32_t lFeedback)
+{
+  int32_t lError = lSetpoint - lFeedback;
+  int32_t lP = (int32_t)(((int64_t)psPid->lKp * lError) >> 16);
+  int32_t lD = (int32_t)(((int64_t)psPid->lKd * (psPid->lLastFeedback - lFeedback)) >> 16);
+  psPid->lLastFeedback = lFeedback;
+
+  /* Conditional integration: hold integral while the out-
+   * put is limited in the direction of the error         */
+  int32_t lOut = lP + (psPid->lIntegral >> 8) + lD;
+  if (!(((lOut >= CONTROL_OUT_MAX) && (lError > 0)) || ((lOut <= 0) && (lError < 0))))
+  {
+    int64_t llIntegral = psPid->lIntegral + (((int64_t)psPid->lKi * lError) >> 8);
+    if      (llIntegral < 0)               psPid->lIntegral = 0;
+    else if (llIntegral > CONTROL_INT_MAX) psPid->lIntegral = CONTROL_INT_MAX;
+    else                                   psPid->lIntegral = (int32_t)llIntegral;
+    lOut = lP + (psPid->lIntegral >> 8) + lD;
+  }
+
+  /* Output limits                                        */
+  psPid->bSaturated = true;
+  if      (lOut < 0)               return 0;
+  else if (lOut > CONTROL_OUT_MAX) return CONTROL_OUT_MAX;
+  psPid->bSaturated = false;
+  return lOut;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Apply configuration; gains take effect at the next iteration without
+ * resetting the integral term
+ *
+ * @param[in] *psCfg      Configuration
+ * @return  (bool)  true if valid and applied
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bSetControlCfg(const ControlCfgTypeDef* psCfg)
+{
+  if ((psCfg->uiRate == 0) || (psCfg->uiRate > CONTROL_MAX_RATE)) return false;
+  if ((CONTROL_MAX_RATE % psCfg->uiRate) != 0) return false;
+  if ((psCfg->lKp < 0) || (psCfg->lKp > CONTROL_GAIN_MAX)) return false;
+  if ((psCfg->lKi < 0) || (psCfg->lKi > CONTROL_GAIN_MAX)) return false;
+  if ((psCfg->lKd < 0) || (psCfg->lKd > CONTROL_KD_MAX)) return false;
+
+  ControlPidTypeDef sGains;
+  vScalePidGains(&sGains, psCfg);
+  int32_t lNewSetpoint = (int32_t)uiHW_ConvertAdcMvToValue(psCfg->uiSetpoint) << CONTROL_ADC_SHIFT;
+  bool bRateChanged = (psCfg->uiRate != sCfg.uiRate);
+
+  __disable_irq();
+  sCfg = *psCfg;
+  sPid.lKp = sGains.lKp;
+  sPid.lKi = sGains.lKi;
+  sPid.lKd = sGains.lKd;
+  lSetpoint = lNewSetpoint;
+  uDivider = CONTROL_MAX_RATE / psCfg->uiRate;
+  __enable_irq();
+
+  if (bRateChanged) vResetStats();
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get configuration
+ *
+ * @param[out] *psCfg     Configuration
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetControlCfg(ControlCfgTypeDef* psCfg)
+{
+  *psCfg = sCfg;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Start control loop from zero output, resetting the statistics
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vStartControl(void)
+{
+  if (bRunning) return;
+  vInitPid(&sPid, &sCfg);
+  bSetControlCfg(&sCfg);
+  vResetStats();
+  uDivCount = 0;
+
+  /* First sample is ready by the first iteration         */
+  vHW_ConfigAdcInjected(ADCFB_ADC_Channel);
+  vHW_StartAdcInjected();
+  bRunning = true;
+  ulLastTelemetry = SysTick_GetValueLow();
+  vHW_TIM3_SetUpdateHandler(vRunControlStep);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Stop control loop and switch output off
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vStopControl(void)
+{
+  if (!bRunning) return;
+  vHW_TIM3_SetUpdateHandler(NULL);
+  TIM_SetCompare1(TIM3, CONTROL_PWM_COUNTS);
+  bRunning = false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check if control loop is running
+ *
+ * @return  (bool)  true if running
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bIsControlRunning(void)
+{
+  return bRunning;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get consistent copy of loop statistics
+ *
+ * @param[out] *psStats   Statistics
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetControlStats(ControlStatsTypeDef* psStats)
+{
+  __disable_irq();
+  *psStats = sStats;
+  __enable_irq();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Send a telemetry record while the loop is running
+ *
+ * Record layout (little-endian): iteration count u32, feedback in mV u16,
+ * output as Q15 duty cycle u16.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPollControl(void)
+{
+  if (!bRunning) return;
+  uint32_t ulNow = SysTick_GetValueLow();
+  if (ulNow - ulLastTelemetry < ulHW_STK_MsToTicks(CONTROL_TELEMETRY_MS)) return;
+  ulLastTelemetry = ulNow;
+
+  ControlStatsTypeDef sInfo;
+  vGetControlStats(&sInfo);
+  uint16_t uiMv = uiHW_ConvertAdcValue_mV(sInfo.uiFeedback);
+  uint8_t aucRecord[8] = {
+    (uint8_t)sInfo.ulSteps, (uint8_t)(sInfo.ulSteps >> 8),
+    (uint8_t)(sInfo.ulSteps >> 16), (uint8_t)(sInfo.ulSteps >> 24),
+    (uint8_t)uiMv, (uint8_t)(uiMv >> 8),
+    (uint8_t)sInfo.uiOutput, (uint8_t)(sInfo.uiOutput >> 8)
+  };
+  uWriteMux(MUX_CH_TELEMETRY, aucRecord, sizeof(aucRecord));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print loop status and process configuration commands until an empty line
+ * is entered
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vControlShell(void)
+{
+  char acLine[CONTROL_LINE_LEN];
+  vPrintControlInfo();
+  printf("Commands: on, off, reset, sp <mV>, rate <Hz>, kp <gain>, ki <gain/s>, kd <gain*s>\r\n");
+  while (uReadShellLine("pid> ", acLine, sizeof(acLine)) > 0)
+  {
+    if (!bExecControlCmd(acLine))
+    {
+      printf("Invalid command or value.\r\n");
+      continue;
+    }
+    vPrintControlInfo();
+  }
+}
@@ -0,0 +1,91 @@
+/*!****************************************************************************
+ * @file
+ * control.h
+ *
+ * @brief
+ * Closed-loop PWM control with ADC feedback
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added telemetry output
+ ******************************************************************************/
+
+#ifndef CONTROL_H_
+#define CONTROL_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "hw_tim3.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Fixed-point gain representation (Q16.16)                           */
+#define CONTROL_GAIN_ONE              (1L << 16)
+
+/*! @brief Output full scale (Q15 duty cycle)                                 */
+#define CONTROL_OUT_MAX               INT16_MAX
+
+/*! @brief Loop rates are integer fractions of the PWM update frequency       */
+#define CONTROL_MAX_RATE              HW_TIM3_UPDATE_FREQ
+
+/*! @brief Default configuration
+ *  @{                                                                        */
+#define CONTROL_DEFAULT_RATE          500
+#define CONTROL_DEFAULT_SETPOINT_MV   1650
+#define CONTROL_DEFAULT_KP            (CONTROL_GAIN_ONE / 2)
+#define CONTROL_DEFAULT_KI            (50 * CONTROL_GAIN_ONE)
+#define CONTROL_DEFAULT_KD            0
+/*! @}                                                                        */
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Controller configuration                                           */
+typedef struct
+{
+  int32_t lKp;                        /*!< Proportional gain, Q16.16          */
+  int32_t lKi;                        /*!< Integral gain in 1/s, Q16.16       */
+  int32_t lKd;                        /*!< Derivative gain in s, Q16.16       */
+  uint16_t uiSetpoint;                /*!< Setpoint in mV                     */
+  uint16_t uiRate;                    /*!< Loop rate in Hz                    */
+} ControlCfgTypeDef;
+
+/*! @brief PID state; gains are scaled to one loop iteration                  */
+typedef struct
+{
+  int32_t lKp;                        /*!< Proportional gain, Q16.16          */
+  int32_t lKi;                        /*!< Integral gain per step, Q16.16     */
+  int32_t lKd;                        /*!< Derivative gain per step, Q16.16   */
+  int32_t lIntegral;                  /*!< Integral term, Q23                 */
+  int32_t lLastFeedback;              /*!< Previous feedback, Q15             */
+  bool bSaturated;                    /*!< Output limited in last step        */
+} ControlPidTypeDef;
+
+/*! @brief Loop statistics; times in SysTick counts                           */
+typedef struct
+{
+  uint32_t ulSteps;                   /*!< Loop iterations                    */
+  uint32_t ulMissed;                  /*!< Iterations without new sample      */
+  uint32_t ulSaturated;               /*!< Iterations with limited output     */
+  uint32_t ulPeriodMin;               /*!< Shortest iteration interval        */
+  uint32_t ulPeriodMax;               /*!< Longest iteration interval         */
+  uint32_t ulExecSum;                 /*!< Total execution time               */
+  uint32_t ulExecMax;                 /*!< Longest execution time             */
+  uint16_t uiFeedback;                /*!< Last feedback conversion value     */
+  uint16_t uiOutput;                  /*!< Last output, Q15 duty cycle        */
+} ControlStatsTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vInitPid(ControlPidTypeDef* psPid, const ControlCfgTypeDef* psCfg);
+int32_t lStepPid(ControlPidTypeDef* psPid, int32_t lSetpoint, int32_t lFeedback);
+
+bool bSetControlCfg(const ControlCfgTypeDef* psCfg);
+void vGetControlCfg(ControlCfgTypeDef* psCfg);
+void vStartControl(void);
+void vStopControl(void);
+bool bIsControlRunning(void);
+void vGetControlStats(ControlStatsTypeDef* psStats);
+void vPollControl(void);
+void vControlShell(void);
+
+#endif /* CONTROL_H_ */
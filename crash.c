@@ -0,0 +1,240 @@
+/*!****************************************************************************
+ * @file
+ * crash.c
+ *
+ * @brief
+ * Hard fault post-mortem capture and crash report
+ *
+ * The hard fault handler stores the register file into a crash record placed
+ * in no-init RAM, then calls vCaptureCrash() on a separate stack. The trap CSRs
+ * and a bounded snapshot of the faulting stack are added, the record is sealed
+ * with a checksum and the system is reset. On the next boot, the record is
+ * printed and (optionally) mirrored to the 24C64 EEPROM. vInitCrash() clears
+ * the record marker once the record has been found, so the report remains
+ * available until the next reset, but is not reported again after it.
+ *
+ * Reports can be symbolised on the host using tools/crash_decode.py.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  EEPROM copy written to EEPROM volume
+ * @date  18.10.2026  Record reported once only
+ * @date  18.10.2026  EEPROM copy written to reserved system area
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include <stddef.h>
+#include "ch32v10x.h"
+#include "eeprom.h"
+#include "eeprom_layout.h"
+#include "eevol.h"
+#include "crash.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Mirror new crash records to EEPROM (uncomment to activate)         */
+//#define USE_CRASH_EEPROM
+
+/*! @brief Crash record valid marker                                          */
+#define CRASH_MAGIC                   0xDEADC0DEUL
+
+/*! @brief RAM address range for stack snapshot validation
+ *  @{                                                                        */
+#define CRASH_RAM_START               0x20000000UL
+#define CRASH_RAM_END                 (CRASH_RAM_START + 20 * 1024)
+/*! @}                                                                        */
+
+/* Assembly in HardFault_Handler depends on the record layout                 */
+_Static_assert(offsetof(CrashRecordTypeDef, aulRegs) == CRASH_REGS_OFFSET,
+  "CRASH_REGS_OFFSET does not match crash record layout");
+
+/* EEPROM mirror must fit into its system area slot                           */
+_Static_assert(sizeof(CrashRecordTypeDef) <= EEPROM_CRASH_SIZE,
+  "Crash record exceeds EEPROM_CRASH_SIZE");
+
+
+/*- Exported variables -------------------------------------------------------*/
+/*! Crash record (not initialised by startup code)                            */
+__attribute__((section(".noinit"))) CrashRecordTypeDef sCrashRecord;
+
+/*! Stack for fault handler C code                                            */
+uint32_t aulCrashHandlerStack[CRASH_HANDLER_STACK_WORDS];
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Trap cause descriptions (exceptions only)                                 */
+static const char* const apszMcause[] = {
+  "Instruction address misaligned",
+  "Instruction access fault",
+  "Illegal instruction",
+  "Breakpoint",
+  "Load address misaligned",
+  "Load access fault",
+  "Store address misaligned",
+  "Store access fault",
+  "Environment call from U-mode",
+  "(reserved)",
+  "(reserved)",
+  "Environment call from M-mode"
+};
+
+/*! ABI register names for x1 .. x31                                          */
+static const char* const apszRegNames[31] = {
+  "ra", "sp", "gp", "tp", "t0", "t1", "t2", "s0", "s1", "a0", "a1", "a2", "a3",
+  "a4", "a5", "a6", "a7", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9", "s10",
+  "s11", "t3", "t4", "t5", "t6"
+};
+
+/*! Valid crash record found at boot (record marker is cleared afterwards)    */
+static bool bReportAvailable;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Calculate crash record checksum
+ *
+ * @return  (uint32_t)  Checksum over all fields preceding ulChecksum
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulCalcChecksum(void)
+{
+  const uint32_t* pulWord = (const uint32_t*)&sCrashRecord;
+  unsigned uNumWords = offsetof(CrashRecordTypeDef, ulChecksum) / sizeof(uint32_t);
+  uint32_t ulSum = 0;
+  while (uNumWords-- > 0) ulSum = ((ulSum << 1) | (ulSum >> 31)) ^ *pulWord++;
+  return ~ulSum;
+}
+
+#ifdef USE_CRASH_EEPROM
+/*!****************************************************************************
+ * @brief
+ * Copy crash record to EEPROM
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Write to EEPROM volume
+ * @date  18.10.2026  Write to EEPROM system area
+ ******************************************************************************/
+static void vMirrorToEeprom(void)
+{
+  bWriteEepromSysArea((const unsigned char*)&sCrashRecord, EEPROM_CRASH_ADDR, sizeof(sCrashRecord));
+  vSyncEepromVolume();
+}
+#endif /* USE_CRASH_EEPROM */
+
+
+/*!****************************************************************************
+ * @brief
+ * Complete crash record and reset system
+ *
+ * @note
+ * Called from HardFault_Handler after the register file has been stored and
+ * the stack pointer has been switched to aulCrashHandlerStack.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vCaptureCrash(void)
+{
+  sCrashRecord.ulMcause = __get_MCAUSE();
+  sCrashRecord.ulMepc = __get_MEPC();
+  sCrashRecord.ulMtval = __get_MTVAL();
+
+  /* Snapshot of faulting stack, bounded to RAM           */
+  uint32_t ulSp = sCrashRecord.aulRegs[1] & ~3UL;
+  unsigned uWords = 0;
+  if ((ulSp >= CRASH_RAM_START) && (ulSp < CRASH_RAM_END))
+  {
+    const uint32_t* pulStack = (const uint32_t*)ulSp;
+    uWords = (CRASH_RAM_END - ulSp) / sizeof(uint32_t);
+    if (uWords > CRASH_STACK_WORDS) uWords = CRASH_STACK_WORDS;
+    for (unsigned i = 0; i < uWords; ++i) sCrashRecord.aulStack[i] = pulStack[i];
+  }
+  sCrashRecord.ulStackWords = uWords;
+
+  /* Seal record and reset                                */
+  sCrashRecord.ulMagic = CRASH_MAGIC;
+  sCrashRecord.ulChecksum = ulCalcChecksum();
+  PFIC_SystemReset();
+  while (1);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check for crash record from previous run
+ *
+ * A valid record is latched for the report of this run, and its marker is
+ * cleared, so that it is neither reported nor mirrored again after the next
+ * reset. The record contents stay untouched until the next hard fault.
+ *
+ * @note
+ * Call after peripheral initialisation (EEPROM mirror uses I2C2).
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Clear record marker after latching the record
+ ******************************************************************************/
+void vInitCrash(void)
+{
+  bReportAvailable = (sCrashRecord.ulMagic == CRASH_MAGIC) &&
+                     (sCrashRecord.ulChecksum == ulCalcChecksum());
+  sCrashRecord.ulMagic = 0;
+
+#ifdef USE_CRASH_EEPROM
+  if (bReportAvailable) vMirrorToEeprom();
+#endif /* USE_CRASH_EEPROM */
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check if a crash report from a previous run is available
+ *
+ * @return  (bool)      true, if a valid crash record is present
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bIsCrashReportAvailable(void)
+{
+  return bReportAvailable;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print crash report
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPrintCrashReport(void)
+{
+  printf(
+    "-- Crash report ----------------------------------\r\n"
+  );
+  if (!bReportAvailable)
+  {
+    printf("No crash recorded.\r\n");
+    return;
+  }
+
+  /* Trap CSRs                                            */
+  uint32_t ulCause = sCrashRecord.ulMcause & 0x7FFFFFFFUL;
+  const char* pszCause = "(unknown)";
+  if (sCrashRecord.ulMcause & 0x80000000UL) pszCause = "Interrupt";
+  else if (ulCause < sizeof(apszMcause) / sizeof(apszMcause[0])) pszCause = apszMcause[ulCause];
+  printf("mcause: 0x%08lx (%s)\r\n", sCrashRecord.ulMcause, pszCause);
+  printf("mepc:   0x%08lx\r\n", sCrashRecord.ulMepc);
+  printf("mtval:  0x%08lx\r\n", sCrashRecord.ulMtval);
+
+  /* Register file                                        */
+  for (unsigned i = 0; i < 31; ++i)
+  {
+    printf("x%-2u %-3s 0x%08lx%s", i + 1, apszRegNames[i], sCrashRecord.aulRegs[i],
+      (i % 4 == 3) ? "\r\n" : "  ");
+  }
+  printf("\r\n");
+
+  /* Stack snapshot                                       */
+  printf("stack:\r\n");
+  for (unsigned i = 0; i < sCrashRecord.ulStackWords; ++i)
+  {
+    if (i % 4 == 0) printf("%08lx ", sCrashRecord.aulRegs[1] + 4 * i);
+    printf(" %08lx", sCrashRecord.aulStack[i]);
+    if ((i % 4 == 3) || (i + 1 == sCrashRecord.ulStackWords)) printf("\r\n");
+  }
+}
@@ -0,0 +1,57 @@
+/*!****************************************************************************
+ * @file
+ * crash.h
+ *
+ * @brief
+ * Hard fault post-mortem capture and crash report
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Removed EEPROM mirror flag from crash record
+ ******************************************************************************/
+
+#ifndef CRASH_H_
+#define CRASH_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Number of stack words captured from the faulting stack pointer     */
+#define CRASH_STACK_WORDS             32
+
+/*! @brief Size of the stack used by the fault handler in words               */
+#define CRASH_HANDLER_STACK_WORDS     64
+
+/*! @brief Byte offset of register x1 in the crash record (used by assembly)  */
+#define CRASH_REGS_OFFSET             16
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Crash record, kept in no-init RAM across reset                     */
+typedef struct
+{
+  uint32_t ulMagic;                   /*!< Record valid marker                */
+  uint32_t ulMcause;                  /*!< Trap cause                         */
+  uint32_t ulMepc;                    /*!< Faulting instruction address       */
+  uint32_t ulMtval;                   /*!< Trap value (address/instruction)   */
+  uint32_t aulRegs[31];               /*!< Register file x1 .. x31            */
+  uint32_t aulStack[CRASH_STACK_WORDS]; /*!< Stack snapshot from x2 (sp)      */
+  uint32_t ulStackWords;              /*!< Number of valid stack words        */
+  uint32_t ulChecksum;                /*!< Checksum over preceding fields     */
+} CrashRecordTypeDef;
+
+
+/*- Exported variables -------------------------------------------------------*/
+extern CrashRecordTypeDef sCrashRecord;
+extern uint32_t aulCrashHandlerStack[CRASH_HANDLER_STACK_WORDS];
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vCaptureCrash(void) __attribute__((noreturn));
+void vInitCrash(void);
+bool bIsCrashReportAvailable(void);
+void vPrintCrashReport(void);
+
+#endif /* CRASH_H_ */
@@ -7,13 +7,186 @@
  *
  * @date  11.02.2022
  * @date  23.02.2022  Added single-char write and blocking read
+ * @date  18.10.2026  Added RAMFUNC placement tags
+ * @date  18.10.2026  Changed reception to DMA circular buffer
+ * @date  18.10.2026  Added transmit flush
+ * @date  18.10.2026  Delegated to USART driver instance DBGSER_USART
+ * @date  18.10.2026  Added scatter-gather message queue
+ * @date  18.10.2026  RAMFUNC placement tags moved to message queue
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
 #include "ch32v10x.h"
+#include "hw_ramfunc.h"
+#include "hw_usart.h"
 #include "dbgser.h"
 
 
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Queued message                                                     */
+typedef struct
+{
+  DbgSerSegTypeDef asSegs[DBGSER_MAX_SEGMENTS]; /*!< Non-empty segments       */
+  unsigned uNumSegs;                  /*!< Number of segments                 */
+  DbgSerReleaseTypeDef pvRelease;     /*!< Release callback, or NULL          */
+  void* pvContext;                    /*!< Callback context                   */
+} DbgSerMsgTypeDef;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Message queue                                                             */
+static DbgSerMsgTypeDef asMsgQueue[DBGSER_MSG_QUEUE_LEN];
+
+/*! Message queue write count (free-running)                                  */
+static unsigned uMsgHead;
+
+/*! Message queue read count (free-running)                                   */
+static unsigned uMsgTail;
+
+/*! Next segment of the oldest message to be started                          */
+static unsigned uNextSeg;
+
+/*! Message queue statistics                                                  */
+static DbgSerStatsTypeDef sStats;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Wait until all queued messages have been handed to the transmitter
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vDrainDbgSer(void)
+{
+  while (uMsgHead != uMsgTail) vPollDbgSer();
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Queue a message of multiple segments for transmission
+ *
+ * The segments are sent back to back directly from their buffers, without
+ * being copied, and without other output in between. Messages are sent in
+ * the order they were queued. Once the transmitter has read the last segment,
+ * the release callback is called, after which the buffers may be reused.
+ *
+ * Transmission advances in vPollDbgSer(), for both the DMA and interrupt
+ * transmitter of the USART driver.
+ *
+ * @param[in] *psSegs     Segments; the array itself may be released on return
+ * @param[in] uNumSegs    Number of segments (at most DBGSER_MAX_SEGMENTS)
+ * @param[in] pvRelease   Release callback, or NULL
+ * @param[in] *pvContext  Callback context
+ * @return  (bool)      true, if queued; false if the queue is full or there
+ *                      are too many segments
+ * @date  18.10.2026
+ * @date  18.10.2026  Added RAMFUNC placement tag
+ ******************************************************************************/
+RAMFUNC bool bWriteVDbgSer(const DbgSerSegTypeDef* psSegs, unsigned uNumSegs, DbgSerReleaseTypeDef pvRelease, void* pvContext)
+{
+  if (uNumSegs > DBGSER_MAX_SEGMENTS) return false;
+  if (uMsgHead - uMsgTail == DBGSER_MSG_QUEUE_LEN) vPollDbgSer();
+  if (uMsgHead - uMsgTail == DBGSER_MSG_QUEUE_LEN)
+  {
+    ++sStats.ulQueueFull;
+    return false;
+  }
+
+  /* Empty segments are dropped, so every started block
+   * keeps the transmitter busy                           */
+  DbgSerMsgTypeDef* psMsg = &asMsgQueue[uMsgHead & (DBGSER_MSG_QUEUE_LEN - 1)];
+  psMsg->uNumSegs = 0;
+  for (unsigned i = 0; i < uNumSegs; ++i)
+  {
+    if (psSegs[i].uLen == 0) continue;
+    psMsg->asSegs[psMsg->uNumSegs++] = psSegs[i];
+    sStats.ulBytes += psSegs[i].uLen;
+  }
+  psMsg->pvRelease = pvRelease;
+  psMsg->pvContext = pvContext;
+  ++uMsgHead;
+
+  ++sStats.ulMessages;
+  sStats.ulSegments += psMsg->uNumSegs;
+  if (uMsgHead - uMsgTail > sStats.uPeak) sStats.uPeak = uMsgHead - uMsgTail;
+  vPollDbgSer();
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Blocking write of a message of multiple segments
+ *
+ * Like bWriteVDbgSer(), but waits for a free queue slot, and returns once the
+ * transmitter has read all segments.
+ *
+ * @param[in] *psSegs     Segments
+ * @param[in] uNumSegs    Number of segments (at most DBGSER_MAX_SEGMENTS)
+ * @date  18.10.2026
+ ******************************************************************************/
+void vWriteVDbgSer(const DbgSerSegTypeDef* psSegs, unsigned uNumSegs)
+{
+  while (uMsgHead - uMsgTail == DBGSER_MSG_QUEUE_LEN) vPollDbgSer();
+  if (bWriteVDbgSer(psSegs, uNumSegs, NULL, NULL)) vDrainDbgSer();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Start the next queued segment if the transmitter is idle, and release
+ * messages which have been sent
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added RAMFUNC placement tag
+ ******************************************************************************/
+RAMFUNC void vPollDbgSer(void)
+{
+  while ((uMsgHead != uMsgTail) && !bHW_USART_IsTxBusy(DBGSER_USART))
+  {
+    DbgSerMsgTypeDef* psMsg = &asMsgQueue[uMsgTail & (DBGSER_MSG_QUEUE_LEN - 1)];
+    if (uNextSeg < psMsg->uNumSegs)
+    {
+      const DbgSerSegTypeDef* psSeg = &psMsg->asSegs[uNextSeg++];
+      vHW_USART_StartTx(DBGSER_USART, psSeg->pvData, psSeg->uLen);
+      continue;
+    }
+
+    /* Slot is free before the callback, which may queue
+     * the next message                                   */
+    DbgSerReleaseTypeDef pvRelease = psMsg->pvRelease;
+    void* pvContext = psMsg->pvContext;
+    uNextSeg = 0;
+    ++uMsgTail;
+    if (pvRelease != NULL) pvRelease(pvContext);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check if queued messages or a block transmission are pending
+ *
+ * @return  (bool)      true, if busy
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bIsDbgSerTxBusy(void)
+{
+  return (uMsgHead != uMsgTail) || bHW_USART_IsTxBusy(DBGSER_USART);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get message queue statistics
+ *
+ * @param[out] *psStats   Statistics
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetDbgSerStats(DbgSerStatsTypeDef* psStats)
+{
+  *psStats = sStats;
+}
+
 /*!****************************************************************************
  * @brief
  * Write data to serial debug output
@@ -22,10 +195,14 @@
  * @param[in] uLen        Data length in bytes
  * @date  12.02.2022
  * @date  23.02.2022  Modified to use local function for single-char output
+ * @date  18.10.2026  Added RAMFUNC placement tag
+ * @date  18.10.2026  Sent as single-segment message, without per-byte wait
+ * @date  18.10.2026  Removed RAMFUNC placement tag (moved to message queue)
  ******************************************************************************/
 void vWriteDbgSer(const unsigned char* pucData, unsigned uLen)
 {
-  for (unsigned i = 0; i < uLen; ++i) vPutCharDbgSer(pucData[i]);
+  const DbgSerSegTypeDef sSeg = { pucData, uLen };
+  vWriteVDbgSer(&sSeg, 1);
 }
 
 /*!****************************************************************************
@@ -47,11 +224,29 @@ void vPrintDbgSer(const char* pszStr)
  *
  * @param[in] cData       Output character
  * @date  23.02.2022
+ * @date  18.10.2026  Added RAMFUNC placement tag
+ * @date  18.10.2026  Delegated to USART driver
+ * @date  18.10.2026  Sent after queued messages
+ * @date  18.10.2026  Removed RAMFUNC placement tag
  ******************************************************************************/
 void vPutCharDbgSer(char cData)
 {
-  while (USART_GetFlagStatus(USART1, USART_FLAG_TC) != SET);
-  USART_SendData(USART1, cData);
+  vDrainDbgSer();
+  vHW_USART_PutChar(DBGSER_USART, cData);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Wait until all data has been transmitted
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Delegated to USART driver
+ * @date  18.10.2026  Includes queued messages
+ ******************************************************************************/
+void vFlushDbgSer(void)
+{
+  vDrainDbgSer();
+  vHW_USART_Flush(DBGSER_USART);
 }
 
 /*!****************************************************************************
@@ -60,10 +255,45 @@ void vPutCharDbgSer(char cData)
  *
  * @return  (bool)      true, if data is present
  * @date  23.02.2022
+ * @date  18.10.2026  Changed to check DMA buffer fill level
+ * @date  18.10.2026  Delegated to USART driver
  ******************************************************************************/
 bool bIsDbgSerAvailable(void)
 {
-  return USART_GetFlagStatus(USART1, USART_FLAG_RXNE) == SET;
+  return uHW_USART_GetRxCount(DBGSER_USART) != 0;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get next character from RX buffer without removing it
+ *
+ * @param[out] *pcData    Next character
+ * @return  (bool)      true, if data is present
+ * @date  18.10.2026
+ * @date  18.10.2026  Delegated to USART driver
+ ******************************************************************************/
+bool bPeekDbgSer(char* pcData)
+{
+  return bHW_USART_Peek(DBGSER_USART, (uint8_t*)pcData);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Non-blocking read from serial debug input
+ *
+ * @note
+ * The RX buffer is overwritten by DMA once more than HW_USART1_RX_BUF_SIZE
+ * bytes are pending. Callers are expected to poll at least that often.
+ *
+ * @param[out] *pucData   Data buffer
+ * @param[in] uMaxLen     Buffer size in bytes
+ * @return  (unsigned)  Number of bytes read
+ * @date  18.10.2026
+ * @date  18.10.2026  Delegated to USART driver
+ ******************************************************************************/
+unsigned uReadDbgSer(unsigned char* pucData, unsigned uMaxLen)
+{
+  return uHW_USART_Read(DBGSER_USART, pucData, uMaxLen);
 }
 
 /*!****************************************************************************
@@ -72,9 +302,12 @@ bool bIsDbgSerAvailable(void)
  *
  * @return  (char)      Received character (ASCII)
  * @date  23.02.2022
+ * @date  18.10.2026  Changed to read from DMA buffer
+ * @date  18.10.2026  Delegated to USART driver
  ******************************************************************************/
 char cGetCharDbgSer(void)
 {
-  while (!bIsDbgSerAvailable());
-  return USART_ReceiveData(USART1);
+  uint8_t ucData;
+  while (uHW_USART_Read(DBGSER_USART, &ucData, 1) == 0);
+  return (char)ucData;
 }
@@ -8,6 +8,11 @@
  * @date  11.02.2022
  * @date  23.02.2022  Added single-char write and blocking read
  * @date  03.03.2022  Added escape sequence macros
+ * @date  18.10.2026  Added peek and non-blocking bulk read
+ * @date  18.10.2026  Added transmit flush
+ * @date  18.10.2026  Port selected by DBGSER_USART
+ * @date  18.10.2026  Added scatter-gather message queue
+ * @date  18.10.2026  DBGSER_USART may be set by the build
  ******************************************************************************/
 
 #ifndef DBGSER_H_
@@ -15,9 +20,22 @@
 
 /*- Header files -------------------------------------------------------------*/
 #include <stdbool.h>
+#include <stdint.h>
+#include "hw_usart.h"
 
 
 /*- Macros -------------------------------------------------------------------*/
+/*! USART instance connected to the debugger serial port                      */
+#ifndef DBGSER_USART
+#define DBGSER_USART                  HW_USART1
+#endif
+
+/*! Number of queued scatter-gather messages (power of 2)                     */
+#define DBGSER_MSG_QUEUE_LEN          4
+
+/*! Maximum number of segments per message                                    */
+#define DBGSER_MAX_SEGMENTS           4
+
 /*! Escape code to clear terminal output                                      */
 #define VT100_CLEAR_TERM              "\x1b[2J"
 
@@ -28,11 +46,42 @@
 #define VT100_COLOR_RESET             "\x1b[m"
 
 
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Message segment                                                    */
+typedef struct
+{
+  const void* pvData;                 /*!< Segment data                       */
+  unsigned uLen;                      /*!< Segment length in bytes            */
+} DbgSerSegTypeDef;
+
+/*! @brief Message release callback, called from the context of
+ *  vPollDbgSer() once the transmitter has read all segments                  */
+typedef void (*DbgSerReleaseTypeDef)(void* pvContext);
+
+/*! @brief Message queue statistics                                           */
+typedef struct
+{
+  uint32_t ulMessages;                /*!< Messages queued                    */
+  uint32_t ulSegments;                /*!< Non-empty segments queued          */
+  uint32_t ulBytes;                   /*!< Bytes queued                       */
+  uint32_t ulQueueFull;               /*!< Messages rejected, queue full      */
+  unsigned uPeak;                     /*!< Maximum number of queued messages  */
+} DbgSerStatsTypeDef;
+
+
 /*- Exported functions -------------------------------------------------------*/
+bool bWriteVDbgSer(const DbgSerSegTypeDef* psSegs, unsigned uNumSegs, DbgSerReleaseTypeDef pvRelease, void* pvContext);
+void vWriteVDbgSer(const DbgSerSegTypeDef* psSegs, unsigned uNumSegs);
+void vPollDbgSer(void);
+bool bIsDbgSerTxBusy(void);
+void vGetDbgSerStats(DbgSerStatsTypeDef* psStats);
 void vWriteDbgSer(const unsigned char* pucData, unsigned uLen);
 void vPrintDbgSer(const char* pszStr);
 void vPutCharDbgSer(char cData);
+void vFlushDbgSer(void);
 bool bIsDbgSerAvailable(void);
 char cGetCharDbgSer(void);
+bool bPeekDbgSer(char* pcData);
+unsigned uReadDbgSer(unsigned char* pucData, unsigned uMaxLen);
 
 #endif /* DBGSER_H_ */
@@ -6,49 +6,146 @@
  * AT24C64 EEPROM access via I2C2
  *
  * @date  03.03.2022
+ * @date  18.10.2026  Added RAMFUNC placement tags
+ * @date  18.10.2026  Added write cycle delay
+ * @date  18.10.2026  Write cycle delay follows HCLK changes
+ * @date  18.10.2026  Added device selection and probing
+ * @date  18.10.2026  Fixed high address byte; added current-address reads
+ * @date  18.10.2026  Added check for USART3 pin conflict
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
 #include "ch32v10x.h"
+#include "hw_ramfunc.h"
+#include "hw_stk.h"
+#include "hw_usart.h"
 #include "eeprom.h"
 
+#if defined(USE_EEPROM_DEMO) && defined(USE_USART3)
+#error "USART3 uses the I2C2 pins of the EEPROM"
+#endif
+
 
 /*- Macros -------------------------------------------------------------------*/
-/*! @brief AT24C64 I2C Device Address                                         */
+/*! @brief AT24C64 I2C base device address (A0..A2 low)                      */
 #define EEPROM_ADDR                   0xA0
 
+/*! @brief I2C device address for a device index (A0..A2 pin setting)         */
+#define EEPROM_DEV_ADDR(dev)          (EEPROM_ADDR | ((dev) << 1))
+
+/*! @brief Internal write cycle time (tWR) in ms                              */
+#define EEPROM_TWR_MS                 5
+
+/*! @brief Bus bytes of the dummy write setting the start address (device
+ *  address and two address bytes)                                           */
+#define EEPROM_ADDR_PHASE_BYTES       3
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Internal address counter per device, valid if flagged in ucNextValid.
+ *  After a read, the device continues at the following address.             */
+static uint16_t auiNextAddr[EEPROM_MAX_DEVICES];
+
+/*! Devices with known internal address counter (bit per device)              */
+static uint8_t ucNextValid;
+
+/*! Bus usage statistics                                                      */
+static EepromStatsTypeDef sStats;
+
 
 /*!****************************************************************************
  * @brief
- * Blocking read of data from EEPROM
+ * Blocking read of data from EEPROM device 0
  *
  * @param[out] *aucBuffer Buffer for received data
  * @param[in] uAddress    Start address for read operation
  * @param[in] uLength     Number of bytes to be read
  * @date  03.03.2022
+ * @date  18.10.2026  Added RAMFUNC placement tag
+ * @date  18.10.2026  Moved into vReadEepromDev()
  ******************************************************************************/
 void vReadEeprom(unsigned char* aucBuffer, unsigned uAddress, unsigned uLength)
 {
-  /* Dummy write to set start address                     */
+  vReadEepromDev(0, aucBuffer, uAddress, uLength);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Blocking write of data to EEPROM device 0
+ *
+ * @note
+ * Maximum block length is EEPROM page size. Data block shall not cross page
+ * border.
+ *
+ * @param[in] *aucBuffer  Buffer containing write data
+ * @param[in] uAddress    Start address for write operation
+ * @param[in] uLength     Number of bytes to be written
+ * @date  03.03.2022
+ * @date  18.10.2026  Added RAMFUNC placement tag
+ * @date  18.10.2026  Moved into vWriteEepromDev()
+ ******************************************************************************/
+void vWriteEeprom(const unsigned char* aucBuffer, unsigned uAddress, unsigned uLength)
+{
+  vWriteEepromDev(0, aucBuffer, uAddress, uLength);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Blocking read of data from EEPROM
+ *
+ * If the read continues where the previous read from the same device ended,
+ * the dummy write is skipped and the device's current-address read is used.
+ *
+ * @param[in] uDevice     Device index (A0..A2 pin setting)
+ * @param[out] *aucBuffer Buffer for received data
+ * @param[in] uAddress    Start address for read operation
+ * @param[in] uLength     Number of bytes to be read
+ * @date  18.10.2026
+ * @date  18.10.2026  Fixed high address byte; added current-address read
+ ******************************************************************************/
+RAMFUNC void vReadEepromDev(unsigned uDevice, unsigned char* aucBuffer, unsigned uAddress, unsigned uLength)
+{
+  uint8_t ucMask = 1 << uDevice;
+  uAddress %= EEPROM_SIZE;
+  bool bContinue = (ucNextValid & ucMask) && (auiNextAddr[uDevice] == uAddress);
+  auiNextAddr[uDevice] = (uAddress + uLength) % EEPROM_SIZE;
+  ucNextValid |= ucMask;
+
+  ++sStats.ulReads;
+  sStats.ulBusBytes += 1 + uLength;
+  if (bContinue)
+  {
+    ++sStats.ulContReads;
+    sStats.ulSavedBytes += EEPROM_ADDR_PHASE_BYTES;
+  }
+  else
+  {
+    sStats.ulBusBytes += EEPROM_ADDR_PHASE_BYTES;
+  }
+
   while (I2C_GetFlagStatus(I2C2, I2C_FLAG_BUSY) != RESET);
   I2C_AcknowledgeConfig(I2C2, ENABLE);
-  I2C_GenerateSTART(I2C2, ENABLE);
+  if (!bContinue)
+  {
+    /* Dummy write to set start address                   */
+    I2C_GenerateSTART(I2C2, ENABLE);
 
-  while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_MODE_SELECT));
-  I2C_Send7bitAddress(I2C2, EEPROM_ADDR, I2C_Direction_Transmitter);
+    while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_MODE_SELECT));
+    I2C_Send7bitAddress(I2C2, EEPROM_DEV_ADDR(uDevice), I2C_Direction_Transmitter);
 
-  while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED));
+    while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED));
 
-  I2C_SendData(I2C2, uAddress >> 16);
-  while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
-  I2C_SendData(I2C2, uAddress);
-  while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
+    I2C_SendData(I2C2, uAddress >> 8);
+    while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
+    I2C_SendData(I2C2, uAddress);
+    while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
+  }
 
   /* Read consecutive bytes                               */
   I2C_GenerateSTART(I2C2, ENABLE);
 
   while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_MODE_SELECT));
-  I2C_Send7bitAddress(I2C2, EEPROM_ADDR, I2C_Direction_Receiver);
+  I2C_Send7bitAddress(I2C2, EEPROM_DEV_ADDR(uDevice), I2C_Direction_Receiver);
 
   while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED));
   while (uLength-- > 1)
@@ -73,23 +170,29 @@ void vReadEeprom(unsigned char* aucBuffer, unsigned uAddress, unsigned uLength)
  * Maximum block length is EEPROM page size. Data block shall not cross page
  * border.
  *
+ * @param[in] uDevice     Device index (A0..A2 pin setting)
  * @param[in] *aucBuffer  Buffer containing write data
  * @param[in] uAddress    Start address for write operation
  * @param[in] uLength     Number of bytes to be written
- * @date  03.03.2022
+ * @date  18.10.2026
+ * @date  18.10.2026  Fixed high address byte
  ******************************************************************************/
-void vWriteEeprom(const unsigned char* aucBuffer, unsigned uAddress, unsigned uLength)
+RAMFUNC void vWriteEepromDev(unsigned uDevice, const unsigned char* aucBuffer, unsigned uAddress, unsigned uLength)
 {
+  /* Address counter rolls over within the page           */
+  ucNextValid &= ~(1 << uDevice);
+  sStats.ulBusBytes += EEPROM_ADDR_PHASE_BYTES + uLength;
+
   /* Set start address                                    */
   while (I2C_GetFlagStatus(I2C2, I2C_FLAG_BUSY) != RESET);
   I2C_GenerateSTART(I2C2, ENABLE);
 
   while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_MODE_SELECT));
-  I2C_Send7bitAddress(I2C2, EEPROM_ADDR, I2C_Direction_Transmitter);
+  I2C_Send7bitAddress(I2C2, EEPROM_DEV_ADDR(uDevice), I2C_Direction_Transmitter);
 
   while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED));
 
-  I2C_SendData(I2C2, uAddress >> 16);
+  I2C_SendData(I2C2, uAddress >> 8);
   while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
   I2C_SendData(I2C2, uAddress);
   while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_BYTE_TRANSMITTED));
@@ -104,3 +207,68 @@ void vWriteEeprom(const unsigned char* aucBuffer, unsigned uAddress, unsigned uL
   /* End of transfer                                      */
   I2C_GenerateSTOP(I2C2, ENABLE);
 }
+
+/*!****************************************************************************
+ * @brief
+ * Check whether a device acknowledges its address
+ *
+ * @note
+ * A device also does not acknowledge during its internal write cycle.
+ *
+ * @param[in] uDevice     Device index (A0..A2 pin setting)
+ * @return  (bool)  true if the device acknowledged
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bProbeEeprom(unsigned uDevice)
+{
+  while (I2C_GetFlagStatus(I2C2, I2C_FLAG_BUSY) != RESET);
+  I2C_GenerateSTART(I2C2, ENABLE);
+
+  while (!I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_MODE_SELECT));
+  I2C_Send7bitAddress(I2C2, EEPROM_DEV_ADDR(uDevice), I2C_Direction_Transmitter);
+
+  /* Wait for address acknowledge or failure              */
+  bool bAck;
+  while (1)
+  {
+    if (I2C_CheckEvent(I2C2, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED))
+    {
+      bAck = true;
+      break;
+    }
+    if (I2C_GetFlagStatus(I2C2, I2C_FLAG_AF) == SET)
+    {
+      bAck = false;
+      break;
+    }
+  }
+
+  I2C_GenerateSTOP(I2C2, ENABLE);
+  I2C_ClearFlag(I2C2, I2C_FLAG_AF);
+  return bAck;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get bus usage statistics
+ *
+ * @param[out] *psStats   Statistics
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetEepromStats(EepromStatsTypeDef* psStats)
+{
+  *psStats = sStats;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Wait for completion of the internal write cycle after vWriteEeprom()
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vWaitEepromWriteCycle(void)
+{
+  uint32_t ulTicks = ulHW_STK_MsToTicks(EEPROM_TWR_MS);
+  uint32_t ulStart = SysTick_GetValueLow();
+  while (SysTick_GetValueLow() - ulStart < ulTicks);
+}
@@ -6,18 +6,51 @@
  * AT24C64 EEPROM access via I2C2
  *
  * @date  03.03.2022
+ * @date  18.10.2026  Moved EEPROM demo switch from main.c
+ * @date  18.10.2026  Added device selection and probing
+ * @date  18.10.2026  Added bus statistics
  ******************************************************************************/
 
 #ifndef EEPROM_H_
 #define EEPROM_H_
 
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
 /*- Macros -------------------------------------------------------------------*/
+/*! @brief Enable 24C64 EEPROM demo                                           */
+//#define USE_EEPROM_DEMO
+
 /*! Page size in Bytes                                                        */
 #define EEPROM_PAGE_SIZE              32
 
+/*! Device size in Bytes                                                      */
+#define EEPROM_SIZE                   8192
+
+/*! Maximum number of devices on the bus (address pins A0..A2)                */
+#define EEPROM_MAX_DEVICES            8
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Bus usage statistics                                               */
+typedef struct
+{
+  uint32_t ulBusBytes;                /*!< Address and data bytes transferred */
+  uint32_t ulSavedBytes;              /*!< Bytes saved by current-address reads */
+  uint32_t ulReads;                   /*!< Read transfers                     */
+  uint32_t ulContReads;               /*!< Thereof current-address reads      */
+} EepromStatsTypeDef;
+
 
 /*- Exported functions -------------------------------------------------------*/
 void vReadEeprom(unsigned char* aucBuffer, unsigned uAddress, unsigned uLength);
 void vWriteEeprom(const unsigned char* aucBuffer, unsigned uAddress, unsigned uLength);
+void vReadEepromDev(unsigned uDevice, unsigned char* aucBuffer, unsigned uAddress, unsigned uLength);
+void vWriteEepromDev(unsigned uDevice, const unsigned char* aucBuffer, unsigned uAddress, unsigned uLength);
+bool bProbeEeprom(unsigned uDevice);
+void vGetEepromStats(EepromStatsTypeDef* psStats);
+void vWaitEepromWriteCycle(void);
 
 #endif /* EEPROM_H_ */
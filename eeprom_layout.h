@@ -0,0 +1,48 @@
+/*!****************************************************************************
+ * @file
+ * eeprom_layout.h
+ *
+ * @brief
+ * Partitioning of the 24C64 EEPROMs
+ *
+ * Device addresses, identical on each device of the EEPROM volume:
+ *
+ *   0x0000 .. 0x1BFF   Volume area (7 KB), EEPROM demo and RPC access
+ *   0x1C00 .. 0x1FFF   System area (1 KB)
+ *
+ * Both areas are striped across the devices present (see eevol.c), so the
+ * volume has 7 KB and the system area 1 KB per device. System area contents
+ * (system area addresses):
+ *
+ *   0x0000 .. 0x013F   Crash record mirror (320 bytes)
+ *   last 8 stripes     Benchmark scratch, device addresses 0x1F00 .. 0x1FFF
+ *
+ * The benchmark scratch includes the last page of device 0, which is used by
+ * the single-device EEPROM benchmarks.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef EEPROM_LAYOUT_H_
+#define EEPROM_LAYOUT_H_
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Volume area on each device (device addresses)                      */
+#define EEPROM_VOLUME_DEV_ADDR        0x0000
+#define EEPROM_VOLUME_DEV_SIZE        0x1C00
+
+/*! @brief System area on each device (device addresses)                      */
+#define EEPROM_SYS_DEV_ADDR           0x1C00
+#define EEPROM_SYS_DEV_SIZE           0x0400
+
+/*! @brief Crash record mirror (system area address)                          */
+#define EEPROM_CRASH_ADDR             0x0000
+#define EEPROM_CRASH_SIZE             0x0140
+
+/*! @brief Number of benchmark scratch stripes at the end of the system area  */
+#define EEPROM_BENCH_STRIPES          8
+
+/*! @brief Benchmark scratch page on device 0 (device address)                */
+#define EEPROM_BENCH_DEV_ADDR         0x1FE0
+
+#endif /* EEPROM_LAYOUT_H_ */
@@ -0,0 +1,376 @@
+/*!****************************************************************************
+ * @file
+ * eevol.c
+ *
+ * @brief
+ * Linear storage volume striped across multiple 24Cxx EEPROMs
+ *
+ * Up to EEPROM_MAX_DEVICES devices with different A0..A2 settings share the
+ * I2C2 bus. The devices present are detected by address probing, and their
+ * pages are interleaved into one linear address space: volume page n is
+ * stored on device n % N at device page n / N.
+ *
+ * Only the volume area of each device is part of the volume. The system area
+ * behind it, holding the crash record mirror and benchmark scratch space (see
+ * eeprom_layout.h), is striped the same way, but accessed through its own
+ * functions, so volume users cannot overwrite it.
+ *
+ * A page write is followed by an internal write cycle of up to 5 ms, during
+ * which the device does not respond. The volume tracks the write cycle per
+ * device and only waits before accessing a device which is still busy, so
+ * that sequential writes keep all devices programming in parallel.
+ *
+ * Sequential reads are served by a stream reader, which fetches ahead in
+ * blocks of up to EEVOL_STREAM_BUF_SIZE bytes. Since a device's next stripe in
+ * a sequential read immediately follows its previous one, every fetch after
+ * the first one per device uses the current-address read (see
+ * vReadEepromDev()).
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added streaming reader
+ * @date  18.10.2026  Volume limited to volume area; added system area access
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "ch32v10x.h"
+#include "hw_stk.h"
+#include "eeprom.h"
+#include "eeprom_layout.h"
+#include "eevol.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Internal write cycle time (tWR) in ms                              */
+#define EEVOL_TWR_MS                  5
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Device indices of the volume members, in stripe order                     */
+static uint8_t aucDevices[EEPROM_MAX_DEVICES];
+
+/*! Number of volume members                                                  */
+static unsigned uNumDevices;
+
+/*! Devices have been probed                                                  */
+static bool bProbed;
+
+/*! SysTick timestamp of last page write per volume member                    */
+static uint32_t aulWriteTicks[EEPROM_MAX_DEVICES];
+
+/*! Write cycle pending per volume member                                     */
+static bool abWriteBusy[EEPROM_MAX_DEVICES];
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Wait for completion of a pending write cycle of a volume member
+ *
+ * @param[in] uMember     Volume member index
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vWaitMember(unsigned uMember)
+{
+  if (!abWriteBusy[uMember]) return;
+  uint32_t ulTicks = ulHW_STK_MsToTicks(EEVOL_TWR_MS);
+  while (SysTick_GetValueLow() - aulWriteTicks[uMember] < ulTicks);
+  abWriteBusy[uMember] = false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check access range, probe devices on first use
+ *
+ * @param[in] uAddress    Start address within the area
+ * @param[in] uLength     Access length in bytes
+ * @param[in] uDevSize    Size of the area on each device
+ * @return  (bool)  true if within the area
+ * @date  18.10.2026
+ * @date  18.10.2026  Area size as parameter
+ ******************************************************************************/
+static bool bCheckRange(unsigned uAddress, unsigned uLength, unsigned uDevSize)
+{
+  if (!bProbed) vInitEepromVolume();
+  unsigned uSize = uNumDevices * uDevSize;
+  return (uAddress <= uSize) && (uLength <= uSize - uAddress);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Blocking read from a striped area
+ *
+ * @param[in] uDevBase    Device address of the area
+ * @param[out] *pucBuffer Buffer for received data
+ * @param[in] uAddress    Start address within the area
+ * @param[in] uLength     Number of bytes to be read
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vReadStripes(unsigned uDevBase, unsigned char* pucBuffer, unsigned uAddress, unsigned uLength)
+{
+  while (uLength > 0)
+  {
+    unsigned uStripe = uAddress / EEVOL_STRIPE_SIZE;
+    unsigned uOffset = uAddress % EEVOL_STRIPE_SIZE;
+    unsigned uChunk = EEVOL_STRIPE_SIZE - uOffset;
+    if (uChunk > uLength) uChunk = uLength;
+
+    unsigned uMember = uStripe % uNumDevices;
+    vWaitMember(uMember);
+    vReadEepromDev(aucDevices[uMember], pucBuffer,
+      uDevBase + (uStripe / uNumDevices) * EEVOL_STRIPE_SIZE + uOffset, uChunk);
+
+    pucBuffer += uChunk;
+    uAddress += uChunk;
+    uLength -= uChunk;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write to a striped area
+ *
+ * @param[in] uDevBase    Device address of the area
+ * @param[in] *pucBuffer  Buffer containing write data
+ * @param[in] uAddress    Start address within the area
+ * @param[in] uLength     Number of bytes to be written
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vWriteStripes(unsigned uDevBase, const unsigned char* pucBuffer, unsigned uAddress, unsigned uLength)
+{
+  while (uLength > 0)
+  {
+    unsigned uStripe = uAddress / EEVOL_STRIPE_SIZE;
+    unsigned uOffset = uAddress % EEVOL_STRIPE_SIZE;
+    unsigned uChunk = EEVOL_STRIPE_SIZE - uOffset;
+    if (uChunk > uLength) uChunk = uLength;
+
+    unsigned uMember = uStripe % uNumDevices;
+    vWaitMember(uMember);
+    vWriteEepromDev(aucDevices[uMember], pucBuffer,
+      uDevBase + (uStripe / uNumDevices) * EEVOL_STRIPE_SIZE + uOffset, uChunk);
+    aulWriteTicks[uMember] = SysTick_GetValueLow();
+    abWriteBusy[uMember] = true;
+
+    pucBuffer += uChunk;
+    uAddress += uChunk;
+    uLength -= uChunk;
+  }
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Detect devices present on the bus
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vInitEepromVolume(void)
+{
+  uNumDevices = 0;
+  for (unsigned i = 0; i < EEPROM_MAX_DEVICES; ++i)
+  {
+    if (!bProbeEeprom(i)) continue;
+    abWriteBusy[uNumDevices] = false;
+    aucDevices[uNumDevices++] = (uint8_t)i;
+  }
+  bProbed = true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get number of devices in volume
+ *
+ * @return  (unsigned)  Number of devices
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uGetEepromVolumeDevices(void)
+{
+  return uNumDevices;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get volume size
+ *
+ * @return  (unsigned)  Size in bytes, excluding the system area
+ * @date  18.10.2026
+ * @date  18.10.2026  Volume area only
+ ******************************************************************************/
+unsigned uGetEepromVolumeSize(void)
+{
+  return uNumDevices * EEPROM_VOLUME_DEV_SIZE;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get system area size
+ *
+ * @return  (unsigned)  Size in bytes
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uGetEepromSysAreaSize(void)
+{
+  return uNumDevices * EEPROM_SYS_DEV_SIZE;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Blocking read from volume
+ *
+ * @param[out] *pucBuffer Buffer for received data
+ * @param[in] uAddress    Volume start address
+ * @param[in] uLength     Number of bytes to be read
+ * @return  (bool)  true on success, false if out of range
+ * @date  18.10.2026
+ * @date  18.10.2026  Moved into vReadStripes()
+ ******************************************************************************/
+bool bReadEepromVolume(unsigned char* pucBuffer, unsigned uAddress, unsigned uLength)
+{
+  if (!bCheckRange(uAddress, uLength, EEPROM_VOLUME_DEV_SIZE)) return false;
+  vReadStripes(EEPROM_VOLUME_DEV_ADDR, pucBuffer, uAddress, uLength);
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write to volume
+ *
+ * Returns once the data has been transferred; the write cycles of the last
+ * written pages may still be pending, see vSyncEepromVolume().
+ *
+ * @param[in] *pucBuffer  Buffer containing write data
+ * @param[in] uAddress    Volume start address
+ * @param[in] uLength     Number of bytes to be written
+ * @return  (bool)  true on success, false if out of range
+ * @date  18.10.2026
+ * @date  18.10.2026  Moved into vWriteStripes()
+ ******************************************************************************/
+bool bWriteEepromVolume(const unsigned char* pucBuffer, unsigned uAddress, unsigned uLength)
+{
+  if (!bCheckRange(uAddress, uLength, EEPROM_VOLUME_DEV_SIZE)) return false;
+  vWriteStripes(EEPROM_VOLUME_DEV_ADDR, pucBuffer, uAddress, uLength);
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Blocking read from system area
+ *
+ * @param[out] *pucBuffer Buffer for received data
+ * @param[in] uAddress    System area start address (see eeprom_layout.h)
+ * @param[in] uLength     Number of bytes to be read
+ * @return  (bool)  true on success, false if out of range
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bReadEepromSysArea(unsigned char* pucBuffer, unsigned uAddress, unsigned uLength)
+{
+  if (!bCheckRange(uAddress, uLength, EEPROM_SYS_DEV_SIZE)) return false;
+  vReadStripes(EEPROM_SYS_DEV_ADDR, pucBuffer, uAddress, uLength);
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write to system area
+ *
+ * Returns once the data has been transferred, like bWriteEepromVolume().
+ *
+ * @param[in] *pucBuffer  Buffer containing write data
+ * @param[in] uAddress    System area start address (see eeprom_layout.h)
+ * @param[in] uLength     Number of bytes to be written
+ * @return  (bool)  true on success, false if out of range
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bWriteEepromSysArea(const unsigned char* pucBuffer, unsigned uAddress, unsigned uLength)
+{
+  if (!bCheckRange(uAddress, uLength, EEPROM_SYS_DEV_SIZE)) return false;
+  vWriteStripes(EEPROM_SYS_DEV_ADDR, pucBuffer, uAddress, uLength);
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Wait for completion of all pending write cycles
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSyncEepromVolume(void)
+{
+  for (unsigned i = 0; i < uNumDevices; ++i) vWaitMember(i);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print volume members and size
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added system area size
+ ******************************************************************************/
+void vPrintEepromVolumeInfo(void)
+{
+  if (!bProbed) vInitEepromVolume();
+  printf("EEPROM volume: %u bytes (+%u system), %u device(s) at A2..A0 =",
+    uGetEepromVolumeSize(), uGetEepromSysAreaSize(), uNumDevices);
+  for (unsigned i = 0; i < uNumDevices; ++i) printf(" %u", aucDevices[i]);
+  printf("\r\n");
+}
+
+/*!****************************************************************************
+ * @brief
+ * Open sequential reader on a volume range
+ *
+ * @param[out] *psStream  Stream state
+ * @param[in] uAddress    Volume start address
+ * @param[in] uLength     Number of bytes to be read
+ * @return  (bool)  true on success, false if out of range
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bOpenEepromStream(EepromStreamTypeDef* psStream, unsigned uAddress, unsigned uLength)
+{
+  if (!bCheckRange(uAddress, uLength, EEPROM_VOLUME_DEV_SIZE)) return false;
+  psStream->uAddress = uAddress;
+  psStream->uRemaining = uLength;
+  psStream->uPos = 0;
+  psStream->uFill = 0;
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read next bytes from stream
+ *
+ * @param[in,out] *psStream Stream state
+ * @param[out] *pucBuffer Buffer for read data
+ * @param[in] uLength     Maximum number of bytes
+ * @return  (unsigned)  Number of bytes read, 0 at end of stream
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uReadEepromStream(EepromStreamTypeDef* psStream, unsigned char* pucBuffer, unsigned uLength)
+{
+  unsigned uDone = 0;
+  while (uDone < uLength)
+  {
+    /* Refill read-ahead buffer, ending on a stripe border
+     * so that each device access reads whole stripes     */
+    if (psStream->uPos == psStream->uFill)
+    {
+      if (psStream->uRemaining == 0) break;
+      unsigned uFetch = EEVOL_STREAM_BUF_SIZE - psStream->uAddress % EEVOL_STRIPE_SIZE;
+      if (uFetch > psStream->uRemaining) uFetch = psStream->uRemaining;
+      bReadEepromVolume(psStream->aucBuf, psStream->uAddress, uFetch);
+      psStream->uAddress += uFetch;
+      psStream->uRemaining -= uFetch;
+      psStream->uPos = 0;
+      psStream->uFill = uFetch;
+    }
+
+    unsigned uChunk = psStream->uFill - psStream->uPos;
+    if (uChunk > uLength - uDone) uChunk = uLength - uDone;
+    memcpy(&pucBuffer[uDone], &psStream->aucBuf[psStream->uPos], uChunk);
+    psStream->uPos += uChunk;
+    uDone += uChunk;
+  }
+  return uDone;
+}
@@ -0,0 +1,55 @@
+/*!****************************************************************************
+ * @file
+ * eevol.h
+ *
+ * @brief
+ * Linear storage volume striped across multiple 24Cxx EEPROMs
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added streaming reader
+ * @date  18.10.2026  Added system area access
+ ******************************************************************************/
+
+#ifndef EEVOL_H_
+#define EEVOL_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include "eeprom.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Stripe size in bytes; consecutive stripes go to consecutive devices */
+#define EEVOL_STRIPE_SIZE             EEPROM_PAGE_SIZE
+
+/*! @brief Stream read-ahead buffer size in bytes                             */
+#define EEVOL_STREAM_BUF_SIZE         (2 * EEVOL_STRIPE_SIZE)
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Sequential volume reader                                           */
+typedef struct
+{
+  unsigned uAddress;                  /*!< Next volume address to fetch       */
+  unsigned uRemaining;                /*!< Bytes not yet fetched              */
+  unsigned uPos;                      /*!< Read position in buffer            */
+  unsigned uFill;                     /*!< Valid bytes in buffer              */
+  unsigned char aucBuf[EEVOL_STREAM_BUF_SIZE]; /*!< Read-ahead buffer         */
+} EepromStreamTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vInitEepromVolume(void);
+unsigned uGetEepromVolumeDevices(void);
+unsigned uGetEepromVolumeSize(void);
+bool bReadEepromVolume(unsigned char* pucBuffer, unsigned uAddress, unsigned uLength);
+bool bWriteEepromVolume(const unsigned char* pucBuffer, unsigned uAddress, unsigned uLength);
+unsigned uGetEepromSysAreaSize(void);
+bool bReadEepromSysArea(unsigned char* pucBuffer, unsigned uAddress, unsigned uLength);
+bool bWriteEepromSysArea(const unsigned char* pucBuffer, unsigned uAddress, unsigned uLength);
+void vSyncEepromVolume(void);
+void vPrintEepromVolumeInfo(void);
+bool bOpenEepromStream(EepromStreamTypeDef* psStream, unsigned uAddress, unsigned uLength);
+unsigned uReadEepromStream(EepromStreamTypeDef* psStream, unsigned char* pucBuffer, unsigned uLength);
+
+#endif /* EEVOL_H_ */
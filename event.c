@@ -0,0 +1,201 @@
+/*!****************************************************************************
+ * @file
+ * event.c
+ *
+ * @brief
+ * Lock-free interrupt-to-task event queue and publish/subscribe dispatch
+ *
+ * Events are published from interrupt handlers or the main loop into a single
+ * bounded queue, and dispatched from the main loop to all handlers subscribed
+ * to the event topic. Subscriptions are given as a static table to
+ * vInitEvents().
+ *
+ * The queue is a multi-producer, single-consumer ring with a sequence number
+ * per slot. A producer claims a slot by advancing the write index with an
+ * atomic compare-and-swap (RV32A lr.w/sc.w), fills it and then releases it by
+ * updating the slot sequence number. Publishing therefore never disables
+ * interrupts; a handler interrupting another producer simply claims the next
+ * slot. The consumer only takes a slot once it has been released, so an event
+ * claimed by an interrupted producer delays the events behind it until the
+ * producer resumes.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include "ch32v10x.h"
+#include "hw_stk.h"
+#include "event.h"
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Queue slot                                                         */
+typedef struct
+{
+  uint32_t ulSeq;                     /*!< Slot sequence number               */
+  EventTypeDef sEvent;                /*!< Event data                         */
+} EventSlotTypeDef;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Queue slots                                                               */
+static EventSlotTypeDef asSlots[EVENT_QUEUE_LEN];
+
+/*! Next write position, shared by all producers                              */
+static uint32_t ulWriteIdx;
+
+/*! Next read position, consumer only                                         */
+static uint32_t ulReadIdx;
+
+/*! Subscriber table                                                          */
+static const EventSubTypeDef* psSubTable;
+
+/*! Number of subscriber table entries                                        */
+static unsigned uNumSubEntries;
+
+/*! Queue statistics                                                          */
+static EventStatsTypeDef sStats;
+
+
+/*!****************************************************************************
+ * @brief
+ * Initialise event queue and subscriber table
+ *
+ * @param[in] *psSubs     Subscriber table
+ * @param[in] uNumSubs    Number of table entries
+ * @date  18.10.2026
+ ******************************************************************************/
+void vInitEvents(const EventSubTypeDef* psSubs, unsigned uNumSubs)
+{
+  for (unsigned i = 0; i < EVENT_QUEUE_LEN; ++i) asSlots[i].ulSeq = i;
+  ulWriteIdx = 0;
+  ulReadIdx = 0;
+  psSubTable = psSubs;
+  uNumSubEntries = uNumSubs;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Publish an event
+ *
+ * @note
+ * May be called from interrupt handlers at any priority level.
+ *
+ * @param[in] eTopic      Event topic
+ * @param[in] uiArg       Topic-specific argument
+ * @param[in] ulData      Topic-specific data
+ * @return  (bool)  true if queued, false if the queue is full
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bPublishEvent(EventTopicTypeDef eTopic, uint16_t uiArg, uint32_t ulData)
+{
+  uint32_t ulIdx = __atomic_load_n(&ulWriteIdx, __ATOMIC_RELAXED);
+  EventSlotTypeDef* psSlot;
+  while (1)
+  {
+    psSlot = &asSlots[ulIdx % EVENT_QUEUE_LEN];
+    int32_t lDiff = (int32_t)(__atomic_load_n(&psSlot->ulSeq, __ATOMIC_ACQUIRE) - ulIdx);
+    if (lDiff == 0)
+    {
+      /* Slot free, try to claim it; ulIdx is updated on failure */
+      if (__atomic_compare_exchange_n(&ulWriteIdx, &ulIdx, ulIdx + 1, false,
+        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) break;
+    }
+    else if (lDiff < 0)
+    {
+      /* Slot not yet consumed: queue full                  */
+      __atomic_fetch_add(&sStats.ulDropped, 1, __ATOMIC_RELAXED);
+      return false;
+    }
+    else
+    {
+      /* Slot claimed by a preempting producer                */
+      ulIdx = __atomic_load_n(&ulWriteIdx, __ATOMIC_RELAXED);
+    }
+  }
+
+  psSlot->sEvent.uiTopic = (uint16_t)eTopic;
+  psSlot->sEvent.uiArg = uiArg;
+  psSlot->sEvent.ulData = ulData;
+  psSlot->sEvent.ulTicks = SysTick_GetValueLow();
+  __atomic_store_n(&psSlot->ulSeq, ulIdx + 1, __ATOMIC_RELEASE);
+  __atomic_fetch_add(&sStats.ulPublished, 1, __ATOMIC_RELAXED);
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Take the next event from the queue and pass it to its subscribers
+ *
+ * @note
+ * Shall only be called from the main loop.
+ *
+ * @return  (bool)  true if an event was dispatched
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bDispatchEvent(void)
+{
+  EventSlotTypeDef* psSlot = &asSlots[ulReadIdx % EVENT_QUEUE_LEN];
+  if (__atomic_load_n(&psSlot->ulSeq, __ATOMIC_ACQUIRE) != ulReadIdx + 1) return false;
+
+  /* Copy event and release slot to producers             */
+  EventTypeDef sEvent = psSlot->sEvent;
+  unsigned uFill = __atomic_load_n(&ulWriteIdx, __ATOMIC_RELAXED) - ulReadIdx;
+  __atomic_store_n(&psSlot->ulSeq, ulReadIdx + EVENT_QUEUE_LEN, __ATOMIC_RELEASE);
+  ++ulReadIdx;
+
+  uint32_t ulLatency = SysTick_GetValueLow() - sEvent.ulTicks;
+  if (ulLatency > sStats.ulLatencyMax) sStats.ulLatencyMax = ulLatency;
+  if (uFill > sStats.uPeak) sStats.uPeak = uFill;
+  ++sStats.ulDispatched;
+
+  for (unsigned i = 0; i < uNumSubEntries; ++i)
+  {
+    if (psSubTable[i].eTopic == sEvent.uiTopic) psSubTable[i].pvHandler(&sEvent);
+  }
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Dispatch pending events, at most EVENT_MAX_PER_POLL per call
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPollEvents(void)
+{
+  for (unsigned i = 0; (i < EVENT_MAX_PER_POLL) && bDispatchEvent(); ++i);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get event queue statistics
+ *
+ * @param[out] *psStats   Statistics
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetEventStats(EventStatsTypeDef* psStats)
+{
+  *psStats = sStats;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print event queue statistics
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPrintEventStats(void)
+{
+  EventStatsTypeDef sCopy;
+  vGetEventStats(&sCopy);
+
+  printf(
+    "-- Events ----------------------------------------\r\n"
+  );
+  printf("published: %lu, dropped: %lu, dispatched: %lu\r\n",
+    sCopy.ulPublished, sCopy.ulDropped, sCopy.ulDispatched);
+  printf("queue: %u/%u slots peak, max. latency %lu us\r\n", sCopy.uPeak,
+    EVENT_QUEUE_LEN, (uint32_t)((uint64_t)sCopy.ulLatencyMax * 1000 / ulHW_STK_MsToTicks(1)));
+}
@@ -0,0 +1,73 @@
+/*!****************************************************************************
+ * @file
+ * event.h
+ *
+ * @brief
+ * Lock-free interrupt-to-task event queue and publish/subscribe dispatch
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef EVENT_H_
+#define EVENT_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Number of queue slots (power of 2)                                 */
+#define EVENT_QUEUE_LEN               32
+
+/*! @brief Maximum number of events dispatched per poll call                  */
+#define EVENT_MAX_PER_POLL            8
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Event topics                                                       */
+typedef enum
+{
+  EVENT_TOPIC_CLOCK = 0,              /*!< Clock configuration changed        */
+  EVENT_TOPIC_BENCH,                  /*!< Benchmark events                   */
+  EVENT_TOPIC_ADC_BLOCK,              /*!< ADC capture block completed        */
+  EVENT_NUM_TOPICS
+} EventTopicTypeDef;
+
+/*! @brief Event                                                              */
+typedef struct
+{
+  uint16_t uiTopic;                   /*!< Event topic                        */
+  uint16_t uiArg;                     /*!< Topic-specific argument            */
+  uint32_t ulData;                    /*!< Topic-specific data                */
+  uint32_t ulTicks;                   /*!< SysTick count at publishing        */
+} EventTypeDef;
+
+/*! @brief Subscriber table entry                                             */
+typedef struct
+{
+  EventTopicTypeDef eTopic;           /*!< Subscribed topic                   */
+  void (*pvHandler)(const EventTypeDef* psEvent); /*!< Event handler          */
+} EventSubTypeDef;
+
+/*! @brief Event queue statistics                                             */
+typedef struct
+{
+  uint32_t ulPublished;               /*!< Events queued                      */
+  uint32_t ulDropped;                 /*!< Events lost due to full queue      */
+  uint32_t ulDispatched;              /*!< Events taken from the queue        */
+  uint32_t ulLatencyMax;              /*!< Longest publish-to-dispatch time in
+                                           SysTick counts                     */
+  unsigned uPeak;                     /*!< Maximum queue fill level           */
+} EventStatsTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vInitEvents(const EventSubTypeDef* psSubs, unsigned uNumSubs);
+bool bPublishEvent(EventTopicTypeDef eTopic, uint16_t uiArg, uint32_t ulData);
+bool bDispatchEvent(void);
+void vPollEvents(void);
+void vGetEventStats(EventStatsTypeDef* psStats);
+void vPrintEventStats(void);
+
+#endif /* EVENT_H_ */
@@ -0,0 +1,358 @@
+/*!****************************************************************************
+ * @file
+ * fft.c
+ *
+ * @brief
+ * Fixed-point (Q15) FFT and spectral analysis helpers
+ *
+ * vFftQ15() is an in-place decimation-in-time FFT on separate real and
+ * imaginary arrays of up to FFT_MAX_POINTS points. After the bit-reversal
+ * permutation, all stages are radix-4 butterflies (3 complex multiplies per 4
+ * points), preceded by a single radix-2 stage if log2(N) is odd. Radix-4
+ * works on the ordinary bit-reversed order because the four sub-transforms
+ * of a butterfly lie at offsets 0, h, 2h, 3h in the order 0, 2, 1, 3 (mod 4).
+ *
+ * Each radix-2 stage scales by 1/2 and each radix-4 stage by 1/4, so the
+ * output is the DFT divided by N and cannot overflow. Products are formed in
+ * 32 bits and rounded to Q15. Twiddle factors come from a quarter-wave sine
+ * table for FFT_MAX_POINTS; smaller sizes use every n-th entry.
+ *
+ * tools/fft_check.py contains a bit-exact model to compare the results
+ * against a double-precision reference.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "fft.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Quarter-wave sine table length - 1                                 */
+#define FFT_QUARTER                   (FFT_MAX_POINTS / 4)
+
+/*! @brief Round Q30 product sum to Q15                                       */
+#define FFT_Q15_ROUND(x)              (((x) + 0x4000) >> 15)
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! sin(2 pi i / FFT_MAX_POINTS) in Q15, i = 0 .. FFT_MAX_POINTS / 4          */
+static const int16_t aiSinTable[FFT_QUARTER + 1] = {
+      0,   402,   804,  1206,  1608,  2009,  2411,  2811,
+   3212,  3612,  4011,  4410,  4808,  5205,  5602,  5998,
+   6393,  6787,  7180,  7571,  7962,  8351,  8740,  9127,
+   9512,  9896, 10279, 10660, 11039, 11417, 11793, 12167,
+  12540, 12910, 13279, 13646, 14010, 14373, 14733, 15091,
+  15447, 15800, 16151, 16500, 16846, 17190, 17531, 17869,
+  18205, 18538, 18868, 19195, 19520, 19841, 20160, 20475,
+  20788, 21097, 21403, 21706, 22006, 22302, 22595, 22884,
+  23170, 23453, 23732, 24008, 24279, 24548, 24812, 25073,
+  25330, 25583, 25833, 26078, 26320, 26557, 26791, 27020,
+  27246, 27467, 27684, 27897, 28106, 28311, 28511, 28707,
+  28899, 29086, 29269, 29448, 29622, 29792, 29957, 30118,
+  30274, 30425, 30572, 30715, 30853, 30986, 31114, 31238,
+  31357, 31471, 31581, 31686, 31786, 31881, 31972, 32058,
+  32138, 32214, 32286, 32352, 32413, 32470, 32522, 32568,
+  32610, 32647, 32679, 32706, 32729, 32746, 32758, 32766,
+  32767
+};
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Look up twiddle factor
+ *
+ * @param[in] uIndex      Angle in units of 2 pi / FFT_MAX_POINTS, less than
+ *                        FFT_MAX_POINTS
+ * @param[out] *plCos     cos(angle) in Q15
+ * @param[out] *plSin     sin(angle) in Q15
+ * @date  18.10.2026
+ ******************************************************************************/
+static inline void vGetTwiddle(unsigned uIndex, int32_t* plCos, int32_t* plSin)
+{
+  unsigned uRem = uIndex % FFT_QUARTER;
+  switch (uIndex / FFT_QUARTER)
+  {
+    case 0:
+      *plSin = aiSinTable[uRem];
+      *plCos = aiSinTable[FFT_QUARTER - uRem];
+      break;
+
+    case 1:
+      *plSin = aiSinTable[FFT_QUARTER - uRem];
+      *plCos = -aiSinTable[uRem];
+      break;
+
+    case 2:
+      *plSin = -aiSinTable[uRem];
+      *plCos = -aiSinTable[FFT_QUARTER - uRem];
+      break;
+
+    default:
+      *plSin = -aiSinTable[FFT_QUARTER - uRem];
+      *plCos = aiSinTable[uRem];
+      break;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Saturate to 16 bits
+ *
+ * @param[in] lValue      Value
+ * @return  (int16_t)   Saturated value
+ * @date  18.10.2026
+ ******************************************************************************/
+static inline int16_t iSat16(int32_t lValue)
+{
+  if (lValue > INT16_MAX) return INT16_MAX;
+  if (lValue < INT16_MIN) return INT16_MIN;
+  return (int16_t)lValue;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Bit-reversal permutation
+ *
+ * @param[in,out] *piRe   Real parts
+ * @param[in,out] *piIm   Imaginary parts
+ * @param[in] uN          Number of points
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBitReverse(int16_t* piRe, int16_t* piIm, unsigned uN)
+{
+  unsigned j = 0;
+  for (unsigned i = 1; i < uN; ++i)
+  {
+    unsigned uBit = uN >> 1;
+    for (; j & uBit; uBit >>= 1) j ^= uBit;
+    j ^= uBit;
+    if (i < j)
+    {
+      int16_t iTmp = piRe[i]; piRe[i] = piRe[j]; piRe[j] = iTmp;
+      iTmp = piIm[i]; piIm[i] = piIm[j]; piIm[j] = iTmp;
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Radix-4 butterfly, scaled by 1/4
+ *
+ * Combines the sub-transforms X0 (at i), X2 (at i + h), X1 (at i + 2h) and
+ * X3 (at i + 3h), with the twiddle factors already applied to X1..X3.
+ *
+ * @param[in,out] *piRe   Real parts
+ * @param[in,out] *piIm   Imaginary parts
+ * @param[in] i           Index of first point
+ * @param[in] h           Distance between points
+ * @param[in] lT2r, lT2i  W^2j * X2
+ * @param[in] lT1r, lT1i  W^j * X1
+ * @param[in] lT3r, lT3i  W^3j * X3
+ * @date  18.10.2026
+ ******************************************************************************/
+static inline void vButterfly4(int16_t* piRe, int16_t* piIm, unsigned i, unsigned h,
+  int32_t lT2r, int32_t lT2i, int32_t lT1r, int32_t lT1i, int32_t lT3r, int32_t lT3i)
+{
+  int32_t lAr = piRe[i] + lT2r;
+  int32_t lAi = piIm[i] + lT2i;
+  int32_t lBr = piRe[i] - lT2r;
+  int32_t lBi = piIm[i] - lT2i;
+  int32_t lCr = lT1r + lT3r;
+  int32_t lCi = lT1i + lT3i;
+  int32_t lDr = lT1r - lT3r;
+  int32_t lDi = lT1i - lT3i;
+
+  piRe[i]         = iSat16((lAr + lCr + 2) >> 2);
+  piIm[i]         = iSat16((lAi + lCi + 2) >> 2);
+  piRe[i + h]     = iSat16((lBr + lDi + 2) >> 2);
+  piIm[i + h]     = iSat16((lBi - lDr + 2) >> 2);
+  piRe[i + 2 * h] = iSat16((lAr - lCr + 2) >> 2);
+  piIm[i + 2 * h] = iSat16((lAi - lCi + 2) >> 2);
+  piRe[i + 3 * h] = iSat16((lBr - lDi + 2) >> 2);
+  piIm[i + 3 * h] = iSat16((lBi + lDr + 2) >> 2);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Integer square root
+ *
+ * @param[in] ulValue     Value
+ * @return  (uint32_t)  floor(sqrt(value))
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulSqrt32(uint32_t ulValue)
+{
+  uint32_t ulRoot = 0;
+  uint32_t ulBit = 1UL << 30;
+  while (ulBit > ulValue) ulBit >>= 2;
+  while (ulBit != 0)
+  {
+    if (ulValue >= ulRoot + ulBit)
+    {
+      ulValue -= ulRoot + ulBit;
+      ulRoot = (ulRoot >> 1) + ulBit;
+    }
+    else
+    {
+      ulRoot >>= 1;
+    }
+    ulBit >>= 2;
+  }
+  return ulRoot;
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * In-place forward FFT, output scaled by 1/N
+ *
+ * @param[in,out] *piRe   Real parts (Q15)
+ * @param[in,out] *piIm   Imaginary parts (Q15)
+ * @param[in] uLog2N      Transform size (log2), at most FFT_MAX_LOG2
+ * @date  18.10.2026
+ ******************************************************************************/
+void vFftQ15(int16_t* piRe, int16_t* piIm, unsigned uLog2N)
+{
+  if ((uLog2N == 0) || (uLog2N > FFT_MAX_LOG2)) return;
+  unsigned uN = 1U << uLog2N;
+  vBitReverse(piRe, piIm, uN);
+
+  /* Radix-2 stage for odd log2(N), all twiddles 1       */
+  unsigned h = 1;
+  if (uLog2N & 1)
+  {
+    for (unsigned i = 0; i < uN; i += 2)
+    {
+      int32_t lRe = piRe[i + 1];
+      int32_t lIm = piIm[i + 1];
+      piRe[i + 1] = (piRe[i] - lRe + 1) >> 1;
+      piIm[i + 1] = (piIm[i] - lIm + 1) >> 1;
+      piRe[i]     = (piRe[i] + lRe + 1) >> 1;
+      piIm[i]     = (piIm[i] + lIm + 1) >> 1;
+    }
+    h = 2;
+  }
+
+  /* Radix-4 stages combining sub-transforms of size h   */
+  for (; h < uN; h *= 4)
+  {
+    unsigned uStep = FFT_MAX_POINTS / (4 * h);
+
+    /* j = 0: all twiddles 1                               */
+    for (unsigned i = 0; i < uN; i += 4 * h)
+    {
+      vButterfly4(piRe, piIm, i, h,
+        piRe[i + h],     piIm[i + h],
+        piRe[i + 2 * h], piIm[i + 2 * h],
+        piRe[i + 3 * h], piIm[i + 3 * h]);
+    }
+
+    for (unsigned j = 1; j < h; ++j)
+    {
+      int32_t lC1, lS1, lC2, lS2, lC3, lS3;
+      vGetTwiddle(j * uStep, &lC1, &lS1);
+      vGetTwiddle(2 * j * uStep, &lC2, &lS2);
+      vGetTwiddle(3 * j * uStep, &lC3, &lS3);
+
+      for (unsigned i = j; i < uN; i += 4 * h)
+      {
+        /* x * W with W = cos - i sin                         */
+        int32_t lXr = piRe[i + h], lXi = piIm[i + h];
+        int32_t lT2r = FFT_Q15_ROUND(lXr * lC2 + lXi * lS2);
+        int32_t lT2i = FFT_Q15_ROUND(lXi * lC2 - lXr * lS2);
+        lXr = piRe[i + 2 * h]; lXi = piIm[i + 2 * h];
+        int32_t lT1r = FFT_Q15_ROUND(lXr * lC1 + lXi * lS1);
+        int32_t lT1i = FFT_Q15_ROUND(lXi * lC1 - lXr * lS1);
+        lXr = piRe[i + 3 * h]; lXi = piIm[i + 3 * h];
+        int32_t lT3r = FFT_Q15_ROUND(lXr * lC3 + lXi * lS3);
+        int32_t lT3i = FFT_Q15_ROUND(lXi * lC3 - lXr * lS3);
+        vButterfly4(piRe, piIm, i, h, lT2r, lT2i, lT1r, lT1i, lT3r, lT3i);
+      }
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Apply Hann window in place
+ *
+ * @param[in,out] *piData Samples (Q15)
+ * @param[in] uLog2N      Number of samples (log2), at most FFT_MAX_LOG2
+ * @date  18.10.2026
+ ******************************************************************************/
+void vApplyHannQ15(int16_t* piData, unsigned uLog2N)
+{
+  unsigned uN = 1U << uLog2N;
+  unsigned uStep = FFT_MAX_POINTS >> uLog2N;
+  for (unsigned i = 0; i < uN; ++i)
+  {
+    int32_t lCos, lSin;
+    vGetTwiddle(i * uStep, &lCos, &lSin);
+    int32_t lWeight = (INT16_MAX - lCos) >> 1;
+    piData[i] = FFT_Q15_ROUND(piData[i] * lWeight);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Calculate bin magnitudes
+ *
+ * The output may overlay the real part array.
+ *
+ * @param[in] *piRe       Real parts (Q15)
+ * @param[in] *piIm       Imaginary parts (Q15)
+ * @param[out] *puiMag    Magnitudes (Q15)
+ * @param[in] uCount      Number of bins
+ * @date  18.10.2026
+ ******************************************************************************/
+void vCalcMagnitudeQ15(const int16_t* piRe, const int16_t* piIm, uint16_t* puiMag, unsigned uCount)
+{
+  for (unsigned i = 0; i < uCount; ++i)
+  {
+    int32_t lRe = piRe[i];
+    int32_t lIm = piIm[i];
+    puiMag[i] = ulSqrt32((uint32_t)(lRe * lRe) + (uint32_t)(lIm * lIm));
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Find largest local maxima, excluding the DC and last bin
+ *
+ * The peak position is refined by parabolic interpolation over the adjacent
+ * bins.
+ *
+ * @param[in] *puiMag     Bin magnitudes
+ * @param[in] uCount      Number of bins
+ * @param[out] *psPeaks   Peaks, sorted by decreasing magnitude
+ * @param[in] uMaxPeaks   Maximum number of peaks
+ * @return  (unsigned)  Number of peaks found
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uFindPeaks(const uint16_t* puiMag, unsigned uCount, FftPeakTypeDef* psPeaks, unsigned uMaxPeaks)
+{
+  unsigned uFound = 0;
+  if (uMaxPeaks == 0) return 0;
+  for (unsigned k = 1; k + 1 < uCount; ++k)
+  {
+    int32_t lA = puiMag[k - 1];
+    int32_t lB = puiMag[k];
+    int32_t lC = puiMag[k + 1];
+    if ((lB <= lA) || (lB < lC)) continue;
+    if ((uFound == uMaxPeaks) && (lB <= psPeaks[uFound - 1].uiMag)) continue;
+
+    /* Insert sorted, dropping the smallest if full         */
+    unsigned uPos = (uFound < uMaxPeaks) ? uFound++ : uFound - 1;
+    while ((uPos > 0) && (psPeaks[uPos - 1].uiMag < lB))
+    {
+      psPeaks[uPos] = psPeaks[uPos - 1];
+      --uPos;
+    }
+    psPeaks[uPos].uiBin = k;
+    psPeaks[uPos].uiMag = lB;
+    psPeaks[uPos].iFrac = (lA - lC) * (FFT_PEAK_FRAC_ONE / 2) / (lA - 2 * lB + lC);
+  }
+  return uFound;
+}
@@ -0,0 +1,46 @@
+/*!****************************************************************************
+ * @file
+ * fft.h
+ *
+ * @brief
+ * Fixed-point (Q15) FFT and spectral analysis helpers
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef FFT_H_
+#define FFT_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Largest supported transform size (log2)                            */
+#define FFT_MAX_LOG2                  9
+
+/*! @brief Largest supported transform size in points                         */
+#define FFT_MAX_POINTS                (1U << FFT_MAX_LOG2)
+
+/*! @brief Fractional bin resolution of interpolated peaks                    */
+#define FFT_PEAK_FRAC_ONE             256
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Spectral peak                                                      */
+typedef struct
+{
+  uint16_t uiBin;                     /*!< Bin index                          */
+  int16_t iFrac;                      /*!< Interpolated offset from bin centre
+                                           in 1/FFT_PEAK_FRAC_ONE bins        */
+  uint16_t uiMag;                     /*!< Bin magnitude                      */
+} FftPeakTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vFftQ15(int16_t* piRe, int16_t* piIm, unsigned uLog2N);
+void vApplyHannQ15(int16_t* piData, unsigned uLog2N);
+void vCalcMagnitudeQ15(const int16_t* piRe, const int16_t* piIm, uint16_t* puiMag, unsigned uCount);
+unsigned uFindPeaks(const uint16_t* puiMag, unsigned uCount, FftPeakTypeDef* psPeaks, unsigned uMaxPeaks);
+
+#endif /* FFT_H_ */
@@ -0,0 +1,47 @@
+/*!****************************************************************************
+ * @file
+ * flash_layout.h
+ *
+ * @brief
+ * Partitioning of the internal flash memory
+ *
+ *   0x0000 .. 0x07FF   Firmware update installer (2 KB)
+ *   0x0800 .. 0x73FF   Application image (27 KB)
+ *   0x7400 .. 0xDFFF   Firmware update staging slot (27 KB)
+ *   0xE000 .. 0xE7FF   Firmware update state records (2 KB)
+ *   0xE800 .. 0xFFFF   Data area, used by flash logger (6 KB)
+ *
+ * The installer region is only written by the debugger, never by a firmware
+ * update (see installer.c). The installer and application size limits are
+ * also checked by Controller/app_sections.ld.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Assigned data area to flash logger
+ * @date  18.10.2026  Added installer region
+ ******************************************************************************/
+
+#ifndef FLASH_LAYOUT_H_
+#define FLASH_LAYOUT_H_
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Firmware update installer, entered on reset                       */
+#define FLASH_INSTALLER_ADDR          (FLASH_BASE + 0x0000)
+#define FLASH_INSTALLER_SIZE          0x0800
+
+/*! @brief Application image                                                  */
+#define FLASH_APP_ADDR                (FLASH_BASE + 0x0800)
+#define FLASH_APP_SIZE                0x6C00
+
+/*! @brief Firmware update staging slot                                       */
+#define FLASH_STAGING_ADDR            (FLASH_BASE + 0x7400)
+#define FLASH_STAGING_SIZE            0x6C00
+
+/*! @brief Firmware update state records                                      */
+#define FLASH_FWUPD_STATE_ADDR        (FLASH_BASE + 0xE000)
+#define FLASH_FWUPD_STATE_SIZE        0x0800
+
+/*! @brief Data area                                                          */
+#define FLASH_DATA_ADDR               (FLASH_BASE + 0xE800)
+#define FLASH_DATA_SIZE               0x1800
+
+#endif /* FLASH_LAYOUT_H_ */
@@ -0,0 +1,318 @@
+/*!****************************************************************************
+ * @file
+ * flashlog.c
+ *
+ * @brief
+ * Circular data logger in the internal flash data area
+ *
+ * Records are collected in a RAM page buffer and committed as whole 128-byte
+ * pages using fast page programming, so a page is programmed once per
+ * FLASHLOG_PAYLOAD_SIZE bytes of records instead of once per record. The data
+ * area is used as a ring of pages. vPollFlashLog() keeps FLASHLOG_ERASE_AHEAD
+ * pages in front of the write pointer erased, one page per call, so that a
+ * commit normally only has to program a page. Erasing ahead discards the
+ * oldest pages.
+ *
+ * Since page n is stored at index n % FLASHLOG_NUM_PAGES, the pages written
+ * since the last wrap-around form a run of consecutive sequence numbers at the
+ * start of the ring, followed by the erased pages. The newest page is found at
+ * boot by a binary search over this run, using O(log n) page reads. Within the
+ * run, only the sequence numbers are compared, so that a page which failed
+ * verification does not end the run; it is skipped on readout.
+ *
+ * A power loss during a commit or an erase only affects pages in front of the
+ * write pointer, which fail their CRC check and are treated as erased.
+ *
+ * @note
+ * Not interrupt-safe; records shall only be written from the main loop.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Pages failing verification no longer end the boot search
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "ch32v10x.h"
+#include "offload.h"
+#include "mux.h"
+#include "flashlog.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Number of words in a flash page                                    */
+#define FLASHLOG_PAGE_WORDS           (HW_FLASH_PAGE_SIZE / sizeof(uint32_t))
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Page buffer: header and payload                                           */
+static uint32_t aulPageBuf[FLASHLOG_PAGE_WORDS];
+
+/*! Sequence number of next page to be committed                              */
+static uint32_t ulNextSeq;
+
+/*! Number of erased pages starting at the write pointer                      */
+static unsigned uErasedAhead;
+
+/*! Statistics                                                                */
+static FlashLogInfoTypeDef sStats;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Get page header at ring index
+ *
+ * @param[in] uIndex      Page index
+ * @return  (const FlashLogHdrTypeDef*)  Page in flash
+ * @date  18.10.2026
+ ******************************************************************************/
+static inline const FlashLogHdrTypeDef* psGetPage(unsigned uIndex)
+{
+  return (const FlashLogHdrTypeDef*)(FLASH_DATA_ADDR + uIndex * HW_FLASH_PAGE_SIZE);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Calculate page check value
+ *
+ * @param[in] *psPage     Page header, followed by payload
+ * @return  (uint32_t)  CRC-32 over everything except ulCheck
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulCalcPageCheck(const FlashLogHdrTypeDef* psPage)
+{
+  return ulCalcCrc32Sw(&psPage->ulSeq, HW_FLASH_PAGE_SIZE - sizeof(psPage->ulCheck), OFFLOAD_CRC32_INIT);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check whether a page holds a valid log page for its ring index
+ *
+ * @param[in] uIndex      Page index
+ * @return  (bool)      true, if page is valid
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bIsPageValid(unsigned uIndex)
+{
+  const FlashLogHdrTypeDef* psPage = psGetPage(uIndex);
+  return (psPage->ulSeq % FLASHLOG_NUM_PAGES == uIndex) &&
+    (psPage->ulLen <= FLASHLOG_PAYLOAD_SIZE) &&
+    (psPage->ulCheck == ulCalcPageCheck(psPage));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Erase the next page in front of the known erased pages
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vEraseAhead(void)
+{
+  unsigned uIndex = (ulNextSeq + uErasedAhead) % FLASHLOG_NUM_PAGES;
+  vHW_FlashErasePage(FLASH_DATA_ADDR + uIndex * HW_FLASH_PAGE_SIZE);
+  uErasedAhead++;
+  sStats.ulErases++;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Find the newest page
+ *
+ * @return  (int)       Page index, or -1 if the log is empty. The page may
+ *                      have failed verification when it was committed.
+ * @date  18.10.2026
+ * @date  18.10.2026  Run continues across pages failing verification
+ ******************************************************************************/
+static int iFindNewestPage(void)
+{
+  /* A page 0 failing verification still starts the run,
+   * if page 1 continues it                               */
+  uint32_t ulSeq0 = psGetPage(0)->ulSeq;
+  if (bIsPageValid(0) ||
+    ((ulSeq0 % FLASHLOG_NUM_PAGES == 0) && bIsPageValid(1) && (psGetPage(1)->ulSeq == ulSeq0 + 1)))
+  {
+    /* Pages written in the current lap hold consecutive
+     * sequence numbers, starting at page 0. Erased and
+     * older pages never hold the sequence number of their
+     * position in the run, so checking the number alone
+     * keeps pages which failed verification in the run. */
+    unsigned uLow = 0;
+    unsigned uHigh = FLASHLOG_NUM_PAGES;
+    while (uHigh - uLow > 1)
+    {
+      unsigned uMid = (uLow + uHigh) / 2;
+      if (psGetPage(uMid)->ulSeq == ulSeq0 + uMid)
+      {
+        uLow = uMid;
+      }
+      else
+      {
+        uHigh = uMid;
+      }
+    }
+    return uLow;
+  }
+
+  /* Page 0 lies within the erased pages, which end at most
+   * FLASHLOG_ERASE_AHEAD + 1 pages after the newest page;
+   * one more page may have been hit by an interrupted
+   * erase or commit                                      */
+  for (unsigned i = 1; i <= FLASHLOG_ERASE_AHEAD + 1; ++i)
+  {
+    if (bIsPageValid(FLASHLOG_NUM_PAGES - i)) return FLASHLOG_NUM_PAGES - i;
+  }
+  return -1;
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Recover write pointer
+ *
+ * The erased pages in front of the write pointer are restored by
+ * vPollFlashLog().
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vInitFlashLog(void)
+{
+  memset(&sStats, 0, sizeof(sStats));
+  memset(aulPageBuf, 0, sizeof(aulPageBuf));
+  uErasedAhead = 0;
+
+  int iNewest = iFindNewestPage();
+  ulNextSeq = (iNewest < 0) ? 0 : psGetPage(iNewest)->ulSeq + 1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Append record
+ *
+ * The current page is committed first, if the record does not fit. The
+ * record is also sent on the log output channel, length-prefixed like in the
+ * page.
+ *
+ * @param[in] *pvData     Record data
+ * @param[in] uLen        Record length, 1 .. FLASHLOG_MAX_RECORD
+ * @return  (bool)      true, if the record was stored
+ * @date  18.10.2026
+ * @date  18.10.2026  Record copied to log output channel
+ ******************************************************************************/
+bool bWriteFlashLog(const void* pvData, unsigned uLen)
+{
+  if ((uLen == 0) || (uLen > FLASHLOG_MAX_RECORD)) return false;
+
+  FlashLogHdrTypeDef* psHdr = (FlashLogHdrTypeDef*)aulPageBuf;
+  if (psHdr->ulLen + 1 + uLen > FLASHLOG_PAYLOAD_SIZE) vFlushFlashLog();
+
+  uint8_t* pucPayload = (uint8_t*)aulPageBuf + FLASHLOG_HDR_SIZE;
+  pucPayload[psHdr->ulLen] = uLen;
+  memcpy(&pucPayload[psHdr->ulLen + 1], pvData, uLen);
+  uWriteMux(MUX_CH_LOG, &pucPayload[psHdr->ulLen], 1 + uLen);
+  psHdr->ulLen += 1 + uLen;
+
+  sStats.ulRecords++;
+  sStats.ulBytes += uLen;
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Commit current page, if it holds any records
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vFlushFlashLog(void)
+{
+  FlashLogHdrTypeDef* psHdr = (FlashLogHdrTypeDef*)aulPageBuf;
+  if (psHdr->ulLen == 0) return;
+
+  /* Erase-ahead has fallen behind                        */
+  if (uErasedAhead == 0) vEraseAhead();
+
+  psHdr->ulSeq = ulNextSeq;
+  psHdr->ulCheck = ulCalcPageCheck(psHdr);
+  unsigned uIndex = ulNextSeq % FLASHLOG_NUM_PAGES;
+  if (!bHW_FlashProgramPage(FLASH_DATA_ADDR + uIndex * HW_FLASH_PAGE_SIZE, aulPageBuf))
+  {
+    /* Page is skipped; it fails its CRC check on readout */
+    sStats.ulErrors++;
+  }
+  sStats.ulPages++;
+
+  ulNextSeq++;
+  uErasedAhead--;
+  memset(aulPageBuf, 0, sizeof(aulPageBuf));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Erase one page ahead of the write pointer, if required
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPollFlashLog(void)
+{
+  if (uErasedAhead < FLASHLOG_ERASE_AHEAD) vEraseAhead();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get logger status
+ *
+ * @param[out] *psInfo    Status
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetFlashLogInfo(FlashLogInfoTypeDef* psInfo)
+{
+  *psInfo = sStats;
+  psInfo->ulFirstSeq = (ulNextSeq >= FLASHLOG_NUM_PAGES) ? ulNextSeq - FLASHLOG_NUM_PAGES + 1 : 0;
+  psInfo->ulNextSeq = ulNextSeq;
+  psInfo->uPending = ((const FlashLogHdrTypeDef*)aulPageBuf)->ulLen;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get committed log page by sequence number
+ *
+ * @param[in] ulSeq       Page sequence number
+ * @return  (const FlashLogHdrTypeDef*)  Page in flash, or NULL if the page
+ *                      has been overwritten, erased or is invalid
+ * @date  18.10.2026
+ ******************************************************************************/
+const FlashLogHdrTypeDef* psGetFlashLogPage(uint32_t ulSeq)
+{
+  if ((ulSeq >= ulNextSeq) || (ulNextSeq - ulSeq >= FLASHLOG_NUM_PAGES)) return NULL;
+
+  unsigned uIndex = ulSeq % FLASHLOG_NUM_PAGES;
+  const FlashLogHdrTypeDef* psPage = psGetPage(uIndex);
+  return ((psPage->ulSeq == ulSeq) && bIsPageValid(uIndex)) ? psPage : NULL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print logger status
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPrintFlashLogInfo(void)
+{
+  FlashLogInfoTypeDef sInfo;
+  vGetFlashLogInfo(&sInfo);
+
+  printf("Flash log: %d pages of %d bytes at 0x%08lX\r\n",
+    FLASHLOG_NUM_PAGES, HW_FLASH_PAGE_SIZE, (uint32_t)FLASH_DATA_ADDR);
+  printf("Pages:     seq %lu .. %lu, %u bytes pending\r\n",
+    sInfo.ulFirstSeq, sInfo.ulNextSeq, sInfo.uPending);
+  printf("Records:   %lu (%lu bytes)\r\n", sInfo.ulRecords, sInfo.ulBytes);
+  printf("Flash ops: %lu programmed, %lu erased, %lu errors\r\n",
+    sInfo.ulPages, sInfo.ulErases, sInfo.ulErrors);
+
+  /* Flash bytes programmed per record byte, x100         */
+  if (sInfo.ulBytes > 0)
+  {
+    unsigned uAmp = (sInfo.ulPages * HW_FLASH_PAGE_SIZE * 100) / sInfo.ulBytes;
+    printf("Write amplification: %u.%02u\r\n", uAmp / 100, uAmp % 100);
+  }
+}
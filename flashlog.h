@@ -0,0 +1,74 @@
+/*!****************************************************************************
+ * @file
+ * flashlog.h
+ *
+ * @brief
+ * Circular data logger in the internal flash data area
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef FLASHLOG_H_
+#define FLASHLOG_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "hw_flash.h"
+#include "flash_layout.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Number of log pages in the data area                               */
+#define FLASHLOG_NUM_PAGES            (FLASH_DATA_SIZE / HW_FLASH_PAGE_SIZE)
+
+/*! @brief Number of pages kept erased ahead of the write pointer             */
+#define FLASHLOG_ERASE_AHEAD          2
+
+/*! @brief Page header size in bytes                                          */
+#define FLASHLOG_HDR_SIZE             12
+
+/*! @brief Record payload bytes per page                                      */
+#define FLASHLOG_PAYLOAD_SIZE         (HW_FLASH_PAGE_SIZE - FLASHLOG_HDR_SIZE)
+
+/*! @brief Maximum record length (one length byte per record)                 */
+#define FLASHLOG_MAX_RECORD           (FLASHLOG_PAYLOAD_SIZE - 1)
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Log page header, followed by FLASHLOG_PAYLOAD_SIZE payload bytes.
+ *
+ * The payload holds length-prefixed records (length byte, then data). Page
+ * sequence numbers increase by one per page, and a page with sequence number
+ * n is always stored at page index n % FLASHLOG_NUM_PAGES.                  */
+typedef struct
+{
+  uint32_t ulCheck;                   /*!< CRC-32 over rest of the page       */
+  uint32_t ulSeq;                     /*!< Page sequence number               */
+  uint32_t ulLen;                     /*!< Used payload bytes                 */
+} FlashLogHdrTypeDef;
+
+/*! @brief Logger status                                                      */
+typedef struct
+{
+  uint32_t ulFirstSeq;                /*!< Oldest possibly retained page      */
+  uint32_t ulNextSeq;                 /*!< Sequence number of next page       */
+  unsigned uPending;                  /*!< Payload bytes not yet committed    */
+  uint32_t ulRecords;                 /*!< Records logged since boot          */
+  uint32_t ulBytes;                   /*!< Record data bytes since boot       */
+  uint32_t ulPages;                   /*!< Pages programmed since boot        */
+  uint32_t ulErases;                  /*!< Pages erased since boot            */
+  uint32_t ulErrors;                  /*!< Page verification failures         */
+} FlashLogInfoTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vInitFlashLog(void);
+bool bWriteFlashLog(const void* pvData, unsigned uLen);
+void vFlushFlashLog(void);
+void vPollFlashLog(void);
+void vGetFlashLogInfo(FlashLogInfoTypeDef* psInfo);
+const FlashLogHdrTypeDef* psGetFlashLogPage(uint32_t ulSeq);
+void vPrintFlashLogInfo(void);
+
+#endif /* FLASHLOG_H_ */
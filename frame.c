@@ -0,0 +1,128 @@
+/*!****************************************************************************
+ * @file
+ * frame.c
+ *
+ * @brief
+ * COBS byte stuffing and CRC-16 for binary serial protocols
+ *
+ * Consistent Overhead Byte Stuffing removes all zero bytes from a block of
+ * data at a cost of at most one byte per 254 bytes, so FRAME_DELIM can be used
+ * to mark frame boundaries on a byte stream. See [1] for details.
+ *
+ * References:
+ *  [1] S. Cheshire, M. Baker - Consistent Overhead Byte Stuffing,
+ *      IEEE/ACM Transactions on Networking, Vol. 7, No. 2, April 1999
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "frame.h"
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! CRC-16/CCITT lookup table (polynomial 0x1021), one entry per nibble        */
+static const uint16_t auiCrc16Table[16] = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+
+/*!****************************************************************************
+ * @brief
+ * Calculate CRC-16/CCITT-FALSE over data block
+ *
+ * Pass FRAME_CRC16_INIT for the first block; pass the previous result to
+ * continue a calculation over multiple blocks.
+ *
+ * @param[in] *pucData    Data block
+ * @param[in] uLen        Data length in bytes
+ * @param[in] uiCrc       Initial CRC value
+ * @return  (uint16_t)  Updated CRC value
+ * @date  18.10.2026
+ ******************************************************************************/
+uint16_t uiCalcCrc16(const uint8_t* pucData, unsigned uLen, uint16_t uiCrc)
+{
+  while (uLen-- > 0)
+  {
+    uint8_t ucData = *pucData++;
+    uiCrc = (uiCrc << 4) ^ auiCrc16Table[(uiCrc >> 12) ^ (ucData >> 4)];
+    uiCrc = (uiCrc << 4) ^ auiCrc16Table[(uiCrc >> 12) ^ (ucData & 0x0F)];
+  }
+  return uiCrc;
+}
+
+/*!****************************************************************************
+ * @brief
+ * COBS-encode data block
+ *
+ * @note
+ * Output buffer must hold at least FRAME_COBS_MAX_LEN(uLen) bytes. Delimiters
+ * are not added.
+ *
+ * @param[in] *pucSrc     Input data
+ * @param[in] uLen        Input length in bytes
+ * @param[out] *pucDst    Output buffer
+ * @return  (unsigned)  Encoded length in bytes
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uEncodeCobs(const uint8_t* pucSrc, unsigned uLen, uint8_t* pucDst)
+{
+  uint8_t* pucCode = pucDst;
+  uint8_t* pucOut = pucDst + 1;
+  uint8_t ucCode = 1;
+
+  while (uLen-- > 0)
+  {
+    uint8_t ucData = *pucSrc++;
+    if (ucData != 0)
+    {
+      *pucOut++ = ucData;
+      ++ucCode;
+    }
+
+    /* Close block on zero byte or maximum block length   */
+    if ((ucData == 0) || (ucCode == 0xFF))
+    {
+      *pucCode = ucCode;
+      pucCode = pucOut++;
+      ucCode = 1;
+    }
+  }
+  *pucCode = ucCode;
+
+  return (unsigned)(pucOut - pucDst);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Decode COBS-encoded data block
+ *
+ * @note
+ * Decoding may be done in place (pucDst == pucSrc). Delimiters shall be
+ * removed before decoding.
+ *
+ * @param[in] *pucSrc     Encoded data
+ * @param[in] uLen        Encoded length in bytes
+ * @param[out] *pucDst    Output buffer, at least uLen bytes
+ * @return  (int)       Decoded length in bytes, or -1 if data is malformed
+ * @date  18.10.2026
+ ******************************************************************************/
+int iDecodeCobs(const uint8_t* pucSrc, unsigned uLen, uint8_t* pucDst)
+{
+  const uint8_t* pucEnd = pucSrc + uLen;
+  uint8_t* pucOut = pucDst;
+
+  while (pucSrc < pucEnd)
+  {
+    uint8_t ucCode = *pucSrc++;
+    if ((ucCode == 0) || (pucSrc + ucCode - 1 > pucEnd)) return -1;
+
+    /* Copy block data and re-insert zero byte, except after
+     * maximum-length blocks and at the end of the frame  */
+    for (uint8_t i = 1; i < ucCode; ++i) *pucOut++ = *pucSrc++;
+    if ((ucCode != 0xFF) && (pucSrc < pucEnd)) *pucOut++ = 0;
+  }
+
+  return (int)(pucOut - pucDst);
+}
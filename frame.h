@@ -0,0 +1,34 @@
+/*!****************************************************************************
+ * @file
+ * frame.h
+ *
+ * @brief
+ * COBS byte stuffing and CRC-16 for binary serial protocols
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef FRAME_H_
+#define FRAME_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Frame delimiter (never occurs in COBS-encoded data)                */
+#define FRAME_DELIM                   0x00
+
+/*! @brief CRC-16/CCITT-FALSE initial value                                   */
+#define FRAME_CRC16_INIT              0xFFFF
+
+/*! @brief Worst-case COBS-encoded length for n bytes of input                */
+#define FRAME_COBS_MAX_LEN(n)         ((n) + ((n) / 254) + 1)
+
+
+/*- Exported functions -------------------------------------------------------*/
+uint16_t uiCalcCrc16(const uint8_t* pucData, unsigned uLen, uint16_t uiCrc);
+unsigned uEncodeCobs(const uint8_t* pucSrc, unsigned uLen, uint8_t* pucDst);
+int iDecodeCobs(const uint8_t* pucSrc, unsigned uLen, uint8_t* pucDst);
+
+#endif /* FRAME_H_ */
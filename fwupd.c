@@ -0,0 +1,278 @@
+/*!****************************************************************************
+ * @file
+ * fwupd.c
+ *
+ * @brief
+ * Firmware update through the flash staging slot
+ *
+ * A new image (as produced by tools/image_trailer.py: application code up to
+ * and including the image trailer) is received in 128-byte pages and written
+ * to the staging slot using fast page programming while further data keeps
+ * arriving in the serial RX DMA buffer. Progress is checkpointed into the
+ * update state area every FWUPD_CHECKPOINT_PAGES pages, so an interrupted
+ * transfer can be resumed from the last checkpoint after a reset.
+ *
+ * On commit, the staged image is verified against the session CRC and its own
+ * trailer, and the session state is set to FWUPD_STATE_INSTALLING. The system
+ * is then reset into the installer (see installer.c), which copies the image
+ * over the application before starting it. A power loss during the copy only
+ * interrupts the installer, which continues the copy after the next reset.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Flush multiplexed output before install
+ * @date  18.10.2026  Installation moved to installer
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "ch32v10x.h"
+#include "hw_flash.h"
+#include "mux.h"
+#include "flash_layout.h"
+#include "offload.h"
+#include "image.h"
+#include "fwupd.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Number of words in a flash page                                    */
+#define FWUPD_PAGE_WORDS              (HW_FLASH_PAGE_SIZE / sizeof(uint32_t))
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Current session (copy of latest state record)                            */
+static FwUpdRecordTypeDef sSession;
+
+/*! Slot index of latest state record, or -1 if none                          */
+static int iRecordSlot = -1;
+
+/*! Pages written since last checkpoint                                       */
+static unsigned uPagesSinceCheckpoint;
+
+/*! Installation requested                                                    */
+static bool bInstallPending = false;
+
+/*! Page buffer                                                               */
+static uint32_t aulPageBuf[FWUPD_PAGE_WORDS];
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Calculate state record check value
+ *
+ * @param[in] *psRecord   State record
+ * @return  (uint32_t)  CRC-32 over all fields except ulCheck
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulCalcRecordCheck(const FwUpdRecordTypeDef* psRecord)
+{
+  return ulCalcCrc32Sw(psRecord, offsetof(FwUpdRecordTypeDef, ulCheck), OFFLOAD_CRC32_INIT);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write session state into the next state record slot
+ *
+ * @param[in] eState      New session state
+ * @return  (FwUpdResultTypeDef)  FWUPD_OK or FWUPD_ERR_FLASH
+ * @date  18.10.2026
+ ******************************************************************************/
+static FwUpdResultTypeDef eWriteCheckpoint(FwUpdStateTypeDef eState)
+{
+  sSession.ulMagic = FWUPD_RECORD_MAGIC;
+  sSession.ulSeq++;
+  sSession.ulState = eState;
+  sSession.ulCheck = ulCalcRecordCheck(&sSession);
+
+  iRecordSlot = (iRecordSlot + 1) % FWUPD_NUM_RECORDS;
+  memset(aulPageBuf, 0xFF, sizeof(aulPageBuf));
+  memcpy(aulPageBuf, &sSession, sizeof(sSession));
+  uPagesSinceCheckpoint = 0;
+
+  uint32_t ulAddress = FLASH_FWUPD_STATE_ADDR + iRecordSlot * HW_FLASH_PAGE_SIZE;
+  return bHW_FlashWritePage(ulAddress, aulPageBuf) ? FWUPD_OK : FWUPD_ERR_FLASH;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Verify staged image against session CRC and its own trailer
+ *
+ * @return  (bool)      true, if image is valid
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bVerifyStagedImage(void)
+{
+  const void* pvImage = (const void*)FLASH_STAGING_ADDR;
+  if (ulCalcCrc32(pvImage, sSession.ulSize) != sSession.ulCrc) return false;
+
+  /* Trailer must describe an application image covering
+   * everything up to the trailer                         */
+  unsigned uLength = sSession.ulSize - sizeof(ImageTrailerTypeDef);
+  const ImageTrailerTypeDef* psTrailer = (const void*)(FLASH_STAGING_ADDR + uLength);
+  return (psTrailer->ulMagic == IMAGE_TRAILER_MAGIC) &&
+    ((psTrailer->ulStart & (FLASH_BASE - 1)) == (FLASH_APP_ADDR & (FLASH_BASE - 1))) &&
+    (psTrailer->ulLength == uLength) &&
+    (psTrailer->ulCrc == ulCalcCrc32(pvImage, uLength));
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Load latest state record
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Clear pending installation
+ ******************************************************************************/
+void vInitFwUpd(void)
+{
+  memset(&sSession, 0, sizeof(sSession));
+  iRecordSlot = -1;
+  bInstallPending = false;
+
+  for (unsigned i = 0; i < FWUPD_NUM_RECORDS; ++i)
+  {
+    const FwUpdRecordTypeDef* psRecord = (const void*)(FLASH_FWUPD_STATE_ADDR + i * HW_FLASH_PAGE_SIZE);
+    if ((psRecord->ulMagic != FWUPD_RECORD_MAGIC) || (psRecord->ulCheck != ulCalcRecordCheck(psRecord))) continue;
+    if ((iRecordSlot < 0) || ((int32_t)(psRecord->ulSeq - sSession.ulSeq) > 0))
+    {
+      sSession = *psRecord;
+      iRecordSlot = i;
+    }
+  }
+
+  /* The installer has finished if we are running         */
+  if (sSession.ulState == FWUPD_STATE_INSTALLING)
+  {
+    eWriteCheckpoint(FWUPD_STATE_IDLE);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Start or resume update session
+ *
+ * A session with identical size and CRC is resumed from its last checkpoint.
+ *
+ * @param[in] ulSize      Image size in bytes
+ * @param[in] ulCrc       Image CRC-32
+ * @param[out] *pulNextOfs  Offset at which to continue sending data
+ * @return  (FwUpdResultTypeDef)  Result
+ * @date  18.10.2026
+ ******************************************************************************/
+FwUpdResultTypeDef eBeginFwUpd(uint32_t ulSize, uint32_t ulCrc, uint32_t* pulNextOfs)
+{
+  if (bInstallPending) return FWUPD_ERR_STATE;
+  if ((ulSize < sizeof(ImageTrailerTypeDef)) || (ulSize > FLASH_APP_SIZE) ||
+    (ulSize > FLASH_STAGING_SIZE) || (ulSize % 4 != 0)) return FWUPD_ERR_ARG;
+
+  bool bResume = ((sSession.ulState == FWUPD_STATE_RECEIVING) || (sSession.ulState == FWUPD_STATE_COMPLETE)) &&
+    (sSession.ulSize == ulSize) && (sSession.ulCrc == ulCrc);
+  if (!bResume)
+  {
+    sSession.ulSize = ulSize;
+    sSession.ulCrc = ulCrc;
+    sSession.ulNextOfs = 0;
+    FwUpdResultTypeDef eResult = eWriteCheckpoint(FWUPD_STATE_RECEIVING);
+    if (eResult != FWUPD_OK) return eResult;
+  }
+
+  uPagesSinceCheckpoint = 0;
+  *pulNextOfs = sSession.ulNextOfs;
+  return FWUPD_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write image data into staging slot
+ *
+ * @note
+ * Data must be sent in order, one page per call. Only the last page of the
+ * image may be shorter than HW_FLASH_PAGE_SIZE.
+ *
+ * @param[in] ulOffset    Image offset, must match the next expected offset
+ * @param[in] *pucData    Data
+ * @param[in] uLen        Data length in bytes
+ * @return  (FwUpdResultTypeDef)  Result
+ * @date  18.10.2026
+ ******************************************************************************/
+FwUpdResultTypeDef eWriteFwUpd(uint32_t ulOffset, const uint8_t* pucData, unsigned uLen)
+{
+  if (sSession.ulState != FWUPD_STATE_RECEIVING) return FWUPD_ERR_STATE;
+  if ((ulOffset != sSession.ulNextOfs) || (uLen == 0) || (uLen > HW_FLASH_PAGE_SIZE)) return FWUPD_ERR_ARG;
+  if ((uLen < HW_FLASH_PAGE_SIZE) ? (ulOffset + uLen != sSession.ulSize) : (ulOffset + uLen > sSession.ulSize)) return FWUPD_ERR_ARG;
+
+  /* Program page; a short last page is padded            */
+  memset(aulPageBuf, 0xFF, sizeof(aulPageBuf));
+  memcpy(aulPageBuf, pucData, uLen);
+  if (!bHW_FlashWritePage(FLASH_STAGING_ADDR + ulOffset, aulPageBuf)) return FWUPD_ERR_FLASH;
+  sSession.ulNextOfs += uLen;
+
+  /* Checkpoint progress                                  */
+  if (sSession.ulNextOfs == sSession.ulSize)
+  {
+    return eWriteCheckpoint(FWUPD_STATE_COMPLETE);
+  }
+  if (++uPagesSinceCheckpoint >= FWUPD_CHECKPOINT_PAGES)
+  {
+    return eWriteCheckpoint(FWUPD_STATE_RECEIVING);
+  }
+  return FWUPD_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Verify staged image and schedule installation
+ *
+ * The installation starts from vPollFwUpd(), so a response can be sent first.
+ *
+ * @return  (FwUpdResultTypeDef)  Result
+ * @date  18.10.2026
+ ******************************************************************************/
+FwUpdResultTypeDef eCommitFwUpd(void)
+{
+  if (sSession.ulState != FWUPD_STATE_COMPLETE) return FWUPD_ERR_STATE;
+  if (!bVerifyStagedImage()) return FWUPD_ERR_IMAGE;
+
+  FwUpdResultTypeDef eResult = eWriteCheckpoint(FWUPD_STATE_INSTALLING);
+  if (eResult == FWUPD_OK) bInstallPending = true;
+  return eResult;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get session status
+ *
+ * @param[out] *psStatus  Status
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetFwUpdStatus(FwUpdStatusTypeDef* psStatus)
+{
+  psStatus->eState = sSession.ulState;
+  psStatus->ulSize = sSession.ulSize;
+  psStatus->ulCrc = sSession.ulCrc;
+  psStatus->ulNextOfs = sSession.ulNextOfs;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reset into the installer for a committed image; does not return in that
+ * case
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Flush multiplexed output
+ * @date  18.10.2026  Installation moved to installer
+ ******************************************************************************/
+void vPollFwUpd(void)
+{
+  if (!bInstallPending) return;
+
+  /* Finish pending output, then let the installer replace
+   * the application                                      */
+  fflush(stdout);
+  vFlushMux();
+  PFIC_SystemReset();
+}
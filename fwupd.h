@@ -0,0 +1,87 @@
+/*!****************************************************************************
+ * @file
+ * fwupd.h
+ *
+ * @brief
+ * Firmware update through the flash staging slot
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  State record layout shared with installer
+ * @date  18.10.2026  Added failed state
+ ******************************************************************************/
+
+#ifndef FWUPD_H_
+#define FWUPD_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+#include "hw_flash.h"
+#include "flash_layout.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Number of programmed pages between two progress checkpoints        */
+#define FWUPD_CHECKPOINT_PAGES        8
+
+/*! @brief State record marker                                                */
+#define FWUPD_RECORD_MAGIC            0x44505546UL
+
+/*! @brief Number of state record slots (one fast page each)                  */
+#define FWUPD_NUM_RECORDS             (FLASH_FWUPD_STATE_SIZE / HW_FLASH_PAGE_SIZE)
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Update session state                                               */
+typedef enum
+{
+  FWUPD_STATE_IDLE = 0,               /*!< No update in progress              */
+  FWUPD_STATE_RECEIVING,              /*!< Image is being received            */
+  FWUPD_STATE_COMPLETE,               /*!< Image received, not yet verified   */
+  FWUPD_STATE_INSTALLING,             /*!< Image verified, being installed    */
+  FWUPD_STATE_FAILED                  /*!< Installation given up by installer;
+                                           application may be incomplete      */
+} FwUpdStateTypeDef;
+
+/*! @brief Operation result                                                   */
+typedef enum
+{
+  FWUPD_OK = 0,                       /*!< Success                            */
+  FWUPD_ERR_ARG,                      /*!< Invalid size, offset or length     */
+  FWUPD_ERR_STATE,                    /*!< Not allowed in current state       */
+  FWUPD_ERR_FLASH,                    /*!< Flash verification failed          */
+  FWUPD_ERR_IMAGE                     /*!< Image CRC or trailer invalid       */
+} FwUpdResultTypeDef;
+
+/*! @brief State record, stored at the start of a state area page. The record
+ *  with the highest sequence number is the current one; records are also
+ *  read by the installer (see installer.c).                                 */
+typedef struct
+{
+  uint32_t ulMagic;                   /*!< FWUPD_RECORD_MAGIC                 */
+  uint32_t ulSeq;                     /*!< Record sequence number             */
+  uint32_t ulState;                   /*!< FwUpdStateTypeDef                  */
+  uint32_t ulSize;                    /*!< Image size in bytes                */
+  uint32_t ulCrc;                     /*!< Expected image CRC-32              */
+  uint32_t ulNextOfs;                 /*!< Data below this offset is written  */
+  uint32_t ulCheck;                   /*!< CRC-32 over preceding fields       */
+} FwUpdRecordTypeDef;
+
+/*! @brief Session status                                                     */
+typedef struct
+{
+  FwUpdStateTypeDef eState;           /*!< Session state                      */
+  uint32_t ulSize;                    /*!< Image size in bytes                */
+  uint32_t ulCrc;                     /*!< Expected image CRC-32              */
+  uint32_t ulNextOfs;                 /*!< Offset of next expected data       */
+} FwUpdStatusTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vInitFwUpd(void);
+FwUpdResultTypeDef eBeginFwUpd(uint32_t ulSize, uint32_t ulCrc, uint32_t* pulNextOfs);
+FwUpdResultTypeDef eWriteFwUpd(uint32_t ulOffset, const uint8_t* pucData, unsigned uLen);
+FwUpdResultTypeDef eCommitFwUpd(void);
+void vGetFwUpdStatus(FwUpdStatusTypeDef* psStatus);
+void vPollFwUpd(void);
+
+#endif /* FWUPD_H_ */
@@ -0,0 +1,57 @@
+/*!****************************************************************************
+ * @file
+ * hexdump.c
+ *
+ * @brief
+ * Hexdump printout of memory buffers
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include <ctype.h>
+#include "hexdump.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Hexdump items per row                                              */
+#define HEXDUMP_ROW_ITEMS             16
+
+
+/*!****************************************************************************
+ * @brief
+ * Print Hexdump of memory buffer
+ *
+ * @param[in] *pBuffer    Data buffer
+ * @param[in] uLen        Number of bytes to display
+ * @param[in] uBaseAdr    Base address for row counters
+ * @date  10.03.2022
+ * @date  18.10.2026  Moved from main.c into separate module
+ ******************************************************************************/
+void vPrintHexDump(const uint8_t* pBuffer, unsigned uLen, unsigned uBaseAdr)
+{
+  for (unsigned uRow = 0; uRow < uLen / HEXDUMP_ROW_ITEMS; ++uRow)
+  {
+    /* Address or Offset                                  */
+    unsigned uRowAddr = uRow * HEXDUMP_ROW_ITEMS;
+    printf("%08x  ", uRowAddr + uBaseAdr);
+
+    /* Byte columns                                       */
+    for (unsigned uCol = 0; uCol < HEXDUMP_ROW_ITEMS; ++uCol)
+    {
+      unsigned char ucData = pBuffer[uRowAddr + uCol];
+      printf("%02x ", ucData);
+      if (uCol == (HEXDUMP_ROW_ITEMS / 2 - 1)) putchar(' ');
+    }
+
+    /* ASCII text representation                          */
+    putchar(' ');
+    for (unsigned uCol = 0; uCol < HEXDUMP_ROW_ITEMS; ++uCol)
+    {
+      unsigned char ucData = pBuffer[uRowAddr + uCol];
+      putchar(isprint(ucData) ? ucData : '.');
+    }
+    printf("\r\n");
+  }
+}
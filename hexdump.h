@@ -0,0 +1,21 @@
+/*!****************************************************************************
+ * @file
+ * hexdump.h
+ *
+ * @brief
+ * Hexdump printout of memory buffers
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef HEXDUMP_H_
+#define HEXDUMP_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vPrintHexDump(const uint8_t* pBuffer, unsigned uLen, unsigned uBaseAdr);
+
+#endif /* HEXDUMP_H_ */
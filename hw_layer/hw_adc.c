@@ -6,16 +6,26 @@
  * Low-level ADC setup
  *
  * @date  24.02.2022
+ * @date  18.10.2026  Separated conversion math from hardware access
+ * @date  18.10.2026  Power-on delay follows HCLK changes
+ * @date  18.10.2026  Added continuous capture by DMA
+ * @date  18.10.2026  Added injected conversion for control loops
+ * @date  18.10.2026  Power-on delay and calibration separated from init
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
 #include "ch32v10x.h"
+#include "hw_clk.h"
+#include "hw_dma.h"
+#include "hw_irq.h"
+#include "hw_stk.h"
 #include "hw_adc.h"
 
 
 /*- Macros -------------------------------------------------------------------*/
-/*! ADC power-on delay in SysTick timer counts                                */
-#define ADC_TSTAB_TICKS               ((HSI_VALUE / 8) / 1000000) /* 1 us     */
+/*! ADC power-on delay in us                                                  */
+#define ADC_TSTAB_US                  1
 
 /*! VDDA nominal voltage in mV                                                */
 #define ADC_VDDA_NOM                  3300
@@ -49,8 +59,35 @@
 /*! Selected ADC sample time for software-triggered conversion                */
 #define ADC_SAMPLE_TIME               ADC_SampleTime_239Cycles5
 
+/*! Conversion time in addition to the sample time, in half ADC clock cycles  */
+#define ADC_CONV_HALF_CYCLES          25
+
+/*! DMA channel, interrupt and flags assigned to ADC1
+ *  @{                                                                        */
+#define ADC_DMA_CHANNEL               DMA1_Channel1
+#define ADC_DMA_IRQn                  DMA1_Channel1_IRQn
+#define ADC_DMA_IT_HT                 DMA1_IT_HT1
+#define ADC_DMA_IT_TC                 DMA1_IT_TC1
+#define ADC_DMA_IT_GL                 DMA1_IT_GL1
+/*! @}                                                                        */
+
 
 /*- Private variables --------------------------------------------------------*/
+/*! Sample times in half ADC clock cycles, indexed by ADC_SampleTime_x        */
+static const uint16_t auiSampleHalfCycles[8] = { 3, 15, 27, 57, 83, 111, 143, 479 };
+
+/*! Capture block callback, NULL if no capture is running                    */
+static HwAdcBlockTypeDef pvCaptureBlock;
+
+/*! Capture buffer                                                            */
+static const uint16_t* puiCaptureBuf;
+
+/*! Capture buffer half length in samples                                     */
+static unsigned uCaptureHalf;
+
+/*! SysTick count at power-on by vInitHW_ADC()                                */
+static uint32_t ulPowerOnTicks;
+
 #ifdef USE_ADC_CAL
 /*! ADC calibration value                                                     */
 static uint16_t uiCalibrationValue;
@@ -63,12 +100,14 @@ static uint16_t uiCalibrationValue;
  * Power-on delay (tSTAB), uses SysTick @ HCLK/8
  *
  * @date  24.02.2022
+ * @date  18.10.2026  Converted to SysTick counts at current HCLK
  ******************************************************************************/
 static void vWait_tSTAB(void)
 {
+  uint32_t ulTicks = ulHW_STK_UsToTicks(ADC_TSTAB_US);
   uint32_t ulStartTime = SysTick_GetValueLow();
   uint32_t ulNow = ulStartTime;
-  while (ulNow - ulStartTime < ADC_TSTAB_TICKS) ulNow = SysTick_GetValueLow();
+  while (ulNow - ulStartTime < ulTicks) ulNow = SysTick_GetValueLow();
 }
 
 #ifdef USE_ADC_CAL
@@ -107,11 +146,34 @@ static uint16_t uiApplyCalibration(uint16_t uiConvVal)
 #endif /* USE_ADC_CAL */
 
 
+/*!****************************************************************************
+ * @brief
+ * Configure ADC for software-triggered conversion of a single channel
+ *
+ * @param[in] eContinuous Repeat conversions until stopped
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vConfigAdc(FunctionalState eContinuous)
+{
+  ADC_InitTypeDef sInit = {
+    .ADC_ContinuousConvMode = eContinuous,
+    .ADC_ExternalTrigConv = ADC_ExternalTrigConv_None,
+    .ADC_NbrOfChannel = 1
+  };
+  ADC_Init(ADC1, &sInit);
+}
+
+
 /*!****************************************************************************
  * @brief
  * Initialise ADC peripheral
  *
+ * Returns without waiting for the power-on delay, see bHW_IsAdcReady().
+ *
  * @date  24.02.2022
+ * @date  18.10.2026  Moved base configuration into vConfigAdc()
+ * @date  18.10.2026  Power-on delay and calibration moved into
+ *                    bHW_IsAdcReady() and vHW_CalibrateAdc()
  ******************************************************************************/
 void vInitHW_ADC(void)
 {
@@ -120,26 +182,91 @@ void vInitHW_ADC(void)
 
   /* Set up base peripheral for software-triggered conver-
    * sion of a single channel                             */
-  ADC_InitTypeDef sInit = {
-    .ADC_ExternalTrigConv = ADC_ExternalTrigConv_None,
-    .ADC_NbrOfChannel = 1
-  };
-  ADC_Init(ADC1, &sInit);
+  vConfigAdc(DISABLE);
 
   /* Enable temperature sensor channel and wake up ADC from
    * power-down mode                                      */
   ADC_TempSensorVrefintCmd(ENABLE);
   ADC_Cmd(ADC1, ENABLE);
+  ulPowerOnTicks = SysTick_GetValueLow();
+}
 
-  /* Power-on delay                                       */
-  vWait_tSTAB();
+/*!****************************************************************************
+ * @brief
+ * Check if the power-on delay (tSTAB) after vInitHW_ADC() has elapsed
+ *
+ * @return  (bool)  true if conversions may be started
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_IsAdcReady(void)
+{
+  return SysTick_GetValueLow() - ulPowerOnTicks >= ulHW_STK_UsToTicks(ADC_TSTAB_US);
+}
 
+/*!****************************************************************************
+ * @brief
+ * Run calibration sequence, if enabled by USE_ADC_CAL
+ *
+ * Conversion values are not compensated before calibration has run. The ADC
+ * shall be ready, see bHW_IsAdcReady().
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_CalibrateAdc(void)
+{
 #ifdef USE_ADC_CAL
-  /* Run calibration sequence                             */
   uiCalibrationValue = Get_CalibrationValue(ADC1);
 #endif /* USE_ADC_CAL */
 }
 
+/*!****************************************************************************
+ * @brief
+ * Convert raw conversion value into compensated value in unit of millivolts
+ *
+ * @param[in] uiConvVal   Raw conversion value
+ * @return  (uint16_t)  Compensated conversion value in mV
+ * @date  18.10.2026
+ ******************************************************************************/
+uint16_t uiHW_ConvertAdcValue_mV(uint16_t uiConvVal)
+{
+#ifdef USE_ADC_CAL
+  return (ADC_VDDA_NOM * uiApplyCalibration(uiConvVal)) >> ADC_RES_BITS;
+#else
+  return (ADC_VDDA_NOM * uiConvVal) >> ADC_RES_BITS;
+#endif /* USE_ADC_CAL */
+}
+
+/*!****************************************************************************
+ * @brief
+ * Convert raw conversion value with fractional bits into microvolts
+ *
+ * No calibration offset is applied, so the function is suitable for signal
+ * amplitudes as well as absolute values.
+ *
+ * @param[in] ulConvVal   Raw conversion value, scaled by 2^uFracBits
+ * @param[in] uFracBits   Number of fractional bits
+ * @return  (uint32_t)  Value in uV
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulHW_ConvertAdcValue_uV(uint32_t ulConvVal, unsigned uFracBits)
+{
+  return (uint32_t)(((uint64_t)ulConvVal * ADC_VDDA_NOM * 1000) >> (ADC_RES_BITS + uFracBits));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Convert voltage into raw conversion value, without calibration
+ *
+ * @param[in] uiVoltage   Voltage in mV
+ * @return  (uint16_t)  Raw conversion value, saturated to ADC range
+ * @date  18.10.2026
+ ******************************************************************************/
+uint16_t uiHW_ConvertAdcMvToValue(uint16_t uiVoltage)
+{
+  uint32_t ulConvVal = ((uint32_t)uiVoltage << ADC_RES_BITS) / ADC_VDDA_NOM;
+  return (ulConvVal > ADC_MAX_VAL) ? ADC_MAX_VAL : (uint16_t)ulConvVal;
+}
+
 /*!****************************************************************************
  * @brief
  * Start software-triggered conversion and get compensated conversion value in
@@ -148,6 +275,7 @@ void vInitHW_ADC(void)
  * @param[in] ucChannel Selected ADC channel to start conversion on
  * @return  (uint16_t)  Compensated conversion value in mV
  * @date  24.02.2022
+ * @date  18.10.2026  Moved conversion math into separate function
  ******************************************************************************/
 uint16_t uiHW_GetAdcConversionValue_mV(uint8_t ucChannel)
 {
@@ -163,9 +291,176 @@ uint16_t uiHW_GetAdcConversionValue_mV(uint8_t ucChannel)
 
   /* Apply calibration compensation and convert to milli-
    * volts                                                */
-#ifdef USE_ADC_CAL
-  return (ADC_VDDA_NOM * uiApplyCalibration(uiConvVal)) >> ADC_RES_BITS;
-#else
-  return (ADC_VDDA_NOM * uiConvVal) >> ADC_RES_BITS;
-#endif /* USE_ADC_CAL */
+  return uiHW_ConvertAdcValue_mV(uiConvVal);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Start continuous conversion of a channel into a circular buffer
+ *
+ * Samples are transferred by DMA. The block callback is invoked from the DMA
+ * interrupt whenever one half of the buffer has been filled, and the data in
+ * that half remains valid until the other half has been filled.
+ *
+ * @note
+ * Single conversions by uiHW_GetAdcConversionValue_mV() shall not be
+ * started while the capture is running.
+ *
+ * @param[in] ucChannel   ADC channel
+ * @param[in] ucSampleTime Sample time (ADC_SampleTime_x)
+ * @param[out] *puiBuf    Capture buffer
+ * @param[in] uLen        Capture buffer length in samples (even)
+ * @param[in] pvBlock     Block callback
+ * @return  (bool)  true if the capture was started
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_StartAdcCapture(uint8_t ucChannel, uint8_t ucSampleTime, uint16_t* puiBuf, unsigned uLen, HwAdcBlockTypeDef pvBlock)
+{
+  if ((pvCaptureBlock != NULL) || (pvBlock == NULL)) return false;
+  if ((uLen < 2) || ((uLen % 2) != 0) || (uLen > DMA_MAX_TRANSFER)) return false;
+  if (ucSampleTime >= sizeof(auiSampleHalfCycles) / sizeof(auiSampleHalfCycles[0])) return false;
+
+  pvCaptureBlock = pvBlock;
+  puiCaptureBuf = puiBuf;
+  uCaptureHalf = uLen / 2;
+
+  /* Circular transfer from data register, interrupts at
+   * half and full buffer                                 */
+  DMA_DeInit(ADC_DMA_CHANNEL);
+  DMA_InitTypeDef sInitDma = {
+    .DMA_PeripheralBaseAddr = (uint32_t)&ADC1->RDATAR,
+    .DMA_MemoryBaseAddr = (uint32_t)puiBuf,
+    .DMA_DIR = DMA_DIR_PeripheralSRC,
+    .DMA_BufferSize = uLen,
+    .DMA_PeripheralInc = DMA_PeripheralInc_Disable,
+    .DMA_MemoryInc = DMA_MemoryInc_Enable,
+    .DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord,
+    .DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord,
+    .DMA_Mode = DMA_Mode_Circular,
+    .DMA_Priority = DMA_Priority_Medium,
+    .DMA_M2M = DMA_M2M_Disable
+  };
+  DMA_Init(ADC_DMA_CHANNEL, &sInitDma);
+  DMA_ClearITPendingBit(ADC_DMA_IT_GL);
+  DMA_ITConfig(ADC_DMA_CHANNEL, DMA_IT_HT | DMA_IT_TC, ENABLE);
+  DMA_Cmd(ADC_DMA_CHANNEL, ENABLE);
+  bHW_IrqCmd(ADC_DMA_IRQn, ENABLE);
+
+  /* Start continuous conversion                          */
+  ADC_RegularChannelConfig(ADC1, ucChannel, 1, ucSampleTime);
+  vConfigAdc(ENABLE);
+  ADC_DMACmd(ADC1, ENABLE);
+  ADC_SoftwareStartConvCmd(ADC1, ENABLE);
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Stop continuous conversion and return to single conversions
+ *
+ * The ADC is powered down to abort a running conversion, so that no stale
+ * result is left for the next single conversion.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_StopAdcCapture(void)
+{
+  if (pvCaptureBlock == NULL) return;
+
+  ADC_Cmd(ADC1, DISABLE);
+  ADC_DMACmd(ADC1, DISABLE);
+  vConfigAdc(DISABLE);
+
+  bHW_IrqCmd(ADC_DMA_IRQn, DISABLE);
+  DMA_Cmd(ADC_DMA_CHANNEL, DISABLE);
+  DMA_ITConfig(ADC_DMA_CHANNEL, DMA_IT_HT | DMA_IT_TC, DISABLE);
+  DMA_ClearITPendingBit(ADC_DMA_IT_GL);
+  pvCaptureBlock = NULL;
+
+  /* Power up again                                       */
+  ADC_Cmd(ADC1, ENABLE);
+  vWait_tSTAB();
+  ADC_ClearFlag(ADC1, ADC_FLAG_EOC);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get sample rate of continuous conversion at current ADC clock
+ *
+ * @param[in] ucSampleTime Sample time (ADC_SampleTime_x)
+ * @return  (uint32_t)  Sample rate in Hz
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulHW_GetAdcSampleRate(uint8_t ucSampleTime)
+{
+  HwClkFreqTypeDef sFreq;
+  vHW_GetClockFreq(&sFreq);
+  return 2 * sFreq.ulAdcclk / (auiSampleHalfCycles[ucSampleTime & 7] + ADC_CONV_HALF_CYCLES);
+}
+
+/*!****************************************************************************
+ * @brief
+ * ADC DMA channel interrupt handler, passes completed buffer halves to the
+ * block callback
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_HandleAdcDmaIrq(void)
+{
+  if (DMA_GetITStatus(ADC_DMA_IT_HT) == SET)
+  {
+    DMA_ClearITPendingBit(ADC_DMA_IT_HT);
+    if (pvCaptureBlock != NULL) pvCaptureBlock(puiCaptureBuf, uCaptureHalf);
+  }
+  if (DMA_GetITStatus(ADC_DMA_IT_TC) == SET)
+  {
+    DMA_ClearITPendingBit(ADC_DMA_IT_TC);
+    if (pvCaptureBlock != NULL) pvCaptureBlock(&puiCaptureBuf[uCaptureHalf], uCaptureHalf);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Select channel for software-triggered injected conversion
+ *
+ * Injected conversions take precedence over regular conversions and have a
+ * separate data register, so a control loop can sample its feedback input
+ * alongside single conversions and capture.
+ *
+ * @param[in] ucChannel   ADC channel
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_ConfigAdcInjected(uint8_t ucChannel)
+{
+  ADC_ExternalTrigInjectedConvConfig(ADC1, ADC_ExternalTrigInjecConv_None);
+  ADC_InjectedSequencerLengthConfig(ADC1, 1);
+  ADC_InjectedChannelConfig(ADC1, ucChannel, 1, ADC_SAMPLE_TIME);
+  ADC_ClearFlag(ADC1, ADC_FLAG_JEOC);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Start injected conversion
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_StartAdcInjected(void)
+{
+  ADC_SoftwareStartInjectedConvCmd(ADC1, ENABLE);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fetch result of the last injected conversion
+ *
+ * @param[out] *puiConvVal Raw conversion value
+ * @return  (bool)  true if a new conversion result was available
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_GetAdcInjectedValue(uint16_t* puiConvVal)
+{
+  if (ADC_GetFlagStatus(ADC1, ADC_FLAG_JEOC) != SET) return false;
+  ADC_ClearFlag(ADC1, ADC_FLAG_JEOC);
+  *puiConvVal = ADC_GetInjectedConversionValue(ADC1, ADC_InjectedChannel_1);
+  return true;
 }
@@ -6,17 +6,41 @@
  * Low-level ADC setup
  *
  * @date  24.02.2022
+ * @date  18.10.2026  Added continuous capture by DMA
+ * @date  18.10.2026  Added injected conversion for control loops
+ * @date  18.10.2026  Power-on delay and calibration separated from init
  ******************************************************************************/
 
 #ifndef HW_ADC_H_
 #define HW_ADC_H_
 
 /*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
 #include <stdint.h>
 
 
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Capture block callback, called from the DMA interrupt for each
+ *  completed half of the capture buffer                                      */
+typedef void (*HwAdcBlockTypeDef)(const uint16_t* puiBlock, unsigned uLen);
+
+
 /*- Exported functions -------------------------------------------------------*/
 void vInitHW_ADC(void);
+bool bHW_IsAdcReady(void);
+void vHW_CalibrateAdc(void);
+uint16_t uiHW_ConvertAdcValue_mV(uint16_t uiConvVal);
+uint32_t ulHW_ConvertAdcValue_uV(uint32_t ulConvVal, unsigned uFracBits);
+uint16_t uiHW_ConvertAdcMvToValue(uint16_t uiVoltage);
 uint16_t uiHW_GetAdcConversionValue_mV(uint8_t ucChannel);
 
+void vHW_ConfigAdcInjected(uint8_t ucChannel);
+void vHW_StartAdcInjected(void);
+bool bHW_GetAdcInjectedValue(uint16_t* puiConvVal);
+
+bool bHW_StartAdcCapture(uint8_t ucChannel, uint8_t ucSampleTime, uint16_t* puiBuf, unsigned uLen, HwAdcBlockTypeDef pvBlock);
+void vHW_StopAdcCapture(void);
+uint32_t ulHW_GetAdcSampleRate(uint8_t ucSampleTime);
+void vHW_HandleAdcDmaIrq(void);
+
 #endif /* HW_ADC_H_ */
@@ -0,0 +1,329 @@
+/*!****************************************************************************
+ * @file
+ * hw_clk.c
+ *
+ * @brief
+ * Runtime clock tree configuration
+ *
+ * Switches SYSCLK between a fixed set of clock tree configurations. The
+ * switch is done from HSI: SYSCLK is moved to HSI, the bus prescalers and
+ * flash wait states are set, and then the target source is started and
+ * selected. Modules deriving settings from a bus clock register a notifier,
+ * which is called after each switch with the new frequencies.
+ *
+ * vHW_CalcClockTree() and uHW_CalcFlashLatency() only calculate and do not
+ * access the hardware.
+ *
+ * @note
+ * Characters on the serial port while switching are lost or garbled; flush
+ * the output before switching.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
+#include "ch32v10x.h"
+#include "hw_clk.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Maximum SYSCLK for each flash wait state count                     */
+#define HW_CLK_FLASH_0WS_MAX          24000000UL
+#define HW_CLK_FLASH_1WS_MAX          48000000UL
+
+/*! @brief RCC_GetSYSCLKSource() values                                       */
+#define HW_CLK_SWS_HSI                0x00
+#define HW_CLK_SWS_HSE                0x04
+#define HW_CLK_SWS_PLL                0x08
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief SYSCLK source                                                      */
+typedef enum
+{
+  HW_CLK_SRC_HSI = 0,                 /*!< HSI                                */
+  HW_CLK_SRC_HSE,                     /*!< HSE                                */
+  HW_CLK_SRC_PLL_HSI,                 /*!< PLL, from HSI/2                    */
+  HW_CLK_SRC_PLL_HSE                  /*!< PLL, from HSE                      */
+} HwClkSrcTypeDef;
+
+/*! @brief Clock tree configuration. HCLK and PCLK2 are always SYSCLK.        */
+typedef struct
+{
+  const char* pszName;                /*!< Display name                       */
+  HwClkSrcTypeDef eSource;            /*!< SYSCLK source                      */
+  uint8_t ucPllMul;                   /*!< PLL multiplier, 2 .. 16            */
+  uint8_t ucPclk1Div;                 /*!< APB1 prescaler, 1 or 2 (<= 36 MHz) */
+  uint8_t ucAdcDiv;                   /*!< ADC prescaler, 2 .. 8 (<= 14 MHz)  */
+} HwClkPresetTypeDef;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Clock tree configurations, indexed by HwClkConfigTypeDef                  */
+static const HwClkPresetTypeDef asPresets[HW_CLK_NUM_CONFIGS] = {
+  { "HSI 8 MHz",      HW_CLK_SRC_HSI,     0,  1, 2 },
+  { "HSE 8 MHz",      HW_CLK_SRC_HSE,     0,  1, 2 },
+  { "PLL HSI 48 MHz", HW_CLK_SRC_PLL_HSI, 12, 2, 4 },
+  { "PLL HSE 72 MHz", HW_CLK_SRC_PLL_HSE, 9,  2, 6 }
+};
+
+/*! ADC prescaler settings for a prescaler of 2, 4, 6, 8                      */
+static const uint32_t aulAdcDivCfg[4] = {
+  RCC_PCLK2_Div2, RCC_PCLK2_Div4, RCC_PCLK2_Div6, RCC_PCLK2_Div8
+};
+
+/*! Active configuration                                                      */
+static HwClkConfigTypeDef eCurrent = HW_CLK_NUM_CONFIGS;
+
+/*! Active bus clock frequencies                                              */
+static HwClkFreqTypeDef sCurrentFreq;
+
+/*! Registered notifiers                                                      */
+static HwClkNotifierTypeDef apvNotifiers[HW_CLK_MAX_NOTIFIERS];
+
+/*! Number of registered notifiers                                            */
+static unsigned uNumNotifiers;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Read active bus clock frequencies from the RCC
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vReadClockFreq(void)
+{
+  RCC_ClocksTypeDef sClocks;
+  RCC_GetClocksFreq(&sClocks);
+  sCurrentFreq.ulSysclk = sClocks.SYSCLK_Frequency;
+  sCurrentFreq.ulHclk = sClocks.HCLK_Frequency;
+  sCurrentFreq.ulPclk1 = sClocks.PCLK1_Frequency;
+  sCurrentFreq.ulPclk2 = sClocks.PCLK2_Frequency;
+  sCurrentFreq.ulAdcclk = sClocks.ADCCLK_Frequency;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Select SYSCLK source and wait until it is active
+ *
+ * @param[in] ulSource    RCC_SYSCLKSource_x
+ * @param[in] ucStatus    Matching RCC_GetSYSCLKSource() value
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vSelectSysclk(uint32_t ulSource, uint8_t ucStatus)
+{
+  RCC_SYSCLKConfig(ulSource);
+  while (RCC_GetSYSCLKSource() != ucStatus);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Determine startup clock configuration
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vInitHW_CLK(void)
+{
+  SystemCoreClockUpdate();
+  vReadClockFreq();
+
+  /* Startup configuration from SystemInit() is reported as
+   * a preset, if source and frequencies match            */
+  static const uint8_t aucSws[] = { HW_CLK_SWS_HSI, HW_CLK_SWS_HSE, HW_CLK_SWS_PLL, HW_CLK_SWS_PLL };
+  eCurrent = HW_CLK_NUM_CONFIGS;
+  for (unsigned i = 0; i < HW_CLK_NUM_CONFIGS; ++i)
+  {
+    HwClkFreqTypeDef sFreq;
+    vHW_CalcClockTree(i, &sFreq);
+    if ((RCC_GetSYSCLKSource() == aucSws[asPresets[i].eSource]) &&
+      (sFreq.ulSysclk == sCurrentFreq.ulSysclk) && (sFreq.ulHclk == sCurrentFreq.ulHclk) &&
+      (sFreq.ulPclk1 == sCurrentFreq.ulPclk1) && (sFreq.ulPclk2 == sCurrentFreq.ulPclk2))
+    {
+      eCurrent = i;
+      break;
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Register clock change notifier
+ *
+ * @param[in] pvNotifier  Notifier function
+ * @return  (bool)      true, if registered
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_RegisterClockNotifier(HwClkNotifierTypeDef pvNotifier)
+{
+  if (uNumNotifiers >= HW_CLK_MAX_NOTIFIERS) return false;
+  apvNotifiers[uNumNotifiers++] = pvNotifier;
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Switch clock tree configuration and notify dependent modules
+ *
+ * @param[in] eConfig     New configuration
+ * @return  (bool)      true, if active; false if HSE failed to start
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_SetClockConfig(HwClkConfigTypeDef eConfig)
+{
+  if (eConfig >= HW_CLK_NUM_CONFIGS) return false;
+  const HwClkPresetTypeDef* psPreset = &asPresets[eConfig];
+  bool bUseHse = (psPreset->eSource == HW_CLK_SRC_HSE) || (psPreset->eSource == HW_CLK_SRC_PLL_HSE);
+
+  /* Start crystal oscillator first; the configuration is
+   * left unchanged, if it fails                          */
+  if (bUseHse)
+  {
+    RCC_HSEConfig(RCC_HSE_ON);
+    if (RCC_WaitForHSEStartUp() != SUCCESS)
+    {
+      if (RCC_GetSYSCLKSource() == HW_CLK_SWS_HSI) RCC_HSEConfig(RCC_HSE_OFF);
+      return false;
+    }
+  }
+
+  __disable_irq();
+
+  /* Run from HSI while reconfiguring. Any wait state
+   * count is valid at HSI frequency.                     */
+  vSelectSysclk(RCC_SYSCLKSource_HSI, HW_CLK_SWS_HSI);
+  RCC_PLLCmd(DISABLE);
+
+  HwClkFreqTypeDef sFreq;
+  vHW_CalcClockTree(eConfig, &sFreq);
+  static const uint32_t aulLatencyCfg[] = { FLASH_Latency_0, FLASH_Latency_1, FLASH_Latency_2 };
+  FLASH_SetLatency(aulLatencyCfg[uHW_CalcFlashLatency(sFreq.ulSysclk)]);
+  RCC_HCLKConfig(RCC_SYSCLK_Div1);
+  RCC_PCLK1Config((psPreset->ucPclk1Div == 2) ? RCC_HCLK_Div2 : RCC_HCLK_Div1);
+  RCC_PCLK2Config(RCC_HCLK_Div1);
+  RCC_ADCCLKConfig(aulAdcDivCfg[psPreset->ucAdcDiv / 2 - 1]);
+
+  /* Select new source                                    */
+  switch (psPreset->eSource)
+  {
+    case HW_CLK_SRC_HSE:
+      vSelectSysclk(RCC_SYSCLKSource_HSE, HW_CLK_SWS_HSE);
+      break;
+
+    case HW_CLK_SRC_PLL_HSI:
+    case HW_CLK_SRC_PLL_HSE:
+      /* RCC_PLLMul_x encoding: multiplier - 2 in bits 21:18 */
+      RCC_PLLConfig((psPreset->eSource == HW_CLK_SRC_PLL_HSE) ? RCC_PLLSource_HSE_Div1 : RCC_PLLSource_HSI_Div2,
+        (uint32_t)(psPreset->ucPllMul - 2) << 18);
+      RCC_PLLCmd(ENABLE);
+      while (RCC_GetFlagStatus(RCC_FLAG_PLLRDY) != SET);
+      vSelectSysclk(RCC_SYSCLKSource_PLLCLK, HW_CLK_SWS_PLL);
+      break;
+
+    default:
+      break;
+  }
+  if (!bUseHse) RCC_HSEConfig(RCC_HSE_OFF);
+
+  /* Update frequencies and notify dependent modules      */
+  SystemCoreClockUpdate();
+  vReadClockFreq();
+  eCurrent = eConfig;
+  for (unsigned i = 0; i < uNumNotifiers; ++i)
+  {
+    apvNotifiers[i](&sCurrentFreq);
+  }
+
+  __enable_irq();
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get active clock tree configuration
+ *
+ * @return  (HwClkConfigTypeDef)  Configuration, or HW_CLK_NUM_CONFIGS for an
+ *                      unknown startup configuration
+ * @date  18.10.2026
+ ******************************************************************************/
+HwClkConfigTypeDef eHW_GetClockConfig(void)
+{
+  return eCurrent;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get display name of clock tree configuration
+ *
+ * @param[in] eConfig     Configuration
+ * @return  (const char*)  Name
+ * @date  18.10.2026
+ ******************************************************************************/
+const char* pszHW_GetClockConfigName(HwClkConfigTypeDef eConfig)
+{
+  return (eConfig < HW_CLK_NUM_CONFIGS) ? asPresets[eConfig].pszName : "SystemInit";
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get active bus clock frequencies
+ *
+ * @param[out] *psFreq    Frequencies
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_GetClockFreq(HwClkFreqTypeDef* psFreq)
+{
+  *psFreq = sCurrentFreq;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Calculate bus clock frequencies of a clock tree configuration
+ *
+ * @param[in] eConfig     Configuration
+ * @param[out] *psFreq    Frequencies
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_CalcClockTree(HwClkConfigTypeDef eConfig, HwClkFreqTypeDef* psFreq)
+{
+  const HwClkPresetTypeDef* psPreset = &asPresets[eConfig];
+  switch (psPreset->eSource)
+  {
+    case HW_CLK_SRC_HSE:
+      psFreq->ulSysclk = HSE_VALUE;
+      break;
+
+    case HW_CLK_SRC_PLL_HSI:
+      psFreq->ulSysclk = (HSI_VALUE / 2) * psPreset->ucPllMul;
+      break;
+
+    case HW_CLK_SRC_PLL_HSE:
+      psFreq->ulSysclk = HSE_VALUE * psPreset->ucPllMul;
+      break;
+
+    default:
+      psFreq->ulSysclk = HSI_VALUE;
+      break;
+  }
+  psFreq->ulHclk = psFreq->ulSysclk;
+  psFreq->ulPclk1 = psFreq->ulHclk / psPreset->ucPclk1Div;
+  psFreq->ulPclk2 = psFreq->ulHclk;
+  psFreq->ulAdcclk = psFreq->ulPclk2 / psPreset->ucAdcDiv;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Calculate required flash wait states
+ *
+ * @param[in] ulSysclk    SYSCLK frequency in Hz
+ * @return  (unsigned)  Number of wait states, 0 .. 2
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uHW_CalcFlashLatency(uint32_t ulSysclk)
+{
+  if (ulSysclk <= HW_CLK_FLASH_0WS_MAX) return 0;
+  if (ulSysclk <= HW_CLK_FLASH_1WS_MAX) return 1;
+  return 2;
+}
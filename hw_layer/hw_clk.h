@@ -0,0 +1,63 @@
+/*!****************************************************************************
+ * @file
+ * hw_clk.h
+ *
+ * @brief
+ * Runtime clock tree configuration
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef HW_CLK_H_
+#define HW_CLK_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Maximum number of clock change notifiers                           */
+#define HW_CLK_MAX_NOTIFIERS          8
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Clock tree configurations                                          */
+typedef enum
+{
+  HW_CLK_HSI_8MHZ = 0,                /*!< HSI                                */
+  HW_CLK_HSE_8MHZ,                    /*!< HSE (8 MHz crystal)                */
+  HW_CLK_PLL_HSI_48MHZ,               /*!< PLL, HSI/2 x 12                    */
+  HW_CLK_PLL_HSE_72MHZ,               /*!< PLL, HSE x 9                       */
+  HW_CLK_NUM_CONFIGS                  /*!< Number of configurations; also
+                                           used for the startup configuration
+                                           if it matches none of the above    */
+} HwClkConfigTypeDef;
+
+/*! @brief Bus clock frequencies in Hz                                        */
+typedef struct
+{
+  uint32_t ulSysclk;                  /*!< SYSCLK                             */
+  uint32_t ulHclk;                    /*!< AHB clock, core and SysTick        */
+  uint32_t ulPclk1;                   /*!< APB1 clock: TIM3, I2C2, USART2/3   */
+  uint32_t ulPclk2;                   /*!< APB2 clock: USART1, ADC1           */
+  uint32_t ulAdcclk;                  /*!< ADC clock                          */
+} HwClkFreqTypeDef;
+
+/*! @brief Clock change notifier, called with interrupts disabled after the
+ *  new configuration is active                                              */
+typedef void (*HwClkNotifierTypeDef)(const HwClkFreqTypeDef* psFreq);
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vInitHW_CLK(void);
+bool bHW_RegisterClockNotifier(HwClkNotifierTypeDef pvNotifier);
+bool bHW_SetClockConfig(HwClkConfigTypeDef eConfig);
+HwClkConfigTypeDef eHW_GetClockConfig(void);
+const char* pszHW_GetClockConfigName(HwClkConfigTypeDef eConfig);
+void vHW_GetClockFreq(HwClkFreqTypeDef* psFreq);
+
+void vHW_CalcClockTree(HwClkConfigTypeDef eConfig, HwClkFreqTypeDef* psFreq);
+unsigned uHW_CalcFlashLatency(uint32_t ulSysclk);
+
+#endif /* HW_CLK_H_ */
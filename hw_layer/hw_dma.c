@@ -0,0 +1,34 @@
+/*!****************************************************************************
+ * @file
+ * hw_dma.c
+ *
+ * @brief
+ * Low-level setup for DMA memory-to-memory channel and CRC unit
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Moved interrupt setup into central configuration
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "ch32v10x.h"
+#include "hw_dma.h"
+
+
+/*!****************************************************************************
+ * @brief
+ * Activate clock supply for DMA1 and CRC unit
+ *
+ * @note
+ * The memory-to-memory channel interrupt is enabled by vInitHW_IRQ().
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Moved interrupt setup into central configuration
+ ******************************************************************************/
+void vInitHW_DMA(void)
+{
+  /* Enable peripheral clock supply                       */
+  RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1 | RCC_AHBPeriph_CRC, ENABLE);
+
+  /* Channel is configured per transfer                   */
+  DMA_DeInit(DMA_M2M_CHANNEL);
+}
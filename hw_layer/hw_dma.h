@@ -0,0 +1,34 @@
+/*!****************************************************************************
+ * @file
+ * hw_dma.h
+ *
+ * @brief
+ * Low-level setup for DMA memory-to-memory channel and CRC unit
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef HW_DMA_H_
+#define HW_DMA_H_
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief DMA channel used for memory-to-memory transfers                    */
+#define DMA_M2M_CHANNEL               DMA1_Channel2
+
+/*! @brief Interrupt of memory-to-memory DMA channel                          */
+#define DMA_M2M_IRQn                  DMA1_Channel2_IRQn
+
+/*! @brief Transfer complete flag of memory-to-memory DMA channel             */
+#define DMA_M2M_IT_TC                 DMA1_IT_TC2
+
+/*! @brief Global interrupt flag of memory-to-memory DMA channel              */
+#define DMA_M2M_IT_GL                 DMA1_IT_GL2
+
+/*! @brief Maximum number of data items per DMA transfer                      */
+#define DMA_MAX_TRANSFER              0xFFFF
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vInitHW_DMA(void);
+
+#endif /* HW_DMA_H_ */
@@ -0,0 +1,236 @@
+/*!****************************************************************************
+ * @file
+ * hw_flash.c
+ *
+ * @brief
+ * Low-level internal flash programming in 128-byte fast page mode
+ *
+ * All functions access the flash controller registers directly, following the
+ * fast page sequences of the vendor library (FLASH_ErasePage_Fast(),
+ * FLASH_BufLoad(), FLASH_ProgramPage_Fast()). The page functions execute from
+ * SRAM, so that they do not depend on the flash being programmed. The install
+ * page function executes from the installer region, before the application is
+ * started.
+ * The file is compiled without -msave-restore and LTO for the same reason (see
+ * CMakeLists.txt).
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added separate erase and program functions
+ * @date  18.10.2026  Install copy moved to installer region
+ * @date  18.10.2026  Install copy reduced to single page
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "ch32v10x.h"
+#include "hw_ramfunc.h"
+#include "hw_flash.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Flash controller unlock keys                                       */
+#define HW_FLASH_KEY1                 0x45670123UL
+#define HW_FLASH_KEY2                 0xCDEF89ABUL
+
+/*! @brief FLASH_STATR: busy flag                                             */
+#define HW_FLASH_STATR_BSY            0x00000001UL
+
+/*! @brief FLASH_CTLR bits                                                    */
+#define HW_FLASH_CTLR_STRT            0x00000040UL
+#define HW_FLASH_CTLR_LOCK            0x00000080UL
+#define HW_FLASH_CTLR_FLOCK           0x00008000UL
+#define HW_FLASH_CTLR_PAGE_PG         0x00010000UL
+#define HW_FLASH_CTLR_PAGE_ER         0x00020000UL
+#define HW_FLASH_CTLR_BUF_LOAD        0x00040000UL
+#define HW_FLASH_CTLR_BUF_RST         0x00080000UL
+
+/*! @brief Bytes per buffer load operation                                    */
+#define HW_FLASH_BUF_LOAD_SIZE        16
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Wait for completion of flash operation
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vWaitBusy(void)
+{
+  while (FLASH->STATR & HW_FLASH_STATR_BSY);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Unlock flash controller and fast programming mode
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vUnlockFast(void)
+{
+  FLASH->KEYR = HW_FLASH_KEY1;
+  FLASH->KEYR = HW_FLASH_KEY2;
+  FLASH->MODEKEYR = HW_FLASH_KEY1;
+  FLASH->MODEKEYR = HW_FLASH_KEY2;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Lock fast programming mode and flash controller
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vLockFast(void)
+{
+  FLASH->CTLR |= HW_FLASH_CTLR_FLOCK | HW_FLASH_CTLR_LOCK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Erase one fast page
+ *
+ * @note
+ * Flash must be unlocked.
+ *
+ * @param[in] ulAddress   Page address (FLASH_BASE-based, 128-byte aligned)
+ * @date  18.10.2026
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vErasePage(uint32_t ulAddress)
+{
+  FLASH->CTLR |= HW_FLASH_CTLR_PAGE_ER;
+  FLASH->ADDR = ulAddress;
+  FLASH->CTLR |= HW_FLASH_CTLR_STRT;
+  vWaitBusy();
+  FLASH->CTLR &= ~HW_FLASH_CTLR_PAGE_ER;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Program one erased fast page
+ *
+ * @note
+ * Flash must be unlocked.
+ *
+ * @param[in] ulAddress   Page address (FLASH_BASE-based, 128-byte aligned)
+ * @param[in] *pulData    Page data, 32 words
+ * @date  18.10.2026
+ ******************************************************************************/
+static inline __attribute__((always_inline)) void vProgramPage(uint32_t ulAddress, const volatile uint32_t* pulData)
+{
+  /* Clear page buffer                                    */
+  FLASH->CTLR |= HW_FLASH_CTLR_PAGE_PG;
+  FLASH->CTLR |= HW_FLASH_CTLR_BUF_RST;
+  vWaitBusy();
+  FLASH->CTLR &= ~HW_FLASH_CTLR_PAGE_PG;
+
+  /* Load page buffer, 16 bytes at a time                 */
+  for (unsigned uOfs = 0; uOfs < HW_FLASH_PAGE_SIZE; uOfs += HW_FLASH_BUF_LOAD_SIZE)
+  {
+    volatile uint32_t* pulBuf = (volatile uint32_t*)(ulAddress + uOfs);
+    FLASH->CTLR |= HW_FLASH_CTLR_PAGE_PG;
+    pulBuf[0] = *pulData++;
+    pulBuf[1] = *pulData++;
+    pulBuf[2] = *pulData++;
+    pulBuf[3] = *pulData++;
+    FLASH->CTLR |= HW_FLASH_CTLR_BUF_LOAD;
+    vWaitBusy();
+    FLASH->CTLR &= ~HW_FLASH_CTLR_PAGE_PG;
+  }
+
+  /* Program page                                         */
+  FLASH->CTLR |= HW_FLASH_CTLR_PAGE_PG;
+  FLASH->ADDR = ulAddress;
+  FLASH->CTLR |= HW_FLASH_CTLR_STRT;
+  vWaitBusy();
+  FLASH->CTLR &= ~HW_FLASH_CTLR_PAGE_PG;
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Erase one fast page
+ *
+ * @note
+ * Shall not be used on the flash area of the running application.
+ *
+ * @param[in] ulAddress   Page address (FLASH_BASE-based, 128-byte aligned)
+ * @date  18.10.2026
+ ******************************************************************************/
+RAMFUNC_REQUIRED void vHW_FlashErasePage(uint32_t ulAddress)
+{
+  vUnlockFast();
+  vErasePage(ulAddress);
+  vLockFast();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Program and verify one previously erased fast page
+ *
+ * @note
+ * Shall not be used on the flash area of the running application.
+ *
+ * @param[in] ulAddress   Page address (FLASH_BASE-based, 128-byte aligned)
+ * @param[in] *pulData    Page data, 32 words
+ * @return  (bool)      true, if the page reads back correctly
+ * @date  18.10.2026
+ ******************************************************************************/
+RAMFUNC_REQUIRED bool bHW_FlashProgramPage(uint32_t ulAddress, const uint32_t* pulData)
+{
+  vUnlockFast();
+  vProgramPage(ulAddress, pulData);
+  vLockFast();
+
+  const volatile uint32_t* pulFlash = (const volatile uint32_t*)ulAddress;
+  for (unsigned i = 0; i < HW_FLASH_PAGE_SIZE / 4; ++i)
+  {
+    if (pulFlash[i] != pulData[i]) return false;
+  }
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Erase, program and verify one fast page
+ *
+ * @note
+ * Shall not be used on the flash area of the running application.
+ *
+ * @param[in] ulAddress   Page address (FLASH_BASE-based, 128-byte aligned)
+ * @param[in] *pulData    Page data, 32 words
+ * @return  (bool)      true, if the page reads back correctly
+ * @date  18.10.2026
+ ******************************************************************************/
+RAMFUNC_REQUIRED bool bHW_FlashWritePage(uint32_t ulAddress, const uint32_t* pulData)
+{
+  vHW_FlashErasePage(ulAddress);
+  return bHW_FlashProgramPage(ulAddress, pulData);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Erase, program and verify one fast page from the installer region
+ *
+ * Used by the installer (see installer.c), which runs before the C runtime
+ * and the SRAM functions have been set up.
+ *
+ * @param[in] ulAddress   Page address (FLASH_BASE-based, 128-byte aligned)
+ * @param[in] *pulData    Page data, 32 words
+ * @return  (bool)      true, if the page reads back correctly
+ * @date  18.10.2026
+ * @date  18.10.2026  Moved from SRAM to installer region; skip equal pages
+ * @date  18.10.2026  Reduced to single page; copy loop moved to installer.c
+ ******************************************************************************/
+HW_FLASH_INSTALLER bool bHW_FlashInstallPage(uint32_t ulAddress, const uint32_t* pulData)
+{
+  vUnlockFast();
+  vErasePage(ulAddress);
+  vProgramPage(ulAddress, pulData);
+  vLockFast();
+
+  const volatile uint32_t* pulFlash = (const volatile uint32_t*)ulAddress;
+  for (unsigned i = 0; i < HW_FLASH_PAGE_SIZE / 4; ++i)
+  {
+    if (pulFlash[i] != pulData[i]) return false;
+  }
+  return true;
+}
@@ -0,0 +1,38 @@
+/*!****************************************************************************
+ * @file
+ * hw_flash.h
+ *
+ * @brief
+ * Low-level internal flash programming in 128-byte fast page mode
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added separate erase and program functions
+ * @date  18.10.2026  Install copy moved to installer region
+ * @date  18.10.2026  Install copy reduced to single page
+ ******************************************************************************/
+
+#ifndef HW_FLASH_H_
+#define HW_FLASH_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Fast page size in bytes                                            */
+#define HW_FLASH_PAGE_SIZE            128
+
+/*! @brief Place function in the installer region at the start of flash (see
+ *  flash_layout.h). Such code runs before the C runtime is initialised and
+ *  shall not call functions or use data outside the region.                 */
+#define HW_FLASH_INSTALLER            __attribute__((section(".installer"), noinline))
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vHW_FlashErasePage(uint32_t ulAddress);
+bool bHW_FlashProgramPage(uint32_t ulAddress, const uint32_t* pulData);
+bool bHW_FlashWritePage(uint32_t ulAddress, const uint32_t* pulData);
+bool bHW_FlashInstallPage(uint32_t ulAddress, const uint32_t* pulData);
+
+#endif /* HW_FLASH_H_ */
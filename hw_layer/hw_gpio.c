@@ -6,11 +6,14 @@
  * Low-level GPIO setup
  *
  * @date  11.02.2022
+ * @date  18.10.2026  Added control loop feedback input
+ * @date  18.10.2026  Added USART2/USART3 pins
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
 #include "ch32v10x.h"
 #include "hw_iodefs.h"
+#include "hw_usart.h"
 #include "hw_gpio.h"
 
 
@@ -23,6 +26,8 @@
  * @date  23.02.2022  Modified USART pin mappings; added RX path
  * @date  03.03.2022  Fixed USART RX pin being configured as AF_PP output
  * @date  03.03.2022  Added I2C2 SDA/SCL mappings
+ * @date  18.10.2026  Added control loop feedback input
+ * @date  18.10.2026  Added USART2/USART3 pins
  ******************************************************************************/
 void vInitHW_GPIO(void)
 {
@@ -42,6 +47,21 @@ void vInitHW_GPIO(void)
   GPIO_Init(USART1RTX_GPIO_Port, &sInitUSART1TX);
   GPIO_Init(USART1RTX_GPIO_Port, &sInitUSART1RX);
 
+#ifdef USE_USART2
+  /* USART2 Rx/Tx                                         */
+  GPIO_InitTypeDef sInitUSART2TX = {
+    .GPIO_Pin = USART2TX_GPIO_Pin,
+    .GPIO_Mode = USART2TX_GPIO_Mode,
+    .GPIO_Speed = GPIO_Speed_2MHz
+  };
+  GPIO_InitTypeDef sInitUSART2RX = {
+    .GPIO_Pin = USART2RX_GPIO_Pin,
+    .GPIO_Mode = USART2RX_GPIO_Mode
+  };
+  GPIO_Init(USART2RTX_GPIO_Port, &sInitUSART2TX);
+  GPIO_Init(USART2RTX_GPIO_Port, &sInitUSART2RX);
+#endif /* USE_USART2 */
+
   /* TIM3 Channel 1                                       */
   GPIO_InitTypeDef sInitTIM3CH1 = {
     .GPIO_Pin = TIM3CH1_GPIO_Pin,
@@ -50,6 +70,20 @@ void vInitHW_GPIO(void)
   };
   GPIO_Init(TIM3CH1_GPIO_Port, &sInitTIM3CH1);
 
+#ifdef USE_USART3
+  /* USART3 Rx/Tx, sharing the I2C2 pins                  */
+  GPIO_InitTypeDef sInitUSART3TX = {
+    .GPIO_Pin = USART3TX_GPIO_Pin,
+    .GPIO_Mode = USART3TX_GPIO_Mode,
+    .GPIO_Speed = GPIO_Speed_2MHz
+  };
+  GPIO_InitTypeDef sInitUSART3RX = {
+    .GPIO_Pin = USART3RX_GPIO_Pin,
+    .GPIO_Mode = USART3RX_GPIO_Mode
+  };
+  GPIO_Init(USART3RTX_GPIO_Port, &sInitUSART3TX);
+  GPIO_Init(USART3RTX_GPIO_Port, &sInitUSART3RX);
+#else
   /* I2C2 SCL/SDA                                          */
   GPIO_InitTypeDef sInitI2C2 = {
     .GPIO_Pin = I2C2SCL_GPIO_Pin | I2C2SDA_GPIO_Pin,
@@ -57,4 +91,12 @@ void vInitHW_GPIO(void)
     .GPIO_Speed = GPIO_Speed_2MHz
   };
   GPIO_Init(I2C2_GPIO_Port, &sInitI2C2);
+#endif /* USE_USART3 */
+
+  /* Control loop feedback input                          */
+  GPIO_InitTypeDef sInitADCFB = {
+    .GPIO_Pin = ADCFB_GPIO_Pin,
+    .GPIO_Mode = ADCFB_GPIO_Mode
+  };
+  GPIO_Init(ADCFB_GPIO_Port, &sInitADCFB);
 }
@@ -6,18 +6,66 @@
  * Low-level initialisation for I2C2 (24C64 EEPROM)
  *
  * @date  03.03.2022
+ * @date  18.10.2026  Added clock rate update on clock changes
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
 #include "ch32v10x.h"
+#include "hw_clk.h"
 #include "hw_i2c2.h"
 
 
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief SCL clock rate in Hz                                               */
+#define I2C2_CLOCK_SPEED              100000
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Configure peripheral; I2C_Init() derives CTLR2.FREQ, CKCFGR and RTR from the
+ * current PCLK1
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vConfigure(void)
+{
+  I2C_InitTypeDef sInit = {
+    .I2C_ClockSpeed = I2C2_CLOCK_SPEED,
+    .I2C_Mode = I2C_Mode_I2C,
+    .I2C_DutyCycle = I2C_DutyCycle_2,
+    .I2C_Ack = I2C_Ack_Enable,
+    .I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit
+  };
+  I2C_Init(I2C2, &sInit);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Re-derive clock settings from new PCLK1
+ *
+ * @note
+ * Called between transfers only, since the clock is switched from the main
+ * loop.
+ *
+ * @param[in] *psFreq     Bus clock frequencies
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vClockChanged(const HwClkFreqTypeDef* psFreq)
+{
+  (void)psFreq;
+  I2C_Cmd(I2C2, DISABLE);
+  vConfigure();
+  I2C_Cmd(I2C2, ENABLE);
+}
+
+
 /*!****************************************************************************
  * @brief
  * Activate and configure I2C2 peripheral in master mode
  *
  * @date  03.03.2022
+ * @date  18.10.2026  Added clock change notifier
  ******************************************************************************/
 void vInitHW_I2C2(void)
 {
@@ -29,13 +77,7 @@ void vInitHW_I2C2(void)
   RCC_APB1PeriphResetCmd(RCC_APB1Periph_I2C2, DISABLE);
 
   /* Configure I2C peripheral                             */
-  I2C_InitTypeDef sInit = {
-    .I2C_ClockSpeed = 100000,
-    .I2C_Mode = I2C_Mode_I2C,
-    .I2C_DutyCycle = I2C_DutyCycle_2,
-    .I2C_Ack = I2C_Ack_Enable,
-    .I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit
-  };
-  I2C_Init(I2C2, &sInit);
+  vConfigure();
   I2C_Cmd(I2C2, ENABLE);
+  bHW_RegisterClockNotifier(vClockChanged);
 }
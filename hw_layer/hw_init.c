@@ -8,35 +8,38 @@
  * @date  11.02.2022
  * @date  24.02.2022  Added ADC init
  * @date  03.03.2022  Added I2C2 init
+ * @date  18.10.2026  Added DMA init
+ * @date  18.10.2026  Added clock manager init
+ * @date  18.10.2026  Added interrupt configuration
+ * @date  18.10.2026  Generalised USART init; I2C2 skipped if USART3 is used
+ * @date  18.10.2026  Peripheral init moved into boot sequence
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
-#include <string.h>
 #include "ch32v10x.h"
+#include "hw_clk.h"
 #include "hw_stk.h"
-#include "hw_gpio.h"
-#include "hw_usart1.h"
-#include "hw_tim3.h"
-#include "hw_adc.h"
-#include "hw_i2c2.h"
 
 
 /*!****************************************************************************
  * @brief
- * Top-level call to initialise all used hardware modules
+ * Top-level call to initialise the clock tree and SysTick
+ *
+ * SysTick is the time base of the boot sequencer, which initialises all
+ * other hardware modules (see the boot step table in main.c).
  *
  * @date  11.02.2022
  * @date  24.02.2022  Added ADC init
  * @date  03.03.2022  Added I2C2 init
+ * @date  18.10.2026  Added DMA init
+ * @date  18.10.2026  Added clock manager init, replacing the final
+ *                    SystemCoreClockUpdate()
+ * @date  18.10.2026  Added interrupt configuration
+ * @date  18.10.2026  Generalised USART init; I2C2 skipped if USART3 is used
+ * @date  18.10.2026  Peripheral init moved into boot sequence
  ******************************************************************************/
 void vInitHW(void)
 {
+  vInitHW_CLK();
   vInitHW_STK();
-  vInitHW_GPIO();
-  vInitHW_USART1();
-  vInitHW_TIM3();
-  vInitHW_ADC();
-  vInitHW_I2C2();
-
-  SystemCoreClockUpdate();
 }
@@ -10,6 +10,8 @@
  * @date  23.02.2022  Added USART1RX mapping, combined RX/TX defines
  * @date  03.03.2022  Fixed USART1RX mode configuration to Input w/ Pull-Up
  * @date  03.03.2022  Added I2C SCL/SDA mappings
+ * @date  18.10.2026  Added control loop feedback input
+ * @date  18.10.2026  Added USART2/USART3 mappings
  ******************************************************************************/
 
 #ifndef HW_IODEFS_H_
@@ -40,6 +42,24 @@
 #define USART1RX_GPIO_Mode            GPIO_Mode_IPU
 /*! @}                                                                        */
 
+/*! @brief PA2/3: USART2 TX/RX (USE_USART2)
+ *  @{                                                                        */
+#define USART2RTX_GPIO_Port           GPIOA
+#define USART2TX_GPIO_Pin             GPIO_Pin_2
+#define USART2RX_GPIO_Pin             GPIO_Pin_3
+#define USART2TX_GPIO_Mode            GPIO_Mode_AF_PP
+#define USART2RX_GPIO_Mode            GPIO_Mode_IPU
+/*! @}                                                                        */
+
+/*! @brief PB10/11: USART3 TX/RX (USE_USART3), instead of I2C2
+ *  @{                                                                        */
+#define USART3RTX_GPIO_Port           GPIOB
+#define USART3TX_GPIO_Pin             GPIO_Pin_10
+#define USART3RX_GPIO_Pin             GPIO_Pin_11
+#define USART3TX_GPIO_Mode            GPIO_Mode_AF_PP
+#define USART3RX_GPIO_Mode            GPIO_Mode_IPU
+/*! @}                                                                        */
+
 /*! @brief PB10/11: I2C2 SCL/SDA to 24C64 EEPROM
  *  @{                                                                        */
 #define I2C2_GPIO_Port                GPIOB
@@ -48,4 +68,12 @@
 #define I2C2_GPIO_Mode                GPIO_Mode_AF_OD
 /*! @}                                                                        */
 
+/*! @brief PA1: ADC Channel 1 control loop feedback input
+ *  @{                                                                        */
+#define ADCFB_GPIO_Port               GPIOA
+#define ADCFB_GPIO_Pin                GPIO_Pin_1
+#define ADCFB_GPIO_Mode               GPIO_Mode_AIN
+#define ADCFB_ADC_Channel             ADC_Channel_1
+/*! @}                                                                        */
+
 #endif /* HW_IODEFS_H_ */
@@ -0,0 +1,120 @@
+/*!****************************************************************************
+ * @file
+ * hw_irq.c
+ *
+ * @brief
+ * Central interrupt priority and enable configuration
+ *
+ * All interrupts used by the firmware are listed in asIrqCfg with their
+ * priorities. vInitHW_IRQ() applies the table after all peripherals have been
+ * set up. Drivers which enable or disable their interrupt at runtime do so
+ * through bHW_IrqCmd(), so that the priority always follows the table.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added USART3; profiling test vector moved to TIM4
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include "ch32v10x.h"
+#include "hw_dma.h"
+#include "hw_irq.h"
+#include "hw_usart.h"
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Interrupt configuration table                                             */
+static const HwIrqCfgTypeDef asIrqCfg[] = {
+  /* Preemption level 0: short, time-critical handlers   */
+  { SysTicK_IRQn,       0, 0, DISABLE },
+  { USART1_IRQn,        0, 1, DISABLE },
+  { DMA1_Channel5_IRQn, 0, 1, DISABLE },
+#ifdef USE_USART3
+  { USART3_IRQn,        0, 1, ENABLE  },
+#endif /* USE_USART3 */
+
+  /* Preemption level 1: data processing handlers        */
+  { TIM3_IRQn,          1, 0, DISABLE },
+  { ADC1_2_IRQn,        1, 0, DISABLE },
+  { DMA1_Channel1_IRQn, 1, 0, DISABLE },
+  { DMA_M2M_IRQn,       1, 1, ENABLE  },
+  { I2C2_EV_IRQn,       1, 1, DISABLE },
+  { I2C2_ER_IRQn,       1, 1, DISABLE },
+
+  /* Interrupt profiling test vectors                     */
+  { Software_IRQn,      1, 1, DISABLE },
+  { TIM4_IRQn,          1, 1, DISABLE }
+};
+
+/*! Number of table entries                                                   */
+#define IRQ_NUM_CFG                   (sizeof(asIrqCfg) / sizeof(asIrqCfg[0]))
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Apply interrupt configuration entry
+ *
+ * @param[in] *psCfg      Configuration entry
+ * @param[in] eCmd        Enable or disable interrupt
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vApplyCfg(const HwIrqCfgTypeDef* psCfg, FunctionalState eCmd)
+{
+  NVIC_InitTypeDef sInitNvic = {
+    .NVIC_IRQChannel = psCfg->eIrq,
+    .NVIC_IRQChannelPreemptionPriority = psCfg->ucPreempt,
+    .NVIC_IRQChannelSubPriority = psCfg->ucSub,
+    .NVIC_IRQChannelCmd = eCmd
+  };
+  NVIC_Init(&sInitNvic);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Set priority grouping and apply interrupt configuration table
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vInitHW_IRQ(void)
+{
+  NVIC_PriorityGroupConfig(HW_IRQ_PRIORITY_GROUP);
+  for (unsigned i = 0; i < IRQ_NUM_CFG; ++i) vApplyCfg(&asIrqCfg[i], asIrqCfg[i].eCmd);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Enable or disable an interrupt at its configured priority
+ *
+ * @param[in] eIrq        Interrupt number
+ * @param[in] eCmd        Enable or disable interrupt
+ * @return  (bool)  true if the interrupt is listed in the configuration table
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_IrqCmd(IRQn_Type eIrq, FunctionalState eCmd)
+{
+  for (unsigned i = 0; i < IRQ_NUM_CFG; ++i)
+  {
+    if (asIrqCfg[i].eIrq != eIrq) continue;
+    vApplyCfg(&asIrqCfg[i], eCmd);
+    return true;
+  }
+  return false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print interrupt configuration table and current enable state
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_PrintIrqCfg(void)
+{
+  for (unsigned i = 0; i < IRQ_NUM_CFG; ++i)
+  {
+    printf("IRQ %2d: preempt %u, sub %u, %s\r\n", asIrqCfg[i].eIrq,
+      asIrqCfg[i].ucPreempt, asIrqCfg[i].ucSub,
+      PFIC_GetStatusIRQ(asIrqCfg[i].eIrq) ? "enabled" : "disabled");
+  }
+}
@@ -0,0 +1,43 @@
+/*!****************************************************************************
+ * @file
+ * hw_irq.h
+ *
+ * @brief
+ * Central interrupt priority and enable configuration
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef HW_IRQ_H_
+#define HW_IRQ_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include "ch32v10x.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief PFIC priority grouping: 1 preemption bit, rest sub-priority.
+ *
+ * The QingKe V3A hardware stack holds the register context of two nesting
+ * levels, so interrupts using RV_INTERRUPT shall not nest any deeper.       */
+#define HW_IRQ_PRIORITY_GROUP         NVIC_PriorityGroup_1
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Interrupt configuration entry                                      */
+typedef struct
+{
+  IRQn_Type eIrq;                     /*!< Interrupt number                   */
+  uint8_t ucPreempt;                  /*!< Preemption priority (0 = highest)  */
+  uint8_t ucSub;                      /*!< Sub-priority within same level     */
+  FunctionalState eCmd;               /*!< Enabled at startup                 */
+} HwIrqCfgTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vInitHW_IRQ(void);
+bool bHW_IrqCmd(IRQn_Type eIrq, FunctionalState eCmd);
+void vHW_PrintIrqCfg(void);
+
+#endif /* HW_IRQ_H_ */
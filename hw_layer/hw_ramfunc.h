@@ -0,0 +1,36 @@
+/*!****************************************************************************
+ * @file
+ * hw_ramfunc.h
+ *
+ * @brief
+ * Placement of hot code in SRAM
+ *
+ * Functions tagged with RAMFUNC are placed in a .data subsection when the
+ * release-ramfunc build profile is selected (USE_RAMFUNC defined). The startup
+ * code copies them from flash into SRAM together with the initialised data, so
+ * they execute without flash wait states. In all other profiles the tag has no
+ * effect.
+ *
+ * Functions tagged with RAMFUNC_REQUIRED are placed in SRAM in all profiles.
+ * This is needed for code that keeps running while the flash is erased or
+ * programmed. Such code shall not call functions located in flash.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added RAMFUNC_REQUIRED
+ ******************************************************************************/
+
+#ifndef HW_RAMFUNC_H_
+#define HW_RAMFUNC_H_
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Execute function from SRAM                                         */
+#ifdef USE_RAMFUNC
+#define RAMFUNC                       __attribute__((section(".data.ramfunc"), noinline))
+#else
+#define RAMFUNC
+#endif /* USE_RAMFUNC */
+
+/*! @brief Execute function from SRAM, independent of build profile          */
+#define RAMFUNC_REQUIRED              __attribute__((section(".data.ramfunc"), noinline))
+
+#endif /* HW_RAMFUNC_H_ */
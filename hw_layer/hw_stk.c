@@ -7,10 +7,37 @@
  *
  * @date  17.02.2022
  * @date  18.02.2022  Modified STK access functions
+ * @date  18.10.2026  Added time conversion, updated on clock changes
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
 #include "ch32v10x.h"
+#include "hw_clk.h"
+#include "hw_stk.h"
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! SysTick counts per millisecond                                            */
+static uint32_t ulTicksPerMs;
+
+/*! SysTick counts per microsecond, rounded up                                */
+static uint32_t ulTicksPerUs;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Derive time conversion factors from HCLK
+ *
+ * @param[in] *psFreq     Bus clock frequencies
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vClockChanged(const HwClkFreqTypeDef* psFreq)
+{
+  uint32_t ulTickFreq = psFreq->ulHclk / HW_STK_HCLK_DIV;
+  ulTicksPerMs = ulTickFreq / 1000;
+  ulTicksPerUs = (ulTickFreq + 999999) / 1000000;
+}
 
 
 /*!****************************************************************************
@@ -20,8 +47,40 @@
  * @date  17.02.2022
  * @date  18.02.2022  Modified access functions
  * @date  24.02.2022  Changed SysTick naming convention
+ * @date  18.10.2026  Added clock change notifier
  ******************************************************************************/
 void vInitHW_STK(void)
 {
+  HwClkFreqTypeDef sFreq;
+  vHW_GetClockFreq(&sFreq);
+  vClockChanged(&sFreq);
+  bHW_RegisterClockNotifier(vClockChanged);
+
   SysTick_Cmd(ENABLE);
 }
+
+/*!****************************************************************************
+ * @brief
+ * Convert milliseconds into SysTick counts at the current HCLK
+ *
+ * @param[in] ulMs        Time in ms
+ * @return  (uint32_t)  SysTick counts
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulHW_STK_MsToTicks(uint32_t ulMs)
+{
+  return ulMs * ulTicksPerMs;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Convert microseconds into SysTick counts at the current HCLK
+ *
+ * @param[in] ulUs        Time in us
+ * @return  (uint32_t)  SysTick counts, rounded up
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulHW_STK_UsToTicks(uint32_t ulUs)
+{
+  return ulUs * ulTicksPerUs;
+}
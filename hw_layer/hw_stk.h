@@ -7,12 +7,24 @@
  *
  * @date  17.02.2022
  * @date  18.02.2022  Modified STK access functions
+ * @date  18.10.2026  Added time conversion
  ******************************************************************************/
 
 #ifndef HW_STK_H_
 #define HW_STK_H_
 
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief SysTick counter clock prescaler (HCLK/8)                           */
+#define HW_STK_HCLK_DIV               8
+
+
 /*- Exported functions -------------------------------------------------------*/
 void vInitHW_STK(void);
+uint32_t ulHW_STK_MsToTicks(uint32_t ulMs);
+uint32_t ulHW_STK_UsToTicks(uint32_t ulUs);
 
 #endif /* HW_STK_H_ */
@@ -6,18 +6,45 @@
  * Low-level configuration of TIM3
  *
  * @date  17.02.2022
+ * @date  18.10.2026  Added prescaler update on clock changes
+ * @date  18.10.2026  Added update interrupt handler
+ * @date  18.10.2026  Fixed PWM period (was one count too long)
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
 #include "ch32v10x.h"
+#include "hw_clk.h"
+#include "hw_irq.h"
 #include "hw_tim3.h"
 
 
+/*- Private variables --------------------------------------------------------*/
+/*! Update interrupt handler                                                  */
+static volatile HwTim3UpdateTypeDef pvUpdateHandler;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Re-derive prescaler from new PCLK1
+ *
+ * @param[in] *psFreq     Bus clock frequencies
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vClockChanged(const HwClkFreqTypeDef* psFreq)
+{
+  TIM_PrescalerConfig(TIM3, uiHW_TIM3_CalcPrescaler(psFreq), TIM_PSCReloadMode_Immediate);
+}
+
+
 /*!****************************************************************************
  * @brief
  * Activate peripheral clocks and configure Timer 3
  *
  * @date  17.02.2022
+ * @date  18.10.2026  Prescaler derived from PCLK1; added clock change notifier
+ * @date  18.10.2026  Auto-reload value set for exactly HW_TIM3_UPDATE_FREQ
  ******************************************************************************/
 void vInitHW_TIM3(void)
 {
@@ -25,11 +52,14 @@ void vInitHW_TIM3(void)
   RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE);
 
   /* Configure base timer for 1kHz PWM with pulse width
-   * range of [0 .. 100]                                  */
+   * range of [0 .. HW_TIM3_PWM_PERIOD]; the counter runs
+   * from 0 to the auto-reload value inclusive            */
+  HwClkFreqTypeDef sFreq;
+  vHW_GetClockFreq(&sFreq);
   TIM_TimeBaseInitTypeDef sInitBase = {
-    .TIM_Prescaler = 80,
+    .TIM_Prescaler = uiHW_TIM3_CalcPrescaler(&sFreq),
     .TIM_CounterMode = TIM_CounterMode_Up,
-    .TIM_Period = 100,
+    .TIM_Period = HW_TIM3_PWM_PERIOD - 1,
   };
   TIM_TimeBaseInit(TIM3, &sInitBase);
 
@@ -53,4 +83,60 @@ void vInitHW_TIM3(void)
 
   /* Start timer module                                   */
   TIM_Cmd(TIM3, ENABLE);
+  bHW_RegisterClockNotifier(vClockChanged);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Calculate prescaler for HW_TIM3_COUNT_FREQ counter clock
+ *
+ * The timer kernel clock is PCLK1, doubled if the APB1 prescaler is not 1.
+ *
+ * @param[in] *psFreq     Bus clock frequencies
+ * @return  (uint16_t)  Prescaler register value
+ * @date  18.10.2026
+ ******************************************************************************/
+uint16_t uiHW_TIM3_CalcPrescaler(const HwClkFreqTypeDef* psFreq)
+{
+  uint32_t ulTimClk = (psFreq->ulPclk1 == psFreq->ulHclk) ? psFreq->ulPclk1 : 2 * psFreq->ulPclk1;
+  return (uint16_t)((ulTimClk + HW_TIM3_COUNT_FREQ / 2) / HW_TIM3_COUNT_FREQ - 1);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Set update interrupt handler and enable or disable the interrupt
+ *
+ * @param[in] pvHandler   Handler, called at HW_TIM3_UPDATE_FREQ, or NULL to
+ *                        disable the interrupt
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_TIM3_SetUpdateHandler(HwTim3UpdateTypeDef pvHandler)
+{
+  if (pvHandler == NULL)
+  {
+    TIM_ITConfig(TIM3, TIM_IT_Update, DISABLE);
+    bHW_IrqCmd(TIM3_IRQn, DISABLE);
+    pvUpdateHandler = NULL;
+  }
+  else
+  {
+    pvUpdateHandler = pvHandler;
+    TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
+    TIM_ITConfig(TIM3, TIM_IT_Update, ENABLE);
+    bHW_IrqCmd(TIM3_IRQn, ENABLE);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * TIM3 interrupt handler, dispatches update events
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_TIM3_HandleIrq(void)
+{
+  if (TIM_GetITStatus(TIM3, TIM_IT_Update) != SET) return;
+  TIM_ClearITPendingBit(TIM3, TIM_IT_Update);
+  HwTim3UpdateTypeDef pvHandler = pvUpdateHandler;
+  if (pvHandler != NULL) pvHandler();
 }
@@ -6,12 +6,40 @@
  * Low-level configuration of TIM3
  *
  * @date  17.02.2022
+ * @date  18.10.2026  Added prescaler calculation
+ * @date  18.10.2026  Added update interrupt handler
+ * @date  18.10.2026  PWM period counts include the auto-reload value
  ******************************************************************************/
 
 #ifndef HW_TIM3_H_
 #define HW_TIM3_H_
 
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+#include "hw_clk.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Counter clock frequency in Hz                                      */
+#define HW_TIM3_COUNT_FREQ            100000UL
+
+/*! @brief PWM period in counter clock cycles (auto-reload value + 1); also
+ *  the full scale compare value, giving a duty cycle of 100 %              */
+#define HW_TIM3_PWM_PERIOD            100
+
+/*! @brief Update (PWM) frequency in Hz                                       */
+#define HW_TIM3_UPDATE_FREQ           (HW_TIM3_COUNT_FREQ / HW_TIM3_PWM_PERIOD)
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Update interrupt handler                                           */
+typedef void (*HwTim3UpdateTypeDef)(void);
+
+
 /*- Exported functions -------------------------------------------------------*/
 void vInitHW_TIM3(void);
+uint16_t uiHW_TIM3_CalcPrescaler(const HwClkFreqTypeDef* psFreq);
+void vHW_TIM3_SetUpdateHandler(HwTim3UpdateTypeDef pvHandler);
+void vHW_TIM3_HandleIrq(void);
 
 #endif /* HW_TIM3_H_ */
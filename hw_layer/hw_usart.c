@@ -0,0 +1,571 @@
+/*!****************************************************************************
+ * @file
+ * hw_usart.c
+ *
+ * @brief
+ * Low-level driver for USART1..3
+ *
+ * Each instance is described by an entry of the constant descriptor table,
+ * and keeps its own RX buffer position, transmit state, baud rate and
+ * statistics, so the ports run independently of each other. Reception is
+ * always by circular DMA. Transmission is by DMA where a channel is
+ * available; USART3 shares its TX DMA channel with the memory-to-memory
+ * transfers (DMA_M2M_CHANNEL) and transmits from its interrupt instead, which
+ * calls vHW_USART_IrqHandler().
+ *
+ * DMA channel assignment:
+ *
+ *   USART1  RX 5, TX 4
+ *   USART2  RX 6, TX 7
+ *   USART3  RX 3, TX interrupt
+ *
+ * Apart from bHW_USART_IsEnabled() and pszHW_USART_GetName(), functions shall
+ * only be called for enabled instances. All functions of one instance shall
+ * be called from the same context; the instances themselves may be used from
+ * different contexts.
+ *
+ * @date  11.02.2022
+ * @date  18.10.2026  Added DMA reception into circular buffer
+ * @date  18.10.2026  Added baud rate update on clock changes
+ * @date  18.10.2026  Added runtime baud rate selection
+ * @date  18.10.2026  Added DMA transmission
+ * @date  18.10.2026  Generalised from USART1 to multiple instances
+ * @date  18.10.2026  Block transmission functions tagged RAMFUNC
+ * @date  18.10.2026  Baud rate fallback on clock changes
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
+#include "ch32v10x.h"
+#include "hw_clk.h"
+#include "hw_ramfunc.h"
+#include "hw_usart.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief DMA channels assigned to USART1
+ *  @{                                                                        */
+#define USART1_RX_DMA_CHANNEL         DMA1_Channel5
+#define USART1_TX_DMA_CHANNEL         DMA1_Channel4
+/*! @}                                                                        */
+
+/*! @brief DMA channels assigned to USART2
+ *  @{                                                                        */
+#define USART2_RX_DMA_CHANNEL         DMA1_Channel6
+#define USART2_TX_DMA_CHANNEL         DMA1_Channel7
+/*! @}                                                                        */
+
+/*! @brief DMA channels assigned to USART3; TX by interrupt
+ *  @{                                                                        */
+#define USART3_RX_DMA_CHANNEL         DMA1_Channel3
+#define USART3_TX_DMA_CHANNEL         NULL
+/*! @}                                                                        */
+
+/*! @brief Line error flags counted by reads                                  */
+#define USART_LINE_ERROR_FLAGS        (USART_FLAG_ORE | USART_FLAG_NE | USART_FLAG_FE)
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Instance descriptor                                                */
+typedef struct
+{
+  USART_TypeDef* psUsart;             /*!< Peripheral, NULL if not enabled    */
+  uint32_t ulRccApb1;                 /*!< APB1 clock enable mask, or 0       */
+  uint32_t ulRccApb2;                 /*!< APB2 clock enable mask, or 0       */
+  DMA_Channel_TypeDef* psRxDma;       /*!< RX DMA channel                     */
+  DMA_Channel_TypeDef* psTxDma;       /*!< TX DMA channel, NULL for interrupt */
+  volatile uint8_t* pucRxBuf;         /*!< RX circular buffer                 */
+  uint16_t uiRxBufSize;               /*!< RX buffer size in bytes            */
+} HwUsartDescTypeDef;
+
+/*! @brief Instance state                                                     */
+typedef struct
+{
+  uint32_t ulBaud;                    /*!< Selected baud rate                 */
+  unsigned uRxTail;                   /*!< Read index into RX buffer          */
+  const uint8_t* pucTxData;           /*!< Next byte to transmit by interrupt */
+  volatile unsigned uTxRemain;        /*!< Bytes left to interrupt transmit   */
+  HwUsartStatsTypeDef sStats;         /*!< Statistics                         */
+} HwUsartStateTypeDef;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! RX circular buffers, written by DMA                                       */
+static volatile uint8_t aucUsart1RxBuf[HW_USART1_RX_BUF_SIZE];
+#ifdef USE_USART2
+static volatile uint8_t aucUsart2RxBuf[HW_USART2_RX_BUF_SIZE];
+#endif /* USE_USART2 */
+#ifdef USE_USART3
+static volatile uint8_t aucUsart3RxBuf[HW_USART3_RX_BUF_SIZE];
+#endif /* USE_USART3 */
+
+/*! Instance descriptors                                                      */
+static const HwUsartDescTypeDef asDesc[HW_USART_NUM] = {
+  [HW_USART1] = {
+    USART1, 0, RCC_APB2Periph_USART1,
+    USART1_RX_DMA_CHANNEL, USART1_TX_DMA_CHANNEL,
+    aucUsart1RxBuf, HW_USART1_RX_BUF_SIZE
+  },
+#ifdef USE_USART2
+  [HW_USART2] = {
+    USART2, RCC_APB1Periph_USART2, 0,
+    USART2_RX_DMA_CHANNEL, USART2_TX_DMA_CHANNEL,
+    aucUsart2RxBuf, HW_USART2_RX_BUF_SIZE
+  },
+#endif /* USE_USART2 */
+#ifdef USE_USART3
+  [HW_USART3] = {
+    USART3, RCC_APB1Periph_USART3, 0,
+    USART3_RX_DMA_CHANNEL, USART3_TX_DMA_CHANNEL,
+    aucUsart3RxBuf, HW_USART3_RX_BUF_SIZE
+  },
+#endif /* USE_USART3 */
+};
+
+/*! Instance state                                                            */
+static HwUsartStateTypeDef asState[HW_USART_NUM];
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Select kernel clock of an instance
+ *
+ * @param[in] *psDesc     Instance descriptor
+ * @param[in] *psFreq     Bus clock frequencies
+ * @return  (uint32_t)  PCLK2 for USART1, PCLK1 otherwise
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulSelectPclk(const HwUsartDescTypeDef* psDesc, const HwClkFreqTypeDef* psFreq)
+{
+  return (psDesc->ulRccApb2 != 0) ? psFreq->ulPclk2 : psFreq->ulPclk1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Re-derive baud rate registers from new bus clocks
+ *
+ * A selected rate which the new clock cannot generate within
+ * HW_USART_BAUD_MAX_ERROR (or at all) is replaced by HW_USART_BAUD_RATE, the
+ * rate the host falls back to as well.
+ *
+ * @param[in] *psFreq     Bus clock frequencies
+ * @date  18.10.2026
+ * @date  18.10.2026  All enabled instances
+ * @date  18.10.2026  Fall back to HW_USART_BAUD_RATE for unreachable rates
+ ******************************************************************************/
+static void vClockChanged(const HwClkFreqTypeDef* psFreq)
+{
+  for (unsigned i = 0; i < HW_USART_NUM; ++i)
+  {
+    const HwUsartDescTypeDef* psDesc = &asDesc[i];
+    if (psDesc->psUsart == NULL) continue;
+    uint32_t ulPclk = ulSelectPclk(psDesc, psFreq);
+    int32_t lError = lHW_USART_CalcBaudError(ulPclk, asState[i].ulBaud);
+    if ((lError > HW_USART_BAUD_MAX_ERROR) || (lError < -HW_USART_BAUD_MAX_ERROR))
+    {
+      asState[i].ulBaud = HW_USART_BAUD_RATE;
+    }
+    psDesc->psUsart->BRR = uiHW_USART_CalcBrr(ulPclk, asState[i].ulBaud);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Initialise one instance for HW_USART_BAUD_RATE, 8n1
+ *
+ * @param[in] eId         Instance
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vInitInstance(HwUsartTypeDef eId)
+{
+  const HwUsartDescTypeDef* psDesc = &asDesc[eId];
+  HwUsartStateTypeDef* psState = &asState[eId];
+
+  /* Enable peripheral clock supply                       */
+  if (psDesc->ulRccApb1 != 0) RCC_APB1PeriphClockCmd(psDesc->ulRccApb1, ENABLE);
+  if (psDesc->ulRccApb2 != 0) RCC_APB2PeriphClockCmd(psDesc->ulRccApb2, ENABLE);
+
+  /* Configure peripheral                                 */
+  USART_InitTypeDef sInit = {
+    .USART_BaudRate = HW_USART_BAUD_RATE,
+    .USART_WordLength = USART_WordLength_8b,
+    .USART_Parity = USART_Parity_No,
+    .USART_StopBits = USART_StopBits_1,
+    .USART_Mode = USART_Mode_Tx | USART_Mode_Rx
+  };
+  USART_Init(psDesc->psUsart, &sInit);
+  psState->ulBaud = HW_USART_BAUD_RATE;
+
+  /* Receive continuously into circular buffer, so no data
+   * is lost while the CPU is busy                        */
+  DMA_DeInit(psDesc->psRxDma);
+  DMA_InitTypeDef sInitDma = {
+    .DMA_PeripheralBaseAddr = (uint32_t)&psDesc->psUsart->DATAR,
+    .DMA_MemoryBaseAddr = (uint32_t)psDesc->pucRxBuf,
+    .DMA_DIR = DMA_DIR_PeripheralSRC,
+    .DMA_BufferSize = psDesc->uiRxBufSize,
+    .DMA_PeripheralInc = DMA_PeripheralInc_Disable,
+    .DMA_MemoryInc = DMA_MemoryInc_Enable,
+    .DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte,
+    .DMA_MemoryDataSize = DMA_MemoryDataSize_Byte,
+    .DMA_Mode = DMA_Mode_Circular,
+    .DMA_Priority = DMA_Priority_High,
+    .DMA_M2M = DMA_M2M_Disable
+  };
+  DMA_Init(psDesc->psRxDma, &sInitDma);
+  DMA_Cmd(psDesc->psRxDma, ENABLE);
+
+  /* Transmit channel, started per block by
+   * vHW_USART_StartTx(); otherwise by TXE interrupt      */
+  if (psDesc->psTxDma != NULL)
+  {
+    DMA_DeInit(psDesc->psTxDma);
+    sInitDma.DMA_MemoryBaseAddr = 0;
+    sInitDma.DMA_DIR = DMA_DIR_PeripheralDST;
+    sInitDma.DMA_BufferSize = 0;
+    sInitDma.DMA_Mode = DMA_Mode_Normal;
+    sInitDma.DMA_Priority = DMA_Priority_Medium;
+    DMA_Init(psDesc->psTxDma, &sInitDma);
+    USART_DMACmd(psDesc->psUsart, USART_DMAReq_Rx | USART_DMAReq_Tx, ENABLE);
+  }
+  else
+  {
+    USART_DMACmd(psDesc->psUsart, USART_DMAReq_Rx, ENABLE);
+  }
+
+  /* Start the peripheral                                 */
+  USART_Cmd(psDesc->psUsart, ENABLE);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Activate clock supply and initialise all enabled instances for 115200 Baud,
+ * 8n1
+ *
+ * @date  11.02.2022
+ * @date  23.02.2022  Modified to activate RX mode
+ * @date  18.10.2026  Added circular DMA reception
+ * @date  18.10.2026  Added clock change notifier
+ * @date  18.10.2026  Added DMA transmission channel
+ * @date  18.10.2026  Initialise all enabled instances
+ ******************************************************************************/
+void vInitHW_USART(void)
+{
+  RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+  for (unsigned i = 0; i < HW_USART_NUM; ++i)
+  {
+    if (asDesc[i].psUsart != NULL) vInitInstance(i);
+  }
+  bHW_RegisterClockNotifier(vClockChanged);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check if an instance is enabled
+ *
+ * @param[in] eId         Instance
+ * @return  (bool)      true, if enabled in the build configuration
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_USART_IsEnabled(HwUsartTypeDef eId)
+{
+  return (eId < HW_USART_NUM) && (asDesc[eId].psUsart != NULL);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get instance name
+ *
+ * @param[in] eId         Instance
+ * @return  (const char*) Name
+ * @date  18.10.2026
+ ******************************************************************************/
+const char* pszHW_USART_GetName(HwUsartTypeDef eId)
+{
+  static const char* const apszNames[HW_USART_NUM] = { "USART1", "USART2", "USART3" };
+  return apszNames[eId];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Change baud rate
+ *
+ * @note
+ * Characters being transmitted or received are garbled.
+ *
+ * @param[in] eId         Instance
+ * @param[in] ulBaud      Baud rate, see lHW_USART_CalcBaudError()
+ * @date  18.10.2026
+ * @date  18.10.2026  Added instance parameter
+ ******************************************************************************/
+void vHW_USART_SetBaudRate(HwUsartTypeDef eId, uint32_t ulBaud)
+{
+  asState[eId].ulBaud = ulBaud;
+  asDesc[eId].psUsart->BRR = uiHW_USART_CalcBrr(ulHW_USART_GetPclk(eId), ulBaud);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get selected baud rate
+ *
+ * @param[in] eId         Instance
+ * @return  (uint32_t)  Baud rate
+ * @date  18.10.2026
+ * @date  18.10.2026  Added instance parameter
+ ******************************************************************************/
+uint32_t ulHW_USART_GetBaudRate(HwUsartTypeDef eId)
+{
+  return asState[eId].ulBaud;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get current kernel clock of an instance
+ *
+ * @param[in] eId         Instance
+ * @return  (uint32_t)  PCLK2 for USART1, PCLK1 for USART2/3, in Hz
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulHW_USART_GetPclk(HwUsartTypeDef eId)
+{
+  HwClkFreqTypeDef sFreq;
+  vHW_GetClockFreq(&sFreq);
+  return ulSelectPclk(&asDesc[eId], &sFreq);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Calculate baud rate register value (16x oversampling)
+ *
+ * @param[in] ulPclk      USART kernel clock in Hz
+ * @param[in] ulBaud      Baud rate
+ * @return  (uint16_t)  BRR value: mantissa and 4-bit fraction of PCLK/(16*baud)
+ * @date  18.10.2026
+ ******************************************************************************/
+uint16_t uiHW_USART_CalcBrr(uint32_t ulPclk, uint32_t ulBaud)
+{
+  return (uint16_t)((ulPclk + ulBaud / 2) / ulBaud);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Calculate deviation of the actual from the requested baud rate
+ *
+ * @param[in] ulPclk      USART kernel clock in Hz
+ * @param[in] ulBaud      Requested baud rate
+ * @return  (int32_t)   Error in ppm, or INT32_MAX if the BRR value is out of
+ *                      range
+ * @date  18.10.2026
+ ******************************************************************************/
+int32_t lHW_USART_CalcBaudError(uint32_t ulPclk, uint32_t ulBaud)
+{
+  if ((ulBaud == 0) || ((ulPclk + ulBaud / 2) / ulBaud > 0xFFFF)) return INT32_MAX;
+  uint32_t ulBrr = uiHW_USART_CalcBrr(ulPclk, ulBaud);
+  if (ulBrr < HW_USART_BRR_MIN) return INT32_MAX;
+
+  /* Actual rate is PCLK / BRR                            */
+  int64_t llDiff = (int64_t)ulPclk - (int64_t)ulBrr * ulBaud;
+  return (int32_t)((llDiff * 1000000) / ((int64_t)ulBrr * ulBaud));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get RX buffer size
+ *
+ * @param[in] eId         Instance
+ * @return  (unsigned)  Size in bytes
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uHW_USART_GetRxBufSize(HwUsartTypeDef eId)
+{
+  return asDesc[eId].uiRxBufSize;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get number of received bytes not yet read
+ *
+ * @param[in] eId         Instance
+ * @return  (unsigned)  Number of bytes in RX buffer
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uHW_USART_GetRxCount(HwUsartTypeDef eId)
+{
+  const HwUsartDescTypeDef* psDesc = &asDesc[eId];
+  unsigned uHead = (psDesc->uiRxBufSize - DMA_GetCurrDataCounter(psDesc->psRxDma)) % psDesc->uiRxBufSize;
+  return (uHead + psDesc->uiRxBufSize - asState[eId].uRxTail) % psDesc->uiRxBufSize;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get next received byte without removing it
+ *
+ * @param[in] eId         Instance
+ * @param[out] *pucData   Next byte
+ * @return  (bool)      true, if data is present
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_USART_Peek(HwUsartTypeDef eId, uint8_t* pucData)
+{
+  if (uHW_USART_GetRxCount(eId) == 0) return false;
+  *pucData = asDesc[eId].pucRxBuf[asState[eId].uRxTail];
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Non-blocking read from RX buffer
+ *
+ * @note
+ * The RX buffer is overwritten by DMA once more than its size is pending.
+ * Callers are expected to poll at least that often.
+ *
+ * @param[in] eId         Instance
+ * @param[out] *pucData   Data buffer
+ * @param[in] uMaxLen     Buffer size in bytes
+ * @return  (unsigned)  Number of bytes read
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uHW_USART_Read(HwUsartTypeDef eId, uint8_t* pucData, unsigned uMaxLen)
+{
+  const HwUsartDescTypeDef* psDesc = &asDesc[eId];
+  HwUsartStateTypeDef* psState = &asState[eId];
+  unsigned uCount = uHW_USART_GetRxCount(eId);
+  if (uCount > psState->sStats.uRxPeak) psState->sStats.uRxPeak = uCount;
+  if ((psDesc->psUsart->STATR & USART_LINE_ERROR_FLAGS) != 0) ++psState->sStats.ulLineErrors;
+
+  unsigned uLen = (uCount < uMaxLen) ? uCount : uMaxLen;
+  for (unsigned i = 0; i < uLen; ++i)
+  {
+    pucData[i] = psDesc->pucRxBuf[psState->uRxTail];
+    psState->uRxTail = (psState->uRxTail + 1) % psDesc->uiRxBufSize;
+  }
+  psState->sStats.ulRxBytes += uLen;
+  return uLen;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Blocking write of a single byte, once a running block transmission has
+ * finished
+ *
+ * @param[in] eId         Instance
+ * @param[in] ucData      Data
+ * @date  18.10.2026
+ ******************************************************************************/
+RAMFUNC void vHW_USART_PutChar(HwUsartTypeDef eId, uint8_t ucData)
+{
+  USART_TypeDef* psUsart = asDesc[eId].psUsart;
+  while (bHW_USART_IsTxBusy(eId));
+  while (USART_GetFlagStatus(psUsart, USART_FLAG_TC) != SET);
+  USART_SendData(psUsart, ucData);
+  ++asState[eId].sStats.ulTxBytes;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Wait until all data has been sent
+ *
+ * @param[in] eId         Instance
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_USART_Flush(HwUsartTypeDef eId)
+{
+  while (bHW_USART_IsTxBusy(eId));
+  while (USART_GetFlagStatus(asDesc[eId].psUsart, USART_FLAG_TC) != SET);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Start transmission of a block
+ *
+ * @note
+ * The block must remain valid until bHW_USART_IsTxBusy() returns false.
+ * Single characters shall not be written while the transmission is running.
+ *
+ * @param[in] eId         Instance
+ * @param[in] *pucData    Data
+ * @param[in] uLen        Data length in bytes
+ * @date  18.10.2026
+ * @date  18.10.2026  Added instance parameter and interrupt transmission
+ * @date  18.10.2026  Added RAMFUNC placement tag
+ ******************************************************************************/
+RAMFUNC void vHW_USART_StartTx(HwUsartTypeDef eId, const uint8_t* pucData, unsigned uLen)
+{
+  const HwUsartDescTypeDef* psDesc = &asDesc[eId];
+  HwUsartStateTypeDef* psState = &asState[eId];
+  if (uLen == 0) return;
+  psState->sStats.ulTxBytes += uLen;
+  ++psState->sStats.ulTxBlocks;
+
+  if (psDesc->psTxDma != NULL)
+  {
+    DMA_Cmd(psDesc->psTxDma, DISABLE);
+    psDesc->psTxDma->MADDR = (uint32_t)pucData;
+    DMA_SetCurrDataCounter(psDesc->psTxDma, uLen);
+    DMA_Cmd(psDesc->psTxDma, ENABLE);
+  }
+  else
+  {
+    psState->pucTxData = pucData;
+    psState->uTxRemain = uLen;
+    USART_ITConfig(psDesc->psUsart, USART_IT_TXE, ENABLE);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check if a block transmission is in progress
+ *
+ * The last byte may still be shifted out once this returns false; a new
+ * block can be started immediately.
+ *
+ * @param[in] eId         Instance
+ * @return  (bool)      true, if bytes remain to be loaded into the
+ *                      transmitter
+ * @date  18.10.2026
+ * @date  18.10.2026  Added instance parameter and interrupt transmission
+ * @date  18.10.2026  Added RAMFUNC placement tag
+ ******************************************************************************/
+RAMFUNC bool bHW_USART_IsTxBusy(HwUsartTypeDef eId)
+{
+  const HwUsartDescTypeDef* psDesc = &asDesc[eId];
+  if (psDesc->psTxDma == NULL) return asState[eId].uTxRemain != 0;
+  return DMA_GetCurrDataCounter(psDesc->psTxDma) != 0;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get instance statistics
+ *
+ * @param[in] eId         Instance
+ * @param[out] *psStats   Statistics
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_USART_GetStats(HwUsartTypeDef eId, HwUsartStatsTypeDef* psStats)
+{
+  *psStats = asState[eId].sStats;
+}
+
+/*!****************************************************************************
+ * @brief
+ * USART interrupt handler body for interrupt transmission
+ *
+ * @param[in] eId         Instance
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_USART_IrqHandler(HwUsartTypeDef eId)
+{
+  USART_TypeDef* psUsart = asDesc[eId].psUsart;
+  HwUsartStateTypeDef* psState = &asState[eId];
+  if (USART_GetITStatus(psUsart, USART_IT_TXE) == RESET) return;
+
+  if (psState->uTxRemain != 0)
+  {
+    USART_SendData(psUsart, *psState->pucTxData++);
+    --psState->uTxRemain;
+  }
+  if (psState->uTxRemain == 0) USART_ITConfig(psUsart, USART_IT_TXE, DISABLE);
+}
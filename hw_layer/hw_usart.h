@@ -0,0 +1,91 @@
+/*!****************************************************************************
+ * @file
+ * hw_usart.h
+ *
+ * @brief
+ * Low-level driver for USART1..3
+ *
+ * @date  11.02.2022
+ * @date  18.10.2026  Added DMA reception into circular buffer
+ * @date  18.10.2026  Added baud rate calculation
+ * @date  18.10.2026  Added runtime baud rate selection
+ * @date  18.10.2026  Added DMA transmission
+ * @date  18.10.2026  Generalised from USART1 to multiple instances
+ ******************************************************************************/
+
+#ifndef HW_USART_H_
+#define HW_USART_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Additional USART instances; USART1 is always enabled. USART3 uses
+ *  the I2C2 pins PB10/11 and cannot be used together with the EEPROM.
+ *  @{                                                                        */
+//#define USE_USART2
+//#define USE_USART3
+/*! @}                                                                        */
+
+/*! @brief Serial Baudrate after reset                                       */
+#define HW_USART_BAUD_RATE            115200
+
+/*! @brief Smallest valid BRR value (mantissa 1)                              */
+#define HW_USART_BRR_MIN              16
+
+/*! @brief Maximum baud rate error accepted for a rate change in ppm (2 %)    */
+#define HW_USART_BAUD_MAX_ERROR       20000
+
+/*! @brief RX DMA circular buffer sizes in bytes
+ *  @{                                                                        */
+#define HW_USART1_RX_BUF_SIZE         512
+#define HW_USART2_RX_BUF_SIZE         256
+#define HW_USART3_RX_BUF_SIZE         256
+/*! @}                                                                        */
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief USART instances                                                    */
+typedef enum
+{
+  HW_USART1 = 0,
+  HW_USART2,
+  HW_USART3,
+  HW_USART_NUM
+} HwUsartTypeDef;
+
+/*! @brief Instance statistics                                                */
+typedef struct
+{
+  uint32_t ulRxBytes;                 /*!< Bytes read from RX buffer          */
+  uint32_t ulTxBytes;                 /*!< Bytes passed to the transmitter    */
+  uint32_t ulTxBlocks;                /*!< Blocks started for transmission    */
+  uint32_t ulLineErrors;              /*!< Reads which found an overrun, noise
+                                           or framing error flag              */
+  unsigned uRxPeak;                   /*!< Maximum RX buffer fill level       */
+} HwUsartStatsTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vInitHW_USART(void);
+bool bHW_USART_IsEnabled(HwUsartTypeDef eId);
+const char* pszHW_USART_GetName(HwUsartTypeDef eId);
+void vHW_USART_SetBaudRate(HwUsartTypeDef eId, uint32_t ulBaud);
+uint32_t ulHW_USART_GetBaudRate(HwUsartTypeDef eId);
+uint32_t ulHW_USART_GetPclk(HwUsartTypeDef eId);
+uint16_t uiHW_USART_CalcBrr(uint32_t ulPclk, uint32_t ulBaud);
+int32_t lHW_USART_CalcBaudError(uint32_t ulPclk, uint32_t ulBaud);
+unsigned uHW_USART_GetRxBufSize(HwUsartTypeDef eId);
+unsigned uHW_USART_GetRxCount(HwUsartTypeDef eId);
+bool bHW_USART_Peek(HwUsartTypeDef eId, uint8_t* pucData);
+unsigned uHW_USART_Read(HwUsartTypeDef eId, uint8_t* pucData, unsigned uMaxLen);
+void vHW_USART_PutChar(HwUsartTypeDef eId, uint8_t ucData);
+void vHW_USART_Flush(HwUsartTypeDef eId);
+void vHW_USART_StartTx(HwUsartTypeDef eId, const uint8_t* pucData, unsigned uLen);
+bool bHW_USART_IsTxBusy(HwUsartTypeDef eId);
+void vHW_USART_GetStats(HwUsartTypeDef eId, HwUsartStatsTypeDef* psStats);
+void vHW_USART_IrqHandler(HwUsartTypeDef eId);
+
+#endif /* HW_USART_H_ */
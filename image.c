@@ -0,0 +1,145 @@
+/*!****************************************************************************
+ * @file
+ * image.c
+ *
+ * @brief
+ * Boot-time firmware image integrity check
+ *
+ * The linker places a trailer with start address and length behind the last
+ * flash section (see Controller/app_sections.ld), and the post-build step
+ * tools/image_trailer.py stores the CRC-32 of the image in it. At boot, the
+ * CRC unit checks the image while DMA streams the flash contents, so the
+ * check runs in the background while the banner is printed.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include "ch32v10x.h"
+#include "dbgser.h"
+#include "offload.h"
+#include "image.h"
+
+
+/*- Linker symbols -----------------------------------------------------------*/
+extern const ImageTrailerTypeDef _image_trailer; /*!< Image trailer           */
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Check result                                                              */
+static volatile ImageCheckTypeDef eImageCheck = IMAGE_CHECK_PENDING;
+
+/*! Calculated CRC                                                            */
+static volatile uint32_t ulImageCrc;
+
+/*! SysTick timestamps of check start and completion                          */
+static uint32_t ulStartTicks;
+static volatile uint32_t ulDoneTicks;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * CRC completion callback
+ *
+ * @param[in] ulResult    Calculated CRC-32
+ * @param[in] *pvContext  (unused)
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vImageCrcDone(uint32_t ulResult, void* pvContext)
+{
+  (void)pvContext;
+  ulDoneTicks = SysTick_GetValueLow();
+  ulImageCrc = ulResult;
+  eImageCheck = (ulResult == _image_trailer.ulCrc) ? IMAGE_CHECK_OK : IMAGE_CHECK_FAILED;
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Start image CRC check in the background
+ *
+ * @note
+ * Requires the DMA/CRC unit and its interrupt to be initialised (vInitHW_DMA(),
+ * vInitHW_IRQ()).
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vStartImageCheck(void)
+{
+  const ImageTrailerTypeDef* psTrailer = &_image_trailer;
+  if (psTrailer->ulMagic != IMAGE_TRAILER_MAGIC)
+  {
+    eImageCheck = IMAGE_CHECK_INVALID;
+    return;
+  }
+  if (psTrailer->ulCrc == IMAGE_CRC_UNSEALED)
+  {
+    eImageCheck = IMAGE_CHECK_UNSEALED;
+    return;
+  }
+
+  /* DMA reads flash through its physical address, the
+   * image may be linked to the boot alias at 0           */
+  uintptr_t uStart = FLASH_BASE | (psTrailer->ulStart & (FLASH_BASE - 1));
+  ulStartTicks = SysTick_GetValueLow();
+  while (!bStartCrc32((const void*)uStart, psTrailer->ulLength, vImageCrcDone, NULL));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get image check result
+ *
+ * @return  (ImageCheckTypeDef)  Result, or IMAGE_CHECK_PENDING
+ * @date  18.10.2026
+ ******************************************************************************/
+ImageCheckTypeDef eGetImageCheckResult(void)
+{
+  return eImageCheck;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print image check result, waiting for the check to complete
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPrintImageInfo(void)
+{
+  const ImageTrailerTypeDef* psTrailer = &_image_trailer;
+  while (eImageCheck == IMAGE_CHECK_PENDING);
+
+  printf(
+    "-- Image -----------------------------------------\r\n"
+  );
+
+  switch (eImageCheck)
+  {
+    case IMAGE_CHECK_OK:
+    case IMAGE_CHECK_FAILED:
+    {
+      /* SysTick runs at HCLK/8                           */
+      uint32_t ulUs = (uint32_t)(((uint64_t)(ulDoneTicks - ulStartTicks) * 8000000ULL) / SystemCoreClock);
+      printf("Image: 0x%08lX, %lu bytes\r\n", psTrailer->ulStart, psTrailer->ulLength);
+      if (eImageCheck == IMAGE_CHECK_OK)
+      {
+        printf("CRC-32: %08lX OK (%lu us)\r\n", ulImageCrc, ulUs);
+      }
+      else
+      {
+        printf(VT100_COLOR_FGRED "CRC-32: %08lX FAILED, expected %08lX (%lu us)\r\n" VT100_COLOR_RESET,
+          ulImageCrc, psTrailer->ulCrc, ulUs);
+      }
+      break;
+    }
+
+    case IMAGE_CHECK_UNSEALED:
+      printf("CRC-32: not sealed (run tools/image_trailer.py)\r\n");
+      break;
+
+    default:
+      printf(VT100_COLOR_FGRED "Image trailer not found\r\n" VT100_COLOR_RESET);
+      break;
+  }
+}
@@ -0,0 +1,53 @@
+/*!****************************************************************************
+ * @file
+ * image.h
+ *
+ * @brief
+ * Boot-time firmware image integrity check
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef IMAGE_H_
+#define IMAGE_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Image trailer marker ("IMG1"), see Controller/app_sections.ld      */
+#define IMAGE_TRAILER_MAGIC           0x31474D49UL
+
+/*! @brief CRC field value of an image that has not been sealed               */
+#define IMAGE_CRC_UNSEALED            0xFFFFFFFFUL
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Image trailer, placed behind the last flash section by the linker.
+ *  The CRC is filled in by tools/image_trailer.py after linking.            */
+typedef struct
+{
+  uint32_t ulMagic;                   /*!< IMAGE_TRAILER_MAGIC                */
+  uint32_t ulStart;                   /*!< Image start address                */
+  uint32_t ulLength;                  /*!< Image length up to the trailer     */
+  uint32_t ulCrc;                     /*!< CRC-32 over the image              */
+} ImageTrailerTypeDef;
+
+/*! @brief Image check result                                                 */
+typedef enum
+{
+  IMAGE_CHECK_PENDING = 0,            /*!< Check in progress                  */
+  IMAGE_CHECK_OK,                     /*!< CRC matches                        */
+  IMAGE_CHECK_FAILED,                 /*!< CRC mismatch                       */
+  IMAGE_CHECK_UNSEALED,               /*!< No CRC stored in trailer           */
+  IMAGE_CHECK_INVALID                 /*!< Trailer not found                  */
+} ImageCheckTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vStartImageCheck(void);
+ImageCheckTypeDef eGetImageCheckResult(void);
+void vPrintImageInfo(void);
+
+#endif /* IMAGE_H_ */
@@ -0,0 +1,188 @@
+/*!****************************************************************************
+ * @file
+ * installer.c
+ *
+ * @brief
+ * Update installer in the protected region at the start of flash
+ *
+ * The installer occupies the installer region (see flash_layout.h), which
+ * holds the reset entry (see installer_entry.S) and is never rewritten by a
+ * firmware update. After each reset, it looks up the current update state
+ * record. If the state is FWUPD_STATE_INSTALLING, the staged image is copied
+ * over the application before the application is started; otherwise the
+ * application is started right away. A copy interrupted by a power loss is
+ * thus repeated after the next reset, skipping the pages already copied. A
+ * copy which keeps failing verification is given up and recorded as
+ * FWUPD_STATE_FAILED. The application changes the state from installing to
+ * idle once it is running (see fwupd.c).
+ *
+ * All code runs from the installer region before the C runtime has been
+ * initialised: no initialised or zeroed variables, no library calls and no
+ * lookup tables in the application area may be used. The file is compiled
+ * without -msave-restore, LTO and loop pattern detection (see CMakeLists.txt).
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Reset entry moved to installer_entry.S
+ * @date  18.10.2026  Copy loop moved from hw_flash.c; limited copy attempts
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
+#include "ch32v10x.h"
+#include "hw_flash.h"
+#include "flash_layout.h"
+#include "offload.h"
+#include "fwupd.h"
+#include "installer.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief CRC-32 polynomial of the CRC unit (see offload.c)                  */
+#define INSTALLER_CRC32_POLY          0x04C11DB7UL
+
+
+/*- Exported functions -------------------------------------------------------*/
+/*! Vendor startup code at the start of the application area                  */
+extern void _start(void);
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Calculate state record check value
+ *
+ * Bitwise equivalent of ulCalcCrc32Sw() over all fields except ulCheck.
+ *
+ * @param[in] *psRecord   State record
+ * @return  (uint32_t)  CRC-32 over all fields except ulCheck
+ * @date  18.10.2026
+ ******************************************************************************/
+HW_FLASH_INSTALLER static uint32_t ulCalcRecordCheck(const FwUpdRecordTypeDef* psRecord)
+{
+  const uint32_t* pulWord = (const uint32_t*)psRecord;
+  uint32_t ulCrc = OFFLOAD_CRC32_INIT;
+
+  /* Words are fed MSB first                              */
+  for (unsigned i = 0; i < offsetof(FwUpdRecordTypeDef, ulCheck) / sizeof(uint32_t); ++i)
+  {
+    ulCrc ^= pulWord[i];
+    for (unsigned uBit = 0; uBit < 32; ++uBit)
+    {
+      ulCrc = (ulCrc & 0x80000000UL) ? (ulCrc << 1) ^ INSTALLER_CRC32_POLY : (ulCrc << 1);
+    }
+  }
+  return ulCrc;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Find current state record
+ *
+ * @return  (const FwUpdRecordTypeDef*)  Valid record with the highest sequence
+ *                                       number, NULL if there is none
+ * @date  18.10.2026
+ ******************************************************************************/
+HW_FLASH_INSTALLER static const FwUpdRecordTypeDef* psFindRecord(void)
+{
+  const FwUpdRecordTypeDef* psCurrent = NULL;
+  for (unsigned i = 0; i < FWUPD_NUM_RECORDS; ++i)
+  {
+    const FwUpdRecordTypeDef* psRecord = (const void*)(FLASH_FWUPD_STATE_ADDR + i * HW_FLASH_PAGE_SIZE);
+    if ((psRecord->ulMagic != FWUPD_RECORD_MAGIC) || (psRecord->ulCheck != ulCalcRecordCheck(psRecord))) continue;
+    if ((psCurrent == NULL) || ((int32_t)(psRecord->ulSeq - psCurrent->ulSeq) > 0)) psCurrent = psRecord;
+  }
+  return psCurrent;
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Write state record marking the installation as failed
+ *
+ * The record follows the current record in the next slot, as written by
+ * fwupd.c.
+ *
+ * @param[in] *psRecord   Current state record
+ * @date  18.10.2026
+ ******************************************************************************/
+HW_FLASH_INSTALLER static void vWriteFailedRecord(const FwUpdRecordTypeDef* psRecord)
+{
+  uint32_t aulPage[HW_FLASH_PAGE_SIZE / sizeof(uint32_t)];
+  const uint32_t* pulRecord = (const uint32_t*)psRecord;
+  for (unsigned i = 0; i < HW_FLASH_PAGE_SIZE / sizeof(uint32_t); ++i)
+  {
+    aulPage[i] = (i < sizeof(FwUpdRecordTypeDef) / sizeof(uint32_t)) ? pulRecord[i] : 0xFFFFFFFFUL;
+  }
+
+  FwUpdRecordTypeDef* psFailed = (FwUpdRecordTypeDef*)aulPage;
+  psFailed->ulSeq++;
+  psFailed->ulState = FWUPD_STATE_FAILED;
+  psFailed->ulCheck = ulCalcRecordCheck(psFailed);
+
+  unsigned uSlot = ((uintptr_t)psRecord - FLASH_FWUPD_STATE_ADDR) / HW_FLASH_PAGE_SIZE;
+  uSlot = (uSlot + 1) % FWUPD_NUM_RECORDS;
+  bHW_FlashInstallPage(FLASH_FWUPD_STATE_ADDR + uSlot * HW_FLASH_PAGE_SIZE, aulPage);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Copy image page by page, skipping pages which already match
+ *
+ * Pages copied before an interruption are skipped when the copy is repeated.
+ *
+ * @param[in] ulDst       Destination address (FLASH_BASE-based, page-aligned)
+ * @param[in] ulSrc       Source address (FLASH_BASE-based, page-aligned)
+ * @param[in] uLen        Length in bytes
+ * @return  (bool)      true, if all pages read back correctly
+ * @date  18.10.2026
+ ******************************************************************************/
+HW_FLASH_INSTALLER bool bInstallImage(uint32_t ulDst, uint32_t ulSrc, unsigned uLen)
+{
+  bool bOk = true;
+  for (unsigned uOfs = 0; uOfs < uLen; uOfs += HW_FLASH_PAGE_SIZE)
+  {
+    const volatile uint32_t* pulDst = (const volatile uint32_t*)(uintptr_t)(ulDst + uOfs);
+    const uint32_t* pulSrc = (const uint32_t*)(uintptr_t)(ulSrc + uOfs);
+    unsigned i = 0;
+    while ((i < HW_FLASH_PAGE_SIZE / sizeof(uint32_t)) && (pulDst[i] == pulSrc[i])) ++i;
+    if (i == HW_FLASH_PAGE_SIZE / sizeof(uint32_t)) continue;
+
+    if (!bHW_FlashInstallPage(ulDst + uOfs, pulSrc)) bOk = false;
+  }
+  return bOk;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Complete a pending installation and start the application
+ *
+ * A copy failing verification is repeated up to INSTALLER_MAX_ATTEMPTS times
+ * in total. The installation is then marked as failed in the update state,
+ * and the application is started regardless; its image check reports the
+ * incomplete image (see image.c), and a new update may be sent.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Limited copy attempts
+ ******************************************************************************/
+HW_FLASH_INSTALLER void vRunInstaller(void)
+{
+  const FwUpdRecordTypeDef* psRecord = psFindRecord();
+  if ((psRecord != NULL) && (psRecord->ulState == FWUPD_STATE_INSTALLING) &&
+      (psRecord->ulSize <= FLASH_APP_SIZE))
+  {
+    uint32_t ulLen = (psRecord->ulSize + HW_FLASH_PAGE_SIZE - 1) & ~(HW_FLASH_PAGE_SIZE - 1);
+    unsigned uAttempts = 1;
+    while (!bInstallImage(FLASH_APP_ADDR, FLASH_STAGING_ADDR, ulLen))
+    {
+      if (++uAttempts > INSTALLER_MAX_ATTEMPTS)
+      {
+        vWriteFailedRecord(psRecord);
+        break;
+      }
+    }
+  }
+
+  _start();
+  while (1);
+}
@@ -0,0 +1,29 @@
+/*!****************************************************************************
+ * @file
+ * installer.h
+ *
+ * @brief
+ * Update installer in the protected region at the start of flash
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Limited copy attempts
+ ******************************************************************************/
+
+#ifndef INSTALLER_H_
+#define INSTALLER_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Image copy attempts per reset before the installation is given up */
+#define INSTALLER_MAX_ATTEMPTS        3
+
+
+/*- Exported functions -------------------------------------------------------*/
+bool bInstallImage(uint32_t ulDst, uint32_t ulSrc, unsigned uLen);
+void vRunInstaller(void) __attribute__((noreturn));
+
+#endif /* INSTALLER_H_ */
@@ -0,0 +1,211 @@
+/*!****************************************************************************
+ * @file
+ * irqprof.c
+ *
+ * @brief
+ * Interrupt entry latency and duration profiling
+ *
+ * Instrumented handlers call IRQPROF_ENTER() and IRQPROF_EXIT(), which time
+ * the handler body using the SysTick counter. Durations are collected into
+ * per-vector histograms with logarithmic bins.
+ *
+ * Entry latency cannot be observed for peripheral interrupts, as the time of
+ * the interrupt request is unknown. It is measured on two test vectors which
+ * are triggered by software: the software interrupt, declared with the
+ * hardware stack attribute (RV_INTERRUPT), and the otherwise unused TIM4
+ * interrupt, declared with a standard compiler-generated prologue. The delay
+ * before each trigger is varied to even out the SysTick count resolution of
+ * 8 HCLK cycles.
+ *
+ * The instrumentation is only compiled in if USE_IRQ_PROFILE is defined in
+ * irqprof.h.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "ch32v10x.h"
+#include "hw_irq.h"
+#include "hw_stk.h"
+#include "irqprof.h"
+
+#ifdef USE_IRQ_PROFILE
+
+/*- Private variables --------------------------------------------------------*/
+/*! Per-vector statistics                                                     */
+static IrqProfStatsTypeDef asStats[IRQPROF_NUM_VECTORS];
+
+/*! Vector names                                                              */
+static const char* const apszNames[IRQPROF_NUM_VECTORS] = {
+  [IRQPROF_TEST_FAST] = "test_fast",
+  [IRQPROF_TEST_STD]  = "test_std",
+  [IRQPROF_DMA_M2M]   = "dma_m2m",
+  [IRQPROF_DMA_ADC]   = "dma_adc",
+  [IRQPROF_TIM3]      = "tim3"
+};
+
+/*! SysTick count at latency test trigger                                     */
+static volatile uint32_t ulTriggerTicks;
+
+/*! Latency test handler executed                                             */
+static volatile bool bTestDone;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Determine histogram bin for a duration
+ *
+ * @param[in] ulTicks     Duration in SysTick counts
+ * @return  (unsigned)  Bin index
+ * @date  18.10.2026
+ ******************************************************************************/
+static unsigned uGetBin(uint32_t ulTicks)
+{
+  unsigned uBin = 0;
+  while ((ulTicks > 0) && (uBin < IRQPROF_NUM_BINS - 1))
+  {
+    ulTicks >>= 1;
+    ++uBin;
+  }
+  return uBin;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Convert SysTick counts into nanoseconds at the current HCLK
+ *
+ * @param[in] ulSum       Sum of SysTick counts
+ * @param[in] ulCount     Number of samples
+ * @return  (uint32_t)  Average duration in ns
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulTicksToNs(uint32_t ulSum, uint32_t ulCount)
+{
+  if (ulCount == 0) return 0;
+  return (uint32_t)(((uint64_t)ulSum * HW_STK_HCLK_DIV * 1000000000ULL) /
+    SystemCoreClock / ulCount);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Trigger a latency test vector repeatedly
+ *
+ * @param[in] eIrq        Interrupt number of test vector
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vRunLatencyTest(IRQn_Type eIrq)
+{
+  bHW_IrqCmd(eIrq, ENABLE);
+  for (unsigned i = 0; i < IRQPROF_TEST_COUNT; ++i)
+  {
+    /* Vary trigger phase relative to the SysTick prescaler */
+    for (volatile unsigned j = 0; j < (i % HW_STK_HCLK_DIV); ++j);
+
+    bTestDone = false;
+    ulTriggerTicks = SysTick_GetValueLow();
+    PFIC_SetPendingIRQ(eIrq);
+    while (!bTestDone);
+  }
+  bHW_IrqCmd(eIrq, DISABLE);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print histogram line
+ *
+ * @param[in] pszLabel    Line label
+ * @param[in] *pulBins    Histogram bins
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vPrintHistogram(const char* pszLabel, const uint32_t* pulBins)
+{
+  printf("  %-8s", pszLabel);
+  for (unsigned i = 0; i < IRQPROF_NUM_BINS; ++i) printf(" %6lu", pulBins[i]);
+  printf("\r\n");
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Record handler duration
+ *
+ * @param[in] eVector     Profiled vector
+ * @param[in] ulStart     SysTick count at handler entry
+ * @date  18.10.2026
+ ******************************************************************************/
+void vRecordIrqDuration(IrqProfVectorTypeDef eVector, uint32_t ulStart)
+{
+  uint32_t ulTicks = SysTick_GetValueLow() - ulStart;
+  IrqProfStatsTypeDef* psStats = &asStats[eVector];
+  ++psStats->ulCount;
+  psStats->ulDurationSum += ulTicks;
+  if (ulTicks > psStats->ulDurationMax) psStats->ulDurationMax = ulTicks;
+  ++psStats->aulDuration[uGetBin(ulTicks)];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Latency test vector handler body
+ *
+ * @param[in] eVector     Test vector
+ * @param[in] ulEntry     SysTick count at handler entry
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHandleIrqProfTest(IrqProfVectorTypeDef eVector, uint32_t ulEntry)
+{
+  uint32_t ulTicks = ulEntry - ulTriggerTicks;
+  asStats[eVector].ulLatencySum += ulTicks;
+  ++asStats[eVector].aulLatency[uGetBin(ulTicks)];
+  bTestDone = true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run latency tests, print and reset interrupt statistics
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPrintIrqProf(void)
+{
+  vRunLatencyTest(Software_IRQn);
+  vRunLatencyTest(TIM4_IRQn);
+
+  /* Take snapshot and restart collection                 */
+  static IrqProfStatsTypeDef asSnapshot[IRQPROF_NUM_VECTORS];
+  __disable_irq();
+  memcpy(asSnapshot, asStats, sizeof(asSnapshot));
+  memset(asStats, 0, sizeof(asStats));
+  __enable_irq();
+
+  printf(
+    "-- Interrupts ------------------------------------\r\n"
+  );
+  vHW_PrintIrqCfg();
+  printf("\r\nHistogram bins in SysTick counts (%u HCLK cycles):\r\n",
+    HW_STK_HCLK_DIV);
+  printf("  %-8s      0      1    2-3    4-7   8-15  16-31  32-63    64+\r\n", "");
+  for (unsigned i = 0; i < IRQPROF_NUM_VECTORS; ++i)
+  {
+    const IrqProfStatsTypeDef* psStats = &asSnapshot[i];
+    printf("%s: %lu calls, duration avg %lu ns, max %lu ns", apszNames[i],
+      psStats->ulCount, ulTicksToNs(psStats->ulDurationSum, psStats->ulCount),
+      ulTicksToNs(psStats->ulDurationMax, 1));
+    if ((i == IRQPROF_TEST_FAST) || (i == IRQPROF_TEST_STD))
+    {
+      printf(", latency avg %lu ns", ulTicksToNs(psStats->ulLatencySum, psStats->ulCount));
+    }
+    printf("\r\n");
+    if (psStats->ulCount == 0) continue;
+    if ((i == IRQPROF_TEST_FAST) || (i == IRQPROF_TEST_STD))
+    {
+      vPrintHistogram("latency", psStats->aulLatency);
+    }
+    vPrintHistogram("duration", psStats->aulDuration);
+  }
+}
+
+#endif /* USE_IRQ_PROFILE */
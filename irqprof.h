@@ -0,0 +1,71 @@
+/*!****************************************************************************
+ * @file
+ * irqprof.h
+ *
+ * @brief
+ * Interrupt entry latency and duration profiling
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef IRQPROF_H_
+#define IRQPROF_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+#include "ch32v10x.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Enable interrupt profiling instrumentation                         */
+//#define USE_IRQ_PROFILE
+
+/*! @brief Number of histogram bins (bin n >= 1 counts 2^(n-1)..2^n-1 ticks,
+ *  the last bin also counts all longer durations)                           */
+#define IRQPROF_NUM_BINS              8
+
+/*! @brief Number of triggers per latency test vector                         */
+#define IRQPROF_TEST_COUNT            256
+
+/*! @brief Mark handler entry, shall be the first statement of a handler
+ *  @{                                                                        */
+#ifdef USE_IRQ_PROFILE
+#define IRQPROF_ENTER()               uint32_t ulIrqProfStart = SysTick_GetValueLow()
+#define IRQPROF_EXIT(eVector)         vRecordIrqDuration((eVector), ulIrqProfStart)
+#else
+#define IRQPROF_ENTER()
+#define IRQPROF_EXIT(eVector)
+#endif /* USE_IRQ_PROFILE */
+/*! @}                                                                        */
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Profiled interrupt vectors                                         */
+typedef enum
+{
+  IRQPROF_TEST_FAST = 0,              /*!< Test vector, hardware stack        */
+  IRQPROF_TEST_STD,                   /*!< Test vector, software prologue     */
+  IRQPROF_DMA_M2M,                    /*!< DMA memory-to-memory channel       */
+  IRQPROF_DMA_ADC,                    /*!< DMA ADC capture channel            */
+  IRQPROF_TIM3,                       /*!< TIM3 update, control loop          */
+  IRQPROF_NUM_VECTORS
+} IrqProfVectorTypeDef;
+
+/*! @brief Per-vector statistics in SysTick counts (HCLK/8)                   */
+typedef struct
+{
+  uint32_t ulCount;                   /*!< Number of handler executions       */
+  uint32_t ulLatencySum;              /*!< Sum of entry latencies             */
+  uint32_t ulDurationSum;             /*!< Sum of handler durations           */
+  uint32_t ulDurationMax;             /*!< Longest handler duration           */
+  uint32_t aulLatency[IRQPROF_NUM_BINS];  /*!< Entry latency histogram        */
+  uint32_t aulDuration[IRQPROF_NUM_BINS]; /*!< Duration histogram             */
+} IrqProfStatsTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vRecordIrqDuration(IrqProfVectorTypeDef eVector, uint32_t ulStart);
+void vHandleIrqProfTest(IrqProfVectorTypeDef eVector, uint32_t ulEntry);
+void vPrintIrqProf(void);
+
+#endif /* IRQPROF_H_ */
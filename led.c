@@ -6,18 +6,21 @@
  * Breathing animation using PWM on TIM3 Channel 1
  *
  * @date  17.02.2022
+ * @date  18.10.2026  Interval follows HCLK changes
+ * @date  18.10.2026  Paused while control loop drives the output
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
 #include <stdbool.h>
 #include "ch32v10x.h"
 #include "hw_stk.h"
+#include "control.h"
 #include "led.h"
 
 
 /*- Macros -------------------------------------------------------------------*/
-/*! @brief SysTick timer counter interval for brightness changes              */
-#define LED_TIME_INTER                10000UL
+/*! @brief Interval for brightness changes in ms                             */
+#define LED_TIME_INTER_MS             10
 
 
 /*- Private variables --------------------------------------------------------*/
@@ -51,12 +54,17 @@ void vInitLed(void)
  *
  * @date  17.02.2022
  * @date  24.02.2022  Changed SysTick naming convention
+ * @date  18.10.2026  Interval converted at current HCLK
+ * @date  18.10.2026  Paused while control loop is running
  ******************************************************************************/
 void vPollLed(void)
 {
+  /* Output in use by control loop                        */
+  if (bIsControlRunning()) return;
+
   /* Early exit until minimum interval is reached         */
   uint32_t ulNow = SysTick_GetValueLow();
-  if (ulNow - ulLastChange < LED_TIME_INTER)
+  if (ulNow - ulLastChange < ulHW_STK_MsToTicks(LED_TIME_INTER_MS))
   {
     return;
   }
@@ -7,7 +7,7 @@
  *
  * This project contains a simple set of modules to get the MCU running in a
  * minimal configuration:
- *  - Polling-mode serial I/O on USART1 (connected to WCH-Link VCP)
+ *  - Serial I/O on USART1 (connected to WCH-Link VCP), DMA reception
  *  - SysTick enabled and using empty dummy interrupt handler
  *  - TIM3 PWM output to LED
  *  - ADC1 internal temperature sensor and Vrefint readout
@@ -25,30 +25,104 @@
  * @date  04.03.2022  Added EEPROM demo
  * @date  10.03.2022  Added information block readout; Disabled EEPROM demo for
  *                    default configuration
+ * @date  18.10.2026  Moved command processing into shell module; added
+ *                    benchmark command
+ * @date  18.10.2026  Added stack painting and memory usage command
+ * @date  18.10.2026  Added crash report printout
+ * @date  18.10.2026  Added memory pools
+ * @date  18.10.2026  Added binary RPC protocol
+ * @date  18.10.2026  Added image integrity check
+ * @date  18.10.2026  Added firmware update
+ * @date  18.10.2026  Added flash data logger
+ * @date  18.10.2026  Added clock switching command
+ * @date  18.10.2026  Added baud rate table command
+ * @date  18.10.2026  Added interrupt profile command
+ * @date  18.10.2026  Added event queue; clock info printed on change event
+ * @date  18.10.2026  Added compression statistics command
+ * @date  18.10.2026  Added ADC spectrum command
+ * @date  18.10.2026  EEPROM demo uses striped EEPROM volume
+ * @date  18.10.2026  EEPROM hexdump uses stream reader
+ * @date  18.10.2026  Added control loop command
+ * @date  18.10.2026  Added output channel multiplexer
+ * @date  18.10.2026  Serial port statistics added to baud rate command
+ * @date  18.10.2026  Added boot sequencer
+ * @date  18.10.2026  Memory pools optional
+ * @date  18.10.2026  Benchmarks and spectrum analysis optional
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
 #include <stdio.h>
 #include <string.h>
-#include <ctype.h>
 #include "ch32v10x.h"
 #include "hw_init.h"
+#include "hw_clk.h"
+#include "hw_stk.h"
+#include "hw_gpio.h"
 #include "hw_adc.h"
+#include "hw_usart.h"
+#include "hw_tim3.h"
+#include "hw_i2c2.h"
+#include "hw_dma.h"
+#include "hw_irq.h"
 #include "syscalls.h"
 #include "dbgser.h"
 #include "led.h"
 #include "eeprom.h"
+#include "eevol.h"
+#include "hexdump.h"
+#include "shell.h"
+#include "bench.h"
+#include "memmon.h"
+#include "crash.h"
+#include "pool.h"
+#include "rpc.h"
+#include "image.h"
+#include "fwupd.h"
+#include "flashlog.h"
+#include "irqprof.h"
+#include "event.h"
+#include "compress.h"
+#include "spectrum.h"
+#include "control.h"
+#include "mux.h"
+#include "boot.h"
 
 
 /*- Macros -------------------------------------------------------------------*/
-/*! @brief Enable 24C64 EEPROM demo                                           */
-//#define USE_EEPROM_DEMO
-
 /*! @brief Number of bytes to be read for EEPROM hexdump                      */
 #define EEPROM_NUM_BYTES              256
 
-/*! @brief EEPROM Hexdump items per row                                       */
-#define HEXDUMP_ROW_ITEMS             16
+/*! @brief Number of bytes per EEPROM hexdump row                             */
+#define EEPROM_ROW_BYTES              16
+
+/*! Boot steps which set up peripherals with interrupts                       */
+#define BOOT_DEPS_PERIPH              (BOOT_DEP(BOOT_USART) | BOOT_DEP(BOOT_TIM3) | \
+                                       BOOT_DEP(BOOT_ADC) | BOOT_DEP(BOOT_I2C2) | BOOT_DEP(BOOT_DMA))
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! Boot steps, indices into the boot step table                              */
+typedef enum
+{
+  BOOT_GPIO = 0,
+  BOOT_USART,
+  BOOT_TIM3,
+  BOOT_ADC,
+  BOOT_I2C2,
+  BOOT_DMA,
+  BOOT_IRQ,
+  BOOT_IMAGE,
+  BOOT_FWUPD,
+  BOOT_LED,
+  BOOT_CRASH,
+  BOOT_POOLS,
+  BOOT_SYSCALLS,
+  BOOT_SHELL,
+  BOOT_EVENTS,
+  BOOT_ADC_CAL,
+  BOOT_FLASHLOG,
+  BOOT_NUM_STEPS
+} BootStepIdTypeDef;
 
 
 /*- Private variables --------------------------------------------------------*/
@@ -143,6 +217,7 @@ static void vPrintCoreInfo(void)
  *
  * @date  14.02.2022
  * @date  03.03.2022  Modified to use printf()
+ * @date  18.10.2026  Added clock configuration and bus clocks
  ******************************************************************************/
 static void vPrintSysCoreClk(void)
 {
@@ -154,6 +229,113 @@ static void vPrintSysCoreClk(void)
   unsigned uMHz = uKHz / 1000;
   unsigned uKHzRem = uKHz % 1000;
   printf("f_HCLK = %d.%03d MHz\r\n", uMHz, uKHzRem);
+
+  HwClkFreqTypeDef sFreq;
+  vHW_GetClockFreq(&sFreq);
+  printf("Config: %s\r\n", pszHW_GetClockConfigName(eHW_GetClockConfig()));
+  printf("f_PCLK1 = %lu kHz, f_PCLK2 = %lu kHz, f_ADCCLK = %lu kHz\r\n",
+    sFreq.ulPclk1 / 1000, sFreq.ulPclk2 / 1000, sFreq.ulAdcclk / 1000);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Switch to next clock tree configuration
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Clock info printed by change event subscriber
+ * @date  18.10.2026  Flush multiplexed output
+ ******************************************************************************/
+static void vSwitchSysCoreClk(void)
+{
+  HwClkConfigTypeDef eNext = (eHW_GetClockConfig() + 1) % HW_CLK_NUM_CONFIGS;
+  printf("Switching to %s...\r\n", pszHW_GetClockConfigName(eNext));
+
+  /* Pending output would be garbled by the switch        */
+  fflush(stdout);
+  vFlushMux();
+  if (!bHW_SetClockConfig(eNext)) fprintf(stderr, "HSE failed to start.\r\n");
+}
+
+/*!****************************************************************************
+ * @brief
+ * Clock change notifier: publish clock change event
+ *
+ * @param[in] *psFreq     Bus clock frequencies
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vPublishClockChange(const HwClkFreqTypeDef* psFreq)
+{
+  bPublishEvent(EVENT_TOPIC_CLOCK, eHW_GetClockConfig(), psFreq->ulHclk);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Clock change event subscriber: print new clock configuration
+ *
+ * @param[in] *psEvent    Event
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vOnClockChange(const EventTypeDef* psEvent)
+{
+  (void)psEvent;
+  vPrintSysCoreClk();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print serial port statistics, and achievable baud rates of the debugger
+ * serial port at its current kernel clock
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added statistics of all enabled ports
+ * @date  18.10.2026  Added debugger serial port message queue statistics
+ ******************************************************************************/
+static void vPrintSerialPorts(void)
+{
+  static const uint32_t aulRates[] = {
+    115200, 230400, 460800, 921600, 1000000, 2000000
+  };
+
+  printf(
+    "-- Serial ports ----------------------------------\r\n"
+    "Port       Baud   RX bytes   TX bytes   Blocks RX peak Errors\r\n"
+  );
+  for (unsigned i = 0; i < HW_USART_NUM; ++i)
+  {
+    if (!bHW_USART_IsEnabled(i)) continue;
+    HwUsartStatsTypeDef sStats;
+    vHW_USART_GetStats(i, &sStats);
+    printf("%-6s %8lu %10lu %10lu %8lu %3u/%-3u %6lu\r\n",
+      pszHW_USART_GetName(i), ulHW_USART_GetBaudRate(i), sStats.ulRxBytes, sStats.ulTxBytes,
+      sStats.ulTxBlocks, sStats.uRxPeak, uHW_USART_GetRxBufSize(i), sStats.ulLineErrors);
+  }
+
+  DbgSerStatsTypeDef sMsgStats;
+  vGetDbgSerStats(&sMsgStats);
+  printf("Messages: %lu (%lu segments, %lu bytes), queue peak %u/%u, rejected %lu\r\n",
+    sMsgStats.ulMessages, sMsgStats.ulSegments, sMsgStats.ulBytes, sMsgStats.uPeak,
+    DBGSER_MSG_QUEUE_LEN, sMsgStats.ulQueueFull);
+
+  printf(
+    "-- Baud rates (%s) ---------------------------\r\n",
+    pszHW_USART_GetName(DBGSER_USART)
+  );
+
+  uint32_t ulPclk = ulHW_USART_GetPclk(DBGSER_USART);
+  uint32_t ulCurrent = ulHW_USART_GetBaudRate(DBGSER_USART);
+  for (unsigned i = 0; i < sizeof(aulRates) / sizeof(aulRates[0]); ++i)
+  {
+    int32_t lError = lHW_USART_CalcBaudError(ulPclk, aulRates[i]);
+    printf("%c %7lu: ", (aulRates[i] == ulCurrent) ? '*' : ' ', aulRates[i]);
+    if (lError == INT32_MAX)
+    {
+      printf("out of range\r\n");
+      continue;
+    }
+    printf("BRR = 0x%04X, error = %+ld ppm%s\r\n",
+      uiHW_USART_CalcBrr(ulPclk, aulRates[i]), lError,
+      ((lError > HW_USART_BAUD_MAX_ERROR) || (lError < -HW_USART_BAUD_MAX_ERROR)) ? " (unusable)" : "");
+  }
 }
 
 /*!****************************************************************************
@@ -198,38 +380,21 @@ static void vPrintAnalogInfo(void)
 
 /*!****************************************************************************
  * @brief
- * Print Hexdump of memory buffer
+ * Append analog inputs snapshot to flash log
  *
- * @param[in] *pBuffer    Data buffer
- * @param[in] uLen        Number of bytes to display
- * @param[in] uBaseAdr    Base address for row counters
- * @date  10.03.2022
+ * Record: temp. sensor voltage in mV, temperature in degC, Vrefint in mV
+ * (16 bits each)
+ *
+ * @date  18.10.2026
  ******************************************************************************/
-static void vPrintHexDump(const uint8_t* pBuffer, unsigned uLen, unsigned uBaseAdr)
+static void vLogAnalogInfo(void)
 {
-  for (unsigned uRow = 0; uRow < uLen / HEXDUMP_ROW_ITEMS; ++uRow)
-  {
-    /* Address or Offset                                  */
-    unsigned uRowAddr = uRow * HEXDUMP_ROW_ITEMS;
-    printf("%08x  ", uRowAddr + uBaseAdr);
-
-    /* Byte columns                                       */
-    for (unsigned uCol = 0; uCol < HEXDUMP_ROW_ITEMS; ++uCol)
-    {
-      unsigned char ucData = pBuffer[uRowAddr + uCol];
-      printf("%02x ", ucData);
-      if (uCol == (HEXDUMP_ROW_ITEMS / 2 - 1)) putchar(' ');
-    }
-
-    /* ASCII text representation                          */
-    putchar(' ');
-    for (unsigned uCol = 0; uCol < HEXDUMP_ROW_ITEMS; ++uCol)
-    {
-      unsigned char ucData = pBuffer[uRowAddr + uCol];
-      putchar(isprint(ucData) ? ucData : '.');
-    }
-    printf("\r\n");
-  }
+  uint16_t auiRecord[3];
+  auiRecord[0] = uiHW_GetAdcConversionValue_mV(ADC_Channel_TempSensor);
+  auiRecord[1] = (uint16_t)TempSensor_Volt_To_Temper(auiRecord[0]);
+  auiRecord[2] = uiHW_GetAdcConversionValue_mV(ADC_Channel_Vrefint);
+  bWriteFlashLog(auiRecord, sizeof(auiRecord));
+  vPrintFlashLogInfo();
 }
 
 #ifdef USE_EEPROM_DEMO
@@ -239,20 +404,36 @@ static void vPrintHexDump(const uint8_t* pBuffer, unsigned uLen, unsigned uBaseA
  *
  * @date  04.03.2022
  * @date  10.03.2022  Moved hexdump printout into separate routine
+ * @date  18.10.2026  Read from EEPROM volume
+ * @date  18.10.2026  Read row by row using stream reader; print bus usage
  ******************************************************************************/
 static void vPrintEepromData(void)
 {
-  unsigned char aucBuffer[EEPROM_NUM_BYTES];
+  static EepromStreamTypeDef sStream;
+  unsigned char aucRow[EEPROM_ROW_BYTES];
+  vPrintEepromVolumeInfo();
+  if (!bOpenEepromStream(&sStream, 0, EEPROM_NUM_BYTES))
+  {
+    printf("Reading EEPROM failed.\r\n");
+    return;
+  }
 
-  /* Time readout into buffer                             */
-  printf("Reading EEPROM... ");
-  unsigned uStart = SysTick_GetValueLow();
-  vReadEeprom(aucBuffer, 0, EEPROM_NUM_BYTES);
-  unsigned uDuration = (SysTick_GetValueLow() - uStart) / ((HSI_VALUE / 8) / 1000);
-  printf("done. Read %d bytes in %d ms.\r\n", EEPROM_NUM_BYTES, uDuration);
+  /* Hexdump printout, timing the readout only            */
+  EepromStatsTypeDef sBefore, sAfter;
+  vGetEepromStats(&sBefore);
+  uint32_t ulTicks = 0;
+  for (unsigned uAddr = 0; uAddr < EEPROM_NUM_BYTES; uAddr += EEPROM_ROW_BYTES)
+  {
+    uint32_t ulStart = SysTick_GetValueLow();
+    uReadEepromStream(&sStream, aucRow, EEPROM_ROW_BYTES);
+    ulTicks += SysTick_GetValueLow() - ulStart;
+    vPrintHexDump(aucRow, EEPROM_ROW_BYTES, uAddr);
+  }
+  vGetEepromStats(&sAfter);
 
-  /* Hexdump printout                                     */
-  vPrintHexDump(aucBuffer, EEPROM_NUM_BYTES, 0);
+  printf("Read %d bytes in %lu ms, %lu bytes on bus, %lu saved by current-address reads.\r\n",
+    EEPROM_NUM_BYTES, ulTicks / ulHW_STK_MsToTicks(1),
+    sAfter.ulBusBytes - sBefore.ulBusBytes, sAfter.ulSavedBytes - sBefore.ulSavedBytes);
 }
 #endif /* USE_EEPROM_DEMO */
 
@@ -276,72 +457,106 @@ static void vPrintInfoBlockWords(void)
 
 /*!****************************************************************************
  * @brief
- * Serial input processing
+ * Reboot system
  *
- * @date  23.02.2022
- * @date  24.02.2022  Changed NVIC naming convention
- * @date  24.02.2022  Added analog inputs readout command; modified help text
- * @date  03.03.2022  Modified to use printf(), putchar(), getchar()
- * @date  04.03.2022  Added EEPROM readout demo
- * @date  10.03.2022  Added information block readout command
+ * @date  18.10.2026
  ******************************************************************************/
-static void vPollSerial(void)
+static void vReboot(void)
 {
-  /* Early exit, if no data is available                  */
-  if (!bIsDbgSerAvailable()) return;
-
-  /* Fetch character and print remote echo                */
-  char c = getchar();
-  printf("%c\r\n", c);
-
-  /* Process command                                      */
-  switch (c)
-  {
-    case '?':
-      /* Show available commands                          */
-      printf(
-        "Available Commands:\r\n"
-        "  ?    Show this help\r\n"
-        "  a    Print analog inputs info\r\n"
-#ifdef USE_EEPROM_DEMO
-        "  e    Read EEPROM\r\n"
-#endif /* USE_EEPROM_DEMO */
-        "  i    Read information block\r\n"
-        "  r    Reboot system\r\n"
-      );
-      break;
-
-    case 'a':
-      /* Print analog inputs info                         */
-      vPrintAnalogInfo();
-      break;
+  PFIC_SystemReset();
+}
 
+/*! Shell command table                                                       */
+static const ShellCmdTypeDef asShellCmds[] = {
+  { 'a', "Print analog inputs info",    vPrintAnalogInfo     },
+#ifdef USE_BENCH
+  { 'b', "Run benchmarks",              vRunBenchmarks       },
+#endif /* USE_BENCH */
+  { 'c', "Print last crash report",     vPrintCrashReport    },
 #ifdef USE_EEPROM_DEMO
-    case 'e':
-      /* Print EEPROM hexdump                             */
-      vPrintEepromData();
-      break;
+  { 'e', "Read EEPROM",                 vPrintEepromData     },
 #endif /* USE_EEPROM_DEMO */
+  { 'f', "Switch system clock",         vSwitchSysCoreClk    },
+  { 'g', "Log analog inputs snapshot",  vLogAnalogInfo       },
+  { 'i', "Read information block",      vPrintInfoBlockWords },
+  { 'l', "Print flash log status",      vPrintFlashLogInfo   },
+  { 'm', "Print memory usage",          vPrintMemInfo        },
+  { 'n', "Print event queue status",    vPrintEventStats     },
+  { 'o', "Print output channel stats",  vPrintMuxStats       },
+  { 'p', "Control loop settings",       vControlShell        },
+  { 'r', "Reboot system",               vReboot              },
+#ifdef USE_SPECTRUM
+  { 's', "Print ADC spectrum",          vPrintSpectrum       },
+#endif /* USE_SPECTRUM */
+  { 't', "Print boot timing",           vPrintBootInfo       },
+  { 'u', "Print serial port status",    vPrintSerialPorts    },
+#ifdef USE_IRQ_PROFILE
+  { 'v', "Print interrupt profile",     vPrintIrqProf        },
+#endif /* USE_IRQ_PROFILE */
+  { 'z', "Print compression stats",     vPrintCompressStats  }
+};
 
-    case 'i':
-      /* Read information block                           */
-      vPrintInfoBlockWords();
-      break;
-
-    case 'r':
-      /* Reboot command                                   */
-      PFIC_SystemReset();
-      break;
+/*! Event subscriber table                                                    */
+static const EventSubTypeDef asEventSubs[] = {
+  { EVENT_TOPIC_CLOCK,   vOnClockChange      },
+#ifdef USE_BENCH
+  { EVENT_TOPIC_BENCH,   vHandleBenchEvent   },
+#endif /* USE_BENCH */
+#ifdef USE_SPECTRUM
+  { EVENT_TOPIC_ADC_BLOCK, vHandleSpectrumEvent },
+#endif /* USE_SPECTRUM */
+};
 
-    default:
-      fprintf(stderr, "Unknown command. Press \"?\" to show available commands.\r\n");
-  }
+/*!****************************************************************************
+ * @brief
+ * Boot step: initialise command shell
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vInitShellCmds(void)
+{
+  vInitShell(asShellCmds, sizeof(asShellCmds) / sizeof(asShellCmds[0]));
+}
 
-  /* Input prompt                                         */
-  putchar('>');
-  fflush(stdout);
+/*!****************************************************************************
+ * @brief
+ * Boot step: initialise event queue and publish clock changes
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vInitEventSubs(void)
+{
+  vInitEvents(asEventSubs, sizeof(asEventSubs) / sizeof(asEventSubs[0]));
+  bHW_RegisterClockNotifier(vPublishClockChange);
 }
 
+/*! Boot step table. The interrupt configuration is applied after all
+ *  peripherals have been set up. The image check completes in the back-
+ *  ground while the system info is printed; ADC calibration and the flash
+ *  log page scan are not needed for the first prompt.                        */
+static const BootStepTypeDef asBootSteps[BOOT_NUM_STEPS] = {
+  [BOOT_GPIO]     = { "gpio",     vInitHW_GPIO,      NULL,           0,                                  BOOT_PHASE_EARLY    },
+  [BOOT_USART]    = { "usart",    vInitHW_USART,     NULL,           BOOT_DEP(BOOT_GPIO),                BOOT_PHASE_EARLY    },
+  [BOOT_TIM3]     = { "tim3",     vInitHW_TIM3,      NULL,           BOOT_DEP(BOOT_GPIO),                BOOT_PHASE_EARLY    },
+  [BOOT_ADC]      = { "adc",      vInitHW_ADC,       bHW_IsAdcReady, BOOT_DEP(BOOT_GPIO),                BOOT_PHASE_EARLY    },
+#ifndef USE_USART3
+  [BOOT_I2C2]     = { "i2c2",     vInitHW_I2C2,      NULL,           BOOT_DEP(BOOT_GPIO),                BOOT_PHASE_EARLY    },
+#endif /* USE_USART3 */
+  [BOOT_DMA]      = { "dma",      vInitHW_DMA,       NULL,           0,                                  BOOT_PHASE_EARLY    },
+  [BOOT_IRQ]      = { "irq",      vInitHW_IRQ,       NULL,           BOOT_DEPS_PERIPH,                   BOOT_PHASE_EARLY    },
+  [BOOT_IMAGE]    = { "image",    vStartImageCheck,  NULL,           BOOT_DEP(BOOT_IRQ),                 BOOT_PHASE_EARLY    },
+  [BOOT_FWUPD]    = { "fwupd",    vInitFwUpd,        NULL,           0,                                  BOOT_PHASE_EARLY    },
+  [BOOT_LED]      = { "led",      vInitLed,          NULL,           BOOT_DEP(BOOT_TIM3),                BOOT_PHASE_EARLY    },
+  [BOOT_CRASH]    = { "crash",    vInitCrash,        NULL,           BOOT_DEP(BOOT_IRQ),                 BOOT_PHASE_EARLY    },
+#ifdef USE_POOLS
+  [BOOT_POOLS]    = { "pools",    vInitPools,        NULL,           0,                                  BOOT_PHASE_EARLY    },
+#endif /* USE_POOLS */
+  [BOOT_SYSCALLS] = { "syscalls", vInitSyscalls,     NULL,           BOOT_DEP(BOOT_USART),               BOOT_PHASE_EARLY    },
+  [BOOT_SHELL]    = { "shell",    vInitShellCmds,    NULL,           BOOT_DEP(BOOT_SYSCALLS),            BOOT_PHASE_EARLY    },
+  [BOOT_EVENTS]   = { "events",   vInitEventSubs,    NULL,           0,                                  BOOT_PHASE_EARLY    },
+  [BOOT_ADC_CAL]  = { "adc_cal",  vHW_CalibrateAdc,  NULL,           BOOT_DEP(BOOT_ADC),                 BOOT_PHASE_DEFERRED },
+  [BOOT_FLASHLOG] = { "flashlog", vInitFlashLog,     NULL,           0,                                  BOOT_PHASE_DEFERRED }
+};
 
 /*!****************************************************************************
  * @brief
@@ -356,14 +571,27 @@ static void vPollSerial(void)
  * @date  03.03.2022  Modified to use printf()
  * @date  03.03.2022  Moved escape sequence into dbgser macro
  * @date  04.03.2022  Added EEPROM programming
+ * @date  18.10.2026  Moved serial input processing into shell module
+ * @date  18.10.2026  Added stack painting and overflow check
+ * @date  18.10.2026  Added crash report from previous run
+ * @date  18.10.2026  Added memory pools init
+ * @date  18.10.2026  Added binary RPC input processing
+ * @date  18.10.2026  Added image integrity check
+ * @date  18.10.2026  Added firmware update
+ * @date  18.10.2026  Added flash data logger
+ * @date  18.10.2026  Added event queue
+ * @date  18.10.2026  Added EEPROM volume detection
+ * @date  18.10.2026  Added output multiplexer and control loop polling
+ * @date  18.10.2026  Init moved into boot sequencer; deferred init steps run
+ *                    after the first prompt
  ******************************************************************************/
 int main(void)
 {
+  vInitMemMon();
   vInitHW();
-  vInitLed();
 
-  /* Init syscalls retargeting                            */
-  vInitSyscalls();
+  /* Init peripherals and modules by dependencies         */
+  vRunBoot(asBootSteps, BOOT_NUM_STEPS);
 
   /* Print system info                                    */
   printf(
@@ -386,18 +614,39 @@ int main(void)
   vPrintSysCoreClk();
   printf("\r\n");
   vPrintEsigInfo();
+  printf("\r\n");
+  vPrintImageInfo();
+  if (bIsCrashReportAvailable())
+  {
+    printf("\r\n");
+    vPrintCrashReport();
+  }
 #ifdef USE_EEPROM_DEMO
-  printf("\r\nWriting EEPROM... ");
-  vWriteEeprom((const unsigned char*)pszEepromData, 0, strlen(pszEepromData));
-  printf("done.");
+  printf("\r\n");
+  vInitEepromVolume();
+  vPrintEepromVolumeInfo();
+  printf("Writing EEPROM... ");
+  bool bDone = bWriteEepromVolume((const unsigned char*)pszEepromData, 0, strlen(pszEepromData));
+  vSyncEepromVolume();
+  printf(bDone ? "done." : "failed.");
 #endif /* USE_EEPROM_DEMO */
   printf("\r\nPress \"?\" to show available commands.\r\n>");
   fflush(stdout);
+  vMarkBootPrompt();
 
   /* Main program loop                                    */
   while (1)
   {
+    /* Deferred init runs while the prompt is sent        */
+    if (bPollBoot()) continue;
+
     vPollLed();
-    vPollSerial();
+    vPollMemMon();
+    if (!bPollRpc()) vPollShell();
+    vPollFwUpd();
+    vPollFlashLog();
+    vPollEvents();
+    vPollControl();
+    vPollMux();
   }
 }
@@ -0,0 +1,232 @@
+/*!****************************************************************************
+ * @file
+ * memfunc.c
+ *
+ * @brief
+ * Word-oriented memcpy, memset and strlen for RV32
+ *
+ * newlib-nano is built for size and copies, fills and scans memory one byte
+ * at a time. The functions in this module move aligned 32-bit words instead,
+ * four per loop iteration, and only process the unaligned head and tail
+ * bytewise:
+ *  - memcpy aligns the destination. If the source is misaligned relative to
+ *    it, each destination word is merged from two aligned source words by
+ *    shifts, as the core does not support misaligned word access.
+ *  - strlen scans aligned words for a zero byte.
+ * Aligned word reads never extend past the word holding the last byte used,
+ * so no memory beyond the buffers' word boundaries is accessed.
+ *
+ * With USE_FAST_MEMFUNC defined, memcpy(), memset() and strlen() are aliases
+ * of these functions and replace the C library versions at link time, also
+ * for calls from within the C library. The module is compiled without LTO and
+ * without loop pattern detection, which could otherwise turn the byte loops
+ * back into memcpy()/memset() calls.
+ *
+ * Copies between overlapping buffers are undefined, as for memcpy().
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+#include "hw_ramfunc.h"
+#include "memfunc.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! Address bits below word alignment                                         */
+#define MEMFUNC_ALIGN_MASK            (sizeof(uint32_t) - 1)
+
+/*! Bytes per unrolled loop iteration                                         */
+#define MEMFUNC_BLOCK_LEN             (4 * sizeof(uint32_t))
+
+/*! Word with each byte set to 0x01 and 0x80, respectively
+ *  @{                                                                        */
+#define MEMFUNC_ONES                  0x01010101UL
+#define MEMFUNC_HIGHS                 0x80808080UL
+/*! @}                                                                        */
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Word which may alias any object                                    */
+typedef uint32_t __attribute__((may_alias)) MemWordTypeDef;
+
+
+/*!****************************************************************************
+ * @brief
+ * Copy memory block
+ *
+ * @param[out] *pvDst     Destination
+ * @param[in] *pvSrc      Source, not overlapping the destination
+ * @param[in] uLen        Length in bytes
+ * @return  (void*)  Destination
+ * @date  18.10.2026
+ ******************************************************************************/
+RAMFUNC void* pvFastMemCpy(void* pvDst, const void* pvSrc, size_t uLen)
+{
+  uint8_t* pucDst = pvDst;
+  const uint8_t* pucSrc = pvSrc;
+
+  if (uLen >= MEMFUNC_SMALL_LEN)
+  {
+    /* Head up to destination word boundary               */
+    while ((uintptr_t)pucDst & MEMFUNC_ALIGN_MASK)
+    {
+      *pucDst++ = *pucSrc++;
+      --uLen;
+    }
+
+    MemWordTypeDef* pulDst = (MemWordTypeDef*)pucDst;
+    unsigned uShift = ((uintptr_t)pucSrc & MEMFUNC_ALIGN_MASK) * 8;
+    if (uShift == 0)
+    {
+      const MemWordTypeDef* pulSrc = (const MemWordTypeDef*)pucSrc;
+      for (; uLen >= MEMFUNC_BLOCK_LEN; uLen -= MEMFUNC_BLOCK_LEN)
+      {
+        uint32_t ulW0 = pulSrc[0];
+        uint32_t ulW1 = pulSrc[1];
+        uint32_t ulW2 = pulSrc[2];
+        uint32_t ulW3 = pulSrc[3];
+        pulDst[0] = ulW0;
+        pulDst[1] = ulW1;
+        pulDst[2] = ulW2;
+        pulDst[3] = ulW3;
+        pulSrc += 4;
+        pulDst += 4;
+      }
+      for (; uLen >= sizeof(uint32_t); uLen -= sizeof(uint32_t)) *pulDst++ = *pulSrc++;
+      pucSrc = (const uint8_t*)pulSrc;
+    }
+    else
+    {
+      /* Merge little-endian words: the low bytes of each
+       * destination word come from the upper bytes of the
+       * previous source word                             */
+      const MemWordTypeDef* pulSrc = (const MemWordTypeDef*)((uintptr_t)pucSrc & ~MEMFUNC_ALIGN_MASK);
+      unsigned uShiftNext = 32 - uShift;
+      uint32_t ulPrev = *pulSrc++;
+      for (; uLen >= MEMFUNC_BLOCK_LEN; uLen -= MEMFUNC_BLOCK_LEN)
+      {
+        uint32_t ulW0 = pulSrc[0];
+        uint32_t ulW1 = pulSrc[1];
+        uint32_t ulW2 = pulSrc[2];
+        uint32_t ulW3 = pulSrc[3];
+        pulDst[0] = (ulPrev >> uShift) | (ulW0 << uShiftNext);
+        pulDst[1] = (ulW0 >> uShift) | (ulW1 << uShiftNext);
+        pulDst[2] = (ulW1 >> uShift) | (ulW2 << uShiftNext);
+        pulDst[3] = (ulW2 >> uShift) | (ulW3 << uShiftNext);
+        ulPrev = ulW3;
+        pulSrc += 4;
+        pulDst += 4;
+      }
+      for (; uLen >= sizeof(uint32_t); uLen -= sizeof(uint32_t))
+      {
+        uint32_t ulNext = *pulSrc++;
+        *pulDst++ = (ulPrev >> uShift) | (ulNext << uShiftNext);
+        ulPrev = ulNext;
+      }
+
+      /* Next source byte lies within the last word read  */
+      pucSrc = (const uint8_t*)(pulSrc - 1) + uShift / 8;
+    }
+    pucDst = (uint8_t*)pulDst;
+  }
+
+  /* Tail, or short block                                 */
+  while (uLen--) *pucDst++ = *pucSrc++;
+  return pvDst;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fill memory block
+ *
+ * @param[out] *pvDst     Destination
+ * @param[in] iValue      Fill value, converted to unsigned char
+ * @param[in] uLen        Length in bytes
+ * @return  (void*)  Destination
+ * @date  18.10.2026
+ ******************************************************************************/
+RAMFUNC void* pvFastMemSet(void* pvDst, int iValue, size_t uLen)
+{
+  uint8_t* pucDst = pvDst;
+  uint8_t ucValue = (uint8_t)iValue;
+
+  if (uLen >= MEMFUNC_SMALL_LEN)
+  {
+    /* Head up to word boundary                           */
+    while ((uintptr_t)pucDst & MEMFUNC_ALIGN_MASK)
+    {
+      *pucDst++ = ucValue;
+      --uLen;
+    }
+
+    MemWordTypeDef* pulDst = (MemWordTypeDef*)pucDst;
+    uint32_t ulWord = ucValue * MEMFUNC_ONES;
+    for (; uLen >= MEMFUNC_BLOCK_LEN; uLen -= MEMFUNC_BLOCK_LEN)
+    {
+      pulDst[0] = ulWord;
+      pulDst[1] = ulWord;
+      pulDst[2] = ulWord;
+      pulDst[3] = ulWord;
+      pulDst += 4;
+    }
+    for (; uLen >= sizeof(uint32_t); uLen -= sizeof(uint32_t)) *pulDst++ = ulWord;
+    pucDst = (uint8_t*)pulDst;
+  }
+
+  /* Tail, or short block                                 */
+  while (uLen--) *pucDst++ = ucValue;
+  return pvDst;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get string length
+ *
+ * @param[in] *pszStr     Zero-terminated string
+ * @return  (size_t)  Number of characters before the terminator
+ * @date  18.10.2026
+ ******************************************************************************/
+RAMFUNC size_t uFastStrLen(const char* pszStr)
+{
+  const char* pcChar = pszStr;
+
+  /* Head up to word boundary                             */
+  while ((uintptr_t)pcChar & MEMFUNC_ALIGN_MASK)
+  {
+    if (*pcChar == '\0') return pcChar - pszStr;
+    ++pcChar;
+  }
+
+  /* Subtracting 1 from each byte sets the MSB of the low-
+   * est zero byte, and of bytes whose MSB was already set,
+   * which are masked out                                 */
+  const MemWordTypeDef* pulWord = (const MemWordTypeDef*)pcChar;
+  while (1)
+  {
+    uint32_t ulW0 = pulWord[0];
+    if ((ulW0 - MEMFUNC_ONES) & ~ulW0 & MEMFUNC_HIGHS) break;
+    uint32_t ulW1 = pulWord[1];
+    if ((ulW1 - MEMFUNC_ONES) & ~ulW1 & MEMFUNC_HIGHS)
+    {
+      ++pulWord;
+      break;
+    }
+    pulWord += 2;
+  }
+
+  /* Locate the terminator within the word                */
+  pcChar = (const char*)pulWord;
+  while (*pcChar != '\0') ++pcChar;
+  return pcChar - pszStr;
+}
+
+#ifdef USE_FAST_MEMFUNC
+/*! C library replacements
+ *  @{                                                                        */
+void* memcpy(void* pvDst, const void* pvSrc, size_t uLen) __attribute__((alias("pvFastMemCpy")));
+void* memset(void* pvDst, int iValue, size_t uLen) __attribute__((alias("pvFastMemSet")));
+size_t strlen(const char* pszStr) __attribute__((alias("uFastStrLen")));
+/*! @}                                                                        */
+#endif /* USE_FAST_MEMFUNC */
@@ -0,0 +1,32 @@
+/*!****************************************************************************
+ * @file
+ * memfunc.h
+ *
+ * @brief
+ * Word-oriented memcpy, memset and strlen for RV32
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef MEMFUNC_H_
+#define MEMFUNC_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Replace the C library memcpy(), memset() and strlen() (normally set
+ *  by the USE_FAST_MEMFUNC CMake option)                                     */
+//#define USE_FAST_MEMFUNC
+
+/*! @brief Lengths below which bytes are processed one by one                 */
+#define MEMFUNC_SMALL_LEN             8
+
+
+/*- Exported functions -------------------------------------------------------*/
+void* pvFastMemCpy(void* pvDst, const void* pvSrc, size_t uLen);
+void* pvFastMemSet(void* pvDst, int iValue, size_t uLen);
+size_t uFastStrLen(const char* pszStr);
+
+#endif /* MEMFUNC_H_ */
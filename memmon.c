@@ -0,0 +1,198 @@
+/*!****************************************************************************
+ * @file
+ * memmon.c
+ *
+ * @brief
+ * Stack high-water mark and RAM usage monitoring
+ *
+ * Unused stack memory is painted with a fill pattern at boot. The high-water
+ * mark is found by scanning upwards from the bottom of the stack for the first
+ * overwritten word. Painting and scanning both operate on whole words, four
+ * words per loop iteration.
+ *
+ * The paint/scan functions take arbitrary stack bounds, so they can also be
+ * used for per-task stacks.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include "ch32v10x.h"
+#include "syscalls.h"
+#include "pool.h"
+#include "memmon.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Words below the current stack pointer left unpainted at boot       */
+#define STACK_PAINT_GUARD_WORDS       32
+
+
+/*- Linker symbols -----------------------------------------------------------*/
+extern uint32_t _data_vma[];          /*!< Start of .data in RAM              */
+extern uint32_t _edata[];             /*!< End of .data                       */
+extern uint32_t _snoinit[];           /*!< Start of .noinit                   */
+extern uint32_t _enoinit[];           /*!< End of .noinit                     */
+extern uint32_t _sbss[];              /*!< Start of .bss                      */
+extern uint32_t _ebss[];              /*!< End of .bss                        */
+extern uint32_t _heap_end[];          /*!< End of heap area                   */
+extern uint32_t _susrstack[];         /*!< Bottom of main stack               */
+extern uint32_t _eusrstack[];         /*!< Top of main stack                  */
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Stack overflow has already been reported                                  */
+static bool bOverflowReported;
+
+
+/*!****************************************************************************
+ * @brief
+ * Fill stack area with paint pattern
+ *
+ * @param[in] *pulBottom  Lowest word of stack area (word-aligned)
+ * @param[in] *pulTop     End of stack area (exclusive, word-aligned)
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPaintStack(uint32_t* pulBottom, uint32_t* pulTop)
+{
+  uint32_t* pulWord = pulBottom;
+
+  /* Four words per iteration                             */
+  while (pulTop - pulWord >= 4)
+  {
+    pulWord[0] = STACK_PAINT_PATTERN;
+    pulWord[1] = STACK_PAINT_PATTERN;
+    pulWord[2] = STACK_PAINT_PATTERN;
+    pulWord[3] = STACK_PAINT_PATTERN;
+    pulWord += 4;
+  }
+  while (pulWord < pulTop) *pulWord++ = STACK_PAINT_PATTERN;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Determine number of never-used bytes at the bottom of a painted stack area
+ *
+ * @param[in] *pulBottom  Lowest word of stack area (word-aligned)
+ * @param[in] *pulTop     End of stack area (exclusive, word-aligned)
+ * @return  (unsigned)  Number of untouched bytes
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uGetStackUnused(const uint32_t* pulBottom, const uint32_t* pulTop)
+{
+  const uint32_t* pulWord = pulBottom;
+
+  /* Four words per iteration                             */
+  while ((pulTop - pulWord >= 4) &&
+         (pulWord[0] == STACK_PAINT_PATTERN) &&
+         (pulWord[1] == STACK_PAINT_PATTERN) &&
+         (pulWord[2] == STACK_PAINT_PATTERN) &&
+         (pulWord[3] == STACK_PAINT_PATTERN))
+  {
+    pulWord += 4;
+  }
+  while ((pulWord < pulTop) && (*pulWord == STACK_PAINT_PATTERN)) ++pulWord;
+
+  return (unsigned)(pulWord - pulBottom) * sizeof(uint32_t);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Paint unused part of the main stack
+ *
+ * @note
+ * Call as early as possible in main(), before any deep call chains.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vInitMemMon(void)
+{
+  uint32_t* pulLimit = (uint32_t*)__builtin_frame_address(0) - STACK_PAINT_GUARD_WORDS;
+  vPaintStack(_susrstack, pulLimit);
+  bOverflowReported = false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get size of main stack area
+ *
+ * @return  (unsigned)  Stack size in bytes
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uGetMainStackSize(void)
+{
+  return (unsigned)(_eusrstack - _susrstack) * sizeof(uint32_t);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get main stack high-water mark
+ *
+ * @return  (unsigned)  Maximum stack usage since boot in bytes
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uGetMainStackHighWater(void)
+{
+  return uGetMainStackSize() - uGetStackUnused(_susrstack, _eusrstack);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check if the lowest main stack word has been overwritten
+ *
+ * @return  (bool)      true, if the stack has (most likely) overflowed
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bIsMainStackOverflowed(void)
+{
+  return _susrstack[0] != STACK_PAINT_PATTERN;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Handle stack overflow detection in main() polling
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPollMemMon(void)
+{
+  if (!bOverflowReported && bIsMainStackOverflowed())
+  {
+    bOverflowReported = true;
+    fprintf(stderr, "\r\nStack overflow detected!\r\n");
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print static RAM and stack usage
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Pool statistics only with USE_POOLS
+ ******************************************************************************/
+void vPrintMemInfo(void)
+{
+  unsigned uData = (unsigned)(_edata - _data_vma) * sizeof(uint32_t);
+  unsigned uNoinit = (unsigned)(_enoinit - _snoinit) * sizeof(uint32_t);
+  unsigned uBss = (unsigned)(_ebss - _sbss) * sizeof(uint32_t);
+  unsigned uHeap = (unsigned)(_heap_end - _ebss) * sizeof(uint32_t);
+  unsigned uStack = uGetMainStackSize();
+  unsigned uHighWater = uGetMainStackHighWater();
+
+  printf(
+    "-- Memory ----------------------------------------\r\n"
+  );
+  printf(".data:  %5u bytes @ %08lx\r\n", uData, (uint32_t)_data_vma);
+  printf(".noinit:%5u bytes @ %08lx\r\n", uNoinit, (uint32_t)_snoinit);
+  printf(".bss:   %5u bytes @ %08lx\r\n", uBss, (uint32_t)_sbss);
+  printf("heap:   %5u bytes @ %08lx, %u used\r\n", uHeap, (uint32_t)_ebss,
+    uGetSbrkUsed());
+  printf("stack:  %5u bytes @ %08lx\r\n", uStack, (uint32_t)_susrstack);
+  printf("  high-water mark: %u bytes (%u%%)%s\r\n", uHighWater,
+    100 * uHighWater / uStack,
+    bIsMainStackOverflowed() ? ", OVERFLOW" : "");
+#ifdef USE_POOLS
+  vPrintPoolStats();
+#endif /* USE_POOLS */
+}
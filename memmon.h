@@ -0,0 +1,34 @@
+/*!****************************************************************************
+ * @file
+ * memmon.h
+ *
+ * @brief
+ * Stack high-water mark and RAM usage monitoring
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef MEMMON_H_
+#define MEMMON_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Fill pattern for unused stack memory                               */
+#define STACK_PAINT_PATTERN           0xA5A5A5A5UL
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vPaintStack(uint32_t* pulBottom, uint32_t* pulTop);
+unsigned uGetStackUnused(const uint32_t* pulBottom, const uint32_t* pulTop);
+void vInitMemMon(void);
+unsigned uGetMainStackSize(void);
+unsigned uGetMainStackHighWater(void);
+bool bIsMainStackOverflowed(void);
+void vPollMemMon(void);
+void vPrintMemInfo(void);
+
+#endif /* MEMMON_H_ */
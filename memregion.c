@@ -0,0 +1,107 @@
+/*!****************************************************************************
+ * @file
+ * memregion.c
+ *
+ * @brief
+ * Address ranges which may be read for remote inspection
+ *
+ * Memory reads requested over the binary protocol are limited to the regions
+ * listed here. Reading an unmapped address causes a hard fault, and reading
+ * some peripheral registers has side effects: the data registers of USART,
+ * SPI, I2C and ADC clear status flags or consume received data, so these
+ * peripherals are not listed. The peripherals which are listed are read with
+ * aligned 32-bit accesses.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
+#include <string.h>
+#include "ch32v10x.h"
+#include "memregion.h"
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Readable regions (CH32V103C8: 64 KB flash, 20 KB SRAM)                    */
+static const MemRegionTypeDef asMemRegions[] = {
+  { "flash",   FLASH_BASE,   0x10000, 0               },
+  { "sram",    SRAM_BASE,    0x5000,  0               },
+  { "esig",    0x1FFFF7E0UL, 0x20,    MEM_REGION_WORD },
+  { "infoblk", 0x1FFFF800UL, 0x100,   0               },
+  { "tim2_4",  0x40000000UL, 0xC00,   MEM_REGION_WORD },
+  { "gpio",    0x40010000UL, 0x1C00,  MEM_REGION_WORD },
+  { "tim1",    0x40012C00UL, 0x400,   MEM_REGION_WORD },
+  { "dma",     0x40020000UL, 0x400,   MEM_REGION_WORD },
+  { "rcc",     0x40021000UL, 0x400,   MEM_REGION_WORD },
+  { "flashif", 0x40022000UL, 0x400,   MEM_REGION_WORD },
+  { "pfic",    0xE000E000UL, 0x500,   MEM_REGION_WORD },
+  { "systick", 0xE000F000UL, 0x20,    MEM_REGION_WORD }
+};
+
+/*! Number of regions                                                         */
+#define MEM_NUM_REGIONS               (sizeof(asMemRegions) / sizeof(asMemRegions[0]))
+
+
+/*!****************************************************************************
+ * @brief
+ * Get region by index
+ *
+ * @param[in] uIndex      Region index
+ * @return  (const MemRegionTypeDef*)  Region, or NULL past the last region
+ * @date  18.10.2026
+ ******************************************************************************/
+const MemRegionTypeDef* psGetMemRegion(unsigned uIndex)
+{
+  return (uIndex < MEM_NUM_REGIONS) ? &asMemRegions[uIndex] : NULL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Find the region containing an address range
+ *
+ * @param[in] ulAddress   Start address
+ * @param[in] ulLength    Length in bytes
+ * @return  (const MemRegionTypeDef*)  Region, or NULL if the range is not
+ *                      entirely inside one region, or not aligned as
+ *                      required by the region
+ * @date  18.10.2026
+ ******************************************************************************/
+const MemRegionTypeDef* psFindMemRegion(uint32_t ulAddress, uint32_t ulLength)
+{
+  for (unsigned i = 0; i < MEM_NUM_REGIONS; ++i)
+  {
+    const MemRegionTypeDef* psRegion = &asMemRegions[i];
+    if ((ulAddress < psRegion->ulStart) || (ulAddress - psRegion->ulStart >= psRegion->ulLength)) continue;
+    if (ulLength > psRegion->ulLength - (ulAddress - psRegion->ulStart)) return NULL;
+    if (((psRegion->ucFlags & MEM_REGION_WORD) != 0) && (((ulAddress | ulLength) & 3) != 0)) return NULL;
+    return psRegion;
+  }
+  return NULL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read from a region
+ *
+ * @param[in] *psRegion   Region containing the range, see psFindMemRegion()
+ * @param[out] *pucDst    Destination buffer
+ * @param[in] ulAddress   Start address
+ * @param[in] uLen        Length in bytes
+ * @date  18.10.2026
+ ******************************************************************************/
+void vReadMemRegion(const MemRegionTypeDef* psRegion, uint8_t* pucDst, uint32_t ulAddress, unsigned uLen)
+{
+  if ((psRegion->ucFlags & MEM_REGION_WORD) == 0)
+  {
+    memcpy(pucDst, (const void*)ulAddress, uLen);
+    return;
+  }
+
+  const volatile uint32_t* pulSrc = (const volatile uint32_t*)ulAddress;
+  for (unsigned i = 0; i < uLen / 4; ++i)
+  {
+    uint32_t ulWord = pulSrc[i];
+    memcpy(&pucDst[4 * i], &ulWord, sizeof(ulWord));
+  }
+}
@@ -0,0 +1,42 @@
+/*!****************************************************************************
+ * @file
+ * memregion.h
+ *
+ * @brief
+ * Address ranges which may be read for remote inspection
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef MEMREGION_H_
+#define MEMREGION_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Region flag: read with aligned 32-bit accesses only               */
+#define MEM_REGION_WORD               0x01
+
+/*! @brief Maximum region name length                                         */
+#define MEM_REGION_NAME_LEN           7
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Readable region                                                    */
+typedef struct
+{
+  const char* pszName;                /*!< Region name                        */
+  uint32_t ulStart;                   /*!< Start address                      */
+  uint32_t ulLength;                  /*!< Length in bytes                    */
+  uint8_t ucFlags;                    /*!< MEM_REGION_* flags                 */
+} MemRegionTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+const MemRegionTypeDef* psGetMemRegion(unsigned uIndex);
+const MemRegionTypeDef* psFindMemRegion(uint32_t ulAddress, uint32_t ulLength);
+void vReadMemRegion(const MemRegionTypeDef* psRegion, uint8_t* pucDst, uint32_t ulAddress, unsigned uLen);
+
+#endif /* MEMREGION_H_ */
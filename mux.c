@@ -0,0 +1,446 @@
+/*!****************************************************************************
+ * @file
+ * mux.c
+ *
+ * @brief
+ * Logical output channels multiplexed onto the debug serial port
+ *
+ * All output to the host is written into per-channel queues. While the
+ * multiplexer is enabled, vPollMux() picks the next channel whenever the
+ * transmit DMA is idle, and sends up to MUX_MAX_PAYLOAD of its bytes as one
+ * frame. Frames are COBS-encoded and delimited by FRAME_DELIM on both ends
+ * like binary protocol frames. Decoded frame layout:
+ *
+ *   channel | seq | payload... | crc16
+ *
+ * The sequence number counts frames per channel, so the host can detect
+ * lost frames. The CRC-16/CCITT-FALSE covers all bytes before it.
+ *
+ * Scheduling:
+ *  - channels are served by priority (0 = highest), and round robin among
+ *    channels of equal priority, so an urgent frame waits for at most one
+ *    frame of another channel
+ *  - a channel with a rate limit holds a token bucket of uiBurst bytes,
+ *    refilled at uiRate bytes/s. It is served at its priority only if there
+ *    are tokens for the whole next frame, so frames are not fragmented while
+ *    the bucket refills. Otherwise, a channel either waits for the refill
+ *    (hard limit), or is only served if no other channel has data (borrowing)
+ *
+ * Lossless channels (stdout, stderr, binary protocol) block the writer while
+ * their queue is full, and the writer keeps the line busy meanwhile. Lossy
+ * channels (log records, telemetry) discard writes which do not fit in
+ * whole, so a record is never split. While the multiplexer is disabled,
+ * lossless channels are written to the port directly, as plain text and
+ * binary protocol frames, and lossy channels are discarded.
+ *
+ * Writing is only allowed from main loop context. uWriteVMux() writes a
+ * message gathered from several buffers as a whole; while the multiplexer is
+ * disabled, it is sent from these buffers without copying.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added vector write
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "ch32v10x.h"
+#include "hw_stk.h"
+#include "hw_usart.h"
+#include "dbgser.h"
+#include "mux.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Queue sizes in bytes (powers of 2)
+ *  @{                                                                        */
+#define MUX_ERROR_QUEUE_SIZE          64
+#define MUX_RPC_QUEUE_SIZE            256
+#define MUX_SHELL_QUEUE_SIZE          256
+#define MUX_LOG_QUEUE_SIZE            256
+#define MUX_TELEMETRY_QUEUE_SIZE      128
+/*! @}                                                                        */
+
+/*! @brief Scheduling class of a channel serving borrowed bandwidth           */
+#define MUX_PRIO_BORROW               0xFF
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Channel configuration                                              */
+typedef struct
+{
+  const char* pszName;                /*!< Channel name                       */
+  uint8_t* pucQueue;                  /*!< Queue buffer                       */
+  uint16_t uiSize;                    /*!< Queue size in bytes (power of 2)   */
+  uint8_t ucPrio;                     /*!< Priority, 0 = highest              */
+  bool bLossless;                     /*!< Block writer instead of dropping   */
+  uint16_t uiRate;                    /*!< Rate limit in bytes/s, 0 = none    */
+  uint16_t uiBurst;                   /*!< Token bucket size in bytes         */
+  bool bBorrow;                       /*!< Use idle line beyond rate limit    */
+} MuxChCfgTypeDef;
+
+/*! @brief Channel state                                                      */
+typedef struct
+{
+  unsigned uHead;                     /*!< Write count (free-running)         */
+  unsigned uTail;                     /*!< Read count (free-running)          */
+  unsigned uTokens;                   /*!< Token bucket fill in bytes         */
+  uint32_t ulRefillTicks;             /*!< SysTick count of last refill       */
+  uint32_t ulWaitTicks;               /*!< SysTick count of first write into
+                                           empty queue                        */
+  bool bWaiting;                      /*!< First write not yet on the line    */
+  uint8_t ucSeq;                      /*!< Next frame sequence number         */
+  MuxStatsTypeDef sStats;             /*!< Statistics                         */
+} MuxChStateTypeDef;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Queue buffers                                                             */
+static uint8_t aucErrorQueue[MUX_ERROR_QUEUE_SIZE];
+static uint8_t aucRpcQueue[MUX_RPC_QUEUE_SIZE];
+static uint8_t aucShellQueue[MUX_SHELL_QUEUE_SIZE];
+static uint8_t aucLogQueue[MUX_LOG_QUEUE_SIZE];
+static uint8_t aucTelemetryQueue[MUX_TELEMETRY_QUEUE_SIZE];
+
+/*! Channel configuration; bursts hold at least one frame. Rates leave room
+ *  for binary protocol responses and the lossy channels at 115200 Bd
+ *  (11520 bytes/s), see tools/mux_sim.py                                     */
+static const MuxChCfgTypeDef asChCfg[MUX_NUM_CHANNELS] = {
+  [MUX_CH_ERROR]     = { "error",     aucErrorQueue,     MUX_ERROR_QUEUE_SIZE,     0, true,  0,    0,   false },
+  [MUX_CH_RPC]       = { "rpc",       aucRpcQueue,       MUX_RPC_QUEUE_SIZE,       1, true,  0,    0,   false },
+  [MUX_CH_SHELL]     = { "shell",     aucShellQueue,     MUX_SHELL_QUEUE_SIZE,     1, true,  3000, 256, true  },
+  [MUX_CH_LOG]       = { "log",       aucLogQueue,       MUX_LOG_QUEUE_SIZE,       2, false, 1000, 256, false },
+  [MUX_CH_TELEMETRY] = { "telemetry", aucTelemetryQueue, MUX_TELEMETRY_QUEUE_SIZE, 2, false, 2000, 128, false }
+};
+
+/*! Channel state                                                             */
+static MuxChStateTypeDef asChState[MUX_NUM_CHANNELS];
+
+/*! Frame buffer (decoded)                                                    */
+static uint8_t aucFrame[MUX_HDR_LEN + MUX_MAX_PAYLOAD + MUX_CRC_LEN];
+
+/*! Encoded frame buffer, read by transmit DMA                                */
+static uint8_t aucTxFrame[MUX_MAX_ENC_FRAME];
+
+/*! Last channel served, start of round robin search                          */
+static unsigned uLastCh;
+
+/*! Multiplexer enabled                                                       */
+static bool bEnabled;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Add tokens for the time elapsed since the last refill
+ *
+ * @param[in] eCh         Channel
+ * @param[in] ulNow       Current SysTick count
+ * @param[in] ulTicksPerSec SysTick counts per second
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vRefillTokens(MuxChannelTypeDef eCh, uint32_t ulNow, uint32_t ulTicksPerSec)
+{
+  const MuxChCfgTypeDef* psCfg = &asChCfg[eCh];
+  MuxChStateTypeDef* psState = &asChState[eCh];
+  if (psCfg->uiRate == 0) return;
+
+  /* Whole bytes only; the remainder is kept in the time-
+   * stamp                                                */
+  uint32_t ulBytes = (uint32_t)((uint64_t)(ulNow - psState->ulRefillTicks) * psCfg->uiRate / ulTicksPerSec);
+  if (ulBytes == 0) return;
+  psState->ulRefillTicks += (uint32_t)((uint64_t)ulBytes * ulTicksPerSec / psCfg->uiRate);
+  if (psState->uTokens + ulBytes >= psCfg->uiBurst)
+  {
+    psState->uTokens = psCfg->uiBurst;
+    psState->ulRefillTicks = ulNow;
+  }
+  else
+  {
+    psState->uTokens += ulBytes;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Select channel to be served next
+ *
+ * @param[out] *puLen     Number of bytes to be sent
+ * @return  (int)       Channel, or -1 if there is nothing to send
+ * @date  18.10.2026
+ ******************************************************************************/
+static int iSelectChannel(unsigned* puLen)
+{
+  int iBest = -1;
+  unsigned uBestClass = MUX_PRIO_BORROW + 1;
+  for (unsigned k = 1; k <= MUX_NUM_CHANNELS; ++k)
+  {
+    unsigned i = (uLastCh + k) % MUX_NUM_CHANNELS;
+    const MuxChCfgTypeDef* psCfg = &asChCfg[i];
+    MuxChStateTypeDef* psState = &asChState[i];
+    unsigned uFill = psState->uHead - psState->uTail;
+    if (uFill == 0) continue;
+
+    /* No tokens for whole frame: wait, or serve at lowest
+     * priority                                           */
+    unsigned uClass = psCfg->ucPrio;
+    if ((psCfg->uiRate != 0) && (psState->uTokens < ((uFill < MUX_MAX_PAYLOAD) ? uFill : MUX_MAX_PAYLOAD)))
+    {
+      if (!psCfg->bBorrow) continue;
+      uClass = MUX_PRIO_BORROW;
+    }
+    if (uClass < uBestClass)
+    {
+      iBest = i;
+      uBestClass = uClass;
+    }
+  }
+  if (iBest < 0) return -1;
+
+  /* Frame length limited by queue fill                   */
+  const MuxChCfgTypeDef* psCfg = &asChCfg[iBest];
+  MuxChStateTypeDef* psState = &asChState[iBest];
+  unsigned uLen = psState->uHead - psState->uTail;
+  if (uLen > MUX_MAX_PAYLOAD) uLen = MUX_MAX_PAYLOAD;
+  if ((psCfg->uiRate != 0) && (uBestClass != MUX_PRIO_BORROW)) psState->uTokens -= uLen;
+  *puLen = uLen;
+  return iBest;
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Enable or disable multiplexed output
+ *
+ * Pending output is sent before switching. Queues, sequence numbers and rate
+ * limits start over when enabled.
+ *
+ * @param[in] bEnable     true to enable
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSetMuxEnabled(bool bEnable)
+{
+  if (bEnable == bEnabled) return;
+  vFlushMux();
+  if (bEnable)
+  {
+    uint32_t ulNow = SysTick_GetValueLow();
+    for (unsigned i = 0; i < MUX_NUM_CHANNELS; ++i)
+    {
+      MuxChStateTypeDef* psState = &asChState[i];
+      psState->uHead = 0;
+      psState->uTail = 0;
+      psState->uTokens = asChCfg[i].uiBurst;
+      psState->ulRefillTicks = ulNow;
+      psState->bWaiting = false;
+      psState->ucSeq = 0;
+    }
+  }
+  bEnabled = bEnable;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check if multiplexed output is enabled
+ *
+ * @return  (bool)      true, if enabled
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bIsMuxEnabled(void)
+{
+  return bEnabled;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write data to a channel
+ *
+ * @param[in] eCh         Channel
+ * @param[in] *pvData     Data
+ * @param[in] uLen        Data length in bytes
+ * @return  (unsigned)  Number of bytes written; 0 if a lossy channel write
+ *                      was discarded
+ * @date  18.10.2026
+ * @date  18.10.2026  Written as single-segment vector write
+ ******************************************************************************/
+unsigned uWriteMux(MuxChannelTypeDef eCh, const void* pvData, unsigned uLen)
+{
+  const DbgSerSegTypeDef sSeg = { pvData, uLen };
+  return uWriteVMux(eCh, &sSeg, 1);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write a message gathered from several buffers to a channel
+ *
+ * The message is queued as a whole: a lossy channel discards it unless all
+ * segments fit. While disabled, the segments are sent from their buffers.
+ *
+ * @param[in] eCh         Channel
+ * @param[in] *psSegs     Segments
+ * @param[in] uNumSegs    Number of segments (at most DBGSER_MAX_SEGMENTS)
+ * @return  (unsigned)  Number of bytes written; 0 if a lossy channel write
+ *                      was discarded
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uWriteVMux(MuxChannelTypeDef eCh, const DbgSerSegTypeDef* psSegs, unsigned uNumSegs)
+{
+  if ((eCh >= MUX_NUM_CHANNELS) || (uNumSegs > DBGSER_MAX_SEGMENTS)) return 0;
+  unsigned uLen = 0;
+  for (unsigned i = 0; i < uNumSegs; ++i) uLen += psSegs[i].uLen;
+  if (uLen == 0) return 0;
+  const MuxChCfgTypeDef* psCfg = &asChCfg[eCh];
+  MuxChStateTypeDef* psState = &asChState[eCh];
+
+  /* Plain output while disabled                          */
+  if (!bEnabled)
+  {
+    if (!psCfg->bLossless) return 0;
+    vWriteVDbgSer(psSegs, uNumSegs);
+    return uLen;
+  }
+
+  /* Lossy channels take whole writes only                */
+  if (!psCfg->bLossless && (uLen > psCfg->uiSize - (psState->uHead - psState->uTail)))
+  {
+    psState->sStats.ulDropped += uLen;
+    return 0;
+  }
+
+  if (psState->uHead == psState->uTail)
+  {
+    psState->ulWaitTicks = SysTick_GetValueLow();
+    psState->bWaiting = true;
+  }
+
+  /* Copy, keeping the line busy while the queue is full  */
+  for (unsigned i = 0; i < uNumSegs; ++i)
+  {
+    const uint8_t* pucData = psSegs[i].pvData;
+    for (unsigned j = 0; j < psSegs[i].uLen; ++j)
+    {
+      while (psState->uHead - psState->uTail == psCfg->uiSize) vPollMux();
+      psCfg->pucQueue[psState->uHead & (psCfg->uiSize - 1)] = pucData[j];
+      ++psState->uHead;
+    }
+  }
+  unsigned uFill = psState->uHead - psState->uTail;
+  if (uFill > psState->sStats.uPeak) psState->sStats.uPeak = uFill;
+
+  vPollMux();
+  return uLen;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Send next frame if the transmitter is idle
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Waits for queued serial messages
+ ******************************************************************************/
+void vPollMux(void)
+{
+  vPollDbgSer();
+  if (!bEnabled || bIsDbgSerTxBusy()) return;
+
+  uint32_t ulNow = SysTick_GetValueLow();
+  uint32_t ulTicksPerSec = ulHW_STK_MsToTicks(1000);
+  for (unsigned i = 0; i < MUX_NUM_CHANNELS; ++i) vRefillTokens(i, ulNow, ulTicksPerSec);
+
+  unsigned uLen;
+  int iCh = iSelectChannel(&uLen);
+  if (iCh < 0) return;
+  const MuxChCfgTypeDef* psCfg = &asChCfg[iCh];
+  MuxChStateTypeDef* psState = &asChState[iCh];
+
+  /* Build frame from queue                               */
+  aucFrame[0] = (uint8_t)iCh;
+  aucFrame[1] = psState->ucSeq++;
+  for (unsigned i = 0; i < uLen; ++i)
+  {
+    aucFrame[MUX_HDR_LEN + i] = psCfg->pucQueue[psState->uTail & (psCfg->uiSize - 1)];
+    ++psState->uTail;
+  }
+  unsigned uFrameLen = MUX_HDR_LEN + uLen;
+  uint16_t uiCrc = uiCalcCrc16(aucFrame, uFrameLen, FRAME_CRC16_INIT);
+  aucFrame[uFrameLen++] = (uint8_t)uiCrc;
+  aucFrame[uFrameLen++] = (uint8_t)(uiCrc >> 8);
+
+  aucTxFrame[0] = FRAME_DELIM;
+  unsigned uEncLen = uEncodeCobs(aucFrame, uFrameLen, &aucTxFrame[1]);
+  aucTxFrame[1 + uEncLen] = FRAME_DELIM;
+  vHW_USART_StartTx(DBGSER_USART, aucTxFrame, uEncLen + 2);
+
+  /* Statistics                                           */
+  psState->sStats.ulBytes += uLen;
+  ++psState->sStats.ulFrames;
+  if (psState->bWaiting)
+  {
+    uint32_t ulWait = ulNow - psState->ulWaitTicks;
+    if (ulWait > psState->sStats.ulWaitMax) psState->sStats.ulWaitMax = ulWait;
+    psState->bWaiting = false;
+  }
+  uLastCh = iCh;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Send all queued data and wait until transmission has finished
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vFlushMux(void)
+{
+  bool bPending = bEnabled;
+  while (bPending)
+  {
+    vPollMux();
+    bPending = bIsDbgSerTxBusy();
+    for (unsigned i = 0; i < MUX_NUM_CHANNELS; ++i)
+    {
+      if (asChState[i].uHead != asChState[i].uTail) bPending = true;
+    }
+  }
+  vFlushDbgSer();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get channel statistics
+ *
+ * @param[in] eCh         Channel
+ * @param[out] *psStats   Statistics
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetMuxStats(MuxChannelTypeDef eCh, MuxStatsTypeDef* psStats)
+{
+  *psStats = asChState[eCh].sStats;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print channel configuration and statistics
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPrintMuxStats(void)
+{
+  printf(
+    "-- Output channels -------------------------------\r\n"
+    "Mode: %s, max. %u bytes/frame\r\n"
+    "Channel   Prio Rate B/s  Queue peak      Bytes  Frames Dropped Wait max\r\n",
+    bEnabled ? "multiplexed" : "direct", MUX_MAX_PAYLOAD
+  );
+  for (unsigned i = 0; i < MUX_NUM_CHANNELS; ++i)
+  {
+    const MuxChCfgTypeDef* psCfg = &asChCfg[i];
+    MuxStatsTypeDef sStats;
+    vGetMuxStats(i, &sStats);
+    printf("%-9s %4u %5u%c%c %4u/%-4u %10lu %7lu %7lu %5lu us\r\n",
+      psCfg->pszName, psCfg->ucPrio, psCfg->uiRate,
+      (psCfg->uiRate == 0) ? ' ' : (psCfg->bBorrow ? 's' : 'h'), psCfg->bLossless ? ' ' : 'l',
+      sStats.uPeak, psCfg->uiSize, sStats.ulBytes, sStats.ulFrames, sStats.ulDropped,
+      (uint32_t)((uint64_t)sStats.ulWaitMax * 1000 / ulHW_STK_MsToTicks(1)));
+  }
+  printf("Rate: s = soft limit, h = hard limit; l = lossy\r\n");
+}
@@ -0,0 +1,72 @@
+/*!****************************************************************************
+ * @file
+ * mux.h
+ *
+ * @brief
+ * Logical output channels multiplexed onto the debug serial port
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added vector write
+ ******************************************************************************/
+
+#ifndef MUX_H_
+#define MUX_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "dbgser.h"
+#include "frame.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Maximum payload bytes per frame; bounds the time a frame occupies
+ *  the line before a higher-priority channel is served                      */
+#define MUX_MAX_PAYLOAD               64
+
+/*! @brief Frame header: channel, sequence number                             */
+#define MUX_HDR_LEN                   2
+
+/*! @brief Frame trailer: CRC-16 (little-endian)                              */
+#define MUX_CRC_LEN                   2
+
+/*! @brief Maximum encoded frame length incl. both delimiters                 */
+#define MUX_MAX_ENC_FRAME             (FRAME_COBS_MAX_LEN(MUX_HDR_LEN + MUX_MAX_PAYLOAD + MUX_CRC_LEN) + 2)
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Channels                                                           */
+typedef enum
+{
+  MUX_CH_ERROR = 0,                   /*!< stderr                             */
+  MUX_CH_RPC,                         /*!< Binary protocol responses          */
+  MUX_CH_SHELL,                       /*!< stdout                             */
+  MUX_CH_LOG,                         /*!< Flash log records                  */
+  MUX_CH_TELEMETRY,                   /*!< Control loop samples               */
+  MUX_NUM_CHANNELS
+} MuxChannelTypeDef;
+
+/*! @brief Channel statistics                                                 */
+typedef struct
+{
+  uint32_t ulBytes;                   /*!< Payload bytes sent                 */
+  uint32_t ulFrames;                  /*!< Frames sent                        */
+  uint32_t ulDropped;                 /*!< Bytes discarded due to full queue  */
+  uint32_t ulWaitMax;                 /*!< Longest wait of an idle channel's
+                                           first write for the line, in
+                                           SysTick counts                     */
+  unsigned uPeak;                     /*!< Maximum queue fill level           */
+} MuxStatsTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vSetMuxEnabled(bool bEnable);
+bool bIsMuxEnabled(void);
+unsigned uWriteMux(MuxChannelTypeDef eCh, const void* pvData, unsigned uLen);
+unsigned uWriteVMux(MuxChannelTypeDef eCh, const DbgSerSegTypeDef* psSegs, unsigned uNumSegs);
+void vPollMux(void);
+void vFlushMux(void);
+void vGetMuxStats(MuxChannelTypeDef eCh, MuxStatsTypeDef* psStats);
+void vPrintMuxStats(void);
+
+#endif /* MUX_H_ */
@@ -0,0 +1,43 @@
+/*!****************************************************************************
+ * @file
+ * offload.h
+ *
+ * @brief
+ * CRC-32 and bulk memory operations using the CRC unit and DMA
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef OFFLOAD_H_
+#define OFFLOAD_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief CRC-32 initial value (CRC unit reset value)                        */
+#define OFFLOAD_CRC32_INIT            0xFFFFFFFFUL
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Completion callback, called from interrupt context
+ *
+ * ulResult is the CRC-32 for CRC operations, and 0 for memory operations.   */
+typedef void (*OffloadDoneTypeDef)(uint32_t ulResult, void* pvContext);
+
+
+/*- Exported functions -------------------------------------------------------*/
+bool bStartCrc32(const void* pvData, unsigned uLen, OffloadDoneTypeDef pvDone, void* pvContext);
+bool bStartMemCpy(void* pvDst, const void* pvSrc, unsigned uLen, OffloadDoneTypeDef pvDone, void* pvContext);
+bool bStartMemSet(void* pvDst, uint8_t ucValue, unsigned uLen, OffloadDoneTypeDef pvDone, void* pvContext);
+bool bIsOffloadBusy(void);
+void vHandleOffloadIrq(void);
+
+uint32_t ulCalcCrc32(const void* pvData, unsigned uLen);
+uint32_t ulCalcCrc32Sw(const void* pvData, unsigned uLen, uint32_t ulCrc);
+void vDmaMemCpy(void* pvDst, const void* pvSrc, unsigned uLen);
+void vDmaMemSet(void* pvDst, uint8_t ucValue, unsigned uLen);
+
+#endif /* OFFLOAD_H_ */
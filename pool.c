@@ -0,0 +1,335 @@
+/*!****************************************************************************
+ * @file
+ * pool.c
+ *
+ * @brief
+ * Fixed-block memory pool allocator
+ *
+ * Each size class is a statically allocated array of equally sized blocks.
+ * Free blocks are kept in a singly linked list (link stored in the block
+ * itself), so allocation and release are O(1). Requests are served from the
+ * smallest class with a free block that fits.
+ *
+ * A bitmap per class marks the allocated blocks. Releases of addresses that
+ * are not the start of a block, or of blocks that are already free, are
+ * rejected and counted, so they cannot corrupt the free lists.
+ *
+ * The module is only built with USE_POOLS defined (see pool.h), so the block
+ * storage does not take SRAM otherwise.
+ *
+ * @note
+ * The allocator is not interrupt-safe; do not call from interrupt handlers.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Made optional; added block boundary and double release
+ *                    checks
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <reent.h>
+#include "pool.h"
+
+#ifdef USE_POOLS
+
+/*- Macros -------------------------------------------------------------------*/
+/* The allocation bitmap holds one word per size class                        */
+_Static_assert((POOL0_NUM_BLOCKS <= 32) && (POOL1_NUM_BLOCKS <= 32) &&
+  (POOL2_NUM_BLOCKS <= 32) && (POOL3_NUM_BLOCKS <= 32), "More than 32 blocks in a pool");
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Free list node, overlaid on unused blocks                          */
+typedef struct FreeBlock
+{
+  struct FreeBlock* psNext;           /*!< Next free block                    */
+} FreeBlockTypeDef;
+
+/*! @brief Pool size class descriptor                                         */
+typedef struct
+{
+  uint8_t* pucStorage;                /*!< Block storage                      */
+  uint16_t uiBlockSize;               /*!< Block size in bytes                */
+  uint16_t uiNumBlocks;               /*!< Number of blocks                   */
+} PoolClassTypeDef;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Block storage per size class (word-aligned)
+ *  @{                                                                        */
+static uint32_t aulPool0[POOL0_BLOCK_SIZE * POOL0_NUM_BLOCKS / sizeof(uint32_t)];
+static uint32_t aulPool1[POOL1_BLOCK_SIZE * POOL1_NUM_BLOCKS / sizeof(uint32_t)];
+static uint32_t aulPool2[POOL2_BLOCK_SIZE * POOL2_NUM_BLOCKS / sizeof(uint32_t)];
+static uint32_t aulPool3[POOL3_BLOCK_SIZE * POOL3_NUM_BLOCKS / sizeof(uint32_t)];
+/*! @}                                                                        */
+
+/*! Size class table                                                          */
+static const PoolClassTypeDef asClasses[POOL_NUM_CLASSES] = {
+  { (uint8_t*)aulPool0, POOL0_BLOCK_SIZE, POOL0_NUM_BLOCKS },
+  { (uint8_t*)aulPool1, POOL1_BLOCK_SIZE, POOL1_NUM_BLOCKS },
+  { (uint8_t*)aulPool2, POOL2_BLOCK_SIZE, POOL2_NUM_BLOCKS },
+  { (uint8_t*)aulPool3, POOL3_BLOCK_SIZE, POOL3_NUM_BLOCKS }
+};
+
+/*! Free list heads per size class                                            */
+static FreeBlockTypeDef* apsFreeList[POOL_NUM_CLASSES];
+
+/*! Allocated blocks per size class (bit per block)                           */
+static uint32_t aulAllocated[POOL_NUM_CLASSES];
+
+/*! Usage statistics per size class                                          */
+static PoolStatsTypeDef asStats[POOL_NUM_CLASSES];
+
+/*! Pools have been initialised                                               */
+static uint8_t ucInitialised;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Find size class owning a block
+ *
+ * @param[in] *pvBlock    Block address
+ * @return  (int)       Size class index, or -1 if not a pool block
+ * @date  18.10.2026
+ ******************************************************************************/
+static int iFindClass(const void* pvBlock)
+{
+  const uint8_t* pucBlock = pvBlock;
+  for (unsigned i = 0; i < POOL_NUM_CLASSES; ++i)
+  {
+    const PoolClassTypeDef* psClass = &asClasses[i];
+    if ((pucBlock >= psClass->pucStorage) &&
+        (pucBlock < psClass->pucStorage + psClass->uiBlockSize * psClass->uiNumBlocks))
+    {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Initialise all pools, building the free lists
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vInitPools(void)
+{
+  for (unsigned i = 0; i < POOL_NUM_CLASSES; ++i)
+  {
+    const PoolClassTypeDef* psClass = &asClasses[i];
+    apsFreeList[i] = NULL;
+    for (unsigned uBlock = psClass->uiNumBlocks; uBlock-- > 0; )
+    {
+      FreeBlockTypeDef* psBlock = (FreeBlockTypeDef*)(psClass->pucStorage + uBlock * psClass->uiBlockSize);
+      psBlock->psNext = apsFreeList[i];
+      apsFreeList[i] = psBlock;
+    }
+
+    aulAllocated[i] = 0;
+    memset(&asStats[i], 0, sizeof(asStats[i]));
+    asStats[i].uiBlockSize = psClass->uiBlockSize;
+    asStats[i].uiNumBlocks = psClass->uiNumBlocks;
+  }
+  ucInitialised = 1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Allocate block from the smallest fitting size class
+ *
+ * @param[in] uSize       Requested size in bytes
+ * @return  (void*)     Block address, or NULL if no block is available
+ * @date  18.10.2026
+ * @date  18.10.2026  Mark block as allocated
+ ******************************************************************************/
+void* pvPoolAlloc(size_t uSize)
+{
+  if (!ucInitialised) vInitPools();
+
+  for (unsigned i = 0; i < POOL_NUM_CLASSES; ++i)
+  {
+    if (uSize > asClasses[i].uiBlockSize) continue;
+
+    /* Fall through to next size class if exhausted        */
+    FreeBlockTypeDef* psBlock = apsFreeList[i];
+    if (psBlock == NULL)
+    {
+      ++asStats[i].ulFails;
+      continue;
+    }
+
+    apsFreeList[i] = psBlock->psNext;
+    aulAllocated[i] |= 1UL << (((uint8_t*)psBlock - asClasses[i].pucStorage) / asClasses[i].uiBlockSize);
+    ++asStats[i].ulAllocs;
+    if (++asStats[i].uiUsed > asStats[i].uiPeak) asStats[i].uiPeak = asStats[i].uiUsed;
+    return psBlock;
+  }
+  return NULL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Return block to its pool
+ *
+ * Addresses within a pool that are not the start of an allocated block are
+ * ignored and counted in the statistics.
+ *
+ * @param[in] *pvBlock    Block address (NULL is ignored)
+ * @date  18.10.2026
+ * @date  18.10.2026  Reject misaligned and double releases
+ ******************************************************************************/
+void vPoolFree(void* pvBlock)
+{
+  int iClass = iFindClass(pvBlock);
+  if (iClass < 0) return;
+
+  const PoolClassTypeDef* psClass = &asClasses[iClass];
+  unsigned uOffset = (uint8_t*)pvBlock - psClass->pucStorage;
+  uint32_t ulMask = 1UL << (uOffset / psClass->uiBlockSize);
+  if ((uOffset % psClass->uiBlockSize != 0) || !(aulAllocated[iClass] & ulMask))
+  {
+    ++asStats[iClass].ulBadFrees;
+    return;
+  }
+  aulAllocated[iClass] &= ~ulMask;
+
+  FreeBlockTypeDef* psBlock = pvBlock;
+  psBlock->psNext = apsFreeList[iClass];
+  apsFreeList[iClass] = psBlock;
+  --asStats[iClass].uiUsed;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get usable size of a pool block
+ *
+ * @param[in] *pvBlock    Block address
+ * @return  (size_t)    Block size in bytes, or 0 if not a pool block
+ * @date  18.10.2026
+ ******************************************************************************/
+size_t uGetPoolBlockSize(const void* pvBlock)
+{
+  int iClass = iFindClass(pvBlock);
+  return (iClass < 0) ? 0 : asClasses[iClass].uiBlockSize;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get usage statistics of a size class
+ *
+ * @param[in] uClass      Size class index
+ * @param[out] *psStats   Statistics
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetPoolStats(unsigned uClass, PoolStatsTypeDef* psStats)
+{
+  if (uClass < POOL_NUM_CLASSES) *psStats = asStats[uClass];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print usage statistics of all size classes
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added rejected releases
+ ******************************************************************************/
+void vPrintPoolStats(void)
+{
+  printf("pools:  size  used  peak  total     allocs  fails  bad\r\n");
+  for (unsigned i = 0; i < POOL_NUM_CLASSES; ++i)
+  {
+    const PoolStatsTypeDef* psStats = &asStats[i];
+    printf("       %5u %5u %5u %6u %10lu %6lu %4lu\r\n", psStats->uiBlockSize,
+      psStats->uiUsed, psStats->uiPeak, psStats->uiNumBlocks,
+      psStats->ulAllocs, psStats->ulFails, psStats->ulBadFrees);
+  }
+}
+
+
+#ifdef USE_POOL_MALLOC
+/*- Heap replacement ---------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Reentrant heap functions called by newlib (stdio buffers etc.)
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  calloc() size overflow sets ENOMEM
+ ******************************************************************************/
+void* _malloc_r(struct _reent* psReent, size_t uSize)
+{
+  void* pvBlock = pvPoolAlloc(uSize);
+  if (pvBlock == NULL) psReent->_errno = ENOMEM;
+  return pvBlock;
+}
+
+void _free_r(struct _reent* psReent __attribute__((unused)), void* pvBlock)
+{
+  vPoolFree(pvBlock);
+}
+
+void* _calloc_r(struct _reent* psReent, size_t uNum, size_t uSize)
+{
+  size_t uTotal = uNum * uSize;
+  if ((uSize != 0) && (uTotal / uSize != uNum))
+  {
+    psReent->_errno = ENOMEM;
+    return NULL;
+  }
+
+  void* pvBlock = _malloc_r(psReent, uTotal);
+  if (pvBlock != NULL) memset(pvBlock, 0, uTotal);
+  return pvBlock;
+}
+
+void* _realloc_r(struct _reent* psReent, void* pvBlock, size_t uSize)
+{
+  if (pvBlock == NULL) return _malloc_r(psReent, uSize);
+
+  /* Keep block if it is still large enough               */
+  size_t uOldSize = uGetPoolBlockSize(pvBlock);
+  if (uSize <= uOldSize) return pvBlock;
+
+  void* pvNew = _malloc_r(psReent, uSize);
+  if (pvNew != NULL)
+  {
+    memcpy(pvNew, pvBlock, uOldSize);
+    vPoolFree(pvBlock);
+  }
+  return pvNew;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Standard heap functions
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void* malloc(size_t uSize)
+{
+  return _malloc_r(_REENT, uSize);
+}
+
+void free(void* pvBlock)
+{
+  vPoolFree(pvBlock);
+}
+
+void* calloc(size_t uNum, size_t uSize)
+{
+  return _calloc_r(_REENT, uNum, uSize);
+}
+
+void* realloc(void* pvBlock, size_t uSize)
+{
+  return _realloc_r(_REENT, pvBlock, uSize);
+}
+#endif /* USE_POOL_MALLOC */
+
+#elif defined(USE_POOL_MALLOC)
+#error "USE_POOL_MALLOC requires USE_POOLS"
+#endif /* USE_POOLS */
@@ -0,0 +1,71 @@
+/*!****************************************************************************
+ * @file
+ * pool.h
+ *
+ * @brief
+ * Fixed-block memory pool allocator
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Pools made optional; added release checks
+ * @date  18.10.2026  Pools and heap replacement enabled by default
+ ******************************************************************************/
+
+#ifndef POOL_H_
+#define POOL_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Enable the memory pools, whose block storage occupies about 2.8 KB
+ *  of SRAM (comment out to free the SRAM if nothing allocates)               */
+#define USE_POOLS
+
+/*! @brief Route malloc()/free() and newlib's reentrant variants into the
+ *  pools, so that heap allocations are bounded and O(1) (comment out to use
+ *  newlib's allocator)                                                       */
+#define USE_POOL_MALLOC
+
+/*! @brief Pool size classes (block size in bytes, multiple of 4; number of
+ *  blocks), in ascending block size order
+ *  @{                                                                        */
+#define POOL0_BLOCK_SIZE              16
+#define POOL0_NUM_BLOCKS              16
+#define POOL1_BLOCK_SIZE              64
+#define POOL1_NUM_BLOCKS              8
+#define POOL2_BLOCK_SIZE              256
+#define POOL2_NUM_BLOCKS              4
+#define POOL3_BLOCK_SIZE              1024
+#define POOL3_NUM_BLOCKS              1
+/*! @}                                                                        */
+
+/*! @brief Number of pool size classes                                        */
+#define POOL_NUM_CLASSES              4
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Pool usage statistics                                              */
+typedef struct
+{
+  uint16_t uiBlockSize;               /*!< Block size in bytes                */
+  uint16_t uiNumBlocks;               /*!< Total number of blocks             */
+  uint16_t uiUsed;                    /*!< Blocks currently allocated         */
+  uint16_t uiPeak;                    /*!< Maximum number of used blocks      */
+  uint32_t ulAllocs;                  /*!< Successful allocations             */
+  uint32_t ulFails;                   /*!< Requests that found pool empty     */
+  uint32_t ulBadFrees;                /*!< Rejected releases (not the start of
+                                           a block, or already free)          */
+} PoolStatsTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vInitPools(void);
+void* pvPoolAlloc(size_t uSize);
+void vPoolFree(void* pvBlock);
+size_t uGetPoolBlockSize(const void* pvBlock);
+void vGetPoolStats(unsigned uClass, PoolStatsTypeDef* psStats);
+void vPrintPoolStats(void);
+
+#endif /* POOL_H_ */
@@ -0,0 +1,1020 @@
+/*!****************************************************************************
+ * @file
+ * rpc.c
+ *
+ * @brief
+ * Framed binary request/response protocol on the debug serial port
+ *
+ * Frames are COBS-encoded and delimited by FRAME_DELIM on both ends. Decoded
+ * frame layout (multi-byte values little-endian):
+ *
+ *   Request:   seq | op          | args...          | crc16
+ *   Response:  seq | op | 0x80   | status | data... | crc16
+ *
+ * The CRC-16/CCITT-FALSE covers all bytes before it. Frames with a bad CRC
+ * are dropped without response; the host is expected to retry on timeout.
+ * Requests are processed in order of arrival, so a host may keep multiple
+ * requests outstanding as long as their total size fits into the RX DMA
+ * buffer (HW_USART1_RX_BUF_SIZE), and match responses by sequence number.
+ *
+ * The text shell and the binary protocol share the port: a FRAME_DELIM byte
+ * while in text mode switches to binary mode, which is left again after
+ * RPC_IDLE_TIMEOUT_MS without received data.
+ *
+ * The baud rate is negotiated by a BAUD request at the current rate. The new
+ * rate is applied after the response has been sent, and must be confirmed by
+ * any valid frame at the new rate within RPC_BAUD_CONFIRM_MS. Otherwise, the
+ * previous rate is restored.
+ *
+ * Responses are written to the MUX_CH_RPC output channel, so they are sent
+ * as plain frames while the multiplexer is disabled and wrapped into
+ * multiplexer frames otherwise (see mux.c). A MUX request switches the mode
+ * after its response has been sent.
+ *
+ * Memory reads are limited to the regions listed in memregion.c. A MEM_DUMP
+ * request is answered by a response, followed by a stream of data frames,
+ * which are sent without further requests for as long as the transmitter
+ * takes them. They carry the sequence number of the request and
+ * are laid out like responses:
+ *
+ *   Data:      seq | op | 0x80   | 0x00 | offset | data... | crc32 | crc16
+ *
+ * The CRC-32 (see offload.c) covers the memory data of the frame. The next
+ * request ends a running stream, so the host can stop it and resume from the
+ * last frame received intact by requesting the remaining range. While the
+ * multiplexer is disabled, two frames are encoded alternately, so that one
+ * is encoded while the other is sent.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added firmware update operations
+ * @date  18.10.2026  Added flash log operations
+ * @date  18.10.2026  Idle timeout follows HCLK changes
+ * @date  18.10.2026  Added baud rate negotiation
+ * @date  18.10.2026  EEPROM operations access the striped EEPROM volume
+ * @date  18.10.2026  Added compression of LOG_READ and ADC_CAPTURE data
+ * @date  18.10.2026  Responses written to mux channel; added MUX operation
+ * @date  18.10.2026  Port accessed through DBGSER_USART driver instance
+ * @date  18.10.2026  Added memory dump stream; memory reads limited to
+ *                    readable regions
+ * @date  18.10.2026  Reject requests with more than RPC_MAX_DATA argument
+ *                    bytes
+ * @date  18.10.2026  Handler responses over RPC_MAX_DATA bytes answered with
+ *                    RPC_STATUS_FAILED
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <string.h>
+#include "ch32v10x.h"
+#include "hw_adc.h"
+#include "hw_stk.h"
+#include "hw_usart.h"
+#include "dbgser.h"
+#include "eeprom.h"
+#include "eevol.h"
+#include "memmon.h"
+#include "syscalls.h"
+#include "fwupd.h"
+#include "flashlog.h"
+#include "compress.h"
+#include "mux.h"
+#include "memregion.h"
+#include "offload.h"
+#include "rpc.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Idle time after which binary mode is left                          */
+#define RPC_IDLE_TIMEOUT_MS           500
+
+/*! @brief Time for the host to confirm a new baud rate                       */
+#define RPC_BAUD_CONFIRM_MS           1000
+
+/*! @brief Maximum ADC_CAPTURE sample count, leaving room for the encoding
+ *  byte of an uncompressed block                                             */
+#define RPC_ADC_MAX_SAMPLES           ((RPC_MAX_DATA - 1) / 2)
+
+/*! @brief Number of bytes fetched from the serial port per read call         */
+#define RPC_RX_CHUNK                  32
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Operation handler
+ *
+ * Receives the request arguments and writes response data, returning one of
+ * the RPC_STATUS_* codes. Arguments and response data are limited to
+ * RPC_MAX_DATA bytes each.                                                   */
+typedef uint8_t (*RpcHandlerTypeDef)(const uint8_t* pucArgs, unsigned uArgLen,
+  uint8_t* pucData, unsigned* puDataLen);
+
+/*! @brief Operation table entry                                              */
+typedef struct
+{
+  uint8_t ucOp;                       /*!< Operation code                     */
+  RpcHandlerTypeDef pvHandler;        /*!< Handler function                   */
+} RpcOpTypeDef;
+
+
+/*! @brief Memory dump stream state                                          */
+typedef struct
+{
+  bool bActive;                       /*!< Stream running                     */
+  uint8_t ucSeq;                      /*!< Request sequence number            */
+  const MemRegionTypeDef* psRegion;   /*!< Region being read                  */
+  uint32_t ulAddress;                 /*!< Start address of the range         */
+  uint32_t ulLength;                  /*!< Range length in bytes              */
+  uint32_t ulOffset;                  /*!< Offset of the next data frame      */
+} RpcDumpTypeDef;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Binary mode active                                                        */
+static bool bRpcActive = false;
+
+/*! SysTick timestamp of last received data                                   */
+static uint32_t ulLastRxTicks;
+
+/*! Receive frame buffer (encoded, without delimiters)                        */
+static uint8_t aucRxFrame[FRAME_COBS_MAX_LEN(RPC_MAX_FRAME)];
+
+/*! Number of bytes in receive frame buffer                                   */
+static unsigned uRxLen;
+
+/*! Current frame exceeds buffer size                                         */
+static bool bRxOverrun;
+
+/*! Response frame buffer (decoded)                                           */
+static uint8_t aucResp[RPC_MAX_FRAME];
+
+/*! Encoded response frame buffer                                             */
+static uint8_t aucTxFrame[RPC_MAX_ENC_FRAME];
+
+/*! Protocol statistics                                                       */
+static RpcStatsTypeDef sRpcStats;
+
+/*! Baud rate to be applied after the current response, or 0                 */
+static uint32_t ulPendingBaud;
+
+/*! Baud rate to be restored if the new rate is not confirmed, or 0          */
+static uint32_t ulFallbackBaud;
+
+/*! SysTick timestamp of baud rate change                                    */
+static uint32_t ulBaudChangeTicks;
+
+/*! Multiplexer mode to be applied after the current response, or -1         */
+static int iPendingMux = -1;
+
+/*! Sequence number of the request being processed                           */
+static uint8_t ucReqSeq;
+
+/*! Memory dump stream                                                        */
+static RpcDumpTypeDef sDump;
+
+/*! Encoded memory dump frames, sent alternately                              */
+static uint8_t aaucDumpFrame[2][RPC_MAX_ENC_FRAME];
+
+/*! Memory dump frame queued for transmission                                */
+static bool abDumpFrameBusy[2];
+
+/*! Next memory dump frame buffer                                             */
+static unsigned uDumpFrame;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Read little-endian values from byte buffer
+ *
+ * @param[in] *pucBuf     Buffer
+ * @return  (uint16_t / uint32_t)  Value
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint16_t uiGetLE16(const uint8_t* pucBuf)
+{
+  return pucBuf[0] | ((uint16_t)pucBuf[1] << 8);
+}
+
+static uint32_t ulGetLE32(const uint8_t* pucBuf)
+{
+  return uiGetLE16(pucBuf) | ((uint32_t)uiGetLE16(pucBuf + 2) << 16);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write little-endian values to byte buffer
+ *
+ * @param[out] *pucBuf    Buffer
+ * @param[in] ulValue     Value
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vPutLE16(uint8_t* pucBuf, uint16_t uiValue)
+{
+  pucBuf[0] = uiValue;
+  pucBuf[1] = uiValue >> 8;
+}
+
+static void vPutLE32(uint8_t* pucBuf, uint32_t ulValue)
+{
+  vPutLE16(pucBuf, ulValue);
+  vPutLE16(pucBuf + 2, ulValue >> 16);
+}
+
+/*!****************************************************************************
+ * @brief
+ * PING: echo request arguments
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcPing(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  memcpy(pucData, pucArgs, uArgLen);
+  *puDataLen = uArgLen;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * INFO: protocol version, maximum data length and RX buffer size
+ *
+ * Response: version (u8), max. data length (u16), RX buffer size (u16)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcInfo(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  (void)pucArgs;
+  if (uArgLen != 0) return RPC_STATUS_BAD_LEN;
+
+  pucData[0] = RPC_VERSION;
+  vPutLE16(&pucData[1], RPC_MAX_DATA);
+  vPutLE16(&pucData[3], uHW_USART_GetRxBufSize(DBGSER_USART));
+  *puDataLen = 5;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * STATS: protocol and memory statistics
+ *
+ * Response: rx frames, tx frames, CRC errors, frame errors, overruns, stack
+ * high-water mark, heap used (u32 each)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcStats(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  (void)pucArgs;
+  if (uArgLen != 0) return RPC_STATUS_BAD_LEN;
+
+  vPutLE32(&pucData[0], sRpcStats.ulRxFrames);
+  vPutLE32(&pucData[4], sRpcStats.ulTxFrames);
+  vPutLE32(&pucData[8], sRpcStats.ulCrcErrors);
+  vPutLE32(&pucData[12], sRpcStats.ulFrameErrors);
+  vPutLE32(&pucData[16], sRpcStats.ulOverruns);
+  vPutLE32(&pucData[20], uGetMainStackHighWater());
+  vPutLE32(&pucData[24], uGetSbrkUsed());
+  *puDataLen = 28;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * MEM_READ: bulk memory read
+ *
+ * Request: address (u32), length (u16)
+ *
+ * The range must be inside one readable region, see memregion.c.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Limited to readable regions
+ ******************************************************************************/
+static uint8_t ucRpcMemRead(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  if (uArgLen != 6) return RPC_STATUS_BAD_LEN;
+  uint32_t ulAddress = ulGetLE32(&pucArgs[0]);
+  unsigned uLength = uiGetLE16(&pucArgs[4]);
+  if (uLength > RPC_MAX_DATA) return RPC_STATUS_BAD_ARG;
+  const MemRegionTypeDef* psRegion = psFindMemRegion(ulAddress, uLength);
+  if (psRegion == NULL) return RPC_STATUS_BAD_ARG;
+
+  vReadMemRegion(psRegion, pucData, ulAddress, uLength);
+  *puDataLen = uLength;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * MEM_DUMP: start memory dump stream
+ *
+ * Request: address (u32), length (u32), offset to start from (u32)
+ * Response: length (u32), data bytes per frame (u16), followed by the data
+ * frames, see file header
+ *
+ * The range must be inside one readable region; word-access regions also
+ * require a multiple of 4 as offset.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcMemDump(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  if (uArgLen != 12) return RPC_STATUS_BAD_LEN;
+  uint32_t ulAddress = ulGetLE32(&pucArgs[0]);
+  uint32_t ulLength = ulGetLE32(&pucArgs[4]);
+  uint32_t ulOffset = ulGetLE32(&pucArgs[8]);
+  if (ulOffset >= ulLength) return RPC_STATUS_BAD_ARG;
+  const MemRegionTypeDef* psRegion = psFindMemRegion(ulAddress, ulLength);
+  if (psRegion == NULL) return RPC_STATUS_BAD_ARG;
+  if (((psRegion->ucFlags & MEM_REGION_WORD) != 0) && ((ulOffset & 3) != 0)) return RPC_STATUS_BAD_ARG;
+
+  sDump.ucSeq = ucReqSeq;
+  sDump.psRegion = psRegion;
+  sDump.ulAddress = ulAddress;
+  sDump.ulLength = ulLength;
+  sDump.ulOffset = ulOffset;
+  sDump.bActive = true;
+
+  vPutLE32(&pucData[0], ulLength);
+  vPutLE16(&pucData[4], RPC_MEM_DUMP_CHUNK);
+  *puDataLen = 6;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * MEM_REGIONS: list readable regions
+ *
+ * Response: per region: start address (u32), length (u32), flags (u8), name
+ * (MEM_REGION_NAME_LEN bytes, zero-padded)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcMemRegions(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  (void)pucArgs;
+  if (uArgLen != 0) return RPC_STATUS_BAD_LEN;
+
+  unsigned uOfs = 0;
+  const MemRegionTypeDef* psRegion;
+  for (unsigned i = 0; (psRegion = psGetMemRegion(i)) != NULL; ++i)
+  {
+    if (uOfs + 9 + MEM_REGION_NAME_LEN > RPC_MAX_DATA) break;
+    vPutLE32(&pucData[uOfs], psRegion->ulStart);
+    vPutLE32(&pucData[uOfs + 4], psRegion->ulLength);
+    pucData[uOfs + 8] = psRegion->ucFlags;
+    strncpy((char*)&pucData[uOfs + 9], psRegion->pszName, MEM_REGION_NAME_LEN);
+    uOfs += 9 + MEM_REGION_NAME_LEN;
+  }
+  *puDataLen = uOfs;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * BAUD: change baud rate
+ *
+ * Request: baud rate (u32)
+ * Response: actual baud rate at current kernel clock (u32), error in ppm (s32)
+ *
+ * The new rate is applied after the response, see vHandleRxFrame(). Rates with
+ * an error above HW_USART_BAUD_MAX_ERROR are rejected.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcBaud(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  if (uArgLen != 4) return RPC_STATUS_BAD_LEN;
+  uint32_t ulBaud = ulGetLE32(&pucArgs[0]);
+
+  uint32_t ulPclk = ulHW_USART_GetPclk(DBGSER_USART);
+  int32_t lError = lHW_USART_CalcBaudError(ulPclk, ulBaud);
+  if ((lError > HW_USART_BAUD_MAX_ERROR) || (lError < -HW_USART_BAUD_MAX_ERROR)) return RPC_STATUS_BAD_ARG;
+
+  vPutLE32(&pucData[0], ulPclk / uiHW_USART_CalcBrr(ulPclk, ulBaud));
+  vPutLE32(&pucData[4], (uint32_t)lError);
+  *puDataLen = 8;
+  ulPendingBaud = ulBaud;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * COMPRESS: select channel encoding and read statistics
+ *
+ * Request: channel (u8), encoding (u8, 0xFF: keep current)
+ * Response: encoding (u8), blocks (u32), input bytes (u32), output bytes
+ * (u32), processing time in us (u32)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcCompress(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  if (uArgLen != 2) return RPC_STATUS_BAD_LEN;
+  CompressChannelTypeDef eChannel = pucArgs[0];
+  if (eChannel >= COMPRESS_NUM_CHANNELS) return RPC_STATUS_BAD_ARG;
+  if (pucArgs[1] != 0xFF)
+  {
+    if (pucArgs[1] >= COMPRESS_NUM_MODES) return RPC_STATUS_BAD_ARG;
+    vSetCompressMode(eChannel, pucArgs[1]);
+  }
+
+  CompressStatsTypeDef sStats;
+  vGetCompressStats(eChannel, &sStats);
+  pucData[0] = eGetCompressMode(eChannel);
+  vPutLE32(&pucData[1], sStats.ulBlocks);
+  vPutLE32(&pucData[5], sStats.ulBytesIn);
+  vPutLE32(&pucData[9], sStats.ulBytesOut);
+  vPutLE32(&pucData[13], (uint32_t)((uint64_t)sStats.ulTicks * 1000 / ulHW_STK_MsToTicks(1)));
+  *puDataLen = 17;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * MUX: switch output multiplexer and read channel statistics
+ *
+ * Request: mode (u8, 0: direct, 1: multiplexed, 0xFF: keep current)
+ * Response: mode (u8), number of channels (u8), max. frame payload (u8), then
+ * per channel: payload bytes, frames, dropped bytes (u32 each)
+ *
+ * The new mode applies after the response has been sent.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcMux(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  if (uArgLen != 1) return RPC_STATUS_BAD_LEN;
+  if ((pucArgs[0] > 1) && (pucArgs[0] != 0xFF)) return RPC_STATUS_BAD_ARG;
+
+  pucData[0] = bIsMuxEnabled() ? 1 : 0;
+  pucData[1] = MUX_NUM_CHANNELS;
+  pucData[2] = MUX_MAX_PAYLOAD;
+  unsigned uOfs = 3;
+  for (unsigned i = 0; i < MUX_NUM_CHANNELS; ++i)
+  {
+    MuxStatsTypeDef sStats;
+    vGetMuxStats(i, &sStats);
+    vPutLE32(&pucData[uOfs], sStats.ulBytes);
+    vPutLE32(&pucData[uOfs + 4], sStats.ulFrames);
+    vPutLE32(&pucData[uOfs + 8], sStats.ulDropped);
+    uOfs += 12;
+  }
+  *puDataLen = uOfs;
+  if (pucArgs[0] != 0xFF) iPendingMux = pucArgs[0];
+  return RPC_STATUS_OK;
+}
+
+#ifdef USE_EEPROM_DEMO
+/*!****************************************************************************
+ * @brief
+ * EE_READ: EEPROM volume read
+ *
+ * Request: address (u16), length (u16)
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Read from EEPROM volume
+ ******************************************************************************/
+static uint8_t ucRpcEeRead(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  if (uArgLen != 4) return RPC_STATUS_BAD_LEN;
+  unsigned uAddress = uiGetLE16(&pucArgs[0]);
+  unsigned uLength = uiGetLE16(&pucArgs[2]);
+  if ((uLength == 0) || (uLength > RPC_MAX_DATA)) return RPC_STATUS_BAD_ARG;
+
+  if (!bReadEepromVolume(pucData, uAddress, uLength)) return RPC_STATUS_BAD_ARG;
+  *puDataLen = uLength;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * EE_WRITE: EEPROM volume page write
+ *
+ * Request: address (u16), data (max. one page, not crossing page border).
+ * The response is sent once the data has been transferred. The internal write
+ * cycle continues in the background, so that writes to consecutive pages on
+ * different devices overlap.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Write to EEPROM volume without waiting for write cycle
+ ******************************************************************************/
+static uint8_t ucRpcEeWrite(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  (void)pucData;
+  if (uArgLen < 3) return RPC_STATUS_BAD_LEN;
+  unsigned uAddress = uiGetLE16(&pucArgs[0]);
+  unsigned uLength = uArgLen - 2;
+  unsigned uPageOffset = uAddress % EEPROM_PAGE_SIZE;
+  if (uPageOffset + uLength > EEPROM_PAGE_SIZE) return RPC_STATUS_BAD_ARG;
+
+  if (!bWriteEepromVolume(&pucArgs[2], uAddress, uLength)) return RPC_STATUS_BAD_ARG;
+  *puDataLen = 0;
+  return RPC_STATUS_OK;
+}
+#endif /* USE_EEPROM_DEMO */
+
+/*!****************************************************************************
+ * @brief
+ * ADC: analog inputs snapshot
+ *
+ * Response: temp. sensor voltage in mV (u16), temperature in degC (s16),
+ * Vrefint in mV (u16)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcAdc(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  (void)pucArgs;
+  if (uArgLen != 0) return RPC_STATUS_BAD_LEN;
+
+  uint16_t uiVoltageTS = uiHW_GetAdcConversionValue_mV(ADC_Channel_TempSensor);
+  int16_t iTemperature = TempSensor_Volt_To_Temper(uiVoltageTS);
+  uint16_t uiVoltageVref = uiHW_GetAdcConversionValue_mV(ADC_Channel_Vrefint);
+  vPutLE16(&pucData[0], uiVoltageTS);
+  vPutLE16(&pucData[2], (uint16_t)iTemperature);
+  vPutLE16(&pucData[4], uiVoltageVref);
+  *puDataLen = 6;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * ADC_CAPTURE: sample an analog input repeatedly
+ *
+ * Request: input (u8, 0: temp. sensor, 1: Vrefint), sample count (u16)
+ * Response: samples in mV (u16 each), coded for COMPRESS_CH_ADC
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcAdcCapture(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  static const uint8_t aucInputs[] = { ADC_Channel_TempSensor, ADC_Channel_Vrefint };
+  if (uArgLen != 3) return RPC_STATUS_BAD_LEN;
+  unsigned uInput = pucArgs[0];
+  unsigned uCount = uiGetLE16(&pucArgs[1]);
+  if ((uInput >= sizeof(aucInputs)) || (uCount == 0) || (uCount > RPC_ADC_MAX_SAMPLES)) return RPC_STATUS_BAD_ARG;
+
+  uint8_t aucSamples[2 * RPC_ADC_MAX_SAMPLES];
+  for (unsigned i = 0; i < uCount; ++i)
+  {
+    vPutLE16(&aucSamples[2 * i], uiHW_GetAdcConversionValue_mV(aucInputs[uInput]));
+  }
+  *puDataLen = uCompressBlock(COMPRESS_CH_ADC, aucSamples, 2 * uCount, pucData, RPC_MAX_DATA);
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Map firmware update result to response status
+ *
+ * @param[in] eResult     Firmware update result
+ * @return  (uint8_t)   Response status
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucGetFwUpdStatus(FwUpdResultTypeDef eResult)
+{
+  if (eResult == FWUPD_OK) return RPC_STATUS_OK;
+  if (eResult == FWUPD_ERR_ARG) return RPC_STATUS_BAD_ARG;
+  return RPC_STATUS_FAILED;
+}
+
+/*!****************************************************************************
+ * @brief
+ * FWUPD_BEGIN: start or resume firmware update session
+ *
+ * Request: image size (u32), image CRC-32 (u32)
+ * Response: offset at which to continue (u32)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcFwUpdBegin(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  if (uArgLen != 8) return RPC_STATUS_BAD_LEN;
+
+  uint32_t ulNextOfs;
+  FwUpdResultTypeDef eResult = eBeginFwUpd(ulGetLE32(&pucArgs[0]), ulGetLE32(&pucArgs[4]), &ulNextOfs);
+  vPutLE32(&pucData[0], ulNextOfs);
+  *puDataLen = 4;
+  return ucGetFwUpdStatus(eResult);
+}
+
+/*!****************************************************************************
+ * @brief
+ * FWUPD_DATA: write one page of image data
+ *
+ * Request: offset (u32), data (max. one flash page)
+ * Response: offset of next expected data (u32)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcFwUpdData(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  if (uArgLen < 5) return RPC_STATUS_BAD_LEN;
+
+  FwUpdResultTypeDef eResult = eWriteFwUpd(ulGetLE32(&pucArgs[0]), &pucArgs[4], uArgLen - 4);
+  FwUpdStatusTypeDef sStatus;
+  vGetFwUpdStatus(&sStatus);
+  vPutLE32(&pucData[0], sStatus.ulNextOfs);
+  *puDataLen = 4;
+  return ucGetFwUpdStatus(eResult);
+}
+
+/*!****************************************************************************
+ * @brief
+ * FWUPD_STATUS: firmware update session status
+ *
+ * Response: state (u8), image size (u32), image CRC-32 (u32), next offset (u32)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcFwUpdStatus(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  (void)pucArgs;
+  if (uArgLen != 0) return RPC_STATUS_BAD_LEN;
+
+  FwUpdStatusTypeDef sStatus;
+  vGetFwUpdStatus(&sStatus);
+  pucData[0] = sStatus.eState;
+  vPutLE32(&pucData[1], sStatus.ulSize);
+  vPutLE32(&pucData[5], sStatus.ulCrc);
+  vPutLE32(&pucData[9], sStatus.ulNextOfs);
+  *puDataLen = 13;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * FWUPD_COMMIT: verify staged image and install it
+ *
+ * The system resets after the response has been sent.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcFwUpdCommit(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  (void)pucArgs;
+  (void)pucData;
+  if (uArgLen != 0) return RPC_STATUS_BAD_LEN;
+
+  *puDataLen = 0;
+  return ucGetFwUpdStatus(eCommitFwUpd());
+}
+
+/*!****************************************************************************
+ * @brief
+ * LOG_INFO: flash log status
+ *
+ * Response: first sequence number (u32), next sequence number (u32), page
+ * size (u16), number of pages (u16), pending bytes (u16)
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcLogInfo(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  (void)pucArgs;
+  if (uArgLen != 0) return RPC_STATUS_BAD_LEN;
+
+  FlashLogInfoTypeDef sInfo;
+  vGetFlashLogInfo(&sInfo);
+  vPutLE32(&pucData[0], sInfo.ulFirstSeq);
+  vPutLE32(&pucData[4], sInfo.ulNextSeq);
+  vPutLE16(&pucData[8], HW_FLASH_PAGE_SIZE);
+  vPutLE16(&pucData[10], FLASHLOG_NUM_PAGES);
+  vPutLE16(&pucData[12], sInfo.uPending);
+  *puDataLen = 14;
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * LOG_READ: read one committed flash log page
+ *
+ * Request: sequence number (u32)
+ * Response: page incl. header coded for COMPRESS_CH_LOG, or no data if the
+ * page is not available
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Page is passed through the compression stage
+ ******************************************************************************/
+static uint8_t ucRpcLogRead(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  if (uArgLen != 4) return RPC_STATUS_BAD_LEN;
+
+  const FlashLogHdrTypeDef* psPage = psGetFlashLogPage(ulGetLE32(&pucArgs[0]));
+  *puDataLen = 0;
+  if (psPage != NULL)
+  {
+    *puDataLen = uCompressBlock(COMPRESS_CH_LOG, psPage, HW_FLASH_PAGE_SIZE, pucData, RPC_MAX_DATA);
+  }
+  return RPC_STATUS_OK;
+}
+
+/*!****************************************************************************
+ * @brief
+ * LOG_FLUSH: commit pending flash log records
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint8_t ucRpcLogFlush(const uint8_t* pucArgs, unsigned uArgLen, uint8_t* pucData, unsigned* puDataLen)
+{
+  (void)pucArgs;
+  (void)pucData;
+  if (uArgLen != 0) return RPC_STATUS_BAD_LEN;
+
+  vFlushFlashLog();
+  *puDataLen = 0;
+  return RPC_STATUS_OK;
+}
+
+/*! Operation table                                                           */
+static const RpcOpTypeDef asRpcOps[] = {
+  { RPC_OP_PING,         ucRpcPing        },
+  { RPC_OP_INFO,         ucRpcInfo        },
+  { RPC_OP_STATS,        ucRpcStats       },
+  { RPC_OP_BAUD,         ucRpcBaud        },
+  { RPC_OP_COMPRESS,     ucRpcCompress    },
+  { RPC_OP_MUX,          ucRpcMux         },
+  { RPC_OP_MEM_READ,     ucRpcMemRead     },
+  { RPC_OP_MEM_DUMP,     ucRpcMemDump     },
+  { RPC_OP_MEM_REGIONS,  ucRpcMemRegions  },
+#ifdef USE_EEPROM_DEMO
+  { RPC_OP_EE_READ,      ucRpcEeRead      },
+  { RPC_OP_EE_WRITE,     ucRpcEeWrite     },
+#endif /* USE_EEPROM_DEMO */
+  { RPC_OP_ADC,          ucRpcAdc         },
+  { RPC_OP_ADC_CAPTURE,  ucRpcAdcCapture  },
+  { RPC_OP_FWUPD_BEGIN,  ucRpcFwUpdBegin  },
+  { RPC_OP_FWUPD_DATA,   ucRpcFwUpdData   },
+  { RPC_OP_FWUPD_STATUS, ucRpcFwUpdStatus },
+  { RPC_OP_FWUPD_COMMIT, ucRpcFwUpdCommit },
+  { RPC_OP_LOG_INFO,     ucRpcLogInfo     },
+  { RPC_OP_LOG_READ,     ucRpcLogRead     },
+  { RPC_OP_LOG_FLUSH,    ucRpcLogFlush    }
+};
+
+/*!****************************************************************************
+ * @brief
+ * Append CRC to the response in aucResp and encode it
+ *
+ * @param[in] uDataLen    Response data length in bytes, at most RPC_MAX_DATA
+ * @param[out] *pucOut    Encoded response, including delimiters
+ * @return  (unsigned)  Encoded response length
+ * @date  18.10.2026
+ ******************************************************************************/
+static unsigned uEncodeResponse(unsigned uDataLen, uint8_t* pucOut)
+{
+  unsigned uRespLen = RPC_HDR_LEN + 1 + uDataLen;
+  vPutLE16(&aucResp[uRespLen], uiCalcCrc16(aucResp, uRespLen, FRAME_CRC16_INIT));
+  uRespLen += RPC_CRC_LEN;
+
+  pucOut[0] = FRAME_DELIM;
+  unsigned uEncLen = uEncodeCobs(aucResp, uRespLen, &pucOut[1]);
+  pucOut[1 + uEncLen] = FRAME_DELIM;
+  return uEncLen + 2;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Mark memory dump frame buffer as free once it has been sent
+ *
+ * @param[in] *pvContext  Busy flag of the buffer
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vReleaseDumpFrame(void* pvContext)
+{
+  *(bool*)pvContext = false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Send the next memory dump data frame once the output can take it
+ *
+ * While the multiplexer is disabled, a frame is queued on the serial port
+ * as soon as one of the two frame buffers is free. Otherwise, it is written
+ * to the output channel, which waits for room in the channel queue.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vPollMemDump(void)
+{
+  if (!sDump.bActive) return;
+  bool bMux = bIsMuxEnabled();
+  if (!bMux && abDumpFrameBusy[uDumpFrame]) return;
+
+  uint32_t ulLen = sDump.ulLength - sDump.ulOffset;
+  if (ulLen > RPC_MEM_DUMP_CHUNK) ulLen = RPC_MEM_DUMP_CHUNK;
+  uint8_t* pucData = &aucResp[RPC_HDR_LEN + 5];
+  aucResp[0] = sDump.ucSeq;
+  aucResp[1] = RPC_OP_MEM_DUMP | RPC_OP_RESPONSE;
+  aucResp[2] = RPC_STATUS_OK;
+  vPutLE32(&aucResp[RPC_HDR_LEN + 1], sDump.ulOffset);
+  vReadMemRegion(sDump.psRegion, pucData, sDump.ulAddress + sDump.ulOffset, ulLen);
+  vPutLE32(&pucData[ulLen], ulCalcCrc32(pucData, ulLen));
+  uint8_t* pucFrame = aaucDumpFrame[uDumpFrame];
+  unsigned uFrameLen = uEncodeResponse(4 + ulLen + 4, pucFrame);
+
+  if (bMux)
+  {
+    uWriteMux(MUX_CH_RPC, pucFrame, uFrameLen);
+  }
+  else
+  {
+    /* Retried on the next call if the queue is full        */
+    const DbgSerSegTypeDef sSeg = { pucFrame, uFrameLen };
+    abDumpFrameBusy[uDumpFrame] = true;
+    if (!bWriteVDbgSer(&sSeg, 1, vReleaseDumpFrame, &abDumpFrameBusy[uDumpFrame]))
+    {
+      abDumpFrameBusy[uDumpFrame] = false;
+      return;
+    }
+    uDumpFrame ^= 1;
+  }
+
+  ++sRpcStats.ulTxFrames;
+  sDump.ulOffset += ulLen;
+  if (sDump.ulOffset == sDump.ulLength) sDump.bActive = false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Handle completed receive frame and send response
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Response written to mux channel; apply mux mode change
+ ******************************************************************************/
+static void vHandleRxFrame(void)
+{
+  unsigned uTxLen = uProcessRpcFrame(aucRxFrame, uRxLen, aucTxFrame);
+  if (uTxLen > 0) uWriteMux(MUX_CH_RPC, aucTxFrame, uTxLen);
+
+  /* Switch multiplexer once the response is sent         */
+  if (iPendingMux >= 0)
+  {
+    vSetMuxEnabled(iPendingMux != 0);
+    iPendingMux = -1;
+  }
+
+  /* Change baud rate once the response is sent          */
+  if (ulPendingBaud != 0)
+  {
+    vFlushMux();
+    if (ulFallbackBaud == 0) ulFallbackBaud = ulHW_USART_GetBaudRate(DBGSER_USART);
+    vHW_USART_SetBaudRate(DBGSER_USART, ulPendingBaud);
+    ulBaudChangeTicks = SysTick_GetValueLow();
+    ulPendingBaud = 0;
+  }
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Process one encoded request frame and build the encoded response
+ *
+ * @note
+ * The request buffer is decoded in place. The output buffer must hold at least
+ * RPC_MAX_ENC_FRAME bytes.
+ *
+ * @param[in,out] *pucFrame  Encoded request, without delimiters
+ * @param[in] uLen        Encoded request length in bytes
+ * @param[out] *pucOut    Encoded response, including delimiters
+ * @return  (unsigned)  Encoded response length, or 0 if frame was dropped
+ * @date  18.10.2026
+ * @date  18.10.2026  Requests with more than RPC_MAX_DATA argument bytes are
+ *                    answered with RPC_STATUS_BAD_LEN
+ * @date  18.10.2026  Handler responses over RPC_MAX_DATA bytes are answered
+ *                    with RPC_STATUS_FAILED
+ ******************************************************************************/
+unsigned uProcessRpcFrame(uint8_t* pucFrame, unsigned uLen, uint8_t* pucOut)
+{
+  /* Decode and verify frame                              */
+  int iLen = iDecodeCobs(pucFrame, uLen, pucFrame);
+  if (iLen < RPC_HDR_LEN + RPC_CRC_LEN)
+  {
+    ++sRpcStats.ulFrameErrors;
+    return 0;
+  }
+  unsigned uPayloadLen = iLen - RPC_CRC_LEN;
+  if (uiCalcCrc16(pucFrame, uPayloadLen, FRAME_CRC16_INIT) != uiGetLE16(&pucFrame[uPayloadLen]))
+  {
+    ++sRpcStats.ulCrcErrors;
+    return 0;
+  }
+  ++sRpcStats.ulRxFrames;
+
+  /* Valid frame confirms a new baud rate, and ends a
+   * running memory dump                                  */
+  ulFallbackBaud = 0;
+  sDump.bActive = false;
+
+  /* Build response                                       */
+  uint8_t* pucResp = aucResp;
+  ucReqSeq = pucFrame[0];
+  pucResp[0] = pucFrame[0];
+  pucResp[1] = pucFrame[1] | RPC_OP_RESPONSE;
+  pucResp[2] = RPC_STATUS_BAD_OP;
+  unsigned uDataLen = 0;
+  unsigned uArgLen = uPayloadLen - RPC_HDR_LEN;
+
+  /* The receive buffer holds a few bytes more than the
+   * largest valid request, which handlers like PING
+   * could not answer within RPC_MAX_DATA                 */
+  if (uArgLen > RPC_MAX_DATA)
+  {
+    pucResp[2] = RPC_STATUS_BAD_LEN;
+  }
+  else
+  {
+    for (unsigned i = 0; i < sizeof(asRpcOps) / sizeof(asRpcOps[0]); ++i)
+    {
+      if (asRpcOps[i].ucOp == pucFrame[1])
+      {
+        pucResp[2] = asRpcOps[i].pvHandler(&pucFrame[RPC_HDR_LEN], uArgLen, &pucResp[3], &uDataLen);
+        if (uDataLen > RPC_MAX_DATA) pucResp[2] = RPC_STATUS_FAILED;
+        break;
+      }
+    }
+  }
+  if (pucResp[2] != RPC_STATUS_OK) uDataLen = 0;
+
+  ++sRpcStats.ulTxFrames;
+  return uEncodeResponse(uDataLen, pucOut);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Binary protocol input processing
+ *
+ * @return  (bool)      true, if binary mode is active and the port must not
+ *                      be read by the text shell
+ * @date  18.10.2026
+ * @date  18.10.2026  Sends memory dump frames
+ ******************************************************************************/
+bool bPollRpc(void)
+{
+  vPollMemDump();
+
+  /* Restore previous baud rate if not confirmed         */
+  if ((ulFallbackBaud != 0) &&
+    (SysTick_GetValueLow() - ulBaudChangeTicks > ulHW_STK_MsToTicks(RPC_BAUD_CONFIRM_MS)))
+  {
+    vHW_USART_SetBaudRate(DBGSER_USART, ulFallbackBaud);
+    ulFallbackBaud = 0;
+  }
+
+  /* Switch to binary mode on frame delimiter             */
+  if (!bRpcActive)
+  {
+    char c;
+    if (!bPeekDbgSer(&c) || (c != FRAME_DELIM)) return false;
+    bRpcActive = true;
+    uRxLen = 0;
+    bRxOverrun = false;
+    ulLastRxTicks = SysTick_GetValueLow();
+  }
+
+  /* Collect frame data                                   */
+  unsigned char aucChunk[RPC_RX_CHUNK];
+  unsigned uChunkLen = uReadDbgSer(aucChunk, sizeof(aucChunk));
+  for (unsigned i = 0; i < uChunkLen; ++i)
+  {
+    if (aucChunk[i] == FRAME_DELIM)
+    {
+      /* Empty frames occur between back-to-back delimiters */
+      if (bRxOverrun) ++sRpcStats.ulOverruns;
+      else if (uRxLen > 0) vHandleRxFrame();
+      uRxLen = 0;
+      bRxOverrun = false;
+    }
+    else if (uRxLen < sizeof(aucRxFrame))
+    {
+      aucRxFrame[uRxLen++] = aucChunk[i];
+    }
+    else
+    {
+      bRxOverrun = true;
+    }
+  }
+
+  /* Return to text mode after idle timeout               */
+  if (uChunkLen > 0)
+  {
+    ulLastRxTicks = SysTick_GetValueLow();
+  }
+  else if (SysTick_GetValueLow() - ulLastRxTicks > ulHW_STK_MsToTicks(RPC_IDLE_TIMEOUT_MS))
+  {
+    if (uRxLen > 0) ++sRpcStats.ulFrameErrors;
+    bRpcActive = false;
+  }
+
+  return bRpcActive;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get protocol statistics
+ *
+ * @param[out] *psStats   Statistics
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetRpcStats(RpcStatsTypeDef* psStats)
+{
+  *psStats = sRpcStats;
+}
@@ -0,0 +1,98 @@
+/*!****************************************************************************
+ * @file
+ * rpc.h
+ *
+ * @brief
+ * Framed binary request/response protocol on the debug serial port
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added firmware update operations
+ * @date  18.10.2026  Added flash log operations
+ * @date  18.10.2026  Added baud rate negotiation
+ * @date  18.10.2026  Added output multiplexer operation
+ * @date  18.10.2026  Added memory dump stream and region list
+ ******************************************************************************/
+
+#ifndef RPC_H_
+#define RPC_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "frame.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Protocol version reported by RPC_OP_INFO                           */
+#define RPC_VERSION                   1
+
+/*! @brief Maximum request argument / response data length in bytes          */
+#define RPC_MAX_DATA                  256
+
+/*! @brief Frame header: sequence number, opcode                              */
+#define RPC_HDR_LEN                   2
+
+/*! @brief Frame trailer: CRC-16 (little-endian)                              */
+#define RPC_CRC_LEN                   2
+
+/*! @brief Maximum decoded frame length (response incl. status byte)          */
+#define RPC_MAX_FRAME                 (RPC_HDR_LEN + 1 + RPC_MAX_DATA + RPC_CRC_LEN)
+
+/*! @brief Maximum encoded frame length incl. both delimiters                 */
+#define RPC_MAX_ENC_FRAME             (FRAME_COBS_MAX_LEN(RPC_MAX_FRAME) + 2)
+
+/*! @brief Memory bytes per MEM_DUMP data frame (multiple of 4), leaving room
+ *  for offset and CRC-32                                                     */
+#define RPC_MEM_DUMP_CHUNK            (RPC_MAX_DATA - 8)
+
+/*! @brief Response flag in opcode field                                      */
+#define RPC_OP_RESPONSE               0x80
+
+/*! @brief Operation codes                                                    */
+#define RPC_OP_PING                   0x00
+#define RPC_OP_INFO                   0x01
+#define RPC_OP_STATS                  0x02
+#define RPC_OP_BAUD                   0x03
+#define RPC_OP_COMPRESS               0x04
+#define RPC_OP_MUX                    0x05
+#define RPC_OP_MEM_READ               0x10
+#define RPC_OP_MEM_DUMP               0x11
+#define RPC_OP_MEM_REGIONS            0x12
+#define RPC_OP_EE_READ                0x20
+#define RPC_OP_EE_WRITE               0x21
+#define RPC_OP_ADC                    0x30
+#define RPC_OP_ADC_CAPTURE            0x31
+#define RPC_OP_FWUPD_BEGIN            0x40
+#define RPC_OP_FWUPD_DATA             0x41
+#define RPC_OP_FWUPD_STATUS           0x42
+#define RPC_OP_FWUPD_COMMIT           0x43
+#define RPC_OP_LOG_INFO               0x50
+#define RPC_OP_LOG_READ               0x51
+#define RPC_OP_LOG_FLUSH              0x52
+
+/*! @brief Response status codes                                              */
+#define RPC_STATUS_OK                 0x00
+#define RPC_STATUS_BAD_OP             0x01
+#define RPC_STATUS_BAD_LEN            0x02
+#define RPC_STATUS_BAD_ARG            0x03
+#define RPC_STATUS_FAILED             0x04
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Protocol statistics                                                */
+typedef struct
+{
+  uint32_t ulRxFrames;                /*!< Valid request frames               */
+  uint32_t ulTxFrames;                /*!< Response frames                    */
+  uint32_t ulCrcErrors;               /*!< Frames dropped due to CRC mismatch */
+  uint32_t ulFrameErrors;             /*!< Malformed or truncated frames      */
+  uint32_t ulOverruns;                /*!< Frames exceeding RPC_MAX_FRAME     */
+} RpcStatsTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+bool bPollRpc(void);
+unsigned uProcessRpcFrame(uint8_t* pucFrame, unsigned uLen, uint8_t* pucOut);
+void vGetRpcStats(RpcStatsTypeDef* psStats);
+
+#endif /* RPC_H_ */
@@ -0,0 +1,182 @@
+/*!****************************************************************************
+ * @file
+ * shell.c
+ *
+ * @brief
+ * Single-key command shell on the debug serial port
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added line input for command arguments
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include "dbgser.h"
+#include "shell.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Key to show the help text                                          */
+#define SHELL_HELP_KEY                '?'
+
+/*! @brief Line input control characters
+ *  @{                                                                        */
+#define SHELL_KEY_BACKSPACE           '\b'
+#define SHELL_KEY_DELETE              '\x7F'
+#define SHELL_KEY_ESCAPE              '\x1B'
+/*! @}                                                                        */
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Command table                                                             */
+static const ShellCmdTypeDef* psCmdTable;
+
+/*! Number of entries in command table                                        */
+static unsigned uCmdTableLen;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Print list of available commands
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vPrintHelp(void)
+{
+  printf("Available Commands:\r\n");
+  printf("  %c    Show this help\r\n", SHELL_HELP_KEY);
+  for (unsigned i = 0; i < uCmdTableLen; ++i)
+  {
+    printf("  %c    %s\r\n", psCmdTable[i].cKey, psCmdTable[i].pszHelp);
+  }
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Initialise shell with application command table
+ *
+ * @param[in] *psCmds     Command table
+ * @param[in] uNumCmds    Number of entries in command table
+ * @date  18.10.2026
+ ******************************************************************************/
+void vInitShell(const ShellCmdTypeDef* psCmds, unsigned uNumCmds)
+{
+  psCmdTable = psCmds;
+  uCmdTableLen = uNumCmds;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Look up command table entry
+ *
+ * @param[in] cKey        Command key
+ * @return  (const ShellCmdTypeDef*)  Table entry, or NULL if not found
+ * @date  18.10.2026
+ ******************************************************************************/
+const ShellCmdTypeDef* psFindShellCmd(char cKey)
+{
+  for (unsigned i = 0; i < uCmdTableLen; ++i)
+  {
+    if (psCmdTable[i].cKey == cKey) return &psCmdTable[i];
+  }
+  return NULL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Execute command
+ *
+ * @param[in] cKey        Command key
+ * @date  18.10.2026
+ ******************************************************************************/
+void vExecShellCmd(char cKey)
+{
+  const ShellCmdTypeDef* psCmd = psFindShellCmd(cKey);
+  if (psCmd != NULL)
+  {
+    psCmd->pvHandler();
+  }
+  else if (cKey == SHELL_HELP_KEY)
+  {
+    vPrintHelp();
+  }
+  else
+  {
+    fprintf(stderr, "Unknown command. Press \"%c\" to show available commands.\r\n", SHELL_HELP_KEY);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Serial input processing
+ *
+ * @date  23.02.2022
+ * @date  03.03.2022  Modified to use printf(), putchar(), getchar()
+ * @date  18.10.2026  Moved from main.c; changed to command table lookup
+ ******************************************************************************/
+void vPollShell(void)
+{
+  /* Early exit, if no data is available                  */
+  if (!bIsDbgSerAvailable()) return;
+
+  /* Fetch character and print remote echo                */
+  char c = getchar();
+  printf("%c\r\n", c);
+
+  /* Process command                                      */
+  vExecShellCmd(c);
+
+  /* Input prompt                                         */
+  putchar('>');
+  fflush(stdout);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Read a line of input with echo, for commands taking arguments
+ *
+ * Backspace removes the last character, escape discards the line. Input ends
+ * with carriage return or line feed and is not added to the buffer.
+ *
+ * @param[in] *pszPrompt  Prompt text
+ * @param[out] *pcBuf     Line buffer, zero-terminated
+ * @param[in] uMaxLen     Buffer size incl. terminator
+ * @return  (unsigned)  Line length, 0 if empty or discarded
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uReadShellLine(const char* pszPrompt, char* pcBuf, unsigned uMaxLen)
+{
+  unsigned uLen = 0;
+  printf("%s", pszPrompt);
+  fflush(stdout);
+  for (;;)
+  {
+    char c = getchar();
+    if ((c == '\r') || (c == '\n'))
+    {
+      break;
+    }
+    else if (c == SHELL_KEY_ESCAPE)
+    {
+      uLen = 0;
+      break;
+    }
+    else if ((c == SHELL_KEY_BACKSPACE) || (c == SHELL_KEY_DELETE))
+    {
+      if (uLen == 0) continue;
+      --uLen;
+      printf("\b \b");
+    }
+    else if ((c >= ' ') && (uLen + 1 < uMaxLen))
+    {
+      pcBuf[uLen++] = c;
+      putchar(c);
+    }
+    fflush(stdout);
+  }
+  pcBuf[uLen] = '\0';
+  printf("\r\n");
+  return uLen;
+}
@@ -0,0 +1,32 @@
+/*!****************************************************************************
+ * @file
+ * shell.h
+ *
+ * @brief
+ * Single-key command shell on the debug serial port
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added line input for command arguments
+ ******************************************************************************/
+
+#ifndef SHELL_H_
+#define SHELL_H_
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Shell command table entry                                          */
+typedef struct
+{
+  char cKey;                          /*!< Command key                        */
+  const char* pszHelp;                /*!< Help text                          */
+  void (*pvHandler)(void);            /*!< Command handler                    */
+} ShellCmdTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vInitShell(const ShellCmdTypeDef* psCmds, unsigned uNumCmds);
+const ShellCmdTypeDef* psFindShellCmd(char cKey);
+void vExecShellCmd(char cKey);
+void vPollShell(void);
+unsigned uReadShellLine(const char* pszPrompt, char* pcBuf, unsigned uMaxLen);
+
+#endif /* SHELL_H_ */
@@ -0,0 +1,225 @@
+/*!****************************************************************************
+ * @file
+ * spectrum.c
+ *
+ * @brief
+ * Spectral analysis of continuously captured ADC sample blocks
+ *
+ * The ADC converts SPECTRUM_ADC_CHANNEL continuously into a circular DMA
+ * buffer of two blocks. Each completed block is announced from the DMA
+ * interrupt through the event queue, and analysed in the main loop while DMA
+ * fills the other block:
+ *
+ *  - the block mean is removed and the samples are shifted up to the full
+ *    Q15 range, so that small ripple signals keep their resolution
+ *  - Hann window, FFT, bin magnitudes and peak search (see fft.c)
+ *
+ * A block which has been overwritten before its samples were copied is
+ * counted as overrun and skipped. A sine with amplitude A at a bin centre
+ * yields a magnitude of A / 4 (1/N FFT scaling, Hann window gain 1/2,
+ * one-sided spectrum).
+ *
+ * The analysis is only compiled in with the USE_SPECTRUM CMake option turned
+ * on (off by default, see CMakeLists.txt).
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Made optional
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "ch32v10x.h"
+#include "hw_adc.h"
+#include "hw_stk.h"
+#include "spectrum.h"
+
+#ifdef USE_SPECTRUM
+
+/*- Private variables --------------------------------------------------------*/
+/*! Capture buffer, two blocks written by DMA                                 */
+static uint16_t auiCaptureBuf[2 * SPECTRUM_POINTS];
+
+/*! FFT working buffers; the magnitudes overlay the real parts               */
+static int16_t aiRe[SPECTRUM_POINTS];
+static int16_t aiIm[SPECTRUM_POINTS];
+
+/*! Number of blocks completed by DMA                                         */
+static volatile uint32_t ulBlockSeq;
+
+/*! Capture running                                                           */
+static volatile bool bRunning;
+
+/*! Analysis results                                                          */
+static SpectrumResultTypeDef sResult;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Capture block callback (DMA interrupt context)
+ *
+ * @param[in] *puiBlock   Completed block
+ * @param[in] uLen        Block length in samples
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vOnCaptureBlock(const uint16_t* puiBlock, unsigned uLen)
+{
+  (void)uLen;
+  uint32_t ulSeq = ++ulBlockSeq;
+  bPublishEvent(EVENT_TOPIC_ADC_BLOCK, (puiBlock == auiCaptureBuf) ? 0 : 1, ulSeq);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Start capture and analysis, resetting the results
+ *
+ * @return  (bool)  true if started, false if the ADC capture is in use
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bStartSpectrum(void)
+{
+  if (bRunning) return false;
+  memset(&sResult, 0, sizeof(sResult));
+  sResult.ulSampleRate = ulHW_GetAdcSampleRate(SPECTRUM_SAMPLE_TIME);
+  ulBlockSeq = 0;
+  bRunning = true;
+  if (!bHW_StartAdcCapture(SPECTRUM_ADC_CHANNEL, SPECTRUM_SAMPLE_TIME, auiCaptureBuf,
+      2 * SPECTRUM_POINTS, vOnCaptureBlock))
+  {
+    bRunning = false;
+    return false;
+  }
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Stop capture
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vStopSpectrum(void)
+{
+  if (!bRunning) return;
+  vHW_StopAdcCapture();
+  bRunning = false;
+  sResult.ulCaptured = ulBlockSeq;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Block event handler: analyse a completed block
+ *
+ * @param[in] *psEvent    Event, argument is the buffer half and data the block
+ *                        sequence number
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHandleSpectrumEvent(const EventTypeDef* psEvent)
+{
+  if (!bRunning) return;
+  uint32_t ulStart = SysTick_GetValueLow();
+  const uint16_t* puiBlock = &auiCaptureBuf[psEvent->uiArg * SPECTRUM_POINTS];
+
+  /* Remove mean and find peak deviation                  */
+  uint32_t ulSum = 0;
+  for (unsigned i = 0; i < SPECTRUM_POINTS; ++i) ulSum += puiBlock[i];
+  int32_t lMean = ulSum >> SPECTRUM_LOG2;
+  int32_t lPeak = 0;
+  for (unsigned i = 0; i < SPECTRUM_POINTS; ++i)
+  {
+    int32_t lValue = puiBlock[i] - lMean;
+    aiRe[i] = lValue;
+    aiIm[i] = 0;
+    if (lValue > lPeak) lPeak = lValue;
+    else if (-lValue > lPeak) lPeak = -lValue;
+  }
+
+  /* DMA has wrapped into this block while copying        */
+  if (ulBlockSeq != psEvent->ulData)
+  {
+    ++sResult.ulOverruns;
+    return;
+  }
+
+  /* Scale to full Q15 range                              */
+  unsigned uShift = 0;
+  while ((uShift < 15) && ((lPeak << (uShift + 1)) <= INT16_MAX)) ++uShift;
+  for (unsigned i = 0; i < SPECTRUM_POINTS; ++i) aiRe[i] = aiRe[i] << uShift;
+
+  /* Spectrum and peaks                                   */
+  vApplyHannQ15(aiRe, SPECTRUM_LOG2);
+  vFftQ15(aiRe, aiIm, SPECTRUM_LOG2);
+  uint16_t* puiMag = (uint16_t*)aiRe;
+  vCalcMagnitudeQ15(aiRe, aiIm, puiMag, SPECTRUM_POINTS / 2);
+  sResult.ucNumPeaks = uFindPeaks(puiMag, SPECTRUM_POINTS / 2, sResult.asPeaks, SPECTRUM_NUM_PEAKS);
+  sResult.uiMean = lMean;
+  sResult.ucShift = uShift;
+  ++sResult.ulBlocks;
+
+  uint32_t ulCycles = (SysTick_GetValueLow() - ulStart) * HW_STK_HCLK_DIV;
+  sResult.ulCycles = ulCycles;
+  if (ulCycles > sResult.ulCyclesMax) sResult.ulCyclesMax = ulCycles;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get analysis results
+ *
+ * @param[out] *psResult  Results
+ * @date  18.10.2026
+ ******************************************************************************/
+void vGetSpectrumResult(SpectrumResultTypeDef* psResult)
+{
+  *psResult = sResult;
+  psResult->ulCaptured = ulBlockSeq;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Capture and analyse SPECTRUM_NUM_BLOCKS blocks, then print the peaks of the
+ * last block
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vPrintSpectrum(void)
+{
+  if (!bStartSpectrum())
+  {
+    printf("ADC capture busy.\r\n");
+    return;
+  }
+  uint32_t ulTimeout = ulHW_STK_MsToTicks(SPECTRUM_TIMEOUT_MS);
+  uint32_t ulStart = SysTick_GetValueLow();
+  while ((sResult.ulBlocks < SPECTRUM_NUM_BLOCKS) && (SysTick_GetValueLow() - ulStart < ulTimeout))
+  {
+    vPollEvents();
+  }
+  vStopSpectrum();
+
+  uint32_t ulBinWidth = (uint32_t)((uint64_t)sResult.ulSampleRate * 100 >> SPECTRUM_LOG2);
+  printf(
+    "-- Spectrum --------------------------------------\r\n"
+    "%u points at %lu Hz, %lu.%02lu Hz/bin, Hann window\r\n"
+    "Blocks: %lu captured, %lu analysed, %lu overruns\r\n"
+    "Cycles/block: %lu last, %lu max\r\n",
+    SPECTRUM_POINTS, sResult.ulSampleRate, ulBinWidth / 100, ulBinWidth % 100,
+    sResult.ulCaptured, sResult.ulBlocks, sResult.ulOverruns,
+    sResult.ulCycles, sResult.ulCyclesMax
+  );
+  if (sResult.ulBlocks == 0) return;
+
+  printf("Mean: %u mV\r\n", uiHW_ConvertAdcValue_mV(sResult.uiMean));
+  for (unsigned i = 0; i < sResult.ucNumPeaks; ++i)
+  {
+    const FftPeakTypeDef* psPeak = &sResult.asPeaks[i];
+    int32_t lPos = psPeak->uiBin * FFT_PEAK_FRAC_ONE + psPeak->iFrac;
+    uint32_t ulFreq = (uint32_t)(((uint64_t)lPos * sResult.ulSampleRate * 10) /
+      ((uint64_t)FFT_PEAK_FRAC_ONE << SPECTRUM_LOG2));
+    uint32_t ulAmpl = ulHW_ConvertAdcValue_uV(4UL * psPeak->uiMag, sResult.ucShift);
+    printf("Peak %u: %6lu.%lu Hz, %7lu uV\r\n", i + 1, ulFreq / 10, ulFreq % 10, ulAmpl);
+  }
+}
+
+#endif /* USE_SPECTRUM */
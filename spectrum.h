@@ -0,0 +1,74 @@
+/*!****************************************************************************
+ * @file
+ * spectrum.h
+ *
+ * @brief
+ * Spectral analysis of continuously captured ADC sample blocks
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Made optional
+ ******************************************************************************/
+
+#ifndef SPECTRUM_H_
+#define SPECTRUM_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "fft.h"
+#include "event.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Include the spectrum analysis and its shell command (normally set by
+ *  the USE_SPECTRUM CMake option)                                            */
+//#define USE_SPECTRUM
+
+/*! @brief Transform size (log2), at most FFT_MAX_LOG2                        */
+#define SPECTRUM_LOG2                 9
+
+/*! @brief Samples per block                                                  */
+#define SPECTRUM_POINTS               (1U << SPECTRUM_LOG2)
+
+/*! @brief Analysed ADC channel. Vrefint follows ripple on VDDA; for external
+ *  signals, select e.g. ADC_Channel_0 and configure PA0 as analog input      */
+#define SPECTRUM_ADC_CHANNEL          ADC_Channel_Vrefint
+
+/*! @brief ADC sample time, determines the sample rate                        */
+#define SPECTRUM_SAMPLE_TIME          ADC_SampleTime_239Cycles5
+
+/*! @brief Number of reported peaks                                           */
+#define SPECTRUM_NUM_PEAKS            4
+
+/*! @brief Blocks analysed per shell command                                  */
+#define SPECTRUM_NUM_BLOCKS           8
+
+/*! @brief Shell command timeout in ms                                        */
+#define SPECTRUM_TIMEOUT_MS           2000
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Analysis results                                                   */
+typedef struct
+{
+  uint32_t ulSampleRate;              /*!< Sample rate in Hz                  */
+  uint32_t ulCaptured;                /*!< Blocks captured                    */
+  uint32_t ulBlocks;                  /*!< Blocks analysed                    */
+  uint32_t ulOverruns;                /*!< Blocks overwritten before analysis */
+  uint32_t ulCycles;                  /*!< Core cycles for the last block     */
+  uint32_t ulCyclesMax;               /*!< Maximum core cycles per block      */
+  uint16_t uiMean;                    /*!< Block mean in ADC counts           */
+  uint8_t ucShift;                    /*!< Input scaling (log2) of the block  */
+  uint8_t ucNumPeaks;                 /*!< Number of valid peaks              */
+  FftPeakTypeDef asPeaks[SPECTRUM_NUM_PEAKS]; /*!< Peaks of the last block    */
+} SpectrumResultTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+bool bStartSpectrum(void);
+void vStopSpectrum(void);
+void vHandleSpectrumEvent(const EventTypeDef* psEvent);
+void vGetSpectrumResult(SpectrumResultTypeDef* psResult);
+void vPrintSpectrum(void);
+
+#endif /* SPECTRUM_H_ */
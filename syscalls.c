@@ -23,23 +23,47 @@
  *  [8] _fstat, _fstat32, _fstat64, _fstati64, _fstat32i64, _fstat64i32, CRT
  *  Alphabetical Function Reference, Microsoft
  *  https://docs.microsoft.com/en-us/cpp/c-runtime-library/reference/fstat-fstat32-fstat64-fstati64-fstat32i64-fstat64i32
+ *  [9] sbrk, The Open Group Base Specifications Issue 6
+ *  https://pubs.opengroup.org/onlinepubs/007908799/xsh/brk.html
  *
  * @date  03.03.2022
+ * @date  18.10.2026  Added bounded _sbrk(); static stdio buffers
+ * @date  18.10.2026  Read timeout follows HCLK changes
+ * @date  18.10.2026  Output written through channel multiplexer
  ******************************************************************************/
 
 /*- Header files -------------------------------------------------------------*/
 #include "ch32v10x.h"
 #include <stdio.h>
+#include <stddef.h>
 #include <errno.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include "hw_stk.h"
 #include "dbgser.h"
+#include "mux.h"
 
 
 /*- Macros -------------------------------------------------------------------*/
-/*! Read timeout in SysTick timer counts                                      */
-#define READ_TIMEOUT                  ((HSI_VALUE / 8) / 1000)
+/*! Read timeout in ms                                                        */
+#define READ_TIMEOUT_MS               1
+
+/*! stdout buffer size                                                        */
+#define STDOUT_BUF_SIZE               128
+
+
+/*- Linker symbols -----------------------------------------------------------*/
+extern char _ebss[];                  /*!< End of .bss, start of heap         */
+extern char _heap_end[];              /*!< End of heap, bottom of stack area  */
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Static stdout buffer, avoids heap allocation by newlib                    */
+static char acStdoutBuf[STDOUT_BUF_SIZE];
+
+/*! Current program break                                                     */
+static char* pcHeapBreak = _ebss;
 
 
 /*!****************************************************************************
@@ -53,11 +77,26 @@
  *  https://docs.microsoft.com/en-us/cpp/c-runtime-library/reference/setvbuf
  *
  * @date  03.03.2022
+ * @date  18.10.2026  Changed to static stdout buffer and unbuffered stdin
  ******************************************************************************/
 void vInitSyscalls(void)
 {
-  /* Enable line buffering                                */
-  setvbuf(stdout, NULL, _IOLBF, 0);
+  /* Enable line buffering using a static buffer; read
+   * stdin unbuffered. Neither allocates heap memory.     */
+  setvbuf(stdout, acStdoutBuf, _IOLBF, sizeof(acStdoutBuf));
+  setvbuf(stdin, NULL, _IONBF, 0);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get number of heap bytes handed out by _sbrk()
+ *
+ * @return  (unsigned)  Heap usage in bytes
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uGetSbrkUsed(void)
+{
+  return (unsigned)(pcHeapBreak - _ebss);
 }
 
 
@@ -115,7 +154,7 @@ int _read(int fd, void* buffer, unsigned buffer_size)
       unsigned uStart = SysTick_GetValueLow();
       while (!bIsDbgSerAvailable())
       {
-        if (SysTick_GetValueLow() - uStart > READ_TIMEOUT) return (int)i;
+        if (SysTick_GetValueLow() - uStart > ulHW_STK_MsToTicks(READ_TIMEOUT_MS)) return (int)i;
       }
       ((char*)buffer)[i] = cGetCharDbgSer();
     }
@@ -142,6 +181,8 @@ int _read(int fd, void* buffer, unsigned buffer_size)
  * @return  (int)         Number of bytes written
  * @date  03.03.2022
  * @date  03.03.2022  Added red text coloring for stderr output
+ * @date  18.10.2026  stdout and stderr written to separate mux channels
+ * @date  18.10.2026  stderr color codes written with the data as one message
  ******************************************************************************/
 int _write(int fd, const char* buffer, unsigned count)
 {
@@ -152,9 +193,17 @@ int _write(int fd, const char* buffer, unsigned count)
   }
   else if (fd == STDOUT_FILENO || fd == STDERR_FILENO)
   {
-    if (fd == STDERR_FILENO) vPrintDbgSer(VT100_COLOR_FGRED);
-    vWriteDbgSer((const unsigned char*)buffer, count);
-    if (fd == STDERR_FILENO) vPrintDbgSer(VT100_COLOR_RESET);
+    if (fd == STDOUT_FILENO)
+    {
+      uWriteMux(MUX_CH_SHELL, buffer, count);
+      return (int)count;
+    }
+    const DbgSerSegTypeDef asSegs[] = {
+      { VT100_COLOR_FGRED, sizeof(VT100_COLOR_FGRED) - 1 },
+      { buffer, count },
+      { VT100_COLOR_RESET, sizeof(VT100_COLOR_RESET) - 1 }
+    };
+    uWriteVMux(MUX_CH_ERROR, asSegs, sizeof(asSegs) / sizeof(asSegs[0]));
     return (int)count;
   }
   else
@@ -248,3 +297,27 @@ int _fstat(int fd, struct stat* buffer)
     return -1;
   }
 }
+
+/*!****************************************************************************
+ * @brief
+ * Change data segment size (heap), bounded by the bottom of the stack area
+ *
+ * References:
+ *  [9] sbrk, The Open Group Base Specifications Issue 6
+ *  https://pubs.opengroup.org/onlinepubs/007908799/xsh/brk.html
+ *
+ * @param[in] increment   Number of bytes to add to the heap
+ * @return  (void*)     Previous program break, or (void*)-1 on failure
+ * @date  18.10.2026
+ ******************************************************************************/
+void* _sbrk(ptrdiff_t increment)
+{
+  char* pcPrevBreak = pcHeapBreak;
+  if ((increment > _heap_end - pcHeapBreak) || (increment < _ebss - pcHeapBreak))
+  {
+    errno = ENOMEM;
+    return (void*)-1;
+  }
+  pcHeapBreak += increment;
+  return pcPrevBreak;
+}
@@ -6,6 +6,7 @@
  * Syscalls retargeting
  *
  * @date  03.03.2022
+ * @date  18.10.2026  Added heap usage query
  ******************************************************************************/
 
 #ifndef SYSCALLS_H_
@@ -13,5 +14,6 @@
 
 /*- Exported functions -------------------------------------------------------*/
 void vInitSyscalls(void);
+unsigned uGetSbrkUsed(void);
 
 #endif /* SYSCALLS_H_ */
@@ -0,0 +1,41 @@
+#!/usr/bin/env python3
+"""Compare the firmware software CRC-32 with the image trailer tool.
+
+Runs the CRC host test with --vectors, which prints one line per data block:
+
+  <data in hex> <CRC-32 of ulCalcCrc32Sw()>
+
+and checks each CRC against crc32_words() of tools/image_trailer.py, which
+seals the image that the firmware verifies at boot:
+
+  check_crc.py build-tests/test_crc
+"""
+
+import os
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tools"))
+from image_trailer import crc32_words  # noqa: E402
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__, file=sys.stderr)
+        return 2
+    output = subprocess.run([sys.argv[1], "--vectors"], check=True, capture_output=True, text=True).stdout
+    checked = failed = 0
+    for line in output.splitlines():
+        data, crc = line.split(" ")
+        data = bytes.fromhex(data)
+        expected = crc32_words(data)
+        checked += 1
+        if int(crc, 16) != expected:
+            failed += 1
+            print("%d bytes: firmware %s, image_trailer.py %08x" % (len(data), crc, expected), file=sys.stderr)
+    print("%d vectors, %d mismatches" % (checked, failed))
+    return 1 if failed or not checked else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
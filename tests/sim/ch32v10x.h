@@ -0,0 +1,354 @@
+/*!****************************************************************************
+ * @file
+ * ch32v10x.h
+ *
+ * @brief
+ * Host replacement of the vendor device header for the host tests
+ *
+ * Provides the subset of device definitions and standard peripheral library
+ * functions used by the modules under test. The internal flash is an array
+ * in host memory (see sim_flash.c), the I2C2 functions drive simulated 24C64
+ * devices, and SysTick counts simulated microseconds (see sim_i2c.c). The
+ * USART and DMA registers belong to simulated serial lines (see sim_usart.c).
+ * The CRC unit and the memory-to-memory DMA functions are stubs, which only
+ * let offload.c link for its software CRC-32 (see test_crc.c). RCC, flash
+ * latency and TIM3 form a simulated clock tree (see sim_clk.c).
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added system reset
+ * @date  18.10.2026  Added USART and DMA
+ * @date  18.10.2026  Added CRC unit and DMA interrupt functions
+ * @date  18.10.2026  Added RCC, flash latency and TIM3
+ ******************************************************************************/
+
+#ifndef CH32V10X_H_
+#define CH32V10X_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Simulated flash memory size in bytes                               */
+#define SIM_FLASH_SIZE                0x10000
+
+/*! @brief Flash base address (simulated flash array)                         */
+#define FLASH_BASE                    ((uintptr_t)aucSimFlash)
+
+/*! @brief I2C flags and events used by the EEPROM driver
+ *  @{                                                                        */
+#define I2C_FLAG_BUSY                 0x00020000UL
+#define I2C_FLAG_RXNE                 0x10000040UL
+#define I2C_FLAG_AF                   0x10000400UL
+#define I2C_EVENT_MASTER_MODE_SELECT  0x00030001UL
+#define I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED 0x00070082UL
+#define I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED 0x00030002UL
+#define I2C_EVENT_MASTER_BYTE_TRANSMITTED 0x00070084UL
+#define I2C_Direction_Transmitter     0x00
+#define I2C_Direction_Receiver        0x01
+/*! @}                                                                        */
+
+/*! @brief Peripheral clock enable masks
+ *  @{                                                                        */
+#define RCC_AHBPeriph_DMA1            0x00000001UL
+#define RCC_APB1Periph_TIM3           0x00000002UL
+#define RCC_APB1Periph_USART2         0x00020000UL
+#define RCC_APB1Periph_USART3         0x00040000UL
+#define RCC_APB2Periph_USART1         0x00004000UL
+/*! @}                                                                        */
+
+/*! @brief Oscillator frequencies in Hz                                       */
+#define HSE_VALUE                     8000000UL
+#define HSI_VALUE                     8000000UL
+
+/*! @brief RCC and flash configuration values
+ *  @{                                                                        */
+#define RCC_HSE_OFF                   0x00000000UL
+#define RCC_HSE_ON                    0x00010000UL
+#define RCC_SYSCLKSource_HSI          0x00000000UL
+#define RCC_SYSCLKSource_HSE          0x00000001UL
+#define RCC_SYSCLKSource_PLLCLK       0x00000002UL
+#define RCC_SYSCLK_Div1               0x00000000UL
+#define RCC_HCLK_Div1                 0x00000000UL
+#define RCC_HCLK_Div2                 0x00000400UL
+#define RCC_HCLK_Div4                 0x00000500UL
+#define RCC_HCLK_Div8                 0x00000600UL
+#define RCC_HCLK_Div16                0x00000700UL
+#define RCC_PCLK2_Div2                0x00000000UL
+#define RCC_PCLK2_Div4                0x00004000UL
+#define RCC_PCLK2_Div6                0x00008000UL
+#define RCC_PCLK2_Div8                0x0000C000UL
+#define RCC_PLLSource_HSI_Div2        0x00000000UL
+#define RCC_PLLSource_HSE_Div1        0x00010000UL
+#define RCC_FLAG_PLLRDY               0x39
+#define FLASH_Latency_0               0x00000000UL
+#define FLASH_Latency_1               0x00000001UL
+#define FLASH_Latency_2               0x00000002UL
+/*! @}                                                                        */
+
+/*! @brief TIM configuration values
+ *  @{                                                                        */
+#define TIM_CounterMode_Up            0x0000
+#define TIM_OCMode_PWM1               0x0060
+#define TIM_OutputState_Enable        0x0001
+#define TIM_OCPolarity_Low            0x0002
+#define TIM_OCPreload_Disable         0x0000
+#define TIM_PSCReloadMode_Immediate   0x0001
+#define TIM_IT_Update                 0x0001
+/*! @}                                                                        */
+
+/*! @brief USART register bits, flags and configuration values
+ *  @{                                                                        */
+#define USART_FLAG_TXE                0x0080
+#define USART_FLAG_TC                 0x0040
+#define USART_FLAG_RXNE               0x0020
+#define USART_FLAG_ORE                0x0008
+#define USART_FLAG_NE                 0x0004
+#define USART_FLAG_FE                 0x0002
+#define USART_CTLR1_UE                0x2000
+#define USART_CTLR1_TXEIE             0x0080
+#define USART_CTLR1_TE                0x0008
+#define USART_CTLR1_RE                0x0004
+#define USART_IT_TXE                  0x0727
+#define USART_DMAReq_Tx               0x0080
+#define USART_DMAReq_Rx               0x0040
+#define USART_WordLength_8b           0x0000
+#define USART_Parity_No               0x0000
+#define USART_StopBits_1              0x0000
+#define USART_Mode_Rx                 0x0004
+#define USART_Mode_Tx                 0x0008
+/*! @}                                                                        */
+
+/*! @brief DMA channel configuration values
+ *  @{                                                                        */
+#define DMA_CFGR_EN                   0x0001
+#define DMA_DIR_PeripheralSRC         0x0000
+#define DMA_DIR_PeripheralDST         0x0010
+#define DMA_Mode_Normal               0x0000
+#define DMA_Mode_Circular             0x0020
+#define DMA_PeripheralInc_Enable      0x0040
+#define DMA_PeripheralInc_Disable     0x0000
+#define DMA_MemoryInc_Enable          0x0080
+#define DMA_PeripheralDataSize_Byte   0x0000
+#define DMA_PeripheralDataSize_HalfWord 0x0100
+#define DMA_PeripheralDataSize_Word   0x0200
+#define DMA_MemoryDataSize_Byte       0x0000
+#define DMA_MemoryDataSize_HalfWord   0x0400
+#define DMA_MemoryDataSize_Word       0x0800
+#define DMA_Priority_Low              0x0000
+#define DMA_Priority_Medium           0x1000
+#define DMA_Priority_High             0x2000
+#define DMA_M2M_Disable               0x0000
+#define DMA_M2M_Enable                0x4000
+#define DMA_IT_TC                     0x0002
+#define DMA1_IT_GL2                   0x00000010UL
+#define DMA1_IT_TC2                   0x00000020UL
+/*! @}                                                                        */
+
+/*! @brief Simulated USART and DMA instances
+ *  @{                                                                        */
+#define USART1                        (&asSimUsart[0])
+#define USART2                        (&asSimUsart[1])
+#define USART3                        (&asSimUsart[2])
+#define DMA1_Channel1                 (&asSimDma1[0])
+#define DMA1_Channel2                 (&asSimDma1[1])
+#define DMA1_Channel3                 (&asSimDma1[2])
+#define DMA1_Channel4                 (&asSimDma1[3])
+#define DMA1_Channel5                 (&asSimDma1[4])
+#define DMA1_Channel6                 (&asSimDma1[5])
+#define DMA1_Channel7                 (&asSimDma1[6])
+#define CRC                           (&sSimCrc)
+#define TIM3                          (&sSimTim3)
+/*! @}                                                                        */
+
+
+/*- Type definitions ---------------------------------------------------------*/
+typedef enum { RESET = 0, SET = !RESET } FlagStatus, ITStatus;
+typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
+typedef enum { ERROR = 0, SUCCESS = !ERROR } ErrorStatus;
+
+/*! @brief I2C peripheral (no registers are simulated)                        */
+typedef struct
+{
+  uint32_t ulDummy;
+} I2C_TypeDef;
+
+/*! @brief USART registers                                                    */
+typedef struct
+{
+  volatile uint16_t STATR;
+  volatile uint16_t DATAR;
+  volatile uint16_t BRR;
+  volatile uint16_t CTLR1;
+  volatile uint16_t CTLR2;
+  volatile uint16_t CTLR3;
+} USART_TypeDef;
+
+/*! @brief DMA channel registers                                              */
+typedef struct
+{
+  volatile uint32_t CFGR;
+  volatile uint32_t CNTR;
+  volatile uint32_t PADDR;
+  volatile uint32_t MADDR;
+} DMA_Channel_TypeDef;
+
+/*! @brief CRC unit registers                                                 */
+typedef struct
+{
+  volatile uint32_t DATAR;
+  volatile uint8_t IDATAR;
+  uint8_t ucReserved0;
+  uint16_t uiReserved1;
+  volatile uint32_t CTLR;
+} CRC_TypeDef;
+
+/*! @brief Timer registers (subset)                                           */
+typedef struct
+{
+  volatile uint16_t CTLR1;
+  volatile uint16_t DMAINTENR;
+  volatile uint16_t INTFR;
+  volatile uint16_t PSC;
+  volatile uint16_t ATRLR;
+  volatile uint16_t CH1CVR;
+} TIM_TypeDef;
+
+/*! @brief Interrupt numbers (subset)                                         */
+typedef enum
+{
+  TIM3_IRQn = 45
+} IRQn_Type;
+
+/*! @brief Bus clock frequencies                                              */
+typedef struct
+{
+  uint32_t SYSCLK_Frequency;
+  uint32_t HCLK_Frequency;
+  uint32_t PCLK1_Frequency;
+  uint32_t PCLK2_Frequency;
+  uint32_t ADCCLK_Frequency;
+} RCC_ClocksTypeDef;
+
+/*! @brief Timer base configuration                                           */
+typedef struct
+{
+  uint16_t TIM_Prescaler;
+  uint16_t TIM_CounterMode;
+  uint16_t TIM_Period;
+  uint16_t TIM_ClockDivision;
+  uint8_t TIM_RepetitionCounter;
+} TIM_TimeBaseInitTypeDef;
+
+/*! @brief Timer output compare configuration                                 */
+typedef struct
+{
+  uint16_t TIM_OCMode;
+  uint16_t TIM_OutputState;
+  uint16_t TIM_OutputNState;
+  uint16_t TIM_Pulse;
+  uint16_t TIM_OCPolarity;
+  uint16_t TIM_OCNPolarity;
+  uint16_t TIM_OCIdleState;
+  uint16_t TIM_OCNIdleState;
+} TIM_OCInitTypeDef;
+
+/*! @brief USART configuration                                                */
+typedef struct
+{
+  uint32_t USART_BaudRate;
+  uint16_t USART_WordLength;
+  uint16_t USART_StopBits;
+  uint16_t USART_Parity;
+  uint16_t USART_Mode;
+  uint16_t USART_HardwareFlowControl;
+} USART_InitTypeDef;
+
+/*! @brief DMA channel configuration                                          */
+typedef struct
+{
+  uint32_t DMA_PeripheralBaseAddr;
+  uint32_t DMA_MemoryBaseAddr;
+  uint32_t DMA_DIR;
+  uint32_t DMA_BufferSize;
+  uint32_t DMA_PeripheralInc;
+  uint32_t DMA_MemoryInc;
+  uint32_t DMA_PeripheralDataSize;
+  uint32_t DMA_MemoryDataSize;
+  uint32_t DMA_Mode;
+  uint32_t DMA_Priority;
+  uint32_t DMA_M2M;
+} DMA_InitTypeDef;
+
+
+/*- Exported variables -------------------------------------------------------*/
+extern uint8_t aucSimFlash[SIM_FLASH_SIZE];
+extern I2C_TypeDef* const I2C2;
+extern USART_TypeDef asSimUsart[3];
+extern DMA_Channel_TypeDef asSimDma1[7];
+extern CRC_TypeDef sSimCrc;
+extern TIM_TypeDef sSimTim3;
+extern uint32_t SystemCoreClock;
+
+
+/*- Exported functions -------------------------------------------------------*/
+uint32_t SysTick_GetValueLow(void);
+void PFIC_SystemReset(void);
+FlagStatus I2C_GetFlagStatus(I2C_TypeDef* psI2c, uint32_t ulFlag);
+void I2C_ClearFlag(I2C_TypeDef* psI2c, uint32_t ulFlag);
+ErrorStatus I2C_CheckEvent(I2C_TypeDef* psI2c, uint32_t ulEvent);
+void I2C_GenerateSTART(I2C_TypeDef* psI2c, FunctionalState eState);
+void I2C_GenerateSTOP(I2C_TypeDef* psI2c, FunctionalState eState);
+void I2C_AcknowledgeConfig(I2C_TypeDef* psI2c, FunctionalState eState);
+void I2C_Send7bitAddress(I2C_TypeDef* psI2c, uint8_t ucAddress, uint8_t ucDirection);
+void I2C_SendData(I2C_TypeDef* psI2c, uint8_t ucData);
+uint8_t I2C_ReceiveData(I2C_TypeDef* psI2c);
+void RCC_AHBPeriphClockCmd(uint32_t ulPeriph, FunctionalState eState);
+void RCC_APB1PeriphClockCmd(uint32_t ulPeriph, FunctionalState eState);
+void RCC_APB2PeriphClockCmd(uint32_t ulPeriph, FunctionalState eState);
+void USART_Init(USART_TypeDef* psUsart, const USART_InitTypeDef* psInit);
+void USART_Cmd(USART_TypeDef* psUsart, FunctionalState eState);
+void USART_DMACmd(USART_TypeDef* psUsart, uint16_t uiReq, FunctionalState eState);
+void USART_ITConfig(USART_TypeDef* psUsart, uint16_t uiIt, FunctionalState eState);
+FlagStatus USART_GetITStatus(USART_TypeDef* psUsart, uint16_t uiIt);
+FlagStatus USART_GetFlagStatus(USART_TypeDef* psUsart, uint16_t uiFlag);
+void USART_SendData(USART_TypeDef* psUsart, uint16_t uiData);
+void DMA_DeInit(DMA_Channel_TypeDef* psChannel);
+void DMA_Init(DMA_Channel_TypeDef* psChannel, const DMA_InitTypeDef* psInit);
+void DMA_Cmd(DMA_Channel_TypeDef* psChannel, FunctionalState eState);
+uint16_t DMA_GetCurrDataCounter(DMA_Channel_TypeDef* psChannel);
+void DMA_SetCurrDataCounter(DMA_Channel_TypeDef* psChannel, uint16_t uiCount);
+void DMA_ITConfig(DMA_Channel_TypeDef* psChannel, uint32_t ulIt, FunctionalState eState);
+ITStatus DMA_GetITStatus(uint32_t ulIt);
+void DMA_ClearITPendingBit(uint32_t ulIt);
+void CRC_ResetDR(void);
+void SystemCoreClockUpdate(void);
+void RCC_GetClocksFreq(RCC_ClocksTypeDef* psClocks);
+void RCC_HSEConfig(uint32_t ulHse);
+ErrorStatus RCC_WaitForHSEStartUp(void);
+void RCC_SYSCLKConfig(uint32_t ulSource);
+uint8_t RCC_GetSYSCLKSource(void);
+void RCC_HCLKConfig(uint32_t ulDiv);
+void RCC_PCLK1Config(uint32_t ulDiv);
+void RCC_PCLK2Config(uint32_t ulDiv);
+void RCC_ADCCLKConfig(uint32_t ulDiv);
+void RCC_PLLConfig(uint32_t ulSource, uint32_t ulMul);
+void RCC_PLLCmd(FunctionalState eState);
+FlagStatus RCC_GetFlagStatus(uint8_t ucFlag);
+void FLASH_SetLatency(uint32_t ulLatency);
+void TIM_TimeBaseInit(TIM_TypeDef* psTim, const TIM_TimeBaseInitTypeDef* psInit);
+void TIM_OC1Init(TIM_TypeDef* psTim, const TIM_OCInitTypeDef* psInit);
+void TIM_CtrlPWMOutputs(TIM_TypeDef* psTim, FunctionalState eState);
+void TIM_OC1PreloadConfig(TIM_TypeDef* psTim, uint16_t uiPreload);
+void TIM_ARRPreloadConfig(TIM_TypeDef* psTim, FunctionalState eState);
+void TIM_Cmd(TIM_TypeDef* psTim, FunctionalState eState);
+void TIM_PrescalerConfig(TIM_TypeDef* psTim, uint16_t uiPrescaler, uint16_t uiMode);
+void TIM_ITConfig(TIM_TypeDef* psTim, uint16_t uiIt, FunctionalState eState);
+void TIM_ClearITPendingBit(TIM_TypeDef* psTim, uint16_t uiIt);
+ITStatus TIM_GetITStatus(TIM_TypeDef* psTim, uint16_t uiIt);
+
+/*! @brief Interrupts do not preempt the host tests                           */
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+
+#endif /* CH32V10X_H_ */
@@ -0,0 +1,33 @@
+/*!****************************************************************************
+ * @file
+ * reent.h
+ *
+ * @brief
+ * Host replacement of newlib's reentrancy header for the host tests
+ *
+ * Only the errno member of the reentrancy structure is provided; _REENT is
+ * the structure of the test program (see test_pool.c).
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef REENT_H_
+#define REENT_H_
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Reentrancy structure of the running program                        */
+#define _REENT                        (&sSimReent)
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Reentrancy structure (errno only)                                  */
+struct _reent
+{
+  int _errno;                         /*!< Error number                       */
+};
+
+
+/*- Exported variables -------------------------------------------------------*/
+extern struct _reent sSimReent;
+
+#endif /* REENT_H_ */
@@ -0,0 +1,389 @@
+/*!****************************************************************************
+ * @file
+ * sim_clk.c
+ *
+ * @brief
+ * Simulated clock tree (RCC, flash latency) and TIM3 for the host tests
+ *
+ * Implements the RCC and flash functions of the standard peripheral library
+ * used by hw_clk.c on a model of the clock tree: SYSCLK from HSI, HSE or the
+ * PLL, the APB1, APB2 and ADC prescalers, and the flash wait states. HCLK is
+ * always SYSCLK, as in all presets of hw_clk.c.
+ * RCC_GetClocksFreq() derives the bus clocks from the model as the vendor
+ * library derives them from the RCC registers. Oscillators and the PLL are
+ * ready as soon as they are enabled; the HSE can be made to fail.
+ *
+ * Every call checks the sequence rules of the reference manual, and counts
+ * a violation if one is broken:
+ *  - The wait states suffice for SYSCLK (24 MHz per wait state).
+ *  - SYSCLK <= 72 MHz, PCLK1 <= 36 MHz, ADCCLK <= 14 MHz.
+ *  - A SYSCLK source, or the HSE feeding the PLL, is ready when selected and
+ *    not stopped while in use.
+ *  - The PLL is not configured while enabled.
+ *
+ * TIM3 only stores the prescaler and auto-reload values.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include "sim_clk.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Maximum SYSCLK per flash wait state                                */
+#define SIM_CLK_FLASH_WS_HZ           24000000UL
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Clock tree model                                                   */
+typedef struct
+{
+  bool bHseOn;                        /*!< HSE enabled and ready              */
+  bool bHseFail;                      /*!< HSE does not start                 */
+  bool bPllOn;                        /*!< PLL enabled and locked             */
+  uint32_t ulSysclkSource;            /*!< RCC_SYSCLKSource_x                 */
+  uint32_t ulPllSource;               /*!< RCC_PLLSource_x                    */
+  uint32_t ulPllMul;                  /*!< RCC_PLLMul_x                       */
+  uint32_t ulPclk1Div;                /*!< RCC_HCLK_Divx for APB1             */
+  uint32_t ulPclk2Div;                /*!< RCC_HCLK_Divx for APB2             */
+  uint32_t ulAdcDiv;                  /*!< RCC_PCLK2_Divx                     */
+  uint32_t ulLatency;                 /*!< FLASH_Latency_x                    */
+} SimClkTreeTypeDef;
+
+
+/*- Global variables ---------------------------------------------------------*/
+/*! Core clock (HCLK), updated by SystemCoreClockUpdate()                     */
+uint32_t SystemCoreClock = HSI_VALUE;
+
+/*! TIM3 registers                                                            */
+TIM_TypeDef sSimTim3;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Clock tree                                                                */
+static SimClkTreeTypeDef sTree;
+
+/*! Sequence rule violations                                                  */
+static unsigned uViolations;
+
+/*! Description of the first violation                                        */
+static const char* pszViolation = "";
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Count a violation of the sequence rules
+ *
+ * @param[in] *pszRule    Description
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vViolation(const char* pszRule)
+{
+  if (uViolations++ == 0) pszViolation = pszRule;
+}
+
+/*!****************************************************************************
+ * @brief
+ * APB prescaler of a RCC_HCLK_Divx value
+ *
+ * @param[in] ulDiv       RCC_HCLK_Divx
+ * @return  (uint32_t)  Prescaler
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulApbDiv(uint32_t ulDiv)
+{
+  unsigned uCode = (ulDiv >> 8) & 7;
+  return (uCode < 4) ? 1 : 2U << (uCode - 4);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check frequency limits and flash wait states
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vCheckTree(void)
+{
+  RCC_ClocksTypeDef sClocks;
+  RCC_GetClocksFreq(&sClocks);
+  if (sClocks.SYSCLK_Frequency > 72000000) vViolation("SYSCLK above 72 MHz");
+  if (sClocks.SYSCLK_Frequency > SIM_CLK_FLASH_WS_HZ * (sTree.ulLatency + 1)) vViolation("too few flash wait states");
+  if (sClocks.PCLK1_Frequency > 36000000) vViolation("PCLK1 above 36 MHz");
+  if (sClocks.ADCCLK_Frequency > 14000000) vViolation("ADCCLK above 14 MHz");
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check if the PLL runs from the HSE
+ *
+ * @return  (bool)  true, if PLL is enabled with HSE source
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bPllUsesHse(void)
+{
+  return sTree.bPllOn && (sTree.ulPllSource == RCC_PLLSource_HSE_Div1);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Reset clock tree: HSI, no prescaling, zero wait states
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimClkReset(void)
+{
+  sTree = (SimClkTreeTypeDef){
+    .ulSysclkSource = RCC_SYSCLKSource_HSI,
+    .ulPclk1Div = RCC_HCLK_Div1,
+    .ulPclk2Div = RCC_HCLK_Div1,
+    .ulAdcDiv = RCC_PCLK2_Div2,
+    .ulLatency = FLASH_Latency_0
+  };
+  SystemCoreClock = HSI_VALUE;
+  sSimTim3 = (TIM_TypeDef){ 0 };
+  uViolations = 0;
+  pszViolation = "";
+}
+
+/*!****************************************************************************
+ * @brief
+ * Let the HSE fail to start
+ *
+ * @param[in] bFail       true, if RCC_WaitForHSEStartUp() shall time out
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimClkSetHseFail(bool bFail)
+{
+  sTree.bHseFail = bFail;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check if the HSE is running
+ *
+ * @return  (bool)  true, if enabled
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bSimClkHseOn(void)
+{
+  return sTree.bHseOn;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get flash wait states
+ *
+ * @return  (unsigned)  Wait states
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uSimClkLatency(void)
+{
+  return sTree.ulLatency;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get number of sequence rule violations since the last reset
+ *
+ * @return  (unsigned)  Violations
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uSimClkViolations(void)
+{
+  return uViolations;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get description of the first violation
+ *
+ * @return  (const char*)  Description, empty if none
+ * @date  18.10.2026
+ ******************************************************************************/
+const char* pszSimClkViolation(void)
+{
+  return pszViolation;
+}
+
+
+/*- Simulated hardware -------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * RCC and flash functions of the standard peripheral library
+ * @{
+ ******************************************************************************/
+void SystemCoreClockUpdate(void)
+{
+  RCC_ClocksTypeDef sClocks;
+  RCC_GetClocksFreq(&sClocks);
+  SystemCoreClock = sClocks.HCLK_Frequency;
+}
+
+void RCC_GetClocksFreq(RCC_ClocksTypeDef* psClocks)
+{
+  uint32_t ulSysclk = HSI_VALUE;
+  if (sTree.ulSysclkSource == RCC_SYSCLKSource_HSE)
+  {
+    ulSysclk = HSE_VALUE;
+  }
+  else if (sTree.ulSysclkSource == RCC_SYSCLKSource_PLLCLK)
+  {
+    uint32_t ulMul = ((sTree.ulPllMul >> 18) & 0xF) + 2;
+    if (ulMul > 16) ulMul = 16;
+    ulSysclk = ((sTree.ulPllSource == RCC_PLLSource_HSE_Div1) ? HSE_VALUE : HSI_VALUE / 2) * ulMul;
+  }
+  psClocks->SYSCLK_Frequency = ulSysclk;
+  psClocks->HCLK_Frequency = ulSysclk;
+  psClocks->PCLK1_Frequency = psClocks->HCLK_Frequency / ulApbDiv(sTree.ulPclk1Div);
+  psClocks->PCLK2_Frequency = psClocks->HCLK_Frequency / ulApbDiv(sTree.ulPclk2Div);
+  psClocks->ADCCLK_Frequency = psClocks->PCLK2_Frequency / (2 * (((sTree.ulAdcDiv >> 14) & 3) + 1));
+}
+
+void RCC_HSEConfig(uint32_t ulHse)
+{
+  if (ulHse == RCC_HSE_ON)
+  {
+    sTree.bHseOn = sTree.bHseOn || !sTree.bHseFail;
+    return;
+  }
+  if ((sTree.ulSysclkSource == RCC_SYSCLKSource_HSE) || bPllUsesHse()) vViolation("HSE stopped while in use");
+  sTree.bHseOn = false;
+}
+
+ErrorStatus RCC_WaitForHSEStartUp(void)
+{
+  return sTree.bHseOn ? SUCCESS : ERROR;
+}
+
+void RCC_SYSCLKConfig(uint32_t ulSource)
+{
+  if ((ulSource == RCC_SYSCLKSource_HSE) && !sTree.bHseOn) vViolation("HSE selected before ready");
+  if ((ulSource == RCC_SYSCLKSource_PLLCLK) && !sTree.bPllOn) vViolation("PLL selected before locked");
+  sTree.ulSysclkSource = ulSource;
+  vCheckTree();
+}
+
+uint8_t RCC_GetSYSCLKSource(void)
+{
+  return (uint8_t)(sTree.ulSysclkSource << 2);
+}
+
+void RCC_HCLKConfig(uint32_t ulDiv)
+{
+  if (ulDiv != RCC_SYSCLK_Div1) vViolation("AHB prescaler not simulated");
+}
+
+void RCC_PCLK1Config(uint32_t ulDiv)
+{
+  sTree.ulPclk1Div = ulDiv;
+  vCheckTree();
+}
+
+void RCC_PCLK2Config(uint32_t ulDiv)
+{
+  sTree.ulPclk2Div = ulDiv;
+  vCheckTree();
+}
+
+void RCC_ADCCLKConfig(uint32_t ulDiv)
+{
+  sTree.ulAdcDiv = ulDiv;
+  vCheckTree();
+}
+
+void RCC_PLLConfig(uint32_t ulSource, uint32_t ulMul)
+{
+  if (sTree.bPllOn) vViolation("PLL configured while enabled");
+  sTree.ulPllSource = ulSource;
+  sTree.ulPllMul = ulMul;
+}
+
+void RCC_PLLCmd(FunctionalState eState)
+{
+  if (eState == DISABLE)
+  {
+    if (sTree.ulSysclkSource == RCC_SYSCLKSource_PLLCLK) vViolation("PLL stopped while in use");
+    sTree.bPllOn = false;
+    return;
+  }
+  if ((sTree.ulPllSource == RCC_PLLSource_HSE_Div1) && !sTree.bHseOn) vViolation("PLL started without HSE");
+  sTree.bPllOn = true;
+}
+
+FlagStatus RCC_GetFlagStatus(uint8_t ucFlag)
+{
+  return ((ucFlag == RCC_FLAG_PLLRDY) && sTree.bPllOn) ? SET : RESET;
+}
+
+void FLASH_SetLatency(uint32_t ulLatency)
+{
+  sTree.ulLatency = ulLatency;
+  vCheckTree();
+}
+/*! @}                                                                        */
+
+/*!****************************************************************************
+ * @brief
+ * TIM functions of the standard peripheral library
+ * @{
+ ******************************************************************************/
+void TIM_TimeBaseInit(TIM_TypeDef* psTim, const TIM_TimeBaseInitTypeDef* psInit)
+{
+  psTim->PSC = psInit->TIM_Prescaler;
+  psTim->ATRLR = psInit->TIM_Period;
+}
+
+void TIM_OC1Init(TIM_TypeDef* psTim, const TIM_OCInitTypeDef* psInit)
+{
+  psTim->CH1CVR = psInit->TIM_Pulse;
+}
+
+void TIM_CtrlPWMOutputs(TIM_TypeDef* psTim, FunctionalState eState)
+{
+  (void)psTim;
+  (void)eState;
+}
+
+void TIM_OC1PreloadConfig(TIM_TypeDef* psTim, uint16_t uiPreload)
+{
+  (void)psTim;
+  (void)uiPreload;
+}
+
+void TIM_ARRPreloadConfig(TIM_TypeDef* psTim, FunctionalState eState)
+{
+  (void)psTim;
+  (void)eState;
+}
+
+void TIM_Cmd(TIM_TypeDef* psTim, FunctionalState eState)
+{
+  if (eState == ENABLE) psTim->CTLR1 |= 1;
+  else psTim->CTLR1 &= ~1;
+}
+
+void TIM_PrescalerConfig(TIM_TypeDef* psTim, uint16_t uiPrescaler, uint16_t uiMode)
+{
+  (void)uiMode;
+  psTim->PSC = uiPrescaler;
+}
+
+void TIM_ITConfig(TIM_TypeDef* psTim, uint16_t uiIt, FunctionalState eState)
+{
+  if (eState == ENABLE) psTim->DMAINTENR |= uiIt;
+  else psTim->DMAINTENR &= ~uiIt;
+}
+
+void TIM_ClearITPendingBit(TIM_TypeDef* psTim, uint16_t uiIt)
+{
+  psTim->INTFR &= ~uiIt;
+}
+
+ITStatus TIM_GetITStatus(TIM_TypeDef* psTim, uint16_t uiIt)
+{
+  return ((psTim->INTFR & uiIt) && (psTim->DMAINTENR & uiIt)) ? SET : RESET;
+}
+/*! @}                                                                        */
@@ -0,0 +1,28 @@
+/*!****************************************************************************
+ * @file
+ * sim_clk.h
+ *
+ * @brief
+ * Simulated clock tree (RCC, flash latency) and TIM3 for the host tests
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef SIM_CLK_H_
+#define SIM_CLK_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include "ch32v10x.h"
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vSimClkReset(void);
+void vSimClkSetHseFail(bool bFail);
+bool bSimClkHseOn(void);
+unsigned uSimClkLatency(void);
+unsigned uSimClkViolations(void);
+const char* pszSimClkViolation(void);
+
+#endif /* SIM_CLK_H_ */
@@ -0,0 +1,273 @@
+/*!****************************************************************************
+ * @file
+ * sim_flash.c
+ *
+ * @brief
+ * Simulated internal flash for the host tests
+ *
+ * Implements the page erase and program functions of hw_flash.c on a host
+ * array. Flash addresses are passed as uint32_t like on the target, so the
+ * array offset is taken from the low 32 bits of the address.
+ *
+ * A fast page program requires the page to be erased. Programming a page a
+ * second time without an erase in between is counted as a violation, as are
+ * misaligned and out-of-range addresses.
+ *
+ * A power loss can be injected before any flash operation: the operation is
+ * only half done (the first half of the page erased or programmed) and the
+ * simulation longjmp()s to sSimPowerFail. The caller then restarts the module
+ * under test as after a reset.
+ *
+ * A program can also be made to fail without power loss: one bit of the last
+ * page word is stored inverted, and the program reports a verification
+ * failure. This happens once, or on every program of a bad page.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added installer page function and bad page
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <string.h>
+#include "sim_flash.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Number of words in a flash page                                    */
+#define SIM_FLASH_PAGE_WORDS          (HW_FLASH_PAGE_SIZE / sizeof(uint32_t))
+
+
+/*- Global variables ---------------------------------------------------------*/
+/*! Flash contents                                                            */
+_Alignas(HW_FLASH_PAGE_SIZE) uint8_t aucSimFlash[SIM_FLASH_SIZE];
+
+/*! Power loss jump target                                                    */
+jmp_buf sSimPowerFail;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Operations left until power loss, negative if disabled                    */
+static int iOpsLeft = -1;
+
+/*! Programs left until a failed program, negative if disabled                */
+static int iProgramsLeft = -1;
+
+/*! Page index of a page failing every program, negative if disabled          */
+static int iBadPage = -1;
+
+/*! Page programmed since its last erase                                      */
+static bool abProgrammed[SIM_FLASH_NUM_PAGES];
+
+/*! Erase count per page                                                      */
+static unsigned auErases[SIM_FLASH_NUM_PAGES];
+
+/*! Operation counters                                                        */
+static SimFlashStatsTypeDef sStats;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Get page index of a flash address
+ *
+ * @param[in] ulAddress   Page address
+ * @return  (int)  Page index, or -1 if misaligned or out of range
+ * @date  18.10.2026
+ ******************************************************************************/
+static int iGetPage(uint32_t ulAddress)
+{
+  uint32_t ulOffset = ulAddress - (uint32_t)FLASH_BASE;
+  if ((ulOffset >= SIM_FLASH_SIZE) || (ulOffset % HW_FLASH_PAGE_SIZE))
+  {
+    sStats.ulViolations++;
+    return -1;
+  }
+  return ulOffset / HW_FLASH_PAGE_SIZE;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Count down to power loss
+ *
+ * @return  (unsigned)  Number of page words to be processed
+ * @date  18.10.2026
+ ******************************************************************************/
+static unsigned uStartOp(void)
+{
+  if (iOpsLeft < 0) return SIM_FLASH_PAGE_WORDS;
+  if (iOpsLeft-- > 0) return SIM_FLASH_PAGE_WORDS;
+  return SIM_FLASH_PAGE_WORDS / 2;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Complete an operation, or jump to power loss handler
+ *
+ * @param[in] uWords      Return value of uStartOp()
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vEndOp(unsigned uWords)
+{
+  if (uWords < SIM_FLASH_PAGE_WORDS)
+  {
+    iOpsLeft = -1;
+    longjmp(sSimPowerFail, 1);
+  }
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Erase whole flash, reset counters and disable power loss
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimFlashReset(void)
+{
+  uint32_t* pulFlash = (uint32_t*)aucSimFlash;
+  for (unsigned i = 0; i < SIM_FLASH_SIZE / sizeof(uint32_t); ++i) pulFlash[i] = SIM_FLASH_ERASED_WORD;
+  memset(abProgrammed, 0, sizeof(abProgrammed));
+  memset(auErases, 0, sizeof(auErases));
+  memset(&sStats, 0, sizeof(sStats));
+  iOpsLeft = -1;
+  iProgramsLeft = -1;
+  iBadPage = -1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Inject power loss
+ *
+ * @param[in] iOps        Number of flash operations completed before the
+ *                        power loss; negative to disable
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimFlashFailAfter(int iOps)
+{
+  iOpsLeft = iOps;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Inject program failure
+ *
+ * @param[in] iPrograms   Number of programs completed before the failed one;
+ *                        negative to disable
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimFlashCorruptAfter(int iPrograms)
+{
+  iProgramsLeft = iPrograms;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Make every program of a page fail
+ *
+ * @param[in] ulOffset    Page offset from flash base; UINT32_MAX to disable
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimFlashSetBadPage(uint32_t ulOffset)
+{
+  iBadPage = (ulOffset == UINT32_MAX) ? -1 : (int)(ulOffset / HW_FLASH_PAGE_SIZE);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get operation counters
+ *
+ * @param[out] *psStats   Counters
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimFlashGetStats(SimFlashStatsTypeDef* psStats)
+{
+  *psStats = sStats;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get erase count of a page
+ *
+ * @param[in] ulOffset    Page offset from flash base
+ * @return  (unsigned)  Number of erases since vSimFlashReset()
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uSimFlashPageErases(uint32_t ulOffset)
+{
+  return auErases[ulOffset / HW_FLASH_PAGE_SIZE];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Erase page
+ *
+ * @param[in] ulAddress   Page address
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_FlashErasePage(uint32_t ulAddress)
+{
+  int iPage = iGetPage(ulAddress);
+  if (iPage < 0) return;
+
+  unsigned uWords = uStartOp();
+  uint32_t* pulPage = (uint32_t*)&aucSimFlash[iPage * HW_FLASH_PAGE_SIZE];
+  for (unsigned i = 0; i < uWords; ++i) pulPage[i] = SIM_FLASH_ERASED_WORD;
+  abProgrammed[iPage] = (uWords < SIM_FLASH_PAGE_WORDS) ? abProgrammed[iPage] : false;
+  auErases[iPage]++;
+  sStats.ulErases++;
+  vEndOp(uWords);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Program erased page
+ *
+ * @param[in] ulAddress   Page address
+ * @param[in] *pulData    Page data
+ * @return  (bool)  true if the page reads back correctly
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_FlashProgramPage(uint32_t ulAddress, const uint32_t* pulData)
+{
+  int iPage = iGetPage(ulAddress);
+  if (iPage < 0) return false;
+  if (abProgrammed[iPage]) sStats.ulViolations++;
+
+  unsigned uWords = uStartOp();
+  uint32_t* pulPage = (uint32_t*)&aucSimFlash[iPage * HW_FLASH_PAGE_SIZE];
+  memcpy(pulPage, pulData, uWords * sizeof(uint32_t));
+  if (((iProgramsLeft >= 0) && (iProgramsLeft-- == 0)) || (iPage == iBadPage)) pulPage[SIM_FLASH_PAGE_WORDS - 1] ^= 1;
+  abProgrammed[iPage] = true;
+  sStats.ulPrograms++;
+  vEndOp(uWords);
+  return memcmp(pulPage, pulData, HW_FLASH_PAGE_SIZE) == 0;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Erase and program page
+ *
+ * @param[in] ulAddress   Page address
+ * @param[in] *pulData    Page data
+ * @return  (bool)  true if the page reads back correctly
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_FlashWritePage(uint32_t ulAddress, const uint32_t* pulData)
+{
+  vHW_FlashErasePage(ulAddress);
+  return bHW_FlashProgramPage(ulAddress, pulData);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Erase and program page from the installer region
+ *
+ * @param[in] ulAddress   Page address
+ * @param[in] *pulData    Page data
+ * @return  (bool)  true if the page reads back correctly
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_FlashInstallPage(uint32_t ulAddress, const uint32_t* pulData)
+{
+  return bHW_FlashWritePage(ulAddress, pulData);
+}
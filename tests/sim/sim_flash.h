@@ -0,0 +1,54 @@
+/*!****************************************************************************
+ * @file
+ * sim_flash.h
+ *
+ * @brief
+ * Simulated internal flash for the host tests
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added bad page
+ ******************************************************************************/
+
+#ifndef SIM_FLASH_H_
+#define SIM_FLASH_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <setjmp.h>
+#include <stdint.h>
+#include "ch32v10x.h"
+#include "hw_flash.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Word value of erased flash (CH32V103 erase pattern)                */
+#define SIM_FLASH_ERASED_WORD         0xE339E339UL
+
+/*! @brief Number of fast pages                                               */
+#define SIM_FLASH_NUM_PAGES           (SIM_FLASH_SIZE / HW_FLASH_PAGE_SIZE)
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Flash operation counters                                           */
+typedef struct
+{
+  uint32_t ulErases;                  /*!< Page erases                        */
+  uint32_t ulPrograms;                /*!< Page programs                      */
+  uint32_t ulViolations;              /*!< Programs of a page not erased since
+                                           its last program, and misaligned or
+                                           out-of-range addresses             */
+} SimFlashStatsTypeDef;
+
+
+/*- Exported variables -------------------------------------------------------*/
+extern jmp_buf sSimPowerFail;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vSimFlashReset(void);
+void vSimFlashFailAfter(int iOps);
+void vSimFlashCorruptAfter(int iPrograms);
+void vSimFlashSetBadPage(uint32_t ulOffset);
+void vSimFlashGetStats(SimFlashStatsTypeDef* psStats);
+unsigned uSimFlashPageErases(uint32_t ulOffset);
+
+#endif /* SIM_FLASH_H_ */
@@ -0,0 +1,333 @@
+/*!****************************************************************************
+ * @file
+ * sim_i2c.c
+ *
+ * @brief
+ * Simulated 24C64 EEPROMs on I2C2 for the host tests
+ *
+ * Implements the I2C functions of the standard peripheral library used by
+ * eeprom.c on top of a model of up to EEPROM_MAX_DEVICES 24C64 devices:
+ *  - A write transfer sets the internal address counter from two address
+ *    bytes and stores the data bytes within the addressed page; the counter
+ *    rolls over within the page.
+ *  - After the stop condition of a write, the device does not acknowledge
+ *    for SIM_I2C_TWR_US (internal write cycle).
+ *  - A read transfer returns bytes from the internal address counter, which
+ *    is left behind the last byte read (current-address read).
+ *
+ * Time is simulated: SysTick counts microseconds, advanced by one per read of
+ * the counter and by SIM_I2C_BYTE_US per byte on the bus.
+ *
+ * The driver only polls for the address acknowledge in bProbeEeprom(). Any
+ * other transfer to a device which does not acknowledge would hang on the
+ * target, so the simulation aborts the test instead.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hw_stk.h"
+#include "sim_i2c.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Event polls without acknowledge before a transfer is aborted       */
+#define SIM_I2C_MAX_NACK_POLLS        1000
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Transfer phase                                                     */
+typedef enum
+{
+  SIM_I2C_IDLE = 0,                   /*!< No transfer                        */
+  SIM_I2C_START,                      /*!< Start condition sent               */
+  SIM_I2C_NACK,                       /*!< Address not acknowledged           */
+  SIM_I2C_ADDR_HI,                    /*!< Expecting high address byte        */
+  SIM_I2C_ADDR_LO,                    /*!< Expecting low address byte         */
+  SIM_I2C_WRITE,                      /*!< Expecting data bytes               */
+  SIM_I2C_READ                        /*!< Sending data bytes                 */
+} SimI2cPhaseTypeDef;
+
+/*! @brief Device model                                                       */
+typedef struct
+{
+  uint8_t aucMem[EEPROM_SIZE];        /*!< Memory array                       */
+  uint16_t uiCounter;                 /*!< Internal address counter           */
+  uint32_t ulBusyUntil;               /*!< End of write cycle in us           */
+  bool bBusy;                         /*!< Write cycle pending                */
+} SimEepromTypeDef;
+
+
+/*- Global variables ---------------------------------------------------------*/
+/*! I2C2 peripheral                                                           */
+static I2C_TypeDef sI2c2;
+I2C_TypeDef* const I2C2 = &sI2c2;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Device models                                                             */
+static SimEepromTypeDef asDevices[EEPROM_MAX_DEVICES];
+
+/*! Devices present (bit per device index)                                    */
+static uint8_t ucDevPresent;
+
+/*! Current transfer                                                          */
+static SimI2cPhaseTypeDef ePhase;
+static SimEepromTypeDef* psSelected;
+static uint16_t uiPageOffset;
+static unsigned uWritten;
+static unsigned uNackPolls;
+
+/*! Simulated time in us                                                      */
+static uint32_t ulTimeUs;
+
+/*! Bus counters                                                              */
+static SimI2cStatsTypeDef sStats;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Advance simulated time and count one byte on the bus
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBusByte(void)
+{
+  ulTimeUs += SIM_I2C_BYTE_US;
+  sStats.ulBusBytes++;
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Reset bus, device memories (0xFF) and time
+ *
+ * @param[in] ucPresent   Devices present, bit per device index
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimI2cReset(uint8_t ucPresent)
+{
+  memset(asDevices, 0, sizeof(asDevices));
+  for (unsigned i = 0; i < EEPROM_MAX_DEVICES; ++i) memset(asDevices[i].aucMem, 0xFF, EEPROM_SIZE);
+  memset(&sStats, 0, sizeof(sStats));
+  ucDevPresent = ucPresent;
+  ePhase = SIM_I2C_IDLE;
+  psSelected = NULL;
+  ulTimeUs = 0;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get memory array of a device
+ *
+ * @param[in] uDevice     Device index
+ * @return  (uint8_t*)  EEPROM_SIZE bytes
+ * @date  18.10.2026
+ ******************************************************************************/
+uint8_t* pucSimI2cMemory(unsigned uDevice)
+{
+  return asDevices[uDevice].aucMem;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get bus counters
+ *
+ * @param[out] *psStats   Counters
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimI2cGetStats(SimI2cStatsTypeDef* psStats)
+{
+  *psStats = sStats;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get simulated time
+ *
+ * @return  (uint32_t)  Time in us
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulSimTimeUs(void)
+{
+  return ulTimeUs;
+}
+
+/*!****************************************************************************
+ * @brief
+ * SysTick counter (1 count per us), advancing by one count per read
+ *
+ * @return  (uint32_t)  Counter value
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t SysTick_GetValueLow(void)
+{
+  return ulTimeUs++;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Convert milliseconds to SysTick counts
+ *
+ * @param[in] ulMs        Milliseconds
+ * @return  (uint32_t)  SysTick counts
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulHW_STK_MsToTicks(uint32_t ulMs)
+{
+  return ulMs * 1000;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Convert microseconds to SysTick counts
+ *
+ * @param[in] ulUs        Microseconds
+ * @return  (uint32_t)  SysTick counts
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulHW_STK_UsToTicks(uint32_t ulUs)
+{
+  return ulUs;
+}
+
+/*!****************************************************************************
+ * @brief
+ * I2C standard peripheral library functions
+ *  @{
+ ******************************************************************************/
+FlagStatus I2C_GetFlagStatus(I2C_TypeDef* psI2c, uint32_t ulFlag)
+{
+  (void)psI2c;
+  switch (ulFlag)
+  {
+    case I2C_FLAG_AF:   return (ePhase == SIM_I2C_NACK) ? SET : RESET;
+    case I2C_FLAG_RXNE: return (ePhase == SIM_I2C_READ) ? SET : RESET;
+    default:            return RESET;
+  }
+}
+
+void I2C_ClearFlag(I2C_TypeDef* psI2c, uint32_t ulFlag)
+{
+  (void)psI2c;
+  (void)ulFlag;
+}
+
+ErrorStatus I2C_CheckEvent(I2C_TypeDef* psI2c, uint32_t ulEvent)
+{
+  (void)psI2c;
+  if (ePhase == SIM_I2C_NACK)
+  {
+    if (++uNackPolls > SIM_I2C_MAX_NACK_POLLS)
+    {
+      fprintf(stderr, "FATAL: transfer to device not acknowledging (busy=%d)\n",
+        (psSelected != NULL) && psSelected->bBusy);
+      exit(EXIT_FAILURE);
+    }
+    return ERROR;
+  }
+
+  switch (ulEvent)
+  {
+    case I2C_EVENT_MASTER_MODE_SELECT:
+      return (ePhase == SIM_I2C_START) ? SUCCESS : ERROR;
+    case I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED:
+      return (ePhase == SIM_I2C_ADDR_HI) ? SUCCESS : ERROR;
+    case I2C_EVENT_MASTER_RECEIVER_MODE_SELECTED:
+      return (ePhase == SIM_I2C_READ) ? SUCCESS : ERROR;
+    case I2C_EVENT_MASTER_BYTE_TRANSMITTED:
+      return ((ePhase == SIM_I2C_ADDR_LO) || (ePhase == SIM_I2C_WRITE)) ? SUCCESS : ERROR;
+    default:
+      return ERROR;
+  }
+}
+
+void I2C_GenerateSTART(I2C_TypeDef* psI2c, FunctionalState eState)
+{
+  (void)psI2c;
+  if (eState == DISABLE) return;
+  ePhase = SIM_I2C_START;
+  uNackPolls = 0;
+}
+
+void I2C_GenerateSTOP(I2C_TypeDef* psI2c, FunctionalState eState)
+{
+  (void)psI2c;
+  if (eState == DISABLE) return;
+  if ((ePhase == SIM_I2C_WRITE) && (uWritten > 0))
+  {
+    psSelected->ulBusyUntil = ulTimeUs + SIM_I2C_TWR_US;
+    psSelected->bBusy = true;
+    sStats.ulPageWrites++;
+    if (uWritten > (unsigned)(EEPROM_PAGE_SIZE - uiPageOffset)) sStats.ulRollovers++;
+  }
+  ePhase = SIM_I2C_IDLE;
+}
+
+void I2C_AcknowledgeConfig(I2C_TypeDef* psI2c, FunctionalState eState)
+{
+  (void)psI2c;
+  (void)eState;
+}
+
+void I2C_Send7bitAddress(I2C_TypeDef* psI2c, uint8_t ucAddress, uint8_t ucDirection)
+{
+  (void)psI2c;
+  vBusByte();
+  unsigned uDevice = (ucAddress >> 1) & (EEPROM_MAX_DEVICES - 1);
+  psSelected = &asDevices[uDevice];
+  if (psSelected->bBusy && ((int32_t)(ulTimeUs - psSelected->ulBusyUntil) >= 0)) psSelected->bBusy = false;
+
+  if (((ucAddress & 0xF0) != 0xA0) || !(ucDevPresent & (1 << uDevice)) || psSelected->bBusy)
+  {
+    if (psSelected->bBusy) sStats.ulBusyNacks++;
+    ePhase = SIM_I2C_NACK;
+    return;
+  }
+  ePhase = (ucDirection == I2C_Direction_Receiver) ? SIM_I2C_READ : SIM_I2C_ADDR_HI;
+}
+
+void I2C_SendData(I2C_TypeDef* psI2c, uint8_t ucData)
+{
+  (void)psI2c;
+  vBusByte();
+  switch (ePhase)
+  {
+    case SIM_I2C_ADDR_HI:
+      psSelected->uiCounter = (ucData << 8) & (EEPROM_SIZE - 1);
+      ePhase = SIM_I2C_ADDR_LO;
+      break;
+    case SIM_I2C_ADDR_LO:
+      psSelected->uiCounter |= ucData;
+      uiPageOffset = psSelected->uiCounter % EEPROM_PAGE_SIZE;
+      uWritten = 0;
+      ePhase = SIM_I2C_WRITE;
+      break;
+    case SIM_I2C_WRITE:
+    {
+      uint16_t uiPage = psSelected->uiCounter & ~(EEPROM_PAGE_SIZE - 1);
+      psSelected->aucMem[psSelected->uiCounter] = ucData;
+      psSelected->uiCounter = uiPage | ((psSelected->uiCounter + 1) % EEPROM_PAGE_SIZE);
+      uWritten++;
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+uint8_t I2C_ReceiveData(I2C_TypeDef* psI2c)
+{
+  (void)psI2c;
+  vBusByte();
+  if (ePhase != SIM_I2C_READ) return 0xFF;
+  uint8_t ucData = psSelected->aucMem[psSelected->uiCounter];
+  psSelected->uiCounter = (psSelected->uiCounter + 1) % EEPROM_SIZE;
+  return ucData;
+}
+/*! @}                                                                        */
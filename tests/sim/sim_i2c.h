@@ -0,0 +1,46 @@
+/*!****************************************************************************
+ * @file
+ * sim_i2c.h
+ *
+ * @brief
+ * Simulated 24C64 EEPROMs on I2C2 for the host tests
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef SIM_I2C_H_
+#define SIM_I2C_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+#include "ch32v10x.h"
+#include "eeprom.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Bus time per transferred byte in us (9 clocks at 400 kHz)          */
+#define SIM_I2C_BYTE_US               23
+
+/*! @brief Internal write cycle time (tWR) in us                              */
+#define SIM_I2C_TWR_US                5000
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Bus counters                                                       */
+typedef struct
+{
+  uint32_t ulPageWrites;              /*!< Write transfers                    */
+  uint32_t ulBusyNacks;               /*!< Addressing of a device during its
+                                           write cycle                        */
+  uint32_t ulRollovers;               /*!< Writes wrapping within a page      */
+  uint32_t ulBusBytes;                /*!< Bytes transferred on the bus       */
+} SimI2cStatsTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vSimI2cReset(uint8_t ucPresent);
+uint8_t* pucSimI2cMemory(unsigned uDevice);
+void vSimI2cGetStats(SimI2cStatsTypeDef* psStats);
+uint32_t ulSimTimeUs(void);
+
+#endif /* SIM_I2C_H_ */
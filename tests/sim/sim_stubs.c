@@ -0,0 +1,140 @@
+/*!****************************************************************************
+ * @file
+ * sim_stubs.c
+ *
+ * @brief
+ * Host stand-ins for the CRC service and the output multiplexer
+ *
+ * ulCalcCrc32Sw() computes the same CRC-32 as offload.c (CRC unit compatible,
+ * words fed MSB first), bitwise instead of table-driven; ulCalcCrc32() uses it
+ * in place of the CRC unit. uWriteMux() only counts the bytes written per
+ * channel. CRC calculations are counted, e.g. as a measure of flash log page
+ * reads.
+ *
+ * @date  18.10.2026
+ * @date  18.10.2026  Added blocking CRC and mux flush
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <string.h>
+#include "offload.h"
+#include "sim_stubs.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief CRC-32 polynomial                                                  */
+#define SIM_CRC32_POLY                0x04C11DB7UL
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Bytes written per channel                                                 */
+static uint32_t aulMuxBytes[MUX_NUM_CHANNELS];
+
+/*! Number of CRC calculations                                                */
+static uint32_t ulCrcCalls;
+
+
+/*!****************************************************************************
+ * @brief
+ * Software CRC-32 over words, see offload.c
+ *
+ * @param[in] *pvData     Data, length padded with zero bytes to whole words
+ * @param[in] uLen        Length in bytes
+ * @param[in] ulCrc       Initial value or previous result
+ * @return  (uint32_t)  CRC
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulCalcCrc32Sw(const void* pvData, unsigned uLen, uint32_t ulCrc)
+{
+  const uint8_t* pucData = pvData;
+  ulCrcCalls++;
+  for (unsigned i = 0; i < (uLen + 3) / 4 * 4; ++i)
+  {
+    /* Bytes of each word MSB first                       */
+    unsigned uIndex = i - i % 4 + 3 - i % 4;
+    uint8_t ucByte = (uIndex < uLen) ? pucData[uIndex] : 0;
+    ulCrc ^= (uint32_t)ucByte << 24;
+    for (unsigned uBit = 0; uBit < 8; ++uBit)
+    {
+      ulCrc = (ulCrc & 0x80000000UL) ? (ulCrc << 1) ^ SIM_CRC32_POLY : ulCrc << 1;
+    }
+  }
+  return ulCrc;
+}
+
+/*!****************************************************************************
+ * @brief
+ * CRC-32 over words, in place of the CRC unit
+ *
+ * @param[in] *pvData     Data
+ * @param[in] uLen        Length in bytes
+ * @return  (uint32_t)  CRC
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulCalcCrc32(const void* pvData, unsigned uLen)
+{
+  return ulCalcCrc32Sw(pvData, uLen, OFFLOAD_CRC32_INIT);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Count bytes written to a channel
+ *
+ * @param[in] eCh         Channel
+ * @param[in] *pvData     Data
+ * @param[in] uLen        Length in bytes
+ * @return  (unsigned)  uLen
+ * @date  18.10.2026
+ ******************************************************************************/
+unsigned uWriteMux(MuxChannelTypeDef eCh, const void* pvData, unsigned uLen)
+{
+  (void)pvData;
+  aulMuxBytes[eCh] += uLen;
+  return uLen;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Flush channels; nothing is buffered
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vFlushMux(void)
+{
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reset channel byte counters
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimMuxReset(void)
+{
+  memset(aulMuxBytes, 0, sizeof(aulMuxBytes));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get bytes written to a channel
+ *
+ * @param[in] eCh         Channel
+ * @return  (uint32_t)  Bytes since vSimMuxReset()
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulSimMuxBytes(MuxChannelTypeDef eCh)
+{
+  return aulMuxBytes[eCh];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get number of CRC calculations
+ *
+ * @return  (uint32_t)  Calls of ulCalcCrc32Sw() since program start
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulSimCrcCalls(void)
+{
+  return ulCrcCalls;
+}
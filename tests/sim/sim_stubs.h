@@ -0,0 +1,24 @@
+/*!****************************************************************************
+ * @file
+ * sim_stubs.h
+ *
+ * @brief
+ * Host stand-ins for the CRC service and the output multiplexer
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef SIM_STUBS_H_
+#define SIM_STUBS_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+#include "mux.h"
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vSimMuxReset(void);
+uint32_t ulSimMuxBytes(MuxChannelTypeDef eCh);
+uint32_t ulSimCrcCalls(void);
+
+#endif /* SIM_STUBS_H_ */
@@ -0,0 +1,469 @@
+/*!****************************************************************************
+ * @file
+ * sim_usart.c
+ *
+ * @brief
+ * Simulated serial lines on USART1..3 for the host tests
+ *
+ * Implements the USART, DMA and peripheral clock functions of the standard
+ * peripheral library used by hw_usart.c on top of a model of each USART and
+ * its DMA channels:
+ *  - The transmitter shifts out one 10-bit frame (8n1) at a time, at the
+ *    rate PCLK/BRR of the current clock configuration. The data register is
+ *    refilled by the TX DMA channel, or by vHW_USART_IrqHandler() while the
+ *    TXE interrupt is enabled.
+ *  - Each line runs to a peer which echoes every frame back at its own baud
+ *    rate, or at the USART's rate if none is set (plain loopback).
+ *  - Receivers sample each bit in its middle, measured from the start edge
+ *    at their own rate, so a rate mismatch of about 5 % corrupts frames. A
+ *    frame whose start or stop bit is sampled wrong sets the framing error
+ *    flag; a correct frame clears it again, as the driver's status read
+ *    followed by the DMA's data read would.
+ *  - Received frames are written by the circular RX DMA channel, or set RXNE
+ *    (and ORE, if still set).
+ *
+ * Time is simulated in ns and advanced by vSimUsartRun(). Polling a flag or
+ * a TX DMA counter which is not yet done advances it by 1 us, so that the
+ * driver's busy-wait loops terminate.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <string.h>
+#include "hw_clk.h"
+#include "sim_usart.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Bits per frame (start, 8 data, stop)                               */
+#define SIM_USART_FRAME_BITS          10
+
+/*! @brief Smallest valid BRR value (mantissa 1)                              */
+#define SIM_USART_BRR_MIN             16
+
+/*! @brief Circular mode and direction bits of the DMA configuration         */
+#define SIM_DMA_CIRC                  DMA_Mode_Circular
+#define SIM_DMA_DIR                   DMA_DIR_PeripheralDST
+
+/*! @brief Number of simulated instances                                      */
+#define SIM_USART_NUM                 3
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Line model                                                         */
+typedef struct
+{
+  DMA_Channel_TypeDef* psTxDma;       /*!< TX DMA request channel             */
+  DMA_Channel_TypeDef* psRxDma;       /*!< RX DMA request channel             */
+  bool bApb2;                         /*!< Clocked by PCLK2, else PCLK1       */
+  bool bShifting;                     /*!< Frame in the shift register        */
+  uint8_t ucShift;                    /*!< Frame data                         */
+  uint64_t ullFrameEnd;               /*!< End of the frame in ns             */
+  uint32_t ulPeerBaud;                /*!< Peer rate, 0: USART's rate         */
+  SimUsartStatsTypeDef sStats;        /*!< Counters                           */
+} SimLineTypeDef;
+
+
+/*- Global variables ---------------------------------------------------------*/
+/*! USART and DMA registers                                                   */
+USART_TypeDef asSimUsart[SIM_USART_NUM];
+DMA_Channel_TypeDef asSimDma1[7];
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Lines; DMA request mapping of the CH32V103                                */
+static SimLineTypeDef asLines[SIM_USART_NUM] = {
+  { .psTxDma = DMA1_Channel4, .psRxDma = DMA1_Channel5, .bApb2 = true },
+  { .psTxDma = DMA1_Channel7, .psRxDma = DMA1_Channel6 },
+  { .psTxDma = DMA1_Channel2, .psRxDma = DMA1_Channel3 }
+};
+
+/*! Programmed transfer count per DMA channel                                 */
+static uint16_t auiDmaCount[7];
+
+/*! Simulated time in ns                                                      */
+static uint64_t ullTimeNs;
+
+/*! Transmitter update running (the interrupt handler writes data)            */
+static bool bUpdating;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Get instance of a USART
+ *
+ * @param[in] *psUsart    USART
+ * @return  (unsigned)  Instance index
+ * @date  18.10.2026
+ ******************************************************************************/
+static unsigned uInstance(const USART_TypeDef* psUsart)
+{
+  return (unsigned)(psUsart - asSimUsart);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get kernel clock of an instance
+ *
+ * @param[in] uId         Instance
+ * @return  (uint32_t)  PCLK2 for USART1, PCLK1 otherwise
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulPclk(unsigned uId)
+{
+  HwClkFreqTypeDef sFreq;
+  vHW_GetClockFreq(&sFreq);
+  return asLines[uId].bApb2 ? sFreq.ulPclk2 : sFreq.ulPclk1;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get actual baud rate of an instance
+ *
+ * @param[in] uId         Instance
+ * @return  (double)  PCLK/BRR, or 0 if BRR is not a valid divider
+ * @date  18.10.2026
+ ******************************************************************************/
+static double dRate(unsigned uId)
+{
+  uint16_t uiBrr = asSimUsart[uId].BRR;
+  return (uiBrr < SIM_USART_BRR_MIN) ? 0.0 : (double)ulPclk(uId) / uiBrr;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Sample a frame sent at one rate with a receiver at another rate
+ *
+ * @param[in] ucData      Data sent
+ * @param[in] dRatio      Transmitter rate / receiver rate
+ * @param[out] *pucData   Data received
+ * @return  (bool)  true, if start and stop bit were sampled correctly
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bSampleFrame(uint8_t ucData, double dRatio, uint8_t* pucData)
+{
+  /* Start bit, data LSB first, stop bit; idle line high  */
+  unsigned uFrame = (1U << 9) | ((unsigned)ucData << 1);
+  unsigned uSampled = 0;
+  for (unsigned k = 0; k < SIM_USART_FRAME_BITS; ++k)
+  {
+    unsigned uBit = (unsigned)((k + 0.5) * dRatio);
+    /* Beyond the stop bit: start bit of the next frame    */
+    unsigned uLevel = (uBit < SIM_USART_FRAME_BITS) ? (uFrame >> uBit) & 1 : 0;
+    uSampled |= uLevel << k;
+  }
+  *pucData = (uint8_t)(uSampled >> 1);
+  return ((uSampled & 1) == 0) && ((uSampled >> 9) & 1);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Pass a frame through the peer and back to the receiver
+ *
+ * @param[in] uId         Instance
+ * @param[in] ucData      Data sent by the USART
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vDeliver(unsigned uId, uint8_t ucData)
+{
+  SimLineTypeDef* psLine = &asLines[uId];
+  USART_TypeDef* psUsart = &asSimUsart[uId];
+  double dUsart = dRate(uId);
+  double dPeer = (psLine->ulPeerBaud != 0) ? psLine->ulPeerBaud : dUsart;
+  uint8_t ucEcho, ucRx = (uint8_t)~ucData;
+  bool bValid = false;
+  if (dUsart > 0)
+  {
+    bValid = bSampleFrame(ucData, dUsart / dPeer, &ucEcho);
+    bValid = bSampleFrame(ucEcho, dPeer / dUsart, &ucRx) && bValid;
+  }
+
+  if ((psUsart->CTLR1 & (USART_CTLR1_UE | USART_CTLR1_RE)) != (USART_CTLR1_UE | USART_CTLR1_RE)) return;
+  psLine->sStats.ulRxBytes++;
+  if (!bValid || (ucRx != ucData)) psLine->sStats.ulBadBytes++;
+  if (bValid) psUsart->STATR &= ~USART_FLAG_FE;
+  else psUsart->STATR |= USART_FLAG_FE;
+
+  DMA_Channel_TypeDef* psDma = psLine->psRxDma;
+  unsigned uDma = psDma - asSimDma1;
+  if ((psUsart->CTLR3 & USART_DMAReq_Rx) && (psDma->CFGR & DMA_CFGR_EN) && (psDma->CNTR > 0))
+  {
+    *(uint8_t*)(uintptr_t)(psDma->MADDR + auiDmaCount[uDma] - psDma->CNTR) = ucRx;
+    if ((--psDma->CNTR == 0) && (psDma->CFGR & SIM_DMA_CIRC)) psDma->CNTR = auiDmaCount[uDma];
+  }
+  else if (psUsart->STATR & USART_FLAG_RXNE)
+  {
+    psUsart->STATR |= USART_FLAG_ORE;
+    psLine->sStats.ulOverruns++;
+  }
+  else
+  {
+    psUsart->DATAR = ucRx;
+    psUsart->STATR |= USART_FLAG_RXNE;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Refill the data register and start the next frame, at the current time
+ *
+ * @param[in] uId         Instance
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vUpdateTx(unsigned uId)
+{
+  SimLineTypeDef* psLine = &asLines[uId];
+  USART_TypeDef* psUsart = &asSimUsart[uId];
+  DMA_Channel_TypeDef* psDma = psLine->psTxDma;
+  unsigned uDma = psDma - asSimDma1;
+  if (bUpdating || !(psUsart->CTLR1 & USART_CTLR1_UE) || !(psUsart->CTLR1 & USART_CTLR1_TE)) return;
+  bUpdating = true;
+
+  bool bProgress = true;
+  while (bProgress)
+  {
+    bProgress = false;
+    if (psUsart->STATR & USART_FLAG_TXE)
+    {
+      if ((psUsart->CTLR3 & USART_DMAReq_Tx) && (psDma->CFGR & DMA_CFGR_EN) && (psDma->CNTR > 0))
+      {
+        psUsart->DATAR = *(const uint8_t*)(uintptr_t)(psDma->MADDR + auiDmaCount[uDma] - psDma->CNTR);
+        psDma->CNTR--;
+        psUsart->STATR &= ~USART_FLAG_TXE;
+      }
+      else if (psUsart->CTLR1 & USART_CTLR1_TXEIE)
+      {
+        vHW_USART_IrqHandler(uId);
+      }
+    }
+    if (!psLine->bShifting && !(psUsart->STATR & USART_FLAG_TXE))
+    {
+      psLine->ucShift = (uint8_t)psUsart->DATAR;
+      psLine->bShifting = true;
+      psLine->ullFrameEnd = ullTimeNs +
+        (uint64_t)SIM_USART_FRAME_BITS * psUsart->BRR * 1000000000ULL / ulPclk(uId);
+      psUsart->STATR |= USART_FLAG_TXE;
+      psUsart->STATR &= ~USART_FLAG_TC;
+      psLine->sStats.ulTxBytes++;
+      bProgress = true;
+    }
+  }
+  bUpdating = false;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run the transmitter of an instance up to a point in time
+ *
+ * @param[in] uId         Instance
+ * @param[in] ullEnd      End time in ns
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vRunLine(unsigned uId, uint64_t ullEnd)
+{
+  SimLineTypeDef* psLine = &asLines[uId];
+  uint64_t ullStart = ullTimeNs;
+  vUpdateTx(uId);
+  while (psLine->bShifting && (psLine->ullFrameEnd <= ullEnd))
+  {
+    ullTimeNs = psLine->ullFrameEnd;
+    psLine->bShifting = false;
+    if (asSimUsart[uId].STATR & USART_FLAG_TXE) asSimUsart[uId].STATR |= USART_FLAG_TC;
+    vDeliver(uId, psLine->ucShift);
+    vUpdateTx(uId);
+  }
+  ullTimeNs = ullStart;
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Reset registers, lines, counters and time
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimUsartReset(void)
+{
+  memset(asSimUsart, 0, sizeof(asSimUsart));
+  memset(asSimDma1, 0, sizeof(asSimDma1));
+  memset(auiDmaCount, 0, sizeof(auiDmaCount));
+  for (unsigned i = 0; i < SIM_USART_NUM; ++i)
+  {
+    asLines[i].bShifting = false;
+    asLines[i].ulPeerBaud = 0;
+    memset(&asLines[i].sStats, 0, sizeof(asLines[i].sStats));
+  }
+  ullTimeNs = 0;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Set baud rate of the peer echoing the frames of an instance
+ *
+ * @param[in] eId         Instance
+ * @param[in] ulBaud      Baud rate, 0: rate of the USART (loopback)
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimUsartSetPeer(HwUsartTypeDef eId, uint32_t ulBaud)
+{
+  asLines[eId].ulPeerBaud = ulBaud;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Advance simulated time, running all lines
+ *
+ * @param[in] ulUs        Time in us
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimUsartRun(uint32_t ulUs)
+{
+  uint64_t ullEnd = ullTimeNs + (uint64_t)ulUs * 1000;
+  for (unsigned i = 0; i < SIM_USART_NUM; ++i) vRunLine(i, ullEnd);
+  ullTimeNs = ullEnd;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get simulated time
+ *
+ * @return  (uint64_t)  Time in ns
+ * @date  18.10.2026
+ ******************************************************************************/
+uint64_t ullSimUsartTimeNs(void)
+{
+  return ullTimeNs;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get line counters
+ *
+ * @param[in] eId         Instance
+ * @param[out] *psStats   Counters
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimUsartGetStats(HwUsartTypeDef eId, SimUsartStatsTypeDef* psStats)
+{
+  *psStats = asLines[eId].sStats;
+}
+
+/*!****************************************************************************
+ * @brief
+ * RCC, USART and DMA standard peripheral library functions
+ *  @{
+ ******************************************************************************/
+void RCC_AHBPeriphClockCmd(uint32_t ulPeriph, FunctionalState eState)
+{
+  (void)ulPeriph;
+  (void)eState;
+}
+
+void RCC_APB1PeriphClockCmd(uint32_t ulPeriph, FunctionalState eState)
+{
+  (void)ulPeriph;
+  (void)eState;
+}
+
+void RCC_APB2PeriphClockCmd(uint32_t ulPeriph, FunctionalState eState)
+{
+  (void)ulPeriph;
+  (void)eState;
+}
+
+void USART_Init(USART_TypeDef* psUsart, const USART_InitTypeDef* psInit)
+{
+  /* Divider as calculated by the vendor library          */
+  uint32_t ulDiv = 25 * ulPclk(uInstance(psUsart)) / (4 * psInit->USART_BaudRate);
+  uint32_t ulBrr = (ulDiv / 100) << 4;
+  ulBrr |= (((ulDiv - 100 * (ulBrr >> 4)) * 16 + 50) / 100) & 0x0F;
+  psUsart->BRR = (uint16_t)ulBrr;
+  psUsart->CTLR1 = (psUsart->CTLR1 & USART_CTLR1_UE) | psInit->USART_Mode;
+  psUsart->STATR = USART_FLAG_TXE | USART_FLAG_TC;
+}
+
+void USART_Cmd(USART_TypeDef* psUsart, FunctionalState eState)
+{
+  if (eState == ENABLE) psUsart->CTLR1 |= USART_CTLR1_UE;
+  else psUsart->CTLR1 &= ~USART_CTLR1_UE;
+  vUpdateTx(uInstance(psUsart));
+}
+
+void USART_DMACmd(USART_TypeDef* psUsart, uint16_t uiReq, FunctionalState eState)
+{
+  if (eState == ENABLE) psUsart->CTLR3 |= uiReq;
+  else psUsart->CTLR3 &= ~uiReq;
+  vUpdateTx(uInstance(psUsart));
+}
+
+void USART_ITConfig(USART_TypeDef* psUsart, uint16_t uiIt, FunctionalState eState)
+{
+  if (uiIt != USART_IT_TXE) return;
+  if (eState == ENABLE) psUsart->CTLR1 |= USART_CTLR1_TXEIE;
+  else psUsart->CTLR1 &= ~USART_CTLR1_TXEIE;
+  vUpdateTx(uInstance(psUsart));
+}
+
+FlagStatus USART_GetITStatus(USART_TypeDef* psUsart, uint16_t uiIt)
+{
+  return ((uiIt == USART_IT_TXE) && (psUsart->CTLR1 & USART_CTLR1_TXEIE) && (psUsart->STATR & USART_FLAG_TXE))
+    ? SET : RESET;
+}
+
+FlagStatus USART_GetFlagStatus(USART_TypeDef* psUsart, uint16_t uiFlag)
+{
+  if (psUsart->STATR & uiFlag) return SET;
+  vSimUsartRun(1);
+  return RESET;
+}
+
+void USART_SendData(USART_TypeDef* psUsart, uint16_t uiData)
+{
+  psUsart->DATAR = uiData & 0xFF;
+  psUsart->STATR &= ~USART_FLAG_TXE;
+  vUpdateTx(uInstance(psUsart));
+}
+
+void DMA_DeInit(DMA_Channel_TypeDef* psChannel)
+{
+  memset(psChannel, 0, sizeof(*psChannel));
+  auiDmaCount[psChannel - asSimDma1] = 0;
+}
+
+void DMA_Init(DMA_Channel_TypeDef* psChannel, const DMA_InitTypeDef* psInit)
+{
+  psChannel->CFGR = (psChannel->CFGR & DMA_CFGR_EN) | psInit->DMA_DIR | psInit->DMA_Mode |
+    psInit->DMA_PeripheralInc | psInit->DMA_MemoryInc | psInit->DMA_PeripheralDataSize |
+    psInit->DMA_MemoryDataSize | psInit->DMA_Priority | psInit->DMA_M2M;
+  psChannel->CNTR = psInit->DMA_BufferSize;
+  psChannel->PADDR = psInit->DMA_PeripheralBaseAddr;
+  psChannel->MADDR = psInit->DMA_MemoryBaseAddr;
+  auiDmaCount[psChannel - asSimDma1] = (uint16_t)psInit->DMA_BufferSize;
+}
+
+void DMA_Cmd(DMA_Channel_TypeDef* psChannel, FunctionalState eState)
+{
+  if (eState == ENABLE) psChannel->CFGR |= DMA_CFGR_EN;
+  else psChannel->CFGR &= ~DMA_CFGR_EN;
+  for (unsigned i = 0; i < SIM_USART_NUM; ++i)
+  {
+    if (asLines[i].psTxDma == psChannel) vUpdateTx(i);
+  }
+}
+
+uint16_t DMA_GetCurrDataCounter(DMA_Channel_TypeDef* psChannel)
+{
+  uint16_t uiCount = (uint16_t)psChannel->CNTR;
+  if ((uiCount != 0) && (psChannel->CFGR & SIM_DMA_DIR)) vSimUsartRun(1);
+  return uiCount;
+}
+
+void DMA_SetCurrDataCounter(DMA_Channel_TypeDef* psChannel, uint16_t uiCount)
+{
+  psChannel->CNTR = uiCount;
+  auiDmaCount[psChannel - asSimDma1] = uiCount;
+}
+/*! @}                                                                        */
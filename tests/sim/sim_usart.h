@@ -0,0 +1,39 @@
+/*!****************************************************************************
+ * @file
+ * sim_usart.h
+ *
+ * @brief
+ * Simulated serial lines on USART1..3 for the host tests
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef SIM_USART_H_
+#define SIM_USART_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdint.h>
+#include "ch32v10x.h"
+#include "hw_usart.h"
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Line counters per instance                                         */
+typedef struct
+{
+  uint32_t ulTxBytes;                 /*!< Frames sent by the USART           */
+  uint32_t ulRxBytes;                 /*!< Frames received by the USART       */
+  uint32_t ulBadBytes;                /*!< Frames received with wrong data or
+                                           framing error                      */
+  uint32_t ulOverruns;                /*!< Frames lost, receiver not read     */
+} SimUsartStatsTypeDef;
+
+
+/*- Exported functions -------------------------------------------------------*/
+void vSimUsartReset(void);
+void vSimUsartSetPeer(HwUsartTypeDef eId, uint32_t ulBaud);
+void vSimUsartRun(uint32_t ulUs);
+uint64_t ullSimUsartTimeNs(void);
+void vSimUsartGetStats(HwUsartTypeDef eId, SimUsartStatsTypeDef* psStats);
+
+#endif /* SIM_USART_H_ */
@@ -0,0 +1,57 @@
+/*!****************************************************************************
+ * @file
+ * test.h
+ *
+ * @brief
+ * Minimal check macros for the host tests
+ *
+ * A failed check prints its location and counts as a failure; the test
+ * continues, so that all failures of a run are listed. TEST_RESULT() is the
+ * exit status of the test program.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+#ifndef TEST_H_
+#define TEST_H_
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Check condition, with printf-style message on failure              */
+#define TEST_CHECK(cond, ...)                                                  \
+  do                                                                           \
+  {                                                                            \
+    ++ulTestChecks;                                                            \
+    if (!(cond))                                                               \
+    {                                                                          \
+      ++ulTestFailures;                                                        \
+      printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond);          \
+      printf(__VA_ARGS__);                                                     \
+      printf("\n");                                                            \
+    }                                                                          \
+  } while (0)
+
+/*! @brief Run test case                                                      */
+#define TEST_RUN(func)                                                         \
+  do                                                                           \
+  {                                                                            \
+    unsigned long ulFailed = ulTestFailures;                                   \
+    func();                                                                    \
+    printf("%-40s %s\n", #func, (ulTestFailures == ulFailed) ? "ok" : "FAILED"); \
+  } while (0)
+
+/*! @brief Summary and exit status                                            */
+#define TEST_RESULT()                                                          \
+  (printf("%lu checks, %lu failures\n", ulTestChecks, ulTestFailures),         \
+   (ulTestFailures == 0) ? EXIT_SUCCESS : EXIT_FAILURE)
+
+
+/*- Global variables ---------------------------------------------------------*/
+/*! Check and failure counters of the test program                           */
+static unsigned long ulTestChecks, ulTestFailures;
+
+#endif /* TEST_H_ */
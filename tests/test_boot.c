@@ -0,0 +1,455 @@
+/*!****************************************************************************
+ * @file
+ * test_boot.c
+ *
+ * @brief
+ * Host tests of the boot sequencer (boot.c)
+ *
+ * The steps of the test tables record the order in which they are started
+ * and found ready; steps with a ready check report ready after a given number
+ * of checks, standing in for a peripheral power-on delay. The order is
+ * checked against the dependency masks, independent of the table order.
+ *
+ * Covers steps started while others complete in the background, disabled
+ * table entries, dependency cycles and early steps depending on deferred or
+ * unmet steps (not run, reported by vPrintBootInfo()), and the deferred phase
+ * with one step started per bPollBoot() call.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+/* dup2() and fileno() to capture the boot info        */
+#define _POSIX_C_SOURCE 200809L
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include "boot.h"
+#include "hw_stk.h"
+#include "test.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Number of test steps                                               */
+#define TEST_STEPS                    8
+
+/*! @brief Size of the captured boot info                                     */
+#define TEST_INFO_SIZE                2048
+
+/*! @brief Start function and ready check of test step n                      */
+#define TEST_STEP(n)                                                           \
+  static void vStart##n(void) { vStart(n); }                                   \
+  __attribute__((unused)) static bool bIsReady##n(void) { return bIsReady(n); }
+
+/*! @brief Table entry of test step n
+ *  @{                                                                        */
+#define TEST_EARLY(n, deps)           { #n, vStart##n, NULL, (deps), BOOT_PHASE_EARLY }
+#define TEST_EARLY_BG(n, deps)        { #n, vStart##n, bIsReady##n, (deps), BOOT_PHASE_EARLY }
+#define TEST_DEFERRED(n, deps)        { #n, vStart##n, NULL, (deps), BOOT_PHASE_DEFERRED }
+#define TEST_DEFERRED_BG(n, deps)     { #n, vStart##n, bIsReady##n, (deps), BOOT_PHASE_DEFERRED }
+/*! @}                                                                        */
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Simulated SysTick counter                                                 */
+static uint32_t ulTicks;
+
+/*! Event sequence counter                                                    */
+static unsigned uSeq;
+
+/*! Per step: sequence number of the start and of the ready report (0 if not
+ *  yet), start calls, and ready checks to fail before reporting ready        */
+static unsigned auStartSeq[TEST_STEPS], auReadySeq[TEST_STEPS];
+static unsigned auStarts[TEST_STEPS], auReadyDelay[TEST_STEPS];
+
+/*! Captured boot info                                                        */
+static char acInfo[TEST_INFO_SIZE];
+
+
+/*- Simulated hardware -------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Simulated SysTick counter, advanced by one per read
+ *
+ * @return  (uint32_t)  Counter value
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t SysTick_GetValueLow(void)
+{
+  return ++ulTicks;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Convert milliseconds to SysTick counts (1 count per us)
+ *
+ * @param[in] ulMs        Time in ms
+ * @return  (uint32_t)  SysTick counts
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulHW_STK_MsToTicks(uint32_t ulMs)
+{
+  return ulMs * 1000;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Start test step: record the start, and the ready report for steps without
+ * a ready check
+ *
+ * @param[in] uStep       Step index
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vStart(unsigned uStep)
+{
+  ++auStarts[uStep];
+  auStartSeq[uStep] = ++uSeq;
+  if (auReadyDelay[uStep] == 0) auReadySeq[uStep] = auStartSeq[uStep];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Ready check of test step: ready after the configured number of checks
+ *
+ * @param[in] uStep       Step index
+ * @return  (bool)  true if ready
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bIsReady(unsigned uStep)
+{
+  if (auReadyDelay[uStep] > 0)
+  {
+    --auReadyDelay[uStep];
+    return false;
+  }
+  if (auReadySeq[uStep] == 0) auReadySeq[uStep] = ++uSeq;
+  return true;
+}
+
+TEST_STEP(0)
+TEST_STEP(1)
+TEST_STEP(2)
+TEST_STEP(3)
+TEST_STEP(4)
+TEST_STEP(5)
+TEST_STEP(6)
+TEST_STEP(7)
+
+/*!****************************************************************************
+ * @brief
+ * Reset step records and set ready check delays
+ *
+ * @param[in] *puDelays   Ready checks to fail per step, NULL for none
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vSetup(const unsigned* puDelays)
+{
+  uSeq = 0;
+  memset(auStartSeq, 0, sizeof(auStartSeq));
+  memset(auReadySeq, 0, sizeof(auReadySeq));
+  memset(auStarts, 0, sizeof(auStarts));
+  memset(auReadyDelay, 0, sizeof(auReadyDelay));
+  if (puDelays != NULL) memcpy(auReadyDelay, puDelays, sizeof(auReadyDelay));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check that every started step was started once, after all its dependencies
+ * were ready
+ *
+ * @param[in] *psSteps    Step table
+ * @param[in] uNumSteps   Number of table entries
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vCheckDeps(const BootStepTypeDef* psSteps, unsigned uNumSteps)
+{
+  for (unsigned i = 0; i < uNumSteps; ++i)
+  {
+    if ((psSteps[i].pvStart == NULL) || (auStarts[i] == 0)) continue;
+
+    TEST_CHECK(auStarts[i] == 1, "step %u started %u times", i, auStarts[i]);
+    for (unsigned j = 0; j < uNumSteps; ++j)
+    {
+      if (!(psSteps[i].ulDeps & BOOT_DEP(j)) || (psSteps[j].pvStart == NULL)) continue;
+      TEST_CHECK((auReadySeq[j] != 0) && (auReadySeq[j] < auStartSeq[i]),
+        "step %u started at %u, dependency %u ready at %u", i, auStartSeq[i], j, auReadySeq[j]);
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Capture the output of vPrintBootInfo()
+ *
+ * @return  (const char*)  Boot info
+ * @date  18.10.2026
+ ******************************************************************************/
+static const char* pszBootInfo(void)
+{
+  FILE* psFile = tmpfile();
+  int iStdout = dup(STDOUT_FILENO);
+  fflush(stdout);
+  dup2(fileno(psFile), STDOUT_FILENO);
+  vPrintBootInfo();
+  fflush(stdout);
+  dup2(iStdout, STDOUT_FILENO);
+  close(iStdout);
+
+  rewind(psFile);
+  size_t uLen = fread(acInfo, 1, sizeof(acInfo) - 1, psFile);
+  acInfo[uLen] = '\0';
+  fclose(psFile);
+  return acInfo;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Find the line of a step in the boot info
+ *
+ * @param[in] *pszInfo    Boot info
+ * @param[in] uStep       Step index
+ * @return  (const char*)  Step's line, NULL if not found
+ * @date  18.10.2026
+ ******************************************************************************/
+static const char* pszFindStep(const char* pszInfo, unsigned uStep)
+{
+  /* Name column, the times are at most 9 digits wide     */
+  char acName[16];
+  snprintf(acName, sizeof(acName), "%-10u ", uStep);
+  return strstr(pszInfo, acName);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check that the boot info reports a step as not run
+ *
+ * @param[in] *pszInfo    Boot info
+ * @param[in] uStep       Step index
+ * @return  (bool)  true if the step's line reports it as not run
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bReportedNotRun(const char* pszInfo, unsigned uStep)
+{
+  const char* pszLine = pszFindStep(pszInfo, uStep);
+  if (pszLine == NULL) return false;
+
+  const char* pszEnd = strchr(pszLine, '\n');
+  const char* pszNotRun = strstr(pszLine, "not run");
+  return (pszNotRun != NULL) && (pszNotRun < pszEnd);
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Steps listed before their dependencies are started once these are ready;
+ * all early steps are ready when vRunBoot() returns
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestOrder(void)
+{
+  static const BootStepTypeDef asSteps[] = {
+    TEST_EARLY(0, BOOT_DEP(3) | BOOT_DEP(1)),
+    TEST_EARLY(1, BOOT_DEP(2)),
+    TEST_EARLY(2, BOOT_DEP(4)),
+    TEST_EARLY(3, 0),
+    TEST_EARLY(4, BOOT_DEP(3)),
+  };
+  vSetup(NULL);
+  vRunBoot(asSteps, 5);
+  for (unsigned i = 0; i < 5; ++i) TEST_CHECK(auReadySeq[i] != 0, "step %u not ready", i);
+  vCheckDeps(asSteps, 5);
+  TEST_CHECK(!bPollBoot(), "no deferred steps");
+}
+
+/*!****************************************************************************
+ * @brief
+ * Independent steps are started while a step completes in the background,
+ * its dependents only once it reports ready
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestBackground(void)
+{
+  static const BootStepTypeDef asSteps[] = {
+    TEST_EARLY_BG(0, 0),
+    TEST_EARLY(1, BOOT_DEP(0)),
+    TEST_EARLY(2, 0),
+    TEST_EARLY_BG(3, BOOT_DEP(2)),
+    TEST_EARLY(4, BOOT_DEP(3)),
+  };
+  static const unsigned auDelays[TEST_STEPS] = { 20, 0, 0, 3 };
+  vSetup(auDelays);
+  vRunBoot(asSteps, 5);
+  for (unsigned i = 0; i < 5; ++i) TEST_CHECK(auReadySeq[i] != 0, "step %u not ready", i);
+  vCheckDeps(asSteps, 5);
+
+  /* Step 0 takes longest: the chain 2, 3, 4 runs while it
+   * is waiting                                           */
+  for (unsigned i = 2; i < 5; ++i)
+  {
+    TEST_CHECK(auStartSeq[i] < auReadySeq[0], "step %u started at %u, after step 0 ready at %u",
+      i, auStartSeq[i], auReadySeq[0]);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Disabled table entries count as ready and are not reported
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestDisabled(void)
+{
+  static const BootStepTypeDef asSteps[] = {
+    TEST_EARLY(0, 0),
+    { "1", NULL, NULL, BOOT_DEP(0), BOOT_PHASE_EARLY },
+    TEST_EARLY(2, BOOT_DEP(1)),
+  };
+  vSetup(NULL);
+  vRunBoot(asSteps, 3);
+  TEST_CHECK(auStarts[2] == 1, "step 2 depending on a disabled step started %u times", auStarts[2]);
+
+  const char* pszInfo = pszBootInfo();
+  TEST_CHECK(pszFindStep(pszInfo, 1) == NULL, "disabled step reported:\n%s", pszInfo);
+  TEST_CHECK(pszFindStep(pszInfo, 2) != NULL, "step 2 not reported:\n%s", pszInfo);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Steps in a dependency cycle, their dependents and early steps depending on
+ * deferred steps or on steps beyond the table are not run, without holding up
+ * the other steps
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestUnmet(void)
+{
+  static const BootStepTypeDef asSteps[] = {
+    TEST_EARLY(0, BOOT_DEP(1)),
+    TEST_EARLY(1, BOOT_DEP(2)),
+    TEST_EARLY(2, BOOT_DEP(0)),
+    TEST_EARLY(3, BOOT_DEP(2)),
+    TEST_EARLY(4, BOOT_DEP(5)),
+    TEST_DEFERRED(5, 0),
+    TEST_EARLY(6, BOOT_DEP(7)),
+    TEST_EARLY_BG(7, 0),
+  };
+  static const unsigned auDelays[TEST_STEPS] = { [7] = 5 };
+  vSetup(auDelays);
+
+  /* Step 6 depends on step 7, which is beyond the table  */
+  vRunBoot(asSteps, 7);
+  for (unsigned i = 0; i < 7; ++i)
+  {
+    if (i == 5) continue;
+    TEST_CHECK(auStarts[i] == 0, "step %u with unmet dependencies started", i);
+  }
+
+  /* The deferred step still runs                         */
+  unsigned uPolls = 0;
+  while (bPollBoot() && (uPolls < 100)) ++uPolls;
+  TEST_CHECK(auStarts[5] == 1, "deferred step started %u times", auStarts[5]);
+  TEST_CHECK(auStarts[4] == 0, "early step depending on a deferred step started");
+
+  const char* pszInfo = pszBootInfo();
+  for (unsigned i = 0; i < 7; ++i)
+  {
+    if (i == 5) continue;
+    TEST_CHECK(bReportedNotRun(pszInfo, i), "step %u not reported as not run:\n%s", i, pszInfo);
+  }
+  TEST_CHECK(!bReportedNotRun(pszInfo, 5), "deferred step reported as not run:\n%s", pszInfo);
+
+  /* A cycle alongside runnable steps, including one in the
+   * background                                           */
+  static const BootStepTypeDef asMixed[] = {
+    TEST_EARLY(0, BOOT_DEP(1)),
+    TEST_EARLY(1, BOOT_DEP(0)),
+    TEST_EARLY_BG(2, 0),
+    TEST_EARLY(3, BOOT_DEP(2)),
+  };
+  static const unsigned auMixedDelays[TEST_STEPS] = { [2] = 10 };
+  vSetup(auMixedDelays);
+  vRunBoot(asMixed, 4);
+  TEST_CHECK((auStarts[0] == 0) && (auStarts[1] == 0), "steps in a cycle started");
+  TEST_CHECK(auStarts[3] == 1, "step 3 started %u times", auStarts[3]);
+  vCheckDeps(asMixed, 4);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Deferred steps are not started by vRunBoot(), then one per bPollBoot() call;
+ * bPollBoot() returns true until the last one is ready, false from then on
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestDeferred(void)
+{
+  static const BootStepTypeDef asSteps[] = {
+    TEST_DEFERRED(0, BOOT_DEP(1)),
+    TEST_EARLY(1, 0),
+    TEST_DEFERRED(2, 0),
+    TEST_DEFERRED_BG(3, 0),
+    TEST_DEFERRED(4, BOOT_DEP(3)),
+    TEST_DEFERRED(5, BOOT_DEP(6)),
+    TEST_DEFERRED(6, BOOT_DEP(5)),
+  };
+  static const unsigned auDelays[TEST_STEPS] = { [3] = 4 };
+  vSetup(auDelays);
+  vRunBoot(asSteps, 7);
+  TEST_CHECK(auStarts[1] == 1, "early step started %u times", auStarts[1]);
+  for (unsigned i = 0; i < 7; ++i)
+  {
+    if (i == 1) continue;
+    TEST_CHECK(auStarts[i] == 0, "deferred step %u started by vRunBoot()", i);
+  }
+  vMarkBootPrompt();
+
+  unsigned uPolls = 0;
+  unsigned uStarted = 1;
+  bool bPending = true;
+  while (bPending && (uPolls < 100))
+  {
+    bPending = bPollBoot();
+    ++uPolls;
+
+    unsigned uNow = 0;
+    for (unsigned i = 0; i < 7; ++i) uNow += auStarts[i];
+    TEST_CHECK(uNow - uStarted <= 1, "%u steps started by poll %u", uNow - uStarted, uPolls);
+    uStarted = uNow;
+
+    if (bPending) continue;
+    for (unsigned i = 0; i < 5; ++i) TEST_CHECK(auReadySeq[i] != 0, "step %u not ready when done", i);
+  }
+  TEST_CHECK(!bPending, "deferred phase not done after %u polls", uPolls);
+  TEST_CHECK(uPolls >= 5, "deferred phase done after %u polls", uPolls);
+  TEST_CHECK((auStarts[5] == 0) && (auStarts[6] == 0), "deferred steps in a cycle started");
+  vCheckDeps(asSteps, 7);
+  TEST_CHECK(!bPollBoot(), "deferred phase pending again");
+
+  const char* pszInfo = pszBootInfo();
+  TEST_CHECK(strstr(pszInfo, "Deferred phase done") != NULL, "deferred phase not reported:\n%s", pszInfo);
+  TEST_CHECK(bReportedNotRun(pszInfo, 5) && bReportedNotRun(pszInfo, 6),
+    "deferred cycle not reported:\n%s", pszInfo);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Run boot sequencer tests
+ *
+ * @return  (int)  Exit status
+ * @date  18.10.2026
+ ******************************************************************************/
+int main(void)
+{
+  TEST_RUN(vTestOrder);
+  TEST_RUN(vTestBackground);
+  TEST_RUN(vTestDisabled);
+  TEST_RUN(vTestUnmet);
+  TEST_RUN(vTestDeferred);
+  return TEST_RESULT();
+}
@@ -0,0 +1,381 @@
+/*!****************************************************************************
+ * @file
+ * test_clk.c
+ *
+ * @brief
+ * Host tests of the clock tree (hw_clk.c) and the values derived from it
+ *
+ * Covers the bus clocks and flash wait states of every preset, switching
+ * between all pairs of presets on the simulated RCC without breaking its
+ * sequence rules, a failing HSE, detection of the startup configuration, and
+ * the USART baud rate register and TIM3 prescaler, computed and as updated
+ * by their clock change notifiers.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <string.h>
+#include "hw_clk.h"
+#include "hw_irq.h"
+#include "hw_tim3.h"
+#include "hw_usart.h"
+#include "sim_clk.h"
+#include "test.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Number of elements of an array                                     */
+#define TEST_COUNT(a)                 (sizeof(a) / sizeof((a)[0]))
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Expected values of a preset                                        */
+typedef struct
+{
+  HwClkConfigTypeDef eConfig;         /*!< Preset                             */
+  HwClkFreqTypeDef sFreq;             /*!< Bus clocks                         */
+  unsigned uLatency;                  /*!< Flash wait states                  */
+  uint16_t uiTimPsc;                  /*!< TIM3 prescaler register            */
+  bool bHse;                          /*!< HSE running                        */
+} TestPresetTypeDef;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Expected values of all presets (SYSCLK, HCLK, PCLK1, PCLK2, ADCCLK)       */
+static const TestPresetTypeDef asExpected[HW_CLK_NUM_CONFIGS] = {
+  { HW_CLK_HSI_8MHZ,      { 8000000, 8000000, 8000000, 8000000, 4000000 },      0, 79,  false },
+  { HW_CLK_HSE_8MHZ,      { 8000000, 8000000, 8000000, 8000000, 4000000 },      0, 79,  true },
+  { HW_CLK_PLL_HSI_48MHZ, { 48000000, 48000000, 24000000, 48000000, 12000000 }, 1, 479, false },
+  { HW_CLK_PLL_HSE_72MHZ, { 72000000, 72000000, 36000000, 72000000, 12000000 }, 2, 719, true }
+};
+
+/*! Last frequencies passed to the notifier                                   */
+static HwClkFreqTypeDef sNotified;
+
+/*! Notifier calls                                                            */
+static unsigned uNotifications;
+
+
+/*- Simulated interrupt controller -------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Enable or disable interrupt (without effect)
+ *
+ * @param[in] eIrq        Interrupt number
+ * @param[in] eCmd        ENABLE or DISABLE
+ * @return  (bool)  true
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_IrqCmd(IRQn_Type eIrq, FunctionalState eCmd)
+{
+  (void)eIrq;
+  (void)eCmd;
+  return true;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Clock change notifier: record frequencies
+ *
+ * @param[in] *psFreq     New frequencies
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vNotifier(const HwClkFreqTypeDef* psFreq)
+{
+  sNotified = *psFreq;
+  uNotifications++;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Compare bus clock frequencies
+ *
+ * @param[in] *psA        Frequencies
+ * @param[in] *psB        Frequencies
+ * @return  (bool)  true, if equal
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bSameFreq(const HwClkFreqTypeDef* psA, const HwClkFreqTypeDef* psB)
+{
+  return (psA->ulSysclk == psB->ulSysclk) && (psA->ulHclk == psB->ulHclk) && (psA->ulPclk1 == psB->ulPclk1) &&
+    (psA->ulPclk2 == psB->ulPclk2) && (psA->ulAdcclk == psB->ulAdcclk);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reset the simulated clock tree to HSI and re-detect it
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vReset(void)
+{
+  vSimClkReset();
+  vInitHW_CLK();
+  uNotifications = 0;
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Bus clocks and flash wait states of every preset, within the device limits
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestPresets(void)
+{
+  for (unsigned i = 0; i < HW_CLK_NUM_CONFIGS; ++i)
+  {
+    const TestPresetTypeDef* psExp = &asExpected[i];
+    HwClkFreqTypeDef sFreq;
+    memset(&sFreq, 0xFF, sizeof(sFreq));
+    vHW_CalcClockTree(psExp->eConfig, &sFreq);
+    const char* pszName = pszHW_GetClockConfigName(psExp->eConfig);
+
+    TEST_CHECK(bSameFreq(&sFreq, &psExp->sFreq), "%s: SYSCLK %u, HCLK %u, PCLK1 %u, PCLK2 %u, ADCCLK %u", pszName,
+      sFreq.ulSysclk, sFreq.ulHclk, sFreq.ulPclk1, sFreq.ulPclk2, sFreq.ulAdcclk);
+    TEST_CHECK((sFreq.ulSysclk <= 72000000) && (sFreq.ulPclk1 <= 36000000) && (sFreq.ulAdcclk <= 14000000),
+      "%s: clock above device limit", pszName);
+    unsigned uLatency = uHW_CalcFlashLatency(sFreq.ulSysclk);
+    TEST_CHECK(uLatency == psExp->uLatency, "%s: %u wait states, expected %u", pszName, uLatency, psExp->uLatency);
+  }
+  TEST_CHECK(strcmp(pszHW_GetClockConfigName(HW_CLK_NUM_CONFIGS), "SystemInit") == 0, "name of unknown config");
+}
+
+/*!****************************************************************************
+ * @brief
+ * Flash wait states at the limits: 0 up to 24 MHz, 1 up to 48 MHz, else 2
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestFlashLatency(void)
+{
+  static const struct
+  {
+    uint32_t ulSysclk;
+    unsigned uLatency;
+  } asCases[] = {
+    { 0, 0 }, { 8000000, 0 }, { 24000000, 0 }, { 24000001, 1 }, { 36000000, 1 },
+    { 48000000, 1 }, { 48000001, 2 }, { 56000000, 2 }, { 72000000, 2 }
+  };
+  for (unsigned i = 0; i < TEST_COUNT(asCases); ++i)
+  {
+    unsigned uLatency = uHW_CalcFlashLatency(asCases[i].ulSysclk);
+    TEST_CHECK(uLatency == asCases[i].uLatency, "%u Hz: %u wait states, expected %u", asCases[i].ulSysclk, uLatency,
+      asCases[i].uLatency);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Switch between all pairs of presets: RCC sequence, resulting clocks, wait
+ * states, HSE state, notifiers, TIM3 prescaler and USART1 baud rate register
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestSwitch(void)
+{
+  for (unsigned uFrom = 0; uFrom < HW_CLK_NUM_CONFIGS; ++uFrom)
+  {
+    for (unsigned uTo = 0; uTo < HW_CLK_NUM_CONFIGS; ++uTo)
+    {
+      const TestPresetTypeDef* psExp = &asExpected[uTo];
+      vReset();
+      bool bOk = bHW_SetClockConfig(uFrom);
+      uNotifications = 0;
+      bOk = bHW_SetClockConfig(uTo) && bOk;
+      const char* pszFrom = pszHW_GetClockConfigName(uFrom);
+      const char* pszTo = pszHW_GetClockConfigName(uTo);
+
+      HwClkFreqTypeDef sFreq;
+      vHW_GetClockFreq(&sFreq);
+      TEST_CHECK(bOk && (eHW_GetClockConfig() == uTo), "%s -> %s: not active", pszFrom, pszTo);
+      TEST_CHECK(uSimClkViolations() == 0, "%s -> %s: %u violations, first: %s", pszFrom, pszTo, uSimClkViolations(),
+        pszSimClkViolation());
+      TEST_CHECK(bSameFreq(&sFreq, &psExp->sFreq), "%s -> %s: SYSCLK %u, PCLK1 %u, PCLK2 %u, ADCCLK %u", pszFrom, pszTo,
+        sFreq.ulSysclk, sFreq.ulPclk1, sFreq.ulPclk2, sFreq.ulAdcclk);
+      TEST_CHECK(SystemCoreClock == psExp->sFreq.ulHclk, "%s -> %s: SystemCoreClock %u", pszFrom, pszTo,
+        SystemCoreClock);
+      TEST_CHECK(uSimClkLatency() == psExp->uLatency, "%s -> %s: %u wait states", pszFrom, pszTo, uSimClkLatency());
+      TEST_CHECK(bSimClkHseOn() == psExp->bHse, "%s -> %s: HSE %s", pszFrom, pszTo, bSimClkHseOn() ? "on" : "off");
+      TEST_CHECK((uNotifications == 1) && bSameFreq(&sNotified, &psExp->sFreq), "%s -> %s: %u notifications",
+        pszFrom, pszTo, uNotifications);
+
+      /* Dependent modules follow through their notifiers     */
+      TEST_CHECK(TIM3->PSC == psExp->uiTimPsc, "%s -> %s: TIM3 prescaler %u", pszFrom, pszTo, TIM3->PSC);
+      uint16_t uiBrr = uiHW_USART_CalcBrr(psExp->sFreq.ulPclk2, ulHW_USART_GetBaudRate(HW_USART1));
+      TEST_CHECK(USART1->BRR == uiBrr, "%s -> %s: USART1 BRR %u, expected %u", pszFrom, pszTo, USART1->BRR, uiBrr);
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * A failing HSE leaves the configuration unchanged and the HSE stopped
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestHseFail(void)
+{
+  static const HwClkConfigTypeDef aeFrom[] = { HW_CLK_HSI_8MHZ, HW_CLK_PLL_HSI_48MHZ };
+  static const HwClkConfigTypeDef aeTo[] = { HW_CLK_HSE_8MHZ, HW_CLK_PLL_HSE_72MHZ };
+  for (unsigned i = 0; i < TEST_COUNT(aeFrom); ++i)
+  {
+    for (unsigned j = 0; j < TEST_COUNT(aeTo); ++j)
+    {
+      vReset();
+      bHW_SetClockConfig(aeFrom[i]);
+      uNotifications = 0;
+      vSimClkSetHseFail(true);
+      bool bOk = bHW_SetClockConfig(aeTo[j]);
+      const char* pszFrom = pszHW_GetClockConfigName(aeFrom[i]);
+      const char* pszTo = pszHW_GetClockConfigName(aeTo[j]);
+
+      HwClkFreqTypeDef sFreq;
+      vHW_GetClockFreq(&sFreq);
+      TEST_CHECK(!bOk && (eHW_GetClockConfig() == aeFrom[i]), "%s -> %s: config changed", pszFrom, pszTo);
+      TEST_CHECK(bSameFreq(&sFreq, &asExpected[aeFrom[i]].sFreq) && (uNotifications == 0),
+        "%s -> %s: clocks changed", pszFrom, pszTo);
+      TEST_CHECK(!bSimClkHseOn() && (uSimClkViolations() == 0), "%s -> %s: HSE on, %u violations", pszFrom, pszTo,
+        uSimClkViolations());
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Startup configuration: reported as a preset if it matches one, else as
+ * SystemInit
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestStartup(void)
+{
+  vReset();
+  TEST_CHECK(eHW_GetClockConfig() == HW_CLK_HSI_8MHZ, "reset state: config %u", eHW_GetClockConfig());
+
+  /* PLL HSE x9 set up as by SystemInit()                  */
+  vSimClkReset();
+  RCC_HSEConfig(RCC_HSE_ON);
+  FLASH_SetLatency(FLASH_Latency_2);
+  RCC_PCLK1Config(RCC_HCLK_Div2);
+  RCC_ADCCLKConfig(RCC_PCLK2_Div6);
+  RCC_PLLConfig(RCC_PLLSource_HSE_Div1, 7UL << 18);
+  RCC_PLLCmd(ENABLE);
+  RCC_SYSCLKConfig(RCC_SYSCLKSource_PLLCLK);
+  vInitHW_CLK();
+  TEST_CHECK(eHW_GetClockConfig() == HW_CLK_PLL_HSE_72MHZ, "PLL HSE x9: config %u", eHW_GetClockConfig());
+
+  /* PLL HSE x4 = 32 MHz matches no preset                */
+  vSimClkReset();
+  RCC_HSEConfig(RCC_HSE_ON);
+  FLASH_SetLatency(FLASH_Latency_1);
+  RCC_ADCCLKConfig(RCC_PCLK2_Div4);
+  RCC_PLLConfig(RCC_PLLSource_HSE_Div1, 2UL << 18);
+  RCC_PLLCmd(ENABLE);
+  RCC_SYSCLKConfig(RCC_SYSCLKSource_PLLCLK);
+  vInitHW_CLK();
+  HwClkFreqTypeDef sFreq;
+  vHW_GetClockFreq(&sFreq);
+  TEST_CHECK(eHW_GetClockConfig() == HW_CLK_NUM_CONFIGS, "PLL HSE x4: config %u", eHW_GetClockConfig());
+  TEST_CHECK(sFreq.ulSysclk == 32000000, "PLL HSE x4: SYSCLK %u", sFreq.ulSysclk);
+  TEST_CHECK(uSimClkViolations() == 0, "startup sequences: %s", pszSimClkViolation());
+}
+
+/*!****************************************************************************
+ * @brief
+ * USART baud rate register: known values, and the nearest register value for
+ * all preset bus clocks and common rates
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestUsartBrr(void)
+{
+  static const struct
+  {
+    uint32_t ulPclk;
+    uint32_t ulBaud;
+    uint16_t uiBrr;
+  } asKnown[] = {
+    { 72000000, 115200, 625 }, { 36000000, 115200, 313 }, { 24000000, 115200, 208 },
+    { 8000000, 115200, 69 },   { 8000000, 9600, 833 },    { 72000000, 2000000, 36 }
+  };
+  for (unsigned i = 0; i < TEST_COUNT(asKnown); ++i)
+  {
+    uint16_t uiBrr = uiHW_USART_CalcBrr(asKnown[i].ulPclk, asKnown[i].ulBaud);
+    TEST_CHECK(uiBrr == asKnown[i].uiBrr, "%u Hz, %u baud: BRR %u, expected %u", asKnown[i].ulPclk,
+      asKnown[i].ulBaud, uiBrr, asKnown[i].uiBrr);
+  }
+
+  static const uint32_t aulRates[] = { 9600, 19200, 57600, 115200, 230400, 460800, 921600, 2000000 };
+  for (unsigned i = 0; i < HW_CLK_NUM_CONFIGS; ++i)
+  {
+    const uint32_t aulPclk[] = { asExpected[i].sFreq.ulPclk1, asExpected[i].sFreq.ulPclk2 };
+    for (unsigned k = 0; k < TEST_COUNT(aulPclk); ++k)
+    {
+      for (unsigned j = 0; j < TEST_COUNT(aulRates); ++j)
+      {
+        uint32_t ulBrr = uiHW_USART_CalcBrr(aulPclk[k], aulRates[j]);
+        int64_t llDiff = (int64_t)aulPclk[k] - (int64_t)ulBrr * aulRates[j];
+        TEST_CHECK((2 * llDiff <= (int64_t)aulRates[j]) && (-2 * llDiff <= (int64_t)aulRates[j]),
+          "%u Hz, %u baud: BRR %u not nearest", aulPclk[k], aulRates[j], ulBrr);
+      }
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * TIM3 prescaler: exact counter clock for every preset, and the doubled timer
+ * clock for a divided APB1
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestTim3Prescaler(void)
+{
+  for (unsigned i = 0; i < HW_CLK_NUM_CONFIGS; ++i)
+  {
+    const HwClkFreqTypeDef* psFreq = &asExpected[i].sFreq;
+    uint16_t uiPsc = uiHW_TIM3_CalcPrescaler(psFreq);
+    uint32_t ulTimClk = (psFreq->ulPclk1 == psFreq->ulHclk) ? psFreq->ulPclk1 : 2 * psFreq->ulPclk1;
+    TEST_CHECK(uiPsc == asExpected[i].uiTimPsc, "%s: prescaler %u, expected %u",
+      pszHW_GetClockConfigName(asExpected[i].eConfig), uiPsc, asExpected[i].uiTimPsc);
+    TEST_CHECK(ulTimClk % (uiPsc + 1U) == 0 && ulTimClk / (uiPsc + 1U) == HW_TIM3_COUNT_FREQ,
+      "%s: counter clock %u / %u", pszHW_GetClockConfigName(asExpected[i].eConfig), ulTimClk, uiPsc + 1U);
+  }
+
+  /* APB1 prescaler 4: timer clock is 2 x PCLK1            */
+  HwClkFreqTypeDef sFreq = { 72000000, 72000000, 18000000, 72000000, 12000000 };
+  uint16_t uiPsc = uiHW_TIM3_CalcPrescaler(&sFreq);
+  TEST_CHECK(uiPsc == 359, "PCLK1 = HCLK/4: prescaler %u, expected 359", uiPsc);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Run clock tree tests
+ *
+ * @return  (int)  Exit status
+ * @date  18.10.2026
+ ******************************************************************************/
+int main(void)
+{
+  /* Notifiers stay registered for all test cases         */
+  vReset();
+  bHW_RegisterClockNotifier(vNotifier);
+  vInitHW_TIM3();
+  vInitHW_USART();
+
+  TEST_RUN(vTestPresets);
+  TEST_RUN(vTestFlashLatency);
+  TEST_RUN(vTestSwitch);
+  TEST_RUN(vTestHseFail);
+  TEST_RUN(vTestStartup);
+  TEST_RUN(vTestUsartBrr);
+  TEST_RUN(vTestTim3Prescaler);
+  return TEST_RESULT();
+}
@@ -0,0 +1,260 @@
+/*!****************************************************************************
+ * @file
+ * test_crc.c
+ *
+ * @brief
+ * Host tests of the software CRC-32 (ulCalcCrc32Sw() in offload.c)
+ *
+ * The table-driven CRC is compared with a bitwise implementation of the CRC
+ * unit conventions (polynomial 0x04C11DB7, MSB first, little-endian words,
+ * zero-padded partial last word) for all alignments and lengths with 0 to 3
+ * trailing bytes, and for continued calculations.
+ *
+ * Called with --vectors, the test prints data and CRC pairs instead, which
+ * check_crc.py compares with crc32_words() of tools/image_trailer.py.
+ *
+ * The CRC unit and DMA are not simulated; their functions only let offload.c
+ * link.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <string.h>
+#include "ch32v10x.h"
+#include "offload.h"
+#include "test.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief CRC-32 polynomial                                                  */
+#define TEST_CRC32_POLY               0x04C11DB7UL
+
+/*! @brief Test data size                                                     */
+#define TEST_DATA_SIZE                4100
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Test data, word aligned                                                   */
+static uint32_t aulData[TEST_DATA_SIZE / 4 + 1];
+
+
+/*- Simulated hardware -------------------------------------------------------*/
+/*! @brief DMA channels and CRC unit registers                                */
+DMA_Channel_TypeDef asSimDma1[7];
+CRC_TypeDef sSimCrc;
+
+/*!****************************************************************************
+ * @brief
+ * Memory-to-memory DMA and CRC unit functions, without effect
+ * @{
+ ******************************************************************************/
+void DMA_Init(DMA_Channel_TypeDef* psChannel, const DMA_InitTypeDef* psInit)
+{
+  (void)psChannel;
+  (void)psInit;
+}
+
+void DMA_Cmd(DMA_Channel_TypeDef* psChannel, FunctionalState eState)
+{
+  (void)psChannel;
+  (void)eState;
+}
+
+void DMA_ITConfig(DMA_Channel_TypeDef* psChannel, uint32_t ulIt, FunctionalState eState)
+{
+  (void)psChannel;
+  (void)ulIt;
+  (void)eState;
+}
+
+ITStatus DMA_GetITStatus(uint32_t ulIt)
+{
+  (void)ulIt;
+  return RESET;
+}
+
+void DMA_ClearITPendingBit(uint32_t ulIt)
+{
+  (void)ulIt;
+}
+
+void CRC_ResetDR(void)
+{
+  sSimCrc.DATAR = OFFLOAD_CRC32_INIT;
+}
+/*! @}                                                                        */
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Bitwise CRC-32 as calculated by the CRC unit
+ *
+ * @param[in] *pucData    Data
+ * @param[in] uLen        Data length in bytes
+ * @param[in] ulCrc       Initial CRC value
+ * @return  (uint32_t)  CRC-32 value
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulCrc32Bitwise(const uint8_t* pucData, unsigned uLen, uint32_t ulCrc)
+{
+  for (unsigned uOfs = 0; uOfs < uLen; uOfs += 4)
+  {
+    /* Little-endian word, zero-padded                    */
+    uint32_t ulWord = 0;
+    for (unsigned k = 0; (k < 4) && (uOfs + k < uLen); ++k) ulWord |= (uint32_t)pucData[uOfs + k] << (8 * k);
+
+    ulCrc ^= ulWord;
+    for (unsigned uBit = 0; uBit < 32; ++uBit)
+    {
+      ulCrc = (ulCrc & 0x80000000UL) ? (ulCrc << 1) ^ TEST_CRC32_POLY : ulCrc << 1;
+    }
+  }
+  return ulCrc;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fill test data with a pseudo-random sequence
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vFillData(void)
+{
+  uint32_t ulSeed = 0x12345678UL;
+  uint8_t* pucData = (uint8_t*)aulData;
+  for (unsigned i = 0; i < sizeof(aulData); ++i)
+  {
+    ulSeed = ulSeed * 1103515245UL + 12345;
+    pucData[i] = (uint8_t)(ulSeed >> 16);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Print test vectors: one line per block with the data in hex and the CRC
+ *
+ * @return  (int)  Exit status
+ * @date  18.10.2026
+ ******************************************************************************/
+static int iPrintVectors(void)
+{
+  static const unsigned auLengths[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 15, 16, 17, 63, 64, 65, 66, 67, 1021, 4096 };
+  const uint8_t* pucData = (const uint8_t*)aulData;
+  for (unsigned uOfs = 0; uOfs < 4; ++uOfs)
+  {
+    for (unsigned k = 0; k < sizeof(auLengths) / sizeof(auLengths[0]); ++k)
+    {
+      for (unsigned i = 0; i < auLengths[k]; ++i) printf("%02x", pucData[uOfs + i]);
+      printf(" %08x\n", ulCalcCrc32Sw(&pucData[uOfs], auLengths[k], OFFLOAD_CRC32_INIT));
+    }
+  }
+  return 0;
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Known values: the CRC unit result for the word 0x12345678, and the initial
+ * value for no data
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestKnown(void)
+{
+  static const uint8_t aucWord[] = { 0x78, 0x56, 0x34, 0x12 };
+  uint32_t ulCrc = ulCalcCrc32Sw(aucWord, sizeof(aucWord), OFFLOAD_CRC32_INIT);
+  TEST_CHECK(ulCrc == 0xDF8A8A2BUL, "CRC of 0x12345678: %08x", ulCrc);
+  ulCrc = ulCalcCrc32Sw(aucWord, 0, OFFLOAD_CRC32_INIT);
+  TEST_CHECK(ulCrc == OFFLOAD_CRC32_INIT, "CRC of no data: %08x", ulCrc);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Table-driven and bitwise CRC agree for all alignments and lengths
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestBitwise(void)
+{
+  const uint8_t* pucData = (const uint8_t*)aulData;
+  for (unsigned uOfs = 0; uOfs < 4; ++uOfs)
+  {
+    for (unsigned uLen = 0; uLen <= TEST_DATA_SIZE - 4; uLen += (uLen < 256) ? 1 : 253)
+    {
+      uint32_t ulCrc = ulCalcCrc32Sw(&pucData[uOfs], uLen, OFFLOAD_CRC32_INIT);
+      uint32_t ulRef = ulCrc32Bitwise(&pucData[uOfs], uLen, OFFLOAD_CRC32_INIT);
+      TEST_CHECK(ulCrc == ulRef, "offset %u, %u bytes: %08x, expected %08x", uOfs, uLen, ulCrc, ulRef);
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * A partial last word equals the zero-padded word, and bytes beyond the
+ * length are not read
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestTail(void)
+{
+  for (unsigned uTail = 1; uTail < 4; ++uTail)
+  {
+    uint8_t aucPadded[12] = { 0 };
+    uint8_t aucDirty[12];
+    memcpy(aucPadded, aulData, 8 + uTail);
+    memset(aucDirty, 0xA5, sizeof(aucDirty));
+    memcpy(aucDirty, aulData, 8 + uTail);
+
+    uint32_t ulCrc = ulCalcCrc32Sw(aucDirty, 8 + uTail, OFFLOAD_CRC32_INIT);
+    uint32_t ulPadded = ulCalcCrc32Sw(aucPadded, sizeof(aucPadded), OFFLOAD_CRC32_INIT);
+    TEST_CHECK(ulCrc == ulPadded, "%u tail bytes: %08x, padded %08x", uTail, ulCrc, ulPadded);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Continuing after blocks with a length divisible by four gives the CRC of
+ * the whole data, whatever the length of the last block
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestContinue(void)
+{
+  const uint8_t* pucData = (const uint8_t*)aulData;
+  for (unsigned uLen = 1; uLen <= 64; ++uLen)
+  {
+    uint32_t ulWhole = ulCalcCrc32Sw(pucData, uLen, OFFLOAD_CRC32_INIT);
+    for (unsigned uSplit = 0; uSplit <= uLen; uSplit += 4)
+    {
+      uint32_t ulCrc = ulCalcCrc32Sw(pucData, uSplit, OFFLOAD_CRC32_INIT);
+      ulCrc = ulCalcCrc32Sw(&pucData[uSplit], uLen - uSplit, ulCrc);
+      TEST_CHECK(ulCrc == ulWhole, "%u bytes split at %u: %08x, expected %08x", uLen, uSplit, ulCrc, ulWhole);
+    }
+  }
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Run CRC tests, or print test vectors
+ *
+ * @param[in] argc        Argument count
+ * @param[in] *argv[]     Arguments: --vectors to print test vectors
+ * @return  (int)  Exit status
+ * @date  18.10.2026
+ ******************************************************************************/
+int main(int argc, char* argv[])
+{
+  vFillData();
+  if ((argc > 1) && (strcmp(argv[1], "--vectors") == 0)) return iPrintVectors();
+
+  TEST_RUN(vTestKnown);
+  TEST_RUN(vTestBitwise);
+  TEST_RUN(vTestTail);
+  TEST_RUN(vTestContinue);
+  return TEST_RESULT();
+}
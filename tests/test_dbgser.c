@@ -0,0 +1,342 @@
+/*!****************************************************************************
+ * @file
+ * test_dbgser.c
+ *
+ * @brief
+ * Host tests of the scatter-gather message queue of the debug serial port
+ * (dbgser.c) on a simulated serial line
+ *
+ * The port runs at 115200 baud on the simulated clock tree at 72 MHz, with a
+ * loopback peer. Built for USART1, messages are sent by the DMA transmitter;
+ * built with DBGSER_USART = HW_USART3 and TEST_TX_IRQ, by the interrupt
+ * transmitter.
+ *
+ * Covers message and segment order, release callbacks (order, timing, and
+ * queueing from the callback), the queue limits and statistics, output of
+ * the single-character functions after queued messages, and back-to-back
+ * transmission of short segments.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <string.h>
+#include "dbgser.h"
+#include "hw_clk.h"
+#include "hw_usart.h"
+#include "sim_clk.h"
+#include "sim_usart.h"
+#include "test.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Simulation step of the polling loop in us                          */
+#define TEST_STEP_US                  5
+
+/*! @brief Receive buffer size                                                */
+#define TEST_RX_SIZE                  4096
+
+/*! @brief Maximum number of recorded releases                                */
+#define TEST_MAX_RELEASES             64
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Data received from the loopback                                           */
+static uint8_t aucRx[TEST_RX_SIZE];
+static unsigned uRxLen;
+
+/*! Time of the last reception in ns                                          */
+static uint64_t ullLastRxNs;
+
+/*! Contexts of the release callbacks in call order                           */
+static unsigned auReleased[TEST_MAX_RELEASES];
+static unsigned uNumReleased;
+
+/*! Segment buffers, overwritten on release                                   */
+static uint8_t aaucBuf[8][64];
+
+/*! Messages still to be queued by the release callback                       */
+static unsigned uChainLeft;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Reset baud rate, records and buffers. The line is idle after each test case.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vSetup(void)
+{
+  vHW_USART_SetBaudRate(DBGSER_USART, HW_USART_BAUD_RATE);
+  uRxLen = 0;
+  uNumReleased = 0;
+  for (unsigned i = 0; i < 8; ++i)
+  {
+    for (unsigned j = 0; j < sizeof(aaucBuf[i]); ++j) aaucBuf[i][j] = (uint8_t)('A' + i * 3 + j % 7);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run the line and the message queue, and collect received data
+ *
+ * @param[in] ulUs        Time to run in us
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vRun(uint32_t ulUs)
+{
+  for (uint32_t t = 0; t < ulUs; t += TEST_STEP_US)
+  {
+    vPollDbgSer();
+    vSimUsartRun(TEST_STEP_US);
+    unsigned uLen = uReadDbgSer(&aucRx[uRxLen], TEST_RX_SIZE - uRxLen);
+    if (uLen > 0) ullLastRxNs = ullSimUsartTimeNs();
+    uRxLen += uLen;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run until the queue and the transmitter are idle and the last byte is back
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vRunIdle(void)
+{
+  uint64_t ullStart = ullSimUsartTimeNs();
+  unsigned uIdle = 0;
+  while ((uIdle < 1000 / TEST_STEP_US) && (ullSimUsartTimeNs() - ullStart < 2000000000ULL))
+  {
+    unsigned uLen = uRxLen;
+    vRun(TEST_STEP_US);
+    uIdle = (bIsDbgSerTxBusy() || (uRxLen != uLen)) ? 0 : uIdle + 1;
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Release callback: record the message and overwrite its buffer
+ *
+ * @param[in] *pvContext  Buffer index
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vRelease(void* pvContext)
+{
+  unsigned uIndex = (unsigned)(uintptr_t)pvContext;
+  if (uNumReleased < TEST_MAX_RELEASES) auReleased[uNumReleased++] = uIndex;
+  memset(aaucBuf[uIndex], 0xEE, sizeof(aaucBuf[uIndex]));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Release callback which queues the next message of a chain
+ *
+ * @param[in] *pvContext  Buffer index
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vReleaseChain(void* pvContext)
+{
+  vRelease(pvContext);
+  if (uChainLeft == 0) return;
+  unsigned uNext = (unsigned)(uintptr_t)pvContext + 1;
+  const DbgSerSegTypeDef asSegs[] = { { aaucBuf[uNext], 5 }, { aaucBuf[uNext] + 10, 3 } };
+  uChainLeft--;
+  TEST_CHECK(bWriteVDbgSer(asSegs, 2, vReleaseChain, (void*)(uintptr_t)uNext), "chain message not queued");
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Messages arrive in order with their segments back to back; releases come
+ * in order, after the transmitter has read the buffers
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestOrder(void)
+{
+  vSetup();
+  uint8_t aucExpected[256];
+  unsigned uExpLen = 0;
+  for (unsigned i = 0; i < DBGSER_MSG_QUEUE_LEN; ++i)
+  {
+    /* Segments of different length, one empty            */
+    const DbgSerSegTypeDef asSegs[DBGSER_MAX_SEGMENTS] = {
+      { aaucBuf[i], 3 + i }, { aaucBuf[i] + 20, 0 }, { aaucBuf[i] + 30, 17 }, { aaucBuf[i] + 1, 1 }
+    };
+    for (unsigned k = 0; k < DBGSER_MAX_SEGMENTS; ++k)
+    {
+      memcpy(&aucExpected[uExpLen], asSegs[k].pvData, asSegs[k].uLen);
+      uExpLen += asSegs[k].uLen;
+    }
+    TEST_CHECK(bWriteVDbgSer(asSegs, DBGSER_MAX_SEGMENTS, vRelease, (void*)(uintptr_t)i), "message %u not queued", i);
+  }
+  vRunIdle();
+
+  TEST_CHECK((uRxLen == uExpLen) && (memcmp(aucRx, aucExpected, uExpLen) == 0), "%u of %u bytes, data %s", uRxLen,
+    uExpLen, memcmp(aucRx, aucExpected, uExpLen) ? "differs" : "ok");
+  TEST_CHECK(uNumReleased == DBGSER_MSG_QUEUE_LEN, "%u releases", uNumReleased);
+  for (unsigned i = 0; i < uNumReleased; ++i)
+  {
+    TEST_CHECK(auReleased[i] == i, "release %u: message %u", i, auReleased[i]);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * A release callback may queue the next message
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestChain(void)
+{
+  vSetup();
+  uint8_t aucExpected[64];
+  unsigned uExpLen = 0;
+  for (unsigned i = 0; i < 8; ++i)
+  {
+    memcpy(&aucExpected[uExpLen], aaucBuf[i], 5);
+    memcpy(&aucExpected[uExpLen + 5], aaucBuf[i] + 10, 3);
+    uExpLen += 8;
+  }
+  uChainLeft = 7;
+  const DbgSerSegTypeDef asSegs[] = { { aaucBuf[0], 5 }, { aaucBuf[0] + 10, 3 } };
+  TEST_CHECK(bWriteVDbgSer(asSegs, 2, vReleaseChain, (void*)(uintptr_t)0), "first message not queued");
+  vRunIdle();
+
+  TEST_CHECK((uRxLen == uExpLen) && (memcmp(aucRx, aucExpected, uExpLen) == 0), "%u of %u bytes, data %s", uRxLen,
+    uExpLen, memcmp(aucRx, aucExpected, uExpLen) ? "differs" : "ok");
+  TEST_CHECK((uNumReleased == 8) && (uChainLeft == 0), "%u releases, %u left", uNumReleased, uChainLeft);
+  for (unsigned i = 0; i < uNumReleased; ++i)
+  {
+    TEST_CHECK(auReleased[i] == i, "release %u: message %u", i, auReleased[i]);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Queue limits: full queue and too many segments are rejected, statistics
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestLimits(void)
+{
+  vSetup();
+  DbgSerStatsTypeDef sBefore, sStats;
+  vGetDbgSerStats(&sBefore);
+
+  const DbgSerSegTypeDef asSegs[DBGSER_MAX_SEGMENTS + 1] = {
+    { aaucBuf[0], 10 }, { aaucBuf[1], 0 }, { aaucBuf[2], 10 }, { aaucBuf[3], 10 }, { aaucBuf[4], 10 }
+  };
+  TEST_CHECK(!bWriteVDbgSer(asSegs, DBGSER_MAX_SEGMENTS + 1, vRelease, NULL), "too many segments queued");
+
+  /* The line does not run: the first message stays in
+   * the transmitter, so the queue fills up               */
+  unsigned uQueued = 0;
+  while ((uQueued <= DBGSER_MSG_QUEUE_LEN) && bWriteVDbgSer(asSegs, DBGSER_MAX_SEGMENTS, vRelease,
+    (void*)(uintptr_t)uQueued))
+  {
+    uQueued++;
+  }
+  TEST_CHECK(uQueued == DBGSER_MSG_QUEUE_LEN, "%u messages queued", uQueued);
+  TEST_CHECK(!bWriteVDbgSer(asSegs, 1, NULL, NULL), "message queued in full queue");
+
+  vGetDbgSerStats(&sStats);
+  TEST_CHECK(sStats.ulMessages - sBefore.ulMessages == DBGSER_MSG_QUEUE_LEN, "%u messages counted",
+    sStats.ulMessages - sBefore.ulMessages);
+  TEST_CHECK(sStats.ulSegments - sBefore.ulSegments == 3 * DBGSER_MSG_QUEUE_LEN, "%u segments counted",
+    sStats.ulSegments - sBefore.ulSegments);
+  TEST_CHECK(sStats.ulBytes - sBefore.ulBytes == 30 * DBGSER_MSG_QUEUE_LEN, "%u bytes counted",
+    sStats.ulBytes - sBefore.ulBytes);
+  TEST_CHECK(sStats.ulQueueFull - sBefore.ulQueueFull == 2, "%u full queue rejections",
+    sStats.ulQueueFull - sBefore.ulQueueFull);
+  TEST_CHECK(sStats.uPeak == DBGSER_MSG_QUEUE_LEN, "peak %u", sStats.uPeak);
+
+  vRunIdle();
+  TEST_CHECK((uRxLen == 30 * DBGSER_MSG_QUEUE_LEN) && (uNumReleased == DBGSER_MSG_QUEUE_LEN),
+    "%u bytes received, %u releases", uRxLen, uNumReleased);
+}
+
+#ifndef TEST_TX_IRQ
+/*!****************************************************************************
+ * @brief
+ * Single characters and blocking writes follow the queued messages
+ *
+ * @note
+ * The blocking functions wait for the interrupt transmitter without calling
+ * the simulation, so they are only tested with the DMA transmitter.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestMixed(void)
+{
+  vSetup();
+  const DbgSerSegTypeDef asSegs[] = { { "queued ", 7 }, { "message", 7 } };
+  TEST_CHECK(bWriteVDbgSer(asSegs, 2, NULL, NULL), "message not queued");
+  vPutCharDbgSer('|');
+  vWriteDbgSer((const unsigned char*)"block", 5);
+  vPrintDbgSer("|end");
+  vRunIdle();
+
+  static const char szExpected[] = "queued message|block|end";
+  TEST_CHECK((uRxLen == sizeof(szExpected) - 1) && (memcmp(aucRx, szExpected, uRxLen) == 0), "received \"%.*s\"",
+    (int)uRxLen, aucRx);
+}
+#endif /* TEST_TX_IRQ */
+
+/*!****************************************************************************
+ * @brief
+ * Short segments are sent back to back at the full line rate
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestBackToBack(void)
+{
+  vSetup();
+  uint64_t ullStart = ullSimUsartTimeNs();
+  unsigned uSent = 0;
+  for (unsigned i = 0; i < 64; ++i)
+  {
+    const DbgSerSegTypeDef asSegs[] = { { aaucBuf[i % 8], 2 }, { aaucBuf[i % 8] + 2, 1 }, { aaucBuf[i % 8] + 3, 5 } };
+    while (!bWriteVDbgSer(asSegs, 3, NULL, NULL)) vRun(TEST_STEP_US);
+    uSent += 8;
+  }
+  vRunIdle();
+  uint64_t ullNs = ullLastRxNs - ullStart;
+
+  uint32_t ulPclk = ulHW_USART_GetPclk(DBGSER_USART);
+  uint32_t ulLineRate = ulPclk / uiHW_USART_CalcBrr(ulPclk, HW_USART_BAUD_RATE) / 10;
+  uint32_t ulRate = (uint32_t)((uint64_t)uRxLen * 1000000000ULL / (ullNs + 1));
+  TEST_CHECK(uRxLen == uSent, "%u of %u bytes", uRxLen, uSent);
+  TEST_CHECK(ulRate * 100 >= ulLineRate * 97, "%u bytes/s of %u", ulRate, ulLineRate);
+  printf("  %s: %u bytes in segments of 1 to 5 bytes, %u bytes/s (%u %% of line rate)\n",
+    pszHW_USART_GetName(DBGSER_USART), uRxLen, ulRate, (unsigned)((uint64_t)ulRate * 100 / ulLineRate));
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Run debug serial port tests
+ *
+ * @return  (int)  Exit status
+ * @date  18.10.2026
+ ******************************************************************************/
+int main(void)
+{
+  vSimClkReset();
+  vInitHW_CLK();
+  bHW_SetClockConfig(HW_CLK_PLL_HSE_72MHZ);
+  vSimUsartReset();
+  vInitHW_USART();
+
+  TEST_RUN(vTestOrder);
+  TEST_RUN(vTestChain);
+  TEST_RUN(vTestLimits);
+#ifndef TEST_TX_IRQ
+  TEST_RUN(vTestMixed);
+#endif /* TEST_TX_IRQ */
+  TEST_RUN(vTestBackToBack);
+  return TEST_RESULT();
+}
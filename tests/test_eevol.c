@@ -0,0 +1,408 @@
+/*!****************************************************************************
+ * @file
+ * test_eevol.c
+ *
+ * @brief
+ * Host tests of the striped EEPROM volume (eevol.c, eeprom.c) on simulated
+ * 24C64 devices
+ *
+ * Covers device probing, the stripe mapping for different device sets, the
+ * separation of volume and system area, write cycle handling per device, and
+ * the use of current-address reads by the stream reader, after writes and
+ * over a whole device.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <string.h>
+#include "eeprom.h"
+#include "eeprom_layout.h"
+#include "eevol.h"
+#include "sim_i2c.h"
+#include "test.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Largest volume (all devices present)                               */
+#define TEST_MAX_VOLUME               (EEPROM_MAX_DEVICES * EEPROM_VOLUME_DEV_SIZE)
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Device sets: one device, two non-adjacent devices, three devices, all     */
+static const uint8_t aucDeviceSets[] = { 0x01, 0x24, 0x83, 0xFF };
+
+/*! Write and read buffers                                                    */
+static uint8_t aucPattern[TEST_MAX_VOLUME], aucRead[TEST_MAX_VOLUME];
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Reset simulated bus and detect devices
+ *
+ * @param[in] ucPresent   Devices present, bit per device index
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vSetup(uint8_t ucPresent)
+{
+  vSimI2cReset(ucPresent);
+  vInitEepromVolume();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get device and device address of a volume address by the documented
+ * mapping: volume stripe n is stored on member n % N at stripe n / N
+ *
+ * @param[in] ucPresent   Devices present
+ * @param[in] uDevBase    Device address of the area
+ * @param[in] uAddress    Address within the area
+ * @param[out] *puDevAddr Device address
+ * @return  (unsigned)  Device index
+ * @date  18.10.2026
+ ******************************************************************************/
+static unsigned uMapAddress(uint8_t ucPresent, unsigned uDevBase, unsigned uAddress, unsigned* puDevAddr)
+{
+  unsigned auMembers[EEPROM_MAX_DEVICES];
+  unsigned uMembers = 0;
+  for (unsigned i = 0; i < EEPROM_MAX_DEVICES; ++i)
+  {
+    if (ucPresent & (1 << i)) auMembers[uMembers++] = i;
+  }
+  unsigned uStripe = uAddress / EEVOL_STRIPE_SIZE;
+  *puDevAddr = uDevBase + (uStripe / uMembers) * EEVOL_STRIPE_SIZE + uAddress % EEVOL_STRIPE_SIZE;
+  return auMembers[uStripe % uMembers];
+}
+
+/*!****************************************************************************
+ * @brief
+ * Fill pattern buffer
+ *
+ * @param[in] ulSeed      Pattern seed
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vFillPattern(uint32_t ulSeed)
+{
+  for (unsigned i = 0; i < sizeof(aucPattern); ++i)
+  {
+    ulSeed = ulSeed * 1103515245UL + 12345;
+    aucPattern[i] = (uint8_t)(ulSeed >> 16);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get number of devices accessed during their write cycle
+ *
+ * @return  (uint32_t)  Count since the last vSimI2cReset()
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulBusyNacks(void)
+{
+  SimI2cStatsTypeDef sStats;
+  vSimI2cGetStats(&sStats);
+  return sStats.ulBusyNacks;
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Probing and area sizes
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestProbe(void)
+{
+  for (unsigned k = 0; k < sizeof(aucDeviceSets); ++k)
+  {
+    uint8_t ucPresent = aucDeviceSets[k];
+    unsigned uDevices = __builtin_popcount(ucPresent);
+    vSetup(ucPresent);
+    TEST_CHECK(uGetEepromVolumeDevices() == uDevices, "set 0x%02X: %u devices", ucPresent, uGetEepromVolumeDevices());
+    TEST_CHECK(uGetEepromVolumeSize() == uDevices * EEPROM_VOLUME_DEV_SIZE, "set 0x%02X: volume size %u",
+      ucPresent, uGetEepromVolumeSize());
+    TEST_CHECK(uGetEepromSysAreaSize() == uDevices * EEPROM_SYS_DEV_SIZE, "set 0x%02X: system area size %u",
+      ucPresent, uGetEepromSysAreaSize());
+  }
+
+  vSetup(0x00);
+  unsigned char ucData = 0;
+  TEST_CHECK(!bReadEepromVolume(&ucData, 0, 1), "read without devices accepted");
+  TEST_CHECK(!bWriteEepromVolume(&ucData, 0, 1), "write without devices accepted");
+}
+
+/*!****************************************************************************
+ * @brief
+ * Whole volume written with unaligned block sizes lands on the devices by
+ * the stripe mapping, reads back, and leaves the system area untouched
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestStriping(void)
+{
+  for (unsigned k = 0; k < sizeof(aucDeviceSets); ++k)
+  {
+    uint8_t ucPresent = aucDeviceSets[k];
+    vSetup(ucPresent);
+    vFillPattern(ucPresent);
+
+    unsigned uSize = uGetEepromVolumeSize();
+    unsigned uBlock = 45;
+    for (unsigned uAddr = 0; uAddr < uSize; uAddr += uBlock)
+    {
+      unsigned uLen = (uSize - uAddr < uBlock) ? uSize - uAddr : uBlock;
+      TEST_CHECK(bWriteEepromVolume(&aucPattern[uAddr], uAddr, uLen), "write at %u rejected", uAddr);
+    }
+    vSyncEepromVolume();
+
+    unsigned uMismatch = 0;
+    for (unsigned uAddr = 0; uAddr < uSize; ++uAddr)
+    {
+      unsigned uDevAddr;
+      unsigned uDevice = uMapAddress(ucPresent, EEPROM_VOLUME_DEV_ADDR, uAddr, &uDevAddr);
+      if (pucSimI2cMemory(uDevice)[uDevAddr] != aucPattern[uAddr]) uMismatch++;
+    }
+    TEST_CHECK(uMismatch == 0, "set 0x%02X: %u bytes off the stripe mapping", ucPresent, uMismatch);
+
+    bool bSysClean = true;
+    for (unsigned i = 0; i < EEPROM_MAX_DEVICES; ++i)
+    {
+      for (unsigned j = EEPROM_SYS_DEV_ADDR; j < EEPROM_SYS_DEV_ADDR + EEPROM_SYS_DEV_SIZE; ++j)
+      {
+        if (pucSimI2cMemory(i)[j] != 0xFF) bSysClean = false;
+      }
+    }
+    TEST_CHECK(bSysClean, "set 0x%02X: system area modified by volume writes", ucPresent);
+
+    memset(aucRead, 0, sizeof(aucRead));
+    TEST_CHECK(bReadEepromVolume(aucRead, 0, uSize), "read rejected");
+    TEST_CHECK(memcmp(aucRead, aucPattern, uSize) == 0, "set 0x%02X: read back differs", ucPresent);
+    TEST_CHECK(ulBusyNacks() == 0, "set 0x%02X: %u accesses during write cycle", ucPresent, ulBusyNacks());
+
+    SimI2cStatsTypeDef sStats;
+    vSimI2cGetStats(&sStats);
+    TEST_CHECK(sStats.ulRollovers == 0, "set 0x%02X: %u writes wrapped within a page", ucPresent, sStats.ulRollovers);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Range checks, and system area mapped behind the volume area
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestAreas(void)
+{
+  uint8_t ucPresent = 0x83;
+  vSetup(ucPresent);
+  unsigned uSize = uGetEepromVolumeSize();
+  unsigned uSysSize = uGetEepromSysAreaSize();
+  unsigned char aucData[2] = { 0x12, 0x34 };
+
+  TEST_CHECK(bWriteEepromVolume(aucData, uSize - 2, 2), "write at volume end rejected");
+  TEST_CHECK(!bWriteEepromVolume(aucData, uSize - 1, 2), "write across volume end accepted");
+  TEST_CHECK(!bWriteEepromVolume(aucData, uSize, 1), "write behind volume end accepted");
+  TEST_CHECK(!bReadEepromVolume(aucData, ~0U, 2), "read with wrapping range accepted");
+  TEST_CHECK(!bWriteEepromSysArea(aucData, uSysSize - 1, 2), "write across system area end accepted");
+
+  for (unsigned uAddr = 0; uAddr < uSysSize; uAddr += sizeof(aucData))
+  {
+    aucData[0] = (uint8_t)uAddr;
+    aucData[1] = (uint8_t)(uAddr >> 8);
+    TEST_CHECK(bWriteEepromSysArea(aucData, uAddr, sizeof(aucData)), "system write at %u rejected", uAddr);
+  }
+  vSyncEepromVolume();
+
+  unsigned uMismatch = 0;
+  for (unsigned uAddr = 0; uAddr < uSysSize; ++uAddr)
+  {
+    unsigned uDevAddr;
+    unsigned uDevice = uMapAddress(ucPresent, EEPROM_SYS_DEV_ADDR, uAddr, &uDevAddr);
+    uint8_t ucExpected = (uAddr & 1) ? (uint8_t)((uAddr - 1) >> 8) : (uint8_t)uAddr;
+    if (pucSimI2cMemory(uDevice)[uDevAddr] != ucExpected) uMismatch++;
+  }
+  TEST_CHECK(uMismatch == 0, "%u system area bytes off the stripe mapping", uMismatch);
+
+  /* Last volume bytes still intact                       */
+  TEST_CHECK(bReadEepromVolume(aucData, uSize - 2, 2) && (aucData[0] == 0x12) && (aucData[1] == 0x34),
+    "volume end overwritten by system area");
+  TEST_CHECK(ulBusyNacks() == 0, "%u accesses during write cycle", ulBusyNacks());
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write cycles of different devices overlap: sequential writes over N
+ * devices take about 1/N of the single-device time, as long as the bus time
+ * of a stripe times N stays below the write cycle time
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestWriteCycles(void)
+{
+  /* 1, 2, 4 and 8 devices                                */
+  static const uint8_t aucScaling[] = { 0x01, 0x03, 0x0F, 0xFF };
+  const unsigned uLen = 64 * EEVOL_STRIPE_SIZE;
+  uint32_t ulSingle = 0;
+  vFillPattern(1);
+
+  for (unsigned k = 0; k < sizeof(aucScaling); ++k)
+  {
+    unsigned uDevices = __builtin_popcount(aucScaling[k]);
+    vSetup(aucScaling[k]);
+    uint32_t ulStart = ulSimTimeUs();
+    bWriteEepromVolume(aucPattern, 0, uLen);
+    vSyncEepromVolume();
+    uint32_t ulTime = ulSimTimeUs() - ulStart;
+    if (uDevices == 1) ulSingle = ulTime;
+
+    /* At least 3/4 of the ideal speedup                  */
+    TEST_CHECK(ulTime * uDevices * 3 <= ulSingle * 4, "%u devices: %u us, single device %u us",
+      uDevices, ulTime, ulSingle);
+    TEST_CHECK(ulBusyNacks() == 0, "%u devices: %u accesses during write cycle", uDevices, ulBusyNacks());
+    printf("  %u bytes on %u device(s): %u us, %u.%02u x\n", uLen, uDevices, ulTime,
+      ulSingle / ulTime, ulSingle * 100 / ulTime % 100);
+  }
+  TEST_CHECK(ulSingle >= 64 * SIM_I2C_TWR_US, "single device: %u us for 64 page writes", ulSingle);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Stream reader: read in odd chunk sizes matches the volume, and all fetches
+ * after the first one per device use current-address reads
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestStream(void)
+{
+  for (unsigned k = 0; k < sizeof(aucDeviceSets); ++k)
+  {
+    uint8_t ucPresent = aucDeviceSets[k];
+    vSetup(ucPresent);
+    vFillPattern(ucPresent + 7);
+    unsigned uSize = uGetEepromVolumeSize();
+    bWriteEepromVolume(aucPattern, 0, uSize);
+    vSyncEepromVolume();
+
+    /* Start within a stripe, end before the volume end   */
+    unsigned uStart = 5;
+    unsigned uLen = uSize - uStart - 3;
+    EepromStatsTypeDef sBefore, sAfter;
+    vGetEepromStats(&sBefore);
+
+    EepromStreamTypeDef sStream;
+    TEST_CHECK(bOpenEepromStream(&sStream, uStart, uLen), "stream open rejected");
+    unsigned uDone = 0, uChunk = 1, uRead;
+    memset(aucRead, 0, sizeof(aucRead));
+    while ((uRead = uReadEepromStream(&sStream, &aucRead[uDone], uChunk)) > 0)
+    {
+      uDone += uRead;
+      uChunk = uChunk % 37 + 3;
+    }
+    vGetEepromStats(&sAfter);
+
+    TEST_CHECK(uDone == uLen, "set 0x%02X: stream returned %u of %u bytes", ucPresent, uDone, uLen);
+    TEST_CHECK(memcmp(aucRead, &aucPattern[uStart], uLen) == 0, "set 0x%02X: stream data differs", ucPresent);
+
+    unsigned uDevices = __builtin_popcount(ucPresent);
+    uint32_t ulReads = sAfter.ulReads - sBefore.ulReads;
+    uint32_t ulContReads = sAfter.ulContReads - sBefore.ulContReads;
+    TEST_CHECK(ulReads - ulContReads <= uDevices, "set 0x%02X: %u of %u reads with address phase",
+      ucPresent, ulReads - ulContReads, ulReads);
+  }
+
+  /* Stream beyond the volume is rejected                 */
+  EepromStreamTypeDef sStream;
+  TEST_CHECK(!bOpenEepromStream(&sStream, 1, uGetEepromVolumeSize()), "stream past volume end accepted");
+}
+
+/*!****************************************************************************
+ * @brief
+ * A write between two reads moves the device's address counter, so the
+ * second read must not use the current-address read
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestReadAfterWrite(void)
+{
+  vSetup(0x01);
+  vFillPattern(3);
+  bWriteEepromVolume(aucPattern, 0, 4 * EEVOL_STRIPE_SIZE);
+  vSyncEepromVolume();
+
+  uint8_t aucData[10];
+  bReadEepromVolume(aucRead, 0, sizeof(aucData));
+  memset(aucData, 0xA5, sizeof(aucData));
+  bWriteEepromVolume(aucData, 3 * EEVOL_STRIPE_SIZE, 4);
+  bReadEepromVolume(aucRead, sizeof(aucData), sizeof(aucData));
+  TEST_CHECK(memcmp(aucRead, &aucPattern[sizeof(aucData)], sizeof(aucData)) == 0, "read after write differs");
+  TEST_CHECK(ulBusyNacks() == 0, "%u accesses during write cycle", ulBusyNacks());
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Whole 8 KB of a device read in page-sized chunks: the data matches, the
+ * address counter wraps at the device end, and the bus bytes saved by
+ * current-address reads match the bytes counted on the simulated bus
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestFullDevice(void)
+{
+  vSetup(0x01);
+  vFillPattern(9);
+  memcpy(pucSimI2cMemory(0), aucPattern, EEPROM_SIZE);
+
+  EepromStatsTypeDef sBefore, sAfter;
+  SimI2cStatsTypeDef sBus;
+  vGetEepromStats(&sBefore);
+  vSimI2cGetStats(&sBus);
+  uint32_t ulBusBefore = sBus.ulBusBytes;
+
+  /* One lap plus one chunk across the device end         */
+  memset(aucRead, 0, sizeof(aucRead));
+  for (unsigned uAddr = 0; uAddr < EEPROM_SIZE + EEPROM_PAGE_SIZE; uAddr += EEPROM_PAGE_SIZE)
+  {
+    vReadEepromDev(0, &aucRead[uAddr % EEPROM_SIZE], uAddr % EEPROM_SIZE, EEPROM_PAGE_SIZE);
+  }
+  vGetEepromStats(&sAfter);
+  vSimI2cGetStats(&sBus);
+
+  unsigned uReads = EEPROM_SIZE / EEPROM_PAGE_SIZE + 1;
+  uint32_t ulBusBytes = sBus.ulBusBytes - ulBusBefore;
+  uint32_t ulSaved = sAfter.ulSavedBytes - sBefore.ulSavedBytes;
+  TEST_CHECK(memcmp(aucRead, aucPattern, EEPROM_SIZE) == 0, "device data differs");
+  TEST_CHECK(sAfter.ulContReads - sBefore.ulContReads == uReads - 1, "%u of %u current-address reads",
+    sAfter.ulContReads - sBefore.ulContReads, uReads);
+  TEST_CHECK(sAfter.ulBusBytes - sBefore.ulBusBytes == ulBusBytes, "driver counted %u bus bytes, bus %u",
+    sAfter.ulBusBytes - sBefore.ulBusBytes, ulBusBytes);
+
+  /* Random reads: device address, two address bytes, device address, data */
+  uint32_t ulRandom = uReads * (4 + EEPROM_PAGE_SIZE);
+  TEST_CHECK(ulBusBytes + ulSaved == ulRandom, "%u bus bytes + %u saved, %u with random reads",
+    ulBusBytes, ulSaved, ulRandom);
+  printf("  %u bytes: %u bus bytes, %u saved (%u.%u %%)\n", EEPROM_SIZE + EEPROM_PAGE_SIZE, ulBusBytes,
+    ulSaved, ulSaved * 100 / ulRandom, ulSaved * 1000 / ulRandom % 10);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run EEPROM volume tests
+ *
+ * @return  (int)  Exit status
+ * @date  18.10.2026
+ ******************************************************************************/
+int main(void)
+{
+  TEST_RUN(vTestProbe);
+  TEST_RUN(vTestStriping);
+  TEST_RUN(vTestAreas);
+  TEST_RUN(vTestWriteCycles);
+  TEST_RUN(vTestStream);
+  TEST_RUN(vTestReadAfterWrite);
+  TEST_RUN(vTestFullDevice);
+  return TEST_RESULT();
+}
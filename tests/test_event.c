@@ -0,0 +1,320 @@
+/*!****************************************************************************
+ * @file
+ * test_event.c
+ *
+ * @brief
+ * Host stress tests of the lock-free event queue (event.c)
+ *
+ * Producer threads stand in for interrupt handlers publishing concurrently,
+ * the test's main thread is the consumer. On the host, the queue's atomic
+ * builtins compile to the host's atomic instructions, and the threads run
+ * truly in parallel, which is a harder test of the claim/release protocol
+ * than nested interrupts on a single core. Producers and consumer yield
+ * regularly, so the test also completes on a single host CPU.
+ *
+ * Covers per-producer ordering without lost events when producers retry on
+ * a full queue, the drop count when they do not, and the full queue limit.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <string.h>
+#include "event.h"
+#include "hw_stk.h"
+#include "test.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Number of producer threads                                         */
+#define TEST_PRODUCERS                4
+
+/*! @brief Events published per producer                                     */
+#define TEST_EVENTS                   200000
+
+
+/*- Type definitions ---------------------------------------------------------*/
+/*! @brief Producer thread state                                              */
+typedef struct
+{
+  pthread_t sThread;                  /*!< Thread                             */
+  uint16_t uiId;                      /*!< Producer index (event argument)    */
+  bool bRetry;                        /*!< Retry events rejected as full      */
+  uint32_t ulQueued;                  /*!< Events accepted                    */
+  uint32_t ulRejected;                /*!< Publish calls rejected             */
+  bool bDone;                         /*!< All events published               */
+} ProducerTypeDef;
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Simulated SysTick counter                                                 */
+static uint32_t ulTicks;
+
+/*! Producers                                                                 */
+static ProducerTypeDef asProducers[TEST_PRODUCERS];
+
+/*! Start flag, set once all producers are created                            */
+static bool bGo;
+
+/*! Consumer view per producer: events received, next expected sequence
+ *  number, and events received out of order                                  */
+static uint32_t aulReceived[TEST_PRODUCERS];
+static uint32_t aulNextSeq[TEST_PRODUCERS];
+static uint32_t aulOutOfOrder[TEST_PRODUCERS];
+
+/*! Events with an unknown producer or topic                                  */
+static uint32_t ulCorrupt;
+
+
+/*- Simulated hardware -------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Simulated SysTick counter, advanced by one per read
+ *
+ * @return  (uint32_t)  Counter value
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t SysTick_GetValueLow(void)
+{
+  return __atomic_fetch_add(&ulTicks, 1, __ATOMIC_RELAXED);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Convert milliseconds to SysTick counts (1 count per us)
+ *
+ * @param[in] ulMs        Time in ms
+ * @return  (uint32_t)  SysTick counts
+ * @date  18.10.2026
+ ******************************************************************************/
+uint32_t ulHW_STK_MsToTicks(uint32_t ulMs)
+{
+  return ulMs * 1000;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Subscriber: check the sequence number of the event's producer
+ *
+ * With retrying producers, the sequence numbers of a producer arrive without
+ * gaps; without retries, they only increase.
+ *
+ * @param[in] *psEvent    Event, argument is the producer, data the sequence
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vOnEvent(const EventTypeDef* psEvent)
+{
+  if ((psEvent->uiTopic != EVENT_TOPIC_BENCH) || (psEvent->uiArg >= TEST_PRODUCERS))
+  {
+    ulCorrupt++;
+    return;
+  }
+  unsigned uId = psEvent->uiArg;
+  bool bInOrder = asProducers[uId].bRetry ? (psEvent->ulData == aulNextSeq[uId])
+                                          : (psEvent->ulData >= aulNextSeq[uId]);
+  if (!bInOrder) aulOutOfOrder[uId]++;
+  aulNextSeq[uId] = psEvent->ulData + 1;
+  aulReceived[uId]++;
+}
+
+/*! Subscriber table                                                          */
+static const EventSubTypeDef asSubs[] =
+{
+  { EVENT_TOPIC_BENCH, vOnEvent },
+};
+
+/*!****************************************************************************
+ * @brief
+ * Producer thread: publish TEST_EVENTS numbered events
+ *
+ * @param[in] *pvArg      Producer state
+ * @return  (void*)  NULL
+ * @date  18.10.2026
+ ******************************************************************************/
+static void* pvProducer(void* pvArg)
+{
+  ProducerTypeDef* psProducer = pvArg;
+  while (!__atomic_load_n(&bGo, __ATOMIC_ACQUIRE)) sched_yield();
+
+  for (uint32_t ulSeq = 0; ulSeq < TEST_EVENTS; )
+  {
+    if (bPublishEvent(EVENT_TOPIC_BENCH, psProducer->uiId, ulSeq))
+    {
+      psProducer->ulQueued++;
+      ulSeq++;
+    }
+    else
+    {
+      /* Queue full: let the consumer run                 */
+      psProducer->ulRejected++;
+      if (!psProducer->bRetry) ulSeq++;
+      sched_yield();
+    }
+  }
+  __atomic_store_n(&psProducer->bDone, true, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run producers against the consumer until all events are taken
+ *
+ * @param[in] bRetry      Producers retry rejected events
+ * @param[out] *psStats   Queue statistics of this run
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vRunProducers(bool bRetry, EventStatsTypeDef* psStats)
+{
+  EventStatsTypeDef sBefore;
+  vGetEventStats(&sBefore);
+  vInitEvents(asSubs, sizeof(asSubs) / sizeof(asSubs[0]));
+  memset(aulReceived, 0, sizeof(aulReceived));
+  memset(aulNextSeq, 0, sizeof(aulNextSeq));
+  memset(aulOutOfOrder, 0, sizeof(aulOutOfOrder));
+  ulCorrupt = 0;
+  bGo = false;
+
+  for (unsigned i = 0; i < TEST_PRODUCERS; ++i)
+  {
+    asProducers[i] = (ProducerTypeDef){ .uiId = i, .bRetry = bRetry };
+    pthread_create(&asProducers[i].sThread, NULL, pvProducer, &asProducers[i]);
+  }
+  __atomic_store_n(&bGo, true, __ATOMIC_RELEASE);
+
+  /* Consume while producing, then drain                  */
+  unsigned uRunning = TEST_PRODUCERS;
+  while (uRunning > 0)
+  {
+    vPollEvents();
+    sched_yield();
+    uRunning = 0;
+    for (unsigned i = 0; i < TEST_PRODUCERS; ++i)
+    {
+      if (!__atomic_load_n(&asProducers[i].bDone, __ATOMIC_ACQUIRE)) uRunning++;
+    }
+  }
+  while (bDispatchEvent());
+  for (unsigned i = 0; i < TEST_PRODUCERS; ++i) pthread_join(asProducers[i].sThread, NULL);
+
+  vGetEventStats(psStats);
+  psStats->ulPublished -= sBefore.ulPublished;
+  psStats->ulDropped -= sBefore.ulDropped;
+  psStats->ulDispatched -= sBefore.ulDispatched;
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Producers retrying on a full queue: every event arrives exactly once, in
+ * order per producer
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestOrdering(void)
+{
+  EventStatsTypeDef sStats;
+  vRunProducers(true, &sStats);
+
+  uint32_t ulRejected = 0;
+  for (unsigned i = 0; i < TEST_PRODUCERS; ++i)
+  {
+    TEST_CHECK(aulReceived[i] == TEST_EVENTS, "producer %u: %u of %u events received", i, aulReceived[i],
+      TEST_EVENTS);
+    TEST_CHECK(aulOutOfOrder[i] == 0, "producer %u: %u events out of order", i, aulOutOfOrder[i]);
+    ulRejected += asProducers[i].ulRejected;
+  }
+  TEST_CHECK(ulCorrupt == 0, "%u corrupt events", ulCorrupt);
+  TEST_CHECK(sStats.ulPublished == TEST_PRODUCERS * TEST_EVENTS, "%u events published", sStats.ulPublished);
+  TEST_CHECK(sStats.ulDispatched == sStats.ulPublished, "%u events dispatched", sStats.ulDispatched);
+  TEST_CHECK(sStats.ulDropped == ulRejected, "%u drops counted, %u rejected", sStats.ulDropped, ulRejected);
+  TEST_CHECK(sStats.uPeak <= EVENT_QUEUE_LEN, "peak fill %u", sStats.uPeak);
+  printf("  %u events, %u rejected while full, peak %u/%u\n", sStats.ulPublished, ulRejected,
+    sStats.uPeak, EVENT_QUEUE_LEN);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Producers dropping events on a full queue: drops are counted, and the
+ * events taken keep their order per producer
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestDrops(void)
+{
+  EventStatsTypeDef sStats;
+  vRunProducers(false, &sStats);
+
+  uint32_t ulQueued = 0, ulRejected = 0;
+  for (unsigned i = 0; i < TEST_PRODUCERS; ++i)
+  {
+    TEST_CHECK(aulReceived[i] == asProducers[i].ulQueued, "producer %u: %u of %u events received", i,
+      aulReceived[i], asProducers[i].ulQueued);
+    TEST_CHECK(aulOutOfOrder[i] == 0, "producer %u: %u events out of order", i, aulOutOfOrder[i]);
+    TEST_CHECK(asProducers[i].ulQueued + asProducers[i].ulRejected == TEST_EVENTS, "producer %u: %u + %u events",
+      i, asProducers[i].ulQueued, asProducers[i].ulRejected);
+    ulQueued += asProducers[i].ulQueued;
+    ulRejected += asProducers[i].ulRejected;
+  }
+  TEST_CHECK(ulCorrupt == 0, "%u corrupt events", ulCorrupt);
+  TEST_CHECK(sStats.ulPublished == ulQueued, "%u events published, %u queued", sStats.ulPublished, ulQueued);
+  TEST_CHECK(sStats.ulDispatched == ulQueued, "%u events dispatched, %u queued", sStats.ulDispatched, ulQueued);
+  TEST_CHECK(sStats.ulDropped == ulRejected, "%u drops counted, %u rejected", sStats.ulDropped, ulRejected);
+  printf("  %u events queued, %u dropped\n", ulQueued, ulRejected);
+}
+
+/*!****************************************************************************
+ * @brief
+ * A full queue holds exactly EVENT_QUEUE_LEN events, rejects further events
+ * until one is taken, and keeps their order
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestFull(void)
+{
+  EventStatsTypeDef sBefore, sAfter;
+  vGetEventStats(&sBefore);
+  vInitEvents(asSubs, sizeof(asSubs) / sizeof(asSubs[0]));
+  memset(aulReceived, 0, sizeof(aulReceived));
+  memset(aulNextSeq, 0, sizeof(aulNextSeq));
+  memset(aulOutOfOrder, 0, sizeof(aulOutOfOrder));
+  asProducers[0].bRetry = true;
+
+  uint32_t ulSeq = 0;
+  while (bPublishEvent(EVENT_TOPIC_BENCH, 0, ulSeq)) ulSeq++;
+  TEST_CHECK(ulSeq == EVENT_QUEUE_LEN, "%u events queued", ulSeq);
+  TEST_CHECK(!bPublishEvent(EVENT_TOPIC_BENCH, 0, ulSeq), "event accepted by full queue");
+
+  /* One slot taken: exactly one more event fits          */
+  TEST_CHECK(bDispatchEvent(), "no event dispatched");
+  TEST_CHECK(bPublishEvent(EVENT_TOPIC_BENCH, 0, ulSeq++), "event rejected after dispatch");
+  TEST_CHECK(!bPublishEvent(EVENT_TOPIC_BENCH, 0, ulSeq), "event accepted by full queue");
+
+  while (bDispatchEvent());
+  vGetEventStats(&sAfter);
+  TEST_CHECK(aulReceived[0] == ulSeq, "%u of %u events received", aulReceived[0], ulSeq);
+  TEST_CHECK(aulOutOfOrder[0] == 0, "%u events out of order", aulOutOfOrder[0]);
+  TEST_CHECK(sAfter.ulDropped - sBefore.ulDropped == 3, "%u drops counted", sAfter.ulDropped - sBefore.ulDropped);
+  TEST_CHECK(sAfter.uPeak >= EVENT_QUEUE_LEN, "peak fill %u", sAfter.uPeak);
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Run event queue tests
+ *
+ * @return  (int)  Exit status
+ * @date  18.10.2026
+ ******************************************************************************/
+int main(void)
+{
+  TEST_RUN(vTestFull);
+  TEST_RUN(vTestOrdering);
+  TEST_RUN(vTestDrops);
+  return TEST_RESULT();
+}
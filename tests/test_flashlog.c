@@ -0,0 +1,420 @@
+/*!****************************************************************************
+ * @file
+ * test_flashlog.c
+ *
+ * @brief
+ * Host tests of the flash logger (flashlog.c) on simulated flash
+ *
+ * Covers recovery of the write pointer by iFindNewestPage() in all ring
+ * states, write amplification and wear levelling, power loss during every
+ * flash operation of a logging session, and pages failing verification.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <string.h>
+#include "flashlog.h"
+#include "sim_flash.h"
+#include "sim_stubs.h"
+#include "test.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Pages that survive any power loss, counted back from the newest    */
+#define TEST_RETAINED_PAGES           (FLASHLOG_NUM_PAGES - FLASHLOG_ERASE_AHEAD - 1)
+
+/*! @brief Maximum page reads to find the newest page: page 0, binary search  */
+#define TEST_MAX_FIND_READS           8
+
+/*! @brief Data area offset from flash base                                   */
+#define TEST_DATA_OFFSET              ((uint32_t)(FLASH_DATA_ADDR - FLASH_BASE))
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Running record number; record contents are derived from it                */
+static uint32_t ulRecordNo;
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Append the next test record
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vWriteRecord(void)
+{
+  uint8_t aucRecord[FLASHLOG_MAX_RECORD];
+  unsigned uLen = sizeof(ulRecordNo) + ulRecordNo % 29;
+  memcpy(aucRecord, &ulRecordNo, sizeof(ulRecordNo));
+  for (unsigned i = sizeof(ulRecordNo); i < uLen; ++i) aucRecord[i] = (uint8_t)(ulRecordNo * 31 + i);
+  bWriteFlashLog(aucRecord, uLen);
+  ulRecordNo++;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Commit pages holding a single full-size record
+ *
+ * @param[in] uPages      Number of pages
+ * @param[in] uPolls      vPollFlashLog() calls after each commit
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vCommitPages(unsigned uPages, unsigned uPolls)
+{
+  uint8_t aucRecord[FLASHLOG_MAX_RECORD];
+  for (unsigned i = 0; i < uPages; ++i)
+  {
+    memset(aucRecord, (uint8_t)i, sizeof(aucRecord));
+    bWriteFlashLog(aucRecord, sizeof(aucRecord));
+    vFlushFlashLog();
+    for (unsigned j = 0; j < uPolls; ++j) vPollFlashLog();
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get sequence number of the next page
+ *
+ * @return  (uint32_t)  Sequence number
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulGetNextSeq(void)
+{
+  FlashLogInfoTypeDef sInfo;
+  vGetFlashLogInfo(&sInfo);
+  return sInfo.ulNextSeq;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check that flash outside the data area was never touched
+ *
+ * @return  (bool)  true if untouched
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bIsOutsideUntouched(void)
+{
+  const uint32_t* pulFlash = (const uint32_t*)aucSimFlash;
+  for (uint32_t i = 0; i < SIM_FLASH_SIZE / sizeof(uint32_t); ++i)
+  {
+    uint32_t ulOffset = i * sizeof(uint32_t);
+    if ((ulOffset >= TEST_DATA_OFFSET) && (ulOffset < TEST_DATA_OFFSET + FLASH_DATA_SIZE)) continue;
+    if (pulFlash[i] != SIM_FLASH_ERASED_WORD) return false;
+  }
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check the records of the retained pages
+ *
+ * Records within a page are consecutive, and record numbers increase over
+ * the pages. Records of a page buffer lost by a power loss leave a gap.
+ *
+ * @param[in] ulNextSeq   Sequence number of the next page
+ * @param[in] ulSkipped   Sequence number of a page cut short by a power loss,
+ *                        which is missing, or UINT32_MAX
+ * @return  (bool)  true if all retained pages are present and intact
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bCheckRetainedPages(uint32_t ulNextSeq, uint32_t ulSkipped)
+{
+  uint32_t ulFirst = (ulNextSeq > TEST_RETAINED_PAGES) ? ulNextSeq - TEST_RETAINED_PAGES : 0;
+  bool bFirstRecord = true;
+  uint32_t ulPrevNo = 0;
+  for (uint32_t ulSeq = ulFirst; ulSeq < ulNextSeq; ++ulSeq)
+  {
+    const FlashLogHdrTypeDef* psPage = psGetFlashLogPage(ulSeq);
+    if ((psPage == NULL) && (ulSeq == ulSkipped)) continue;
+    if (psPage == NULL) return false;
+
+    const uint8_t* pucPayload = (const uint8_t*)psPage + FLASHLOG_HDR_SIZE;
+    unsigned uPos = 0;
+    bool bFirstInPage = true;
+    while (uPos < psPage->ulLen)
+    {
+      unsigned uLen = pucPayload[uPos];
+      uint32_t ulNo;
+      memcpy(&ulNo, &pucPayload[uPos + 1], sizeof(ulNo));
+      if ((uLen != sizeof(ulNo) + ulNo % 29) || (uPos + 1 + uLen > psPage->ulLen)) return false;
+      for (unsigned i = sizeof(ulNo); i < uLen; ++i)
+      {
+        if (pucPayload[uPos + 1 + i] != (uint8_t)(ulNo * 31 + i)) return false;
+      }
+      if (!bFirstRecord && ((ulNo <= ulPrevNo) || (!bFirstInPage && (ulNo != ulPrevNo + 1)))) return false;
+
+      ulPrevNo = ulNo;
+      bFirstRecord = false;
+      bFirstInPage = false;
+      uPos += 1 + uLen;
+    }
+  }
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Log records until a power loss
+ *
+ * @param[in] iFailAt     Flash operations before the power loss
+ * @return  (uint32_t)  Number of pages committed before the power loss
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulRunUntilPowerFail(int iFailAt)
+{
+  /* Modified between setjmp() and longjmp()              */
+  volatile uint32_t ulCommitted = ulGetNextSeq();
+
+  vSimFlashFailAfter(iFailAt);
+  if (setjmp(sSimPowerFail) == 0)
+  {
+    while (1)
+    {
+      ulCommitted = ulGetNextSeq();
+      vWriteRecord();
+      ulCommitted = ulGetNextSeq();
+      vPollFlashLog();
+    }
+  }
+  return ulCommitted;
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Empty flash: log starts at sequence number 0
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestEmpty(void)
+{
+  vSimFlashReset();
+  vInitFlashLog();
+  TEST_CHECK(ulGetNextSeq() == 0, "next seq %u", ulGetNextSeq());
+  TEST_CHECK(psGetFlashLogPage(0) == NULL, "page 0 present");
+
+  /* Nothing pending: flush does not program             */
+  vFlushFlashLog();
+  SimFlashStatsTypeDef sFlash;
+  vSimFlashGetStats(&sFlash);
+  TEST_CHECK(sFlash.ulPrograms == 0, "%u programs", sFlash.ulPrograms);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write pointer recovery after every number of committed pages over three
+ * laps, with erase-ahead idle, keeping up and running ahead
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestFindNewest(void)
+{
+  for (unsigned uPolls = 0; uPolls <= FLASHLOG_ERASE_AHEAD; ++uPolls)
+  {
+    for (unsigned uPages = 0; uPages <= 3 * FLASHLOG_NUM_PAGES + 2; ++uPages)
+    {
+      vSimFlashReset();
+      vInitFlashLog();
+      vCommitPages(uPages, uPolls);
+
+      uint32_t ulCrcCalls = ulSimCrcCalls();
+      vInitFlashLog();
+      uint32_t ulReads = ulSimCrcCalls() - ulCrcCalls;
+      uint32_t ulNext = ulGetNextSeq();
+      TEST_CHECK(ulNext == uPages, "polls %u: %u pages committed, next seq %u", uPolls, uPages, ulNext);
+      TEST_CHECK(ulReads <= TEST_MAX_FIND_READS, "polls %u, pages %u: %u page reads", uPolls, uPages, ulReads);
+
+      uint32_t ulFirst = (uPages > TEST_RETAINED_PAGES) ? uPages - TEST_RETAINED_PAGES : 0;
+      for (uint32_t ulSeq = ulFirst; ulSeq < uPages; ++ulSeq)
+      {
+        const FlashLogHdrTypeDef* psPage = psGetFlashLogPage(ulSeq);
+        TEST_CHECK((psPage != NULL) && (((const uint8_t*)psPage)[FLASHLOG_HDR_SIZE + 1] == (uint8_t)ulSeq),
+          "polls %u, pages %u: page %u lost", uPolls, uPages, ulSeq);
+      }
+      TEST_CHECK(bIsOutsideUntouched(), "flash outside data area modified");
+
+      SimFlashStatsTypeDef sFlash;
+      vSimFlashGetStats(&sFlash);
+      TEST_CHECK(sFlash.ulViolations == 0, "%u program/address violations", sFlash.ulViolations);
+    }
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Write amplification and wear levelling for different record sizes
+ *
+ * Each page is programmed once, when full, so the flash bytes programmed per
+ * record byte are HW_FLASH_PAGE_SIZE / (records per page * record length).
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestWriteAmplification(void)
+{
+  static const unsigned auLengths[] = { 1, 7, 20, 57, FLASHLOG_MAX_RECORD };
+  const unsigned uRecords = 1000;
+
+  for (unsigned k = 0; k < sizeof(auLengths) / sizeof(auLengths[0]); ++k)
+  {
+    unsigned uLen = auLengths[k];
+    uint8_t aucRecord[FLASHLOG_MAX_RECORD];
+    memset(aucRecord, 0x5A, sizeof(aucRecord));
+
+    vSimFlashReset();
+    vSimMuxReset();
+    vInitFlashLog();
+    for (unsigned i = 0; i < uRecords; ++i)
+    {
+      TEST_CHECK(bWriteFlashLog(aucRecord, uLen), "record %u of %u bytes rejected", i, uLen);
+      vPollFlashLog();
+    }
+    vFlushFlashLog();
+
+    unsigned uPerPage = FLASHLOG_PAYLOAD_SIZE / (1 + uLen);
+    unsigned uPages = (uRecords + uPerPage - 1) / uPerPage;
+    FlashLogInfoTypeDef sInfo;
+    SimFlashStatsTypeDef sFlash;
+    vGetFlashLogInfo(&sInfo);
+    vSimFlashGetStats(&sFlash);
+    TEST_CHECK(sInfo.ulPages == uPages, "%u-byte records: %u pages, expected %u", uLen, sInfo.ulPages, uPages);
+    TEST_CHECK(sFlash.ulPrograms == uPages, "%u-byte records: %u programs", uLen, sFlash.ulPrograms);
+    TEST_CHECK(sFlash.ulErases == sInfo.ulErases, "erase count %u, logger reports %u", sFlash.ulErases, sInfo.ulErases);
+    TEST_CHECK(sFlash.ulViolations == 0, "%u program/address violations", sFlash.ulViolations);
+    TEST_CHECK(ulSimMuxBytes(MUX_CH_LOG) == uRecords * (1 + uLen), "%u bytes on log channel", ulSimMuxBytes(MUX_CH_LOG));
+
+    /* Erases spread evenly over the ring                 */
+    unsigned uMin = ~0U, uMax = 0;
+    for (unsigned i = 0; i < FLASHLOG_NUM_PAGES; ++i)
+    {
+      unsigned uErases = uSimFlashPageErases(TEST_DATA_OFFSET + i * HW_FLASH_PAGE_SIZE);
+      if (uErases < uMin) uMin = uErases;
+      if (uErases > uMax) uMax = uErases;
+    }
+    TEST_CHECK(uMax - uMin <= 1, "%u-byte records: page erases %u .. %u", uLen, uMin, uMax);
+
+    unsigned uAmp = (sInfo.ulPages * HW_FLASH_PAGE_SIZE * 100) / sInfo.ulBytes;
+    printf("  %3u-byte records: %4u pages, write amplification %u.%02u\n", uLen, sInfo.ulPages, uAmp / 100, uAmp % 100);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Power loss during each flash operation of a session, for every ring
+ * position over two laps
+ *
+ * After the reset, all pages committed before the power loss are found, the
+ * retained pages hold intact records, and logging continues without
+ * programming a page that was not erased. A page cut short by the power loss
+ * may be skipped.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestPowerFail(void)
+{
+  for (unsigned uBase = 0; uBase < 2 * FLASHLOG_NUM_PAGES; ++uBase)
+  {
+    for (int iFailAt = 0; iFailAt < 2 * (FLASHLOG_ERASE_AHEAD + 2); ++iFailAt)
+    {
+      vSimFlashReset();
+      vInitFlashLog();
+      ulRecordNo = 0;
+      while (ulGetNextSeq() < uBase)
+      {
+        vWriteRecord();
+        vPollFlashLog();
+      }
+      vInitFlashLog();
+
+      uint32_t ulCommitted = ulRunUntilPowerFail(iFailAt);
+
+      vInitFlashLog();
+      uint32_t ulNext = ulGetNextSeq();
+      TEST_CHECK((ulNext == ulCommitted) || ((ulNext == ulCommitted + 1) && (psGetFlashLogPage(ulCommitted) == NULL)),
+        "base %u, fail at %d: next seq %u, %u committed", uBase, iFailAt, ulNext, ulCommitted);
+      uint32_t ulSkipped = (ulNext > ulCommitted) ? ulCommitted : UINT32_MAX;
+      TEST_CHECK(bCheckRetainedPages(ulNext, ulSkipped), "base %u, fail at %d: retained pages damaged", uBase, iFailAt);
+
+      /* Logging continues over a full lap                */
+      while (ulGetNextSeq() < ulNext + FLASHLOG_NUM_PAGES)
+      {
+        vWriteRecord();
+        vPollFlashLog();
+      }
+      vFlushFlashLog();
+      uint32_t ulEnd = ulGetNextSeq();
+      vInitFlashLog();
+      TEST_CHECK(ulGetNextSeq() == ulEnd, "base %u, fail at %d: next seq %u after restart, %u committed",
+        uBase, iFailAt, ulGetNextSeq(), ulEnd);
+      TEST_CHECK(bCheckRetainedPages(ulEnd, ulSkipped), "base %u, fail at %d: pages damaged after restart", uBase, iFailAt);
+
+      SimFlashStatsTypeDef sFlash;
+      vSimFlashGetStats(&sFlash);
+      TEST_CHECK(sFlash.ulViolations == 0, "base %u, fail at %d: %u program/address violations",
+        uBase, iFailAt, sFlash.ulViolations);
+      TEST_CHECK(bIsOutsideUntouched(), "base %u, fail at %d: flash outside data area modified", uBase, iFailAt);
+    }
+  }
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Page failing verification, followed by up to two commits and a reset, for
+ * every ring position over two laps
+ *
+ * The failed page keeps its sequence number, so the write pointer is found
+ * behind the pages committed after it, and the failed page is skipped on
+ * readout. If it was the last page before the reset, it may also be reused.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestProgramError(void)
+{
+  for (unsigned uBase = 0; uBase < 2 * FLASHLOG_NUM_PAGES; ++uBase)
+  {
+    for (unsigned uAfter = 0; uAfter <= 2; ++uAfter)
+    {
+      vSimFlashReset();
+      vInitFlashLog();
+      vCommitPages(uBase, FLASHLOG_ERASE_AHEAD);
+      vSimFlashCorruptAfter(0);
+      vCommitPages(1 + uAfter, FLASHLOG_ERASE_AHEAD);
+
+      FlashLogInfoTypeDef sInfo;
+      vGetFlashLogInfo(&sInfo);
+      TEST_CHECK(sInfo.ulErrors == 1, "base %u: %u errors reported", uBase, sInfo.ulErrors);
+
+      vInitFlashLog();
+      uint32_t ulExpected = uBase + 1 + uAfter;
+      TEST_CHECK((ulGetNextSeq() == ulExpected) || ((uAfter == 0) && (ulGetNextSeq() == uBase)),
+        "base %u, %u pages after failure: next seq %u, expected %u", uBase, uAfter, ulGetNextSeq(), ulExpected);
+      TEST_CHECK(psGetFlashLogPage(uBase) == NULL, "base %u: failed page returned", uBase);
+      for (unsigned i = 1; i <= uAfter; ++i)
+      {
+        TEST_CHECK(psGetFlashLogPage(uBase + i) != NULL, "base %u: page %u after failure lost", uBase, i);
+      }
+    }
+  }
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Run flash logger tests
+ *
+ * @return  (int)  Exit status
+ * @date  18.10.2026
+ ******************************************************************************/
+int main(void)
+{
+  TEST_RUN(vTestEmpty);
+  TEST_RUN(vTestFindNewest);
+  TEST_RUN(vTestWriteAmplification);
+  TEST_RUN(vTestPowerFail);
+  TEST_RUN(vTestProgramError);
+  return TEST_RESULT();
+}
@@ -0,0 +1,499 @@
+/*!****************************************************************************
+ * @file
+ * test_fwupd.c
+ *
+ * @brief
+ * Host tests of the firmware update (fwupd.c, installer.c) on simulated flash
+ *
+ * Covers resuming a transfer from its last checkpoint, also after a power
+ * loss during any flash operation of the transfer, verification of the staged
+ * image on commit, and the installer: a copy interrupted by a power loss at
+ * any flash operation is completed after the next reset, skipping the pages
+ * copied before, and a copy which keeps failing is given up and recorded.
+ *
+ * The installer starts the application by calling _start() (renamed to
+ * vSimAppStart(), see CMakeLists.txt), and the update resets the system by
+ * PFIC_SystemReset(); both longjmp() back to the test.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <setjmp.h>
+#include <stdbool.h>
+#include <string.h>
+#include "offload.h"
+#include "image.h"
+#include "fwupd.h"
+#include "installer.h"
+#include "sim_flash.h"
+#include "test.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Test image size: whole pages and a short last page                 */
+#define TEST_IMAGE_SIZE               (40 * HW_FLASH_PAGE_SIZE + 64)
+
+/*! @brief Number of pages covered by the test image                          */
+#define TEST_IMAGE_PAGES              ((TEST_IMAGE_SIZE + HW_FLASH_PAGE_SIZE - 1) / HW_FLASH_PAGE_SIZE)
+
+/*! @brief Bytes between two progress checkpoints                             */
+#define TEST_CHECKPOINT_BYTES         (FWUPD_CHECKPOINT_PAGES * HW_FLASH_PAGE_SIZE)
+
+/*! @brief Flash area offsets from flash base
+ *  @{                                                                        */
+#define TEST_APP_OFFSET               ((uint32_t)(FLASH_APP_ADDR - FLASH_BASE))
+#define TEST_STAGING_OFFSET           ((uint32_t)(FLASH_STAGING_ADDR - FLASH_BASE))
+/*! @}                                                                        */
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Test images: new image to be sent, and image in the application area      */
+static uint8_t aucImage[TEST_IMAGE_SIZE], aucOldImage[TEST_IMAGE_SIZE];
+
+/*! Flash contents before an installation                                     */
+static uint8_t aucFlashCopy[SIM_FLASH_SIZE];
+
+/*! Jump targets of application start and system reset
+ *  @{                                                                        */
+static jmp_buf sAppStart, sSystemReset;
+/*! @}                                                                        */
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Build sealed test image
+ *
+ * @param[out] *pucImage  Image buffer of TEST_IMAGE_SIZE bytes
+ * @param[in] uSeed       Content seed
+ * @param[in] bValid      false for a trailer not covering the image
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vBuildImage(uint8_t* pucImage, unsigned uSeed, bool bValid)
+{
+  unsigned uLength = TEST_IMAGE_SIZE - sizeof(ImageTrailerTypeDef);
+  for (unsigned i = 0; i < uLength; ++i) pucImage[i] = (uint8_t)(i * 7 + (i >> 8) + uSeed);
+
+  ImageTrailerTypeDef sTrailer;
+  sTrailer.ulMagic = IMAGE_TRAILER_MAGIC;
+  sTrailer.ulStart = (uint32_t)FLASH_APP_ADDR;
+  sTrailer.ulLength = bValid ? uLength : uLength - 4;
+  sTrailer.ulCrc = ulCalcCrc32Sw(pucImage, uLength, OFFLOAD_CRC32_INIT);
+  memcpy(&pucImage[uLength], &sTrailer, sizeof(sTrailer));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get CRC-32 of the test image as sent with the session start
+ *
+ * @return  (uint32_t)  CRC
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulGetImageCrc(void)
+{
+  return ulCalcCrc32Sw(aucImage, TEST_IMAGE_SIZE, OFFLOAD_CRC32_INIT);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Send test image pages
+ *
+ * @param[in] ulOffset    Offset of the first page to be sent
+ * @return  (bool)  true if all pages were accepted
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bSendImage(uint32_t ulOffset)
+{
+  for (; ulOffset < TEST_IMAGE_SIZE; ulOffset += HW_FLASH_PAGE_SIZE)
+  {
+    unsigned uLen = (TEST_IMAGE_SIZE - ulOffset < HW_FLASH_PAGE_SIZE) ? TEST_IMAGE_SIZE - ulOffset : HW_FLASH_PAGE_SIZE;
+    if (eWriteFwUpd(ulOffset, &aucImage[ulOffset], uLen) != FWUPD_OK) return false;
+  }
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get session state
+ *
+ * @return  (FwUpdStateTypeDef)  State
+ * @date  18.10.2026
+ ******************************************************************************/
+static FwUpdStateTypeDef eGetState(void)
+{
+  FwUpdStatusTypeDef sStatus;
+  vGetFwUpdStatus(&sStatus);
+  return sStatus.eState;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Check flash area contents against an image
+ *
+ * @param[in] ulOffset    Area offset from flash base
+ * @param[in] *pucData    Image
+ * @return  (bool)  true if equal
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bIsAreaEqual(uint32_t ulOffset, const uint8_t* pucData)
+{
+  return memcmp(&aucSimFlash[ulOffset], pucData, TEST_IMAGE_SIZE) == 0;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Erase flash and place the old image in the application area
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vSetupFlash(void)
+{
+  vSimFlashReset();
+  memcpy(&aucSimFlash[TEST_APP_OFFSET], aucOldImage, TEST_IMAGE_SIZE);
+  vInitFwUpd();
+}
+
+/*!****************************************************************************
+ * @brief
+ * Send and commit the test image
+ *
+ * @return  (bool)  true if the installation has been scheduled
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bStageImage(void)
+{
+  uint32_t ulNextOfs;
+  return (eBeginFwUpd(TEST_IMAGE_SIZE, ulGetImageCrc(), &ulNextOfs) == FWUPD_OK) &&
+    bSendImage(ulNextOfs) && (eCommitFwUpd() == FWUPD_OK);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Send test image with power loss injected
+ *
+ * @param[in] iFailAt     Flash operations before the power loss
+ * @param[out] *pulSent   Offset of the page being written at the power loss,
+ *                        or image size
+ * @return  (bool)  true if the power loss occurred
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bSendUntilPowerFail(int iFailAt, uint32_t* pulSent)
+{
+  /* Modified between setjmp() and longjmp()              */
+  volatile uint32_t ulOffset = 0;
+
+  vSimFlashFailAfter(iFailAt);
+  if (setjmp(sSimPowerFail) == 0)
+  {
+    for (; ulOffset < TEST_IMAGE_SIZE; ulOffset += HW_FLASH_PAGE_SIZE)
+    {
+      unsigned uLen = (TEST_IMAGE_SIZE - ulOffset < HW_FLASH_PAGE_SIZE) ? TEST_IMAGE_SIZE - ulOffset : HW_FLASH_PAGE_SIZE;
+      eWriteFwUpd(ulOffset, &aucImage[ulOffset], uLen);
+    }
+    vSimFlashFailAfter(-1);
+    *pulSent = ulOffset;
+    return false;
+  }
+  *pulSent = ulOffset;
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Run installer after a reset
+ *
+ * @param[in] iFailAt     Flash operations before a power loss, negative for
+ *                        none
+ * @return  (bool)  true if the application was started, false on power loss
+ * @date  18.10.2026
+ ******************************************************************************/
+static bool bRunInstaller(int iFailAt)
+{
+  vSimFlashFailAfter(iFailAt);
+  if (setjmp(sSimPowerFail) != 0) return false;
+  if (setjmp(sAppStart) != 0)
+  {
+    vSimFlashFailAfter(-1);
+    return true;
+  }
+  vRunInstaller();
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Start application, called by the installer in place of _start()
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void vSimAppStart(void)
+{
+  longjmp(sAppStart, 1);
+}
+
+/*!****************************************************************************
+ * @brief
+ * System reset, called by vPollFwUpd()
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+void PFIC_SystemReset(void)
+{
+  longjmp(sSystemReset, 1);
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Interrupted transfer is resumed from the last checkpoint
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestResume(void)
+{
+  vSetupFlash();
+  uint32_t ulNextOfs;
+  TEST_CHECK(eBeginFwUpd(TEST_IMAGE_SIZE, ulGetImageCrc(), &ulNextOfs) == FWUPD_OK, "begin failed");
+  TEST_CHECK(ulNextOfs == 0, "new session starts at %u", ulNextOfs);
+
+  /* Reset after 20 pages resumes behind 16 pages         */
+  for (uint32_t ulOfs = 0; ulOfs < 20 * HW_FLASH_PAGE_SIZE; ulOfs += HW_FLASH_PAGE_SIZE)
+  {
+    eWriteFwUpd(ulOfs, &aucImage[ulOfs], HW_FLASH_PAGE_SIZE);
+  }
+  vInitFwUpd();
+  TEST_CHECK(eGetState() == FWUPD_STATE_RECEIVING, "state %u after reset", eGetState());
+  TEST_CHECK(eBeginFwUpd(TEST_IMAGE_SIZE, ulGetImageCrc(), &ulNextOfs) == FWUPD_OK, "resume failed");
+  TEST_CHECK(ulNextOfs == 2 * TEST_CHECKPOINT_BYTES, "resumed at %u", ulNextOfs);
+  TEST_CHECK(eWriteFwUpd(0, aucImage, HW_FLASH_PAGE_SIZE) == FWUPD_ERR_ARG, "out-of-order page accepted");
+
+  TEST_CHECK(bSendImage(ulNextOfs), "remaining pages rejected");
+  TEST_CHECK(eGetState() == FWUPD_STATE_COMPLETE, "state %u after last page", eGetState());
+  TEST_CHECK(bIsAreaEqual(TEST_STAGING_OFFSET, aucImage), "staged image differs");
+
+  /* Completed transfer is resumed at its end             */
+  vInitFwUpd();
+  TEST_CHECK(eBeginFwUpd(TEST_IMAGE_SIZE, ulGetImageCrc(), &ulNextOfs) == FWUPD_OK, "resume failed");
+  TEST_CHECK(ulNextOfs == TEST_IMAGE_SIZE, "complete session resumed at %u", ulNextOfs);
+
+  /* Another image starts a new session                   */
+  TEST_CHECK(eBeginFwUpd(TEST_IMAGE_SIZE, ulGetImageCrc() + 1, &ulNextOfs) == FWUPD_OK, "begin failed");
+  TEST_CHECK(ulNextOfs == 0, "other image resumed at %u", ulNextOfs);
+
+  SimFlashStatsTypeDef sStats;
+  vSimFlashGetStats(&sStats);
+  TEST_CHECK(sStats.ulViolations == 0, "%u flash violations", sStats.ulViolations);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Power loss during any flash operation of a transfer
+ *
+ * After the reset, the transfer resumes at a checkpoint not behind the page
+ * being written at the power loss, with all data below it staged, and
+ * completes. That page is complete if only its checkpoint was interrupted.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestTransferPowerFail(void)
+{
+  for (int iFailAt = 0; ; ++iFailAt)
+  {
+    vSetupFlash();
+    uint32_t ulNextOfs, ulSent;
+    eBeginFwUpd(TEST_IMAGE_SIZE, ulGetImageCrc(), &ulNextOfs);
+    if (!bSendUntilPowerFail(iFailAt, &ulSent)) break;
+
+    vInitFwUpd();
+    TEST_CHECK(eBeginFwUpd(TEST_IMAGE_SIZE, ulGetImageCrc(), &ulNextOfs) == FWUPD_OK, "fail at %d: resume failed", iFailAt);
+    TEST_CHECK(ulNextOfs <= ulSent + HW_FLASH_PAGE_SIZE, "fail at %d: resumed at %u, page %u written",
+      iFailAt, ulNextOfs, ulSent);
+    TEST_CHECK((ulNextOfs % TEST_CHECKPOINT_BYTES == 0) || (ulNextOfs == TEST_IMAGE_SIZE),
+      "fail at %d: resumed at %u", iFailAt, ulNextOfs);
+    TEST_CHECK(memcmp(&aucSimFlash[TEST_STAGING_OFFSET], aucImage, ulNextOfs) == 0,
+      "fail at %d: staged data below %u differs", iFailAt, ulNextOfs);
+    TEST_CHECK(bSendImage(ulNextOfs) && (eCommitFwUpd() == FWUPD_OK), "fail at %d: transfer not completed", iFailAt);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Commit verifies the staged image and schedules the installation
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestCommit(void)
+{
+  uint32_t ulNextOfs;
+
+  /* Incomplete transfer                                  */
+  vSetupFlash();
+  TEST_CHECK(eCommitFwUpd() == FWUPD_ERR_STATE, "commit without session accepted");
+  eBeginFwUpd(TEST_IMAGE_SIZE, ulGetImageCrc(), &ulNextOfs);
+  eWriteFwUpd(0, aucImage, HW_FLASH_PAGE_SIZE);
+  TEST_CHECK(eCommitFwUpd() == FWUPD_ERR_STATE, "incomplete image committed");
+
+  /* Image not matching the session CRC                   */
+  vSetupFlash();
+  eBeginFwUpd(TEST_IMAGE_SIZE, ulGetImageCrc() ^ 1, &ulNextOfs);
+  bSendImage(0);
+  TEST_CHECK(eCommitFwUpd() == FWUPD_ERR_IMAGE, "image with wrong CRC committed");
+
+  /* Trailer not covering the image                       */
+  vBuildImage(aucImage, 1, false);
+  vSetupFlash();
+  eBeginFwUpd(TEST_IMAGE_SIZE, ulGetImageCrc(), &ulNextOfs);
+  bSendImage(0);
+  TEST_CHECK(eCommitFwUpd() == FWUPD_ERR_IMAGE, "image with invalid trailer committed");
+  TEST_CHECK(eGetState() == FWUPD_STATE_COMPLETE, "state %u after failed commit", eGetState());
+  vBuildImage(aucImage, 1, true);
+
+  /* Valid image: no new session until the reset          */
+  vSetupFlash();
+  TEST_CHECK(bStageImage(), "valid image not committed");
+  TEST_CHECK(eGetState() == FWUPD_STATE_INSTALLING, "state %u after commit", eGetState());
+  TEST_CHECK(eBeginFwUpd(TEST_IMAGE_SIZE, ulGetImageCrc(), &ulNextOfs) == FWUPD_ERR_STATE, "begin accepted after commit");
+  bool bReset = false;
+  if (setjmp(sSystemReset) == 0) vPollFwUpd();
+  else bReset = true;
+  TEST_CHECK(bReset, "no reset into the installer");
+  TEST_CHECK(bIsAreaEqual(TEST_APP_OFFSET, aucOldImage), "application changed before the reset");
+}
+
+/*!****************************************************************************
+ * @brief
+ * Installer copies only differing pages, and the application sets the
+ * session to idle
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestInstall(void)
+{
+  /* Old image shares every third page with the new one   */
+  uint8_t aucShared[TEST_IMAGE_SIZE];
+  memcpy(aucShared, aucOldImage, TEST_IMAGE_SIZE);
+  unsigned uDiffering = 0;
+  for (unsigned i = 0; i < TEST_IMAGE_PAGES; ++i)
+  {
+    unsigned uLen = (i == TEST_IMAGE_PAGES - 1) ? TEST_IMAGE_SIZE - i * HW_FLASH_PAGE_SIZE : HW_FLASH_PAGE_SIZE;
+    if (i % 3 == 0) memcpy(&aucShared[i * HW_FLASH_PAGE_SIZE], &aucImage[i * HW_FLASH_PAGE_SIZE], uLen);
+    else uDiffering++;
+  }
+  vSimFlashReset();
+  memcpy(&aucSimFlash[TEST_APP_OFFSET], aucShared, TEST_IMAGE_SIZE);
+  vInitFwUpd();
+  TEST_CHECK(bStageImage(), "image not committed");
+
+  SimFlashStatsTypeDef sBefore, sAfter;
+  vSimFlashGetStats(&sBefore);
+  TEST_CHECK(bRunInstaller(-1), "application not started");
+  vSimFlashGetStats(&sAfter);
+  TEST_CHECK(bIsAreaEqual(TEST_APP_OFFSET, aucImage), "installed image differs");
+  TEST_CHECK(sAfter.ulErases - sBefore.ulErases == uDiffering, "%u pages erased, %u differ",
+    sAfter.ulErases - sBefore.ulErases, uDiffering);
+
+  /* The application has been reached                     */
+  vInitFwUpd();
+  TEST_CHECK(eGetState() == FWUPD_STATE_IDLE, "state %u after installation", eGetState());
+  vSimFlashGetStats(&sBefore);
+  TEST_CHECK(bRunInstaller(-1), "application not started");
+  vSimFlashGetStats(&sAfter);
+  TEST_CHECK(sAfter.ulErases == sBefore.ulErases, "flash written without pending installation");
+}
+
+/*!****************************************************************************
+ * @brief
+ * Power loss during any flash operation of the installer
+ *
+ * The installer completes the copy after the reset, skipping the pages
+ * copied before the power loss.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestInstallPowerFail(void)
+{
+  vSetupFlash();
+  TEST_CHECK(bStageImage(), "image not committed");
+  memcpy(aucFlashCopy, aucSimFlash, SIM_FLASH_SIZE);
+
+  for (int iFailAt = 0; ; ++iFailAt)
+  {
+    memcpy(aucSimFlash, aucFlashCopy, SIM_FLASH_SIZE);
+    SimFlashStatsTypeDef sStart, sFailed, sDone;
+    vSimFlashGetStats(&sStart);
+    if (bRunInstaller(iFailAt))
+    {
+      TEST_CHECK(iFailAt == 2 * TEST_IMAGE_PAGES, "installer finished after %d operations", iFailAt);
+      break;
+    }
+
+    vSimFlashGetStats(&sFailed);
+    TEST_CHECK(bRunInstaller(-1), "fail at %d: application not started", iFailAt);
+    vSimFlashGetStats(&sDone);
+    TEST_CHECK(bIsAreaEqual(TEST_APP_OFFSET, aucImage), "fail at %d: installed image differs", iFailAt);
+
+    /* Pages programmed before the power loss are skipped,
+     * except for the one interrupted while programming   */
+    uint32_t ulCopied = sFailed.ulPrograms - sStart.ulPrograms;
+    uint32_t ulRecopied = sDone.ulErases - sFailed.ulErases;
+    TEST_CHECK(ulCopied + ulRecopied <= TEST_IMAGE_PAGES + 1, "fail at %d: %u pages copied, then %u",
+      iFailAt, ulCopied, ulRecopied);
+
+    vInitFwUpd();
+    TEST_CHECK(eGetState() == FWUPD_STATE_IDLE, "fail at %d: state %u after installation", iFailAt, eGetState());
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Installer gives up a page which never verifies
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestInstallFailed(void)
+{
+  vSetupFlash();
+  TEST_CHECK(bStageImage(), "image not committed");
+
+  uint32_t ulBadOffset = TEST_APP_OFFSET + 5 * HW_FLASH_PAGE_SIZE;
+  vSimFlashSetBadPage(ulBadOffset);
+  TEST_CHECK(bRunInstaller(-1), "application not started");
+  TEST_CHECK(uSimFlashPageErases(ulBadOffset) == INSTALLER_MAX_ATTEMPTS, "bad page erased %u times",
+    uSimFlashPageErases(ulBadOffset));
+
+  vInitFwUpd();
+  TEST_CHECK(eGetState() == FWUPD_STATE_FAILED, "state %u after failed installation", eGetState());
+  unsigned uErases = uSimFlashPageErases(ulBadOffset);
+  TEST_CHECK(bRunInstaller(-1), "application not started");
+  TEST_CHECK(uSimFlashPageErases(ulBadOffset) == uErases, "failed installation repeated");
+
+  /* A new update may be sent                             */
+  vSimFlashSetBadPage(UINT32_MAX);
+  TEST_CHECK(bStageImage(), "image not committed after failed installation");
+  TEST_CHECK(bRunInstaller(-1), "application not started");
+  TEST_CHECK(bIsAreaEqual(TEST_APP_OFFSET, aucImage), "installed image differs");
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Run firmware update tests
+ *
+ * @return  (int)  Exit status
+ * @date  18.10.2026
+ ******************************************************************************/
+int main(void)
+{
+  vBuildImage(aucImage, 1, true);
+  vBuildImage(aucOldImage, 2, true);
+
+  TEST_RUN(vTestResume);
+  TEST_RUN(vTestTransferPowerFail);
+  TEST_RUN(vTestCommit);
+  TEST_RUN(vTestInstall);
+  TEST_RUN(vTestInstallPowerFail);
+  TEST_RUN(vTestInstallFailed);
+  return TEST_RESULT();
+}
@@ -0,0 +1,329 @@
+/*!****************************************************************************
+ * @file
+ * test_pool.c
+ *
+ * @brief
+ * Host tests of the fixed-block memory pools and the heap replacement
+ * (pool.c)
+ *
+ * pool.c is built with its malloc(), free(), calloc() and realloc() renamed
+ * (see CMakeLists.txt), so that the host C library keeps its own heap; the
+ * renamed functions and newlib's reentrant variants are called directly.
+ *
+ * Covers size class selection, exhaustion and fall-through to larger
+ * classes, rejected releases, and the _realloc_r() and _calloc_r() corner
+ * cases.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <reent.h>
+#include "pool.h"
+#include "test.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Total number of pool blocks                                        */
+#define TEST_NUM_BLOCKS               (POOL0_NUM_BLOCKS + POOL1_NUM_BLOCKS + POOL2_NUM_BLOCKS + POOL3_NUM_BLOCKS)
+
+
+/*- Global variables ---------------------------------------------------------*/
+/*! Reentrancy structure passed to pool.c as _REENT                           */
+struct _reent sSimReent;
+
+
+/*- Exported functions -------------------------------------------------------*/
+/*! Heap replacement of pool.c, renamed for the host build
+ *  @{                                                                        */
+void* pvSimMalloc(size_t uSize);
+void vSimFree(void* pvBlock);
+void* pvSimCalloc(size_t uNum, size_t uSize);
+void* pvSimRealloc(void* pvBlock, size_t uSize);
+void* _malloc_r(struct _reent* psReent, size_t uSize);
+void _free_r(struct _reent* psReent, void* pvBlock);
+void* _calloc_r(struct _reent* psReent, size_t uNum, size_t uSize);
+void* _realloc_r(struct _reent* psReent, void* pvBlock, size_t uSize);
+/*! @}                                                                        */
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Block sizes of the size classes                                           */
+static const unsigned auBlockSizes[POOL_NUM_CLASSES] =
+  { POOL0_BLOCK_SIZE, POOL1_BLOCK_SIZE, POOL2_BLOCK_SIZE, POOL3_BLOCK_SIZE };
+
+/*! Blocks allocated by a test                                                */
+static void* apvBlocks[TEST_NUM_BLOCKS + 1];
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Get number of blocks in use over all size classes
+ *
+ * @return  (unsigned)  Used blocks
+ * @date  18.10.2026
+ ******************************************************************************/
+static unsigned uUsedBlocks(void)
+{
+  unsigned uUsed = 0;
+  for (unsigned i = 0; i < POOL_NUM_CLASSES; ++i)
+  {
+    PoolStatsTypeDef sStats;
+    vGetPoolStats(i, &sStats);
+    uUsed += sStats.uiUsed;
+  }
+  return uUsed;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get number of rejected releases over all size classes
+ *
+ * @return  (uint32_t)  Bad frees
+ * @date  18.10.2026
+ ******************************************************************************/
+static uint32_t ulBadFrees(void)
+{
+  uint32_t ulBad = 0;
+  for (unsigned i = 0; i < POOL_NUM_CLASSES; ++i)
+  {
+    PoolStatsTypeDef sStats;
+    vGetPoolStats(i, &sStats);
+    ulBad += sStats.ulBadFrees;
+  }
+  return ulBad;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Allocate all blocks of all pools and check that they are distinct and
+ * do not overlap
+ *
+ * @return  (unsigned)  Number of blocks allocated
+ * @date  18.10.2026
+ ******************************************************************************/
+static unsigned uAllocAll(void)
+{
+  unsigned uCount = 0;
+  for (unsigned i = 0; i < POOL_NUM_CLASSES; ++i)
+  {
+    void* pvBlock;
+    while ((uCount <= TEST_NUM_BLOCKS) && ((pvBlock = pvPoolAlloc(auBlockSizes[i])) != NULL))
+    {
+      apvBlocks[uCount++] = pvBlock;
+    }
+  }
+
+  unsigned uOverlaps = 0;
+  for (unsigned i = 0; i < uCount; ++i)
+  {
+    const uint8_t* pucA = apvBlocks[i];
+    for (unsigned j = i + 1; j < uCount; ++j)
+    {
+      const uint8_t* pucB = apvBlocks[j];
+      if ((pucA < pucB + uGetPoolBlockSize(pucB)) && (pucB < pucA + uGetPoolBlockSize(pucA))) uOverlaps++;
+    }
+  }
+  TEST_CHECK(uOverlaps == 0, "%u overlapping blocks", uOverlaps);
+  return uCount;
+}
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Requests are served from the smallest fitting class, and released blocks
+ * are reused
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestAllocFree(void)
+{
+  vInitPools();
+  unsigned uMisplaced = 0;
+  for (size_t uSize = 0; uSize <= POOL3_BLOCK_SIZE; ++uSize)
+  {
+    void* pvBlock = pvPoolAlloc(uSize);
+    unsigned uClass = 0;
+    while (uSize > auBlockSizes[uClass]) uClass++;
+    if ((pvBlock == NULL) || (uGetPoolBlockSize(pvBlock) != auBlockSizes[uClass])) uMisplaced++;
+    else memset(pvBlock, 0xA5, uSize);
+    vPoolFree(pvBlock);
+  }
+  TEST_CHECK(uMisplaced == 0, "%u sizes not served from the smallest fitting class", uMisplaced);
+  TEST_CHECK(uUsedBlocks() == 0, "%u blocks still used", uUsedBlocks());
+  TEST_CHECK(pvPoolAlloc(POOL3_BLOCK_SIZE + 1) == NULL, "oversized request served");
+
+  void* pvFirst = pvPoolAlloc(1);
+  vPoolFree(pvFirst);
+  TEST_CHECK(pvPoolAlloc(1) == pvFirst, "released block not reused");
+  TEST_CHECK(uGetPoolBlockSize(&pvFirst) == 0, "block size of a non-pool address");
+
+  PoolStatsTypeDef sStats;
+  vGetPoolStats(0, &sStats);
+  TEST_CHECK((sStats.uiUsed == 1) && (sStats.uiPeak == 1), "class 0: %u used, peak %u", sStats.uiUsed, sStats.uiPeak);
+  TEST_CHECK(sStats.ulAllocs == POOL0_BLOCK_SIZE + 1 + 2, "class 0: %lu allocations", (unsigned long)sStats.ulAllocs);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Exhausted classes fall through to larger ones, until all pools are empty;
+ * releasing everything restores all blocks
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestExhaustion(void)
+{
+  vInitPools();
+  unsigned uSmall = 0;
+  void* pvBlock;
+  while ((uSmall <= TEST_NUM_BLOCKS) && ((pvBlock = pvPoolAlloc(1)) != NULL)) apvBlocks[uSmall++] = pvBlock;
+  TEST_CHECK(uSmall == TEST_NUM_BLOCKS, "%u one-byte blocks of %u", uSmall, TEST_NUM_BLOCKS);
+  TEST_CHECK(uGetPoolBlockSize(apvBlocks[POOL0_NUM_BLOCKS]) == POOL1_BLOCK_SIZE, "no fall-through to class 1");
+
+  PoolStatsTypeDef sStats;
+  vGetPoolStats(0, &sStats);
+  TEST_CHECK(sStats.ulFails == TEST_NUM_BLOCKS - POOL0_NUM_BLOCKS + 1, "class 0: %lu fails",
+    (unsigned long)sStats.ulFails);
+  vGetPoolStats(POOL_NUM_CLASSES - 1, &sStats);
+  TEST_CHECK(sStats.ulFails == 1, "class 3: %lu fails", (unsigned long)sStats.ulFails);
+
+  for (unsigned i = 0; i < uSmall; ++i) vPoolFree(apvBlocks[i]);
+  TEST_CHECK(uUsedBlocks() == 0, "%u blocks still used", uUsedBlocks());
+  TEST_CHECK(ulBadFrees() == 0, "%lu bad frees", (unsigned long)ulBadFrees());
+  TEST_CHECK(uAllocAll() == TEST_NUM_BLOCKS, "blocks lost after release");
+}
+
+/*!****************************************************************************
+ * @brief
+ * Double releases and releases of addresses inside a block are rejected and
+ * counted, and do not corrupt the free lists
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestBadFree(void)
+{
+  vInitPools();
+  uint8_t* pucA = pvPoolAlloc(POOL1_BLOCK_SIZE);
+  uint8_t* pucB = pvPoolAlloc(POOL1_BLOCK_SIZE);
+  int iLocal;
+
+  vPoolFree(pucA);
+  vPoolFree(pucA);
+  TEST_CHECK(ulBadFrees() == 1, "double free: %lu bad frees", (unsigned long)ulBadFrees());
+  vPoolFree(pucB + 4);
+  TEST_CHECK(ulBadFrees() == 2, "free inside a block: %lu bad frees", (unsigned long)ulBadFrees());
+  vPoolFree(pucB + POOL1_BLOCK_SIZE);
+  TEST_CHECK(ulBadFrees() == 3, "free of an unallocated block: %lu bad frees", (unsigned long)ulBadFrees());
+
+  /* Addresses outside the pools are ignored              */
+  vPoolFree(NULL);
+  vPoolFree(&iLocal);
+  TEST_CHECK(ulBadFrees() == 3, "non-pool free: %lu bad frees", (unsigned long)ulBadFrees());
+  TEST_CHECK(uUsedBlocks() == 1, "%u blocks used", uUsedBlocks());
+
+  vPoolFree(pucB);
+  TEST_CHECK(uUsedBlocks() == 0, "%u blocks used", uUsedBlocks());
+  TEST_CHECK(uAllocAll() == TEST_NUM_BLOCKS, "free lists corrupted by bad frees");
+}
+
+/*!****************************************************************************
+ * @brief
+ * _realloc_r(): NULL allocates, shrinking keeps the block, growing moves the
+ * contents and releases the old block, failing to grow keeps the old block
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestRealloc(void)
+{
+  vInitPools();
+  struct _reent sReent = { 0 };
+
+  uint8_t* pucBlock = _realloc_r(&sReent, NULL, 10);
+  TEST_CHECK((pucBlock != NULL) && (uGetPoolBlockSize(pucBlock) == POOL0_BLOCK_SIZE), "realloc(NULL) failed");
+  for (unsigned i = 0; i < POOL0_BLOCK_SIZE; ++i) pucBlock[i] = (uint8_t)i;
+  TEST_CHECK(_realloc_r(&sReent, pucBlock, 3) == pucBlock, "shrinking moved the block");
+  TEST_CHECK(_realloc_r(&sReent, pucBlock, POOL0_BLOCK_SIZE) == pucBlock, "realloc to block size moved the block");
+
+  uint8_t* pucGrown = _realloc_r(&sReent, pucBlock, POOL2_BLOCK_SIZE);
+  bool bKept = (pucGrown != NULL);
+  for (unsigned i = 0; bKept && (i < POOL0_BLOCK_SIZE); ++i) bKept = (pucGrown[i] == (uint8_t)i);
+  TEST_CHECK(bKept, "contents lost by growing");
+  TEST_CHECK(uUsedBlocks() == 1, "%u blocks used after growing", uUsedBlocks());
+
+  /* No larger block left: old block stays valid          */
+  void* pvLarge = _malloc_r(&sReent, POOL3_BLOCK_SIZE);
+  TEST_CHECK(pvLarge != NULL, "largest block not available");
+  TEST_CHECK(_realloc_r(&sReent, pucGrown, POOL3_BLOCK_SIZE) == NULL, "grown into a used block");
+  TEST_CHECK(sReent._errno == ENOMEM, "errno %d after failed realloc", sReent._errno);
+  TEST_CHECK((uGetPoolBlockSize(pucGrown) == POOL2_BLOCK_SIZE) && (pucGrown[1] == 1), "old block lost");
+  TEST_CHECK(uUsedBlocks() == 2, "%u blocks used after failed realloc", uUsedBlocks());
+
+  _free_r(&sReent, pucGrown);
+  vSimFree(pvLarge);
+  TEST_CHECK(uUsedBlocks() == 0, "%u blocks used", uUsedBlocks());
+
+  /* Standard variants use _REENT                         */
+  sSimReent._errno = 0;
+  void* pvBlock = pvSimRealloc(NULL, POOL3_BLOCK_SIZE + 1);
+  TEST_CHECK((pvBlock == NULL) && (sSimReent._errno == ENOMEM), "oversized realloc: %p, errno %d", pvBlock,
+    sSimReent._errno);
+  pvBlock = pvSimMalloc(1);
+  TEST_CHECK(pvSimRealloc(pvBlock, POOL1_BLOCK_SIZE) != pvBlock, "block not moved to a larger class");
+}
+
+/*!****************************************************************************
+ * @brief
+ * _calloc_r(): zeroed blocks, and a size overflow fails with ENOMEM instead of
+ * allocating a truncated size
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestCalloc(void)
+{
+  vInitPools();
+  struct _reent sReent = { 0 };
+
+  uint8_t* pucBlock = pvPoolAlloc(POOL1_BLOCK_SIZE);
+  memset(pucBlock, 0xFF, POOL1_BLOCK_SIZE);
+  vPoolFree(pucBlock);
+  uint8_t* pucZero = _calloc_r(&sReent, 5, 12);
+  bool bZero = (pucZero == pucBlock);
+  for (unsigned i = 0; bZero && (i < 5 * 12); ++i) bZero = (pucZero[i] == 0);
+  TEST_CHECK(bZero, "calloc block not zeroed");
+
+  /* Product wraps to a small size                         */
+  size_t uHalf = SIZE_MAX / 2 + 1;
+  TEST_CHECK(_calloc_r(&sReent, 2, uHalf) == NULL, "overflowing calloc served");
+  TEST_CHECK(sReent._errno == ENOMEM, "errno %d after overflowing calloc", sReent._errno);
+  sReent._errno = 0;
+  TEST_CHECK(_calloc_r(&sReent, uHalf + 8, 2) == NULL, "overflowing calloc served");
+  TEST_CHECK(sReent._errno == ENOMEM, "errno %d after overflowing calloc", sReent._errno);
+  TEST_CHECK(uUsedBlocks() == 1, "%u blocks used", uUsedBlocks());
+
+  TEST_CHECK(_calloc_r(&sReent, 0, uHalf) != NULL, "zero-sized calloc failed");
+  TEST_CHECK(pvSimCalloc(POOL3_BLOCK_SIZE, 2) == NULL, "calloc larger than any block served");
+}
+
+
+/*!****************************************************************************
+ * @brief
+ * Run pool tests
+ *
+ * @return  (int)  Exit status
+ * @date  18.10.2026
+ ******************************************************************************/
+int main(void)
+{
+  TEST_RUN(vTestAllocFree);
+  TEST_RUN(vTestExhaustion);
+  TEST_RUN(vTestBadFree);
+  TEST_RUN(vTestRealloc);
+  TEST_RUN(vTestCalloc);
+  return TEST_RESULT();
+}
@@ -0,0 +1,430 @@
+/*!****************************************************************************
+ * @file
+ * test_usart.c
+ *
+ * @brief
+ * Host tests of the USART driver (hw_usart.c) on simulated serial lines
+ *
+ * USART1 transmits by DMA to a peer which echoes every frame at the nominal
+ * baud rate; the echo is received by the circular RX DMA. The bus clocks are
+ * set by the test, and clock changes are passed to the driver's notifier as
+ * bHW_SetClockConfig() would.
+ *
+ * Covers loopback throughput and error rate at the supported rates, the
+ * error rate against a peer off by more than HW_USART_BAUD_MAX_ERROR, and the
+ * baud rate after clock changes, including the fallback to
+ * HW_USART_BAUD_RATE. Built with USE_USART2 and USE_USART3, all three
+ * instances also run at once, USART3 transmitting by interrupt.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+
+/*- Header files -------------------------------------------------------------*/
+#include <stdbool.h>
+#include <string.h>
+#include "hw_clk.h"
+#include "hw_usart.h"
+#include "sim_usart.h"
+#include "test.h"
+
+
+/*- Macros -------------------------------------------------------------------*/
+/*! @brief Bytes sent per loopback run                                        */
+#define TEST_LEN                      8192
+
+/*! @brief Bytes per DMA block                                                */
+#define TEST_BLOCK                    1024
+
+/*! @brief Simulation step of the polling loop in us                          */
+#define TEST_STEP_US                  5
+
+
+/*- Private variables --------------------------------------------------------*/
+/*! Bus clocks                                                                */
+static HwClkFreqTypeDef sFreq;
+
+/*! Clock change notifier of the driver                                       */
+static HwClkNotifierTypeDef pvNotifier;
+
+/*! Transmit and receive data                                                 */
+static uint8_t aucTx[TEST_LEN], aucRx[TEST_LEN];
+
+
+/*- Simulated clock module ---------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Register clock change notifier (one)
+ *
+ * @param[in] pvNew       Notifier
+ * @return  (bool)  true
+ * @date  18.10.2026
+ ******************************************************************************/
+bool bHW_RegisterClockNotifier(HwClkNotifierTypeDef pvNew)
+{
+  pvNotifier = pvNew;
+  return true;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Get bus clock frequencies
+ *
+ * @param[out] *psFreq    Frequencies
+ * @date  18.10.2026
+ ******************************************************************************/
+void vHW_GetClockFreq(HwClkFreqTypeDef* psFreq)
+{
+  *psFreq = sFreq;
+}
+
+
+/*- Private functions --------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Set bus clocks (SYSCLK = HCLK = PCLK2, PCLK1 at most 36 MHz) and notify
+ * the driver
+ *
+ * @param[in] ulSysclk    SYSCLK in Hz
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vSetClock(uint32_t ulSysclk)
+{
+  sFreq.ulSysclk = sFreq.ulHclk = sFreq.ulPclk2 = ulSysclk;
+  sFreq.ulPclk1 = (ulSysclk > 36000000) ? ulSysclk / 2 : ulSysclk;
+  if (pvNotifier != NULL) pvNotifier(&sFreq);
+}
+
+/*!****************************************************************************
+ * @brief
+ * Reset lines and driver at 72 MHz
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vSetup(void)
+{
+  vSimUsartReset();
+  pvNotifier = NULL;
+  vSetClock(72000000);
+  vInitHW_USART();
+  for (unsigned i = 0; i < TEST_LEN; ++i) aucTx[i] = (uint8_t)(i * 7 + (i >> 8));
+}
+
+/*!****************************************************************************
+ * @brief
+ * Send TEST_LEN bytes through the peer and back
+ *
+ * @param[out] *pulBytesPerSec  Throughput from the start of the transmission
+ *                              to the last byte received
+ * @return  (unsigned)  Bytes received within the time limit
+ * @date  18.10.2026
+ ******************************************************************************/
+static unsigned uLoopback(uint32_t* pulBytesPerSec)
+{
+  /* Time limit: twice the transfer time at the rate set  */
+  uint64_t ullLimit = 2ULL * TEST_LEN * 10 * 1000000000ULL / ulHW_USART_GetBaudRate(HW_USART1);
+  uint64_t ullStart = ullSimUsartTimeNs(), ullLast = ullStart;
+  unsigned uSent = 0, uRecv = 0;
+  memset(aucRx, 0, sizeof(aucRx));
+
+  while ((uRecv < TEST_LEN) && (ullSimUsartTimeNs() - ullStart < ullLimit))
+  {
+    if ((uSent < TEST_LEN) && !bHW_USART_IsTxBusy(HW_USART1))
+    {
+      vHW_USART_StartTx(HW_USART1, &aucTx[uSent], TEST_BLOCK);
+      uSent += TEST_BLOCK;
+    }
+    vSimUsartRun(TEST_STEP_US);
+    unsigned uLen = uHW_USART_Read(HW_USART1, &aucRx[uRecv], TEST_LEN - uRecv);
+    if (uLen > 0) ullLast = ullSimUsartTimeNs();
+    uRecv += uLen;
+  }
+  *pulBytesPerSec = (uint32_t)((uint64_t)uRecv * 1000000000ULL / (ullLast - ullStart + 1));
+  return uRecv;
+}
+
+/*!****************************************************************************
+ * @brief
+ * Count bytes received wrong
+ *
+ * @param[in] uLen        Bytes received
+ * @return  (unsigned)  Number of differing bytes
+ * @date  18.10.2026
+ ******************************************************************************/
+static unsigned uErrors(unsigned uLen)
+{
+  unsigned uCount = 0;
+  for (unsigned i = 0; i < uLen; ++i)
+  {
+    if (aucRx[i] != aucTx[i]) uCount++;
+  }
+  return uCount;
+}
+
+
+#if defined(USE_USART2) && defined(USE_USART3)
+/*!****************************************************************************
+ * @brief
+ * Run all instances at once: block transmission where not busy, and reads
+ * of all RX buffers every simulation step
+ *
+ * @param[in] *pucTx      Transmit data, TEST_LEN bytes per instance
+ * @param[out] *pucRx     Receive data, TEST_LEN bytes per instance
+ * @param[in] *puLen      Bytes to send per instance
+ * @param[out] *puRecv    Bytes received per instance
+ * @param[out] *pullEnd   Time of the last byte received per instance
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vRunAll(const uint8_t* pucTx, uint8_t* pucRx, const unsigned* puLen, unsigned* puRecv,
+  uint64_t* pullEnd)
+{
+  unsigned auSent[HW_USART_NUM] = { 0 };
+  uint64_t ullStart = ullSimUsartTimeNs();
+  bool bDone = false;
+  memset(puRecv, 0, HW_USART_NUM * sizeof(unsigned));
+
+  while (!bDone && (ullSimUsartTimeNs() - ullStart < 1000000000ULL))
+  {
+    bDone = true;
+    for (unsigned i = 0; i < HW_USART_NUM; ++i)
+    {
+      if ((auSent[i] < puLen[i]) && !bHW_USART_IsTxBusy(i))
+      {
+        vHW_USART_StartTx(i, &pucTx[i * TEST_LEN + auSent[i]], TEST_BLOCK);
+        auSent[i] += TEST_BLOCK;
+      }
+    }
+    vSimUsartRun(TEST_STEP_US);
+    for (unsigned i = 0; i < HW_USART_NUM; ++i)
+    {
+      unsigned uLen = uHW_USART_Read(i, &pucRx[i * TEST_LEN + puRecv[i]], puLen[i] - puRecv[i]);
+      if (uLen > 0) pullEnd[i] = ullSimUsartTimeNs() - ullStart;
+      puRecv[i] += uLen;
+      bDone = bDone && (puRecv[i] == puLen[i]);
+    }
+  }
+}
+#endif /* USE_USART2 && USE_USART3 */
+
+
+/*- Test cases ---------------------------------------------------------------*/
+/*!****************************************************************************
+ * @brief
+ * Loopback at the supported rates: no errors, and the line is kept busy
+ * across DMA blocks
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestLoopback(void)
+{
+  static const uint32_t aulRates[] = { 115200, 460800, 921600, 2000000 };
+  for (unsigned k = 0; k < sizeof(aulRates) / sizeof(aulRates[0]); ++k)
+  {
+    uint32_t ulBaud = aulRates[k];
+    vSetup();
+    vHW_USART_SetBaudRate(HW_USART1, ulBaud);
+    vSimUsartSetPeer(HW_USART1, ulBaud);
+
+    HwUsartStatsTypeDef sStats;
+    vHW_USART_GetStats(HW_USART1, &sStats);
+    uint32_t ulBlocks = sStats.ulTxBlocks;
+    uint32_t ulRate;
+    unsigned uRecv = uLoopback(&ulRate);
+    vHW_USART_GetStats(HW_USART1, &sStats);
+    SimUsartStatsTypeDef sLine;
+    vSimUsartGetStats(HW_USART1, &sLine);
+
+    /* Line rate PCLK2/BRR, 10 bits per byte               */
+    uint32_t ulLineRate = sFreq.ulPclk2 / uiHW_USART_CalcBrr(sFreq.ulPclk2, ulBaud) / 10;
+    TEST_CHECK(uRecv == TEST_LEN, "%u baud: %u of %u bytes received", ulBaud, uRecv, TEST_LEN);
+    TEST_CHECK(uErrors(uRecv) == 0, "%u baud: %u bytes wrong", ulBaud, uErrors(uRecv));
+    TEST_CHECK((sLine.ulBadBytes == 0) && (sStats.ulLineErrors == 0), "%u baud: %u bad frames, %u line errors",
+      ulBaud, sLine.ulBadBytes, sStats.ulLineErrors);
+    TEST_CHECK(ulRate * 100 >= ulLineRate * 97, "%u baud: %u bytes/s of %u", ulBaud, ulRate, ulLineRate);
+    TEST_CHECK(sStats.ulTxBlocks - ulBlocks == TEST_LEN / TEST_BLOCK, "%u baud: %u blocks", ulBaud,
+      sStats.ulTxBlocks - ulBlocks);
+    printf("  %7u baud: %7u bytes/s (%u.%u %% of line rate), %u errors\n", ulBaud, ulRate,
+      (unsigned)((uint64_t)ulRate * 100 / ulLineRate), (unsigned)((uint64_t)ulRate * 1000 / ulLineRate % 10),
+      sLine.ulBadBytes);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Error rate against a peer whose rate deviates: none within
+ * HW_USART_BAUD_MAX_ERROR; beyond about 5 % many bytes are corrupted and
+ * framing errors are reported
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestRateMismatch(void)
+{
+  static const int32_t alPpm[] = { -HW_USART_BAUD_MAX_ERROR, HW_USART_BAUD_MAX_ERROR, -60000, 60000 };
+  for (unsigned k = 0; k < sizeof(alPpm) / sizeof(alPpm[0]); ++k)
+  {
+    vSetup();
+    vHW_USART_SetBaudRate(HW_USART1, 921600);
+    uint32_t ulActual = sFreq.ulPclk2 / uiHW_USART_CalcBrr(sFreq.ulPclk2, 921600);
+    vSimUsartSetPeer(HW_USART1, (uint32_t)((int64_t)ulActual * (1000000 + alPpm[k]) / 1000000));
+
+    HwUsartStatsTypeDef sStats;
+    vHW_USART_GetStats(HW_USART1, &sStats);
+    uint32_t ulLineErrors = sStats.ulLineErrors;
+    uint32_t ulRate;
+    unsigned uRecv = uLoopback(&ulRate);
+    vHW_USART_GetStats(HW_USART1, &sStats);
+    ulLineErrors = sStats.ulLineErrors - ulLineErrors;
+    unsigned uBad = uErrors(uRecv);
+    if (alPpm[k] == HW_USART_BAUD_MAX_ERROR || alPpm[k] == -HW_USART_BAUD_MAX_ERROR)
+    {
+      TEST_CHECK((uRecv == TEST_LEN) && (uBad == 0), "%d ppm: %u of %u bytes wrong", alPpm[k], uBad, uRecv);
+      TEST_CHECK(ulLineErrors == 0, "%d ppm: %u line errors", alPpm[k], ulLineErrors);
+    }
+    else
+    {
+      TEST_CHECK(uBad * 4 >= uRecv, "%d ppm: only %u of %u bytes wrong", alPpm[k], uBad, uRecv);
+      TEST_CHECK(ulLineErrors > 0, "%d ppm: framing errors not reported", alPpm[k]);
+    }
+    printf("  peer %+6d ppm: %u of %u bytes wrong, %u reads with line errors\n", alPpm[k], uBad, uRecv,
+      ulLineErrors);
+  }
+}
+
+/*!****************************************************************************
+ * @brief
+ * Clock changes: rates the new clock generates within HW_USART_BAUD_MAX_ERROR
+ * are kept, others fall back to HW_USART_BAUD_RATE
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestClockChange(void)
+{
+  static const struct
+  {
+    uint32_t ulBaud;                  /* Rate selected at 72 MHz              */
+    uint32_t ulSysclk;                /* New clock                            */
+    uint32_t ulExpected;              /* Rate after the change                */
+  } asCases[] = {
+    { 115200,  8000000, 115200 },     /* 0.6 % error at 8 MHz                 */
+    { 230400,  48000000, 230400 },    /* 0.2 % error                          */
+    { 460800,  8000000, HW_USART_BAUD_RATE }, /* 2.1 % error                  */
+    { 921600,  8000000, HW_USART_BAUD_RATE }, /* BRR 9, below minimum         */
+    { 2000000, 48000000, 2000000 },   /* Exact                                */
+  };
+
+  for (unsigned k = 0; k < sizeof(asCases) / sizeof(asCases[0]); ++k)
+  {
+    vSetup();
+    vHW_USART_SetBaudRate(HW_USART1, asCases[k].ulBaud);
+    vSetClock(asCases[k].ulSysclk);
+    uint32_t ulBaud = ulHW_USART_GetBaudRate(HW_USART1);
+    TEST_CHECK(ulBaud == asCases[k].ulExpected, "%u baud at %u Hz: %u baud selected", asCases[k].ulBaud,
+      asCases[k].ulSysclk, ulBaud);
+    TEST_CHECK(USART1->BRR == uiHW_USART_CalcBrr(asCases[k].ulSysclk, ulBaud), "%u baud at %u Hz: BRR %u",
+      asCases[k].ulBaud, asCases[k].ulSysclk, USART1->BRR);
+
+    /* Host follows to the fallback rate                  */
+    vSimUsartSetPeer(HW_USART1, ulBaud);
+    uint32_t ulRate;
+    unsigned uRecv = uLoopback(&ulRate);
+    TEST_CHECK((uRecv == TEST_LEN) && (uErrors(uRecv) == 0), "%u baud at %u Hz: %u of %u bytes wrong",
+      asCases[k].ulBaud, asCases[k].ulSysclk, uErrors(uRecv), uRecv);
+  }
+}
+
+
+#if defined(USE_USART2) && defined(USE_USART3)
+/*!****************************************************************************
+ * @brief
+ * All instances at once, at different rates and with different data: USART1
+ * and USART2 by DMA, USART3 by interrupt. Each one receives exactly its own
+ * data at its full line rate, and counts only its own traffic. A clock change
+ * then moves each instance to a valid rate on its own bus clock.
+ *
+ * @date  18.10.2026
+ ******************************************************************************/
+static void vTestConcurrent(void)
+{
+  static const uint32_t aulBaud[HW_USART_NUM] = { 921600, 460800, 230400 };
+  static const unsigned auLen[HW_USART_NUM] = { TEST_LEN, TEST_LEN / 2, TEST_LEN / 4 };
+  static uint8_t aucTxAll[HW_USART_NUM * TEST_LEN], aucRxAll[HW_USART_NUM * TEST_LEN];
+  unsigned auRecv[HW_USART_NUM];
+  uint64_t aullEnd[HW_USART_NUM] = { 0 };
+
+  vSetup();
+  for (unsigned i = 0; i < HW_USART_NUM; ++i)
+  {
+    vHW_USART_SetBaudRate(i, aulBaud[i]);
+    vSimUsartSetPeer(i, aulBaud[i]);
+    for (unsigned j = 0; j < TEST_LEN; ++j) aucTxAll[i * TEST_LEN + j] = (uint8_t)(j * (2 * i + 3) + i);
+  }
+  HwUsartStatsTypeDef asBefore[HW_USART_NUM];
+  for (unsigned i = 0; i < HW_USART_NUM; ++i) vHW_USART_GetStats(i, &asBefore[i]);
+  memset(aucRxAll, 0, sizeof(aucRxAll));
+
+  vRunAll(aucTxAll, aucRxAll, auLen, auRecv, aullEnd);
+
+  for (unsigned i = 0; i < HW_USART_NUM; ++i)
+  {
+    const char* pszName = pszHW_USART_GetName(i);
+    HwUsartStatsTypeDef sStats;
+    vHW_USART_GetStats(i, &sStats);
+    SimUsartStatsTypeDef sLine;
+    vSimUsartGetStats(i, &sLine);
+    uint32_t ulPclk = ulHW_USART_GetPclk(i);
+    uint32_t ulLineRate = ulPclk / uiHW_USART_CalcBrr(ulPclk, aulBaud[i]) / 10;
+    uint32_t ulRate = (uint32_t)((uint64_t)auRecv[i] * 1000000000ULL / (aullEnd[i] + 1));
+
+    TEST_CHECK(auRecv[i] == auLen[i], "%s: %u of %u bytes received", pszName, auRecv[i], auLen[i]);
+    TEST_CHECK(memcmp(&aucRxAll[i * TEST_LEN], &aucTxAll[i * TEST_LEN], auRecv[i]) == 0, "%s: data differs",
+      pszName);
+    TEST_CHECK((sLine.ulBadBytes == 0) && (sLine.ulOverruns == 0) &&
+      (sStats.ulLineErrors == asBefore[i].ulLineErrors), "%s: %u bad frames, %u overruns, %u line errors", pszName,
+      sLine.ulBadBytes, sLine.ulOverruns, sStats.ulLineErrors - asBefore[i].ulLineErrors);
+    TEST_CHECK((sStats.ulTxBytes - asBefore[i].ulTxBytes == auLen[i]) &&
+      (sStats.ulRxBytes - asBefore[i].ulRxBytes == auLen[i]), "%s: counted %u bytes sent, %u received", pszName,
+      sStats.ulTxBytes - asBefore[i].ulTxBytes, sStats.ulRxBytes - asBefore[i].ulRxBytes);
+    TEST_CHECK(ulRate * 100 >= ulLineRate * 97, "%s: %u bytes/s of %u", pszName, ulRate, ulLineRate);
+    printf("  %s %7u baud: %6u bytes/s (%u %% of line rate), RX peak %u of %u\n", pszName, aulBaud[i], ulRate,
+      (unsigned)((uint64_t)ulRate * 100 / ulLineRate), sStats.uRxPeak, uHW_USART_GetRxBufSize(i));
+  }
+
+  /* At 8 MHz: USART1 and USART2 rates unreachable, USART3
+   * within 0.8 %                                         */
+  static const uint32_t aulAfter[HW_USART_NUM] = { HW_USART_BAUD_RATE, HW_USART_BAUD_RATE, 230400 };
+  vSetClock(8000000);
+  for (unsigned i = 0; i < HW_USART_NUM; ++i)
+  {
+    uint32_t ulBaud = ulHW_USART_GetBaudRate(i);
+    TEST_CHECK(ulBaud == aulAfter[i], "%s at 8 MHz: %u baud", pszHW_USART_GetName(i), ulBaud);
+    vSimUsartSetPeer(i, ulBaud);
+  }
+  static const unsigned auShort[HW_USART_NUM] = { TEST_BLOCK, TEST_BLOCK, 2 * TEST_BLOCK };
+  vRunAll(aucTxAll, aucRxAll, auShort, auRecv, aullEnd);
+  for (unsigned i = 0; i < HW_USART_NUM; ++i)
+  {
+    TEST_CHECK((auRecv[i] == auShort[i]) &&
+      (memcmp(&aucRxAll[i * TEST_LEN], &aucTxAll[i * TEST_LEN], auRecv[i]) == 0), "%s at 8 MHz: %u bytes, data %s",
+      pszHW_USART_GetName(i), auRecv[i],
+      memcmp(&aucRxAll[i * TEST_LEN], &aucTxAll[i * TEST_LEN], auRecv[i]) ? "differs" : "ok");
+  }
+}
+#endif /* USE_USART2 && USE_USART3 */
+
+
+/*!****************************************************************************
+ * @brief
+ * Run USART tests
+ *
+ * @return  (int)  Exit status
+ * @date  18.10.2026
+ ******************************************************************************/
+int main(void)
+{
+  TEST_RUN(vTestLoopback);
+  TEST_RUN(vTestRateMismatch);
+  TEST_RUN(vTestClockChange);
+#if defined(USE_USART2) && defined(USE_USART3)
+  TEST_RUN(vTestConcurrent);
+#endif /* USE_USART2 && USE_USART3 */
+  return TEST_RESULT();
+}
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Compare benchmark results against a stored baseline.
+
+Reads the JSON result line printed by the firmware "b" shell command from a
+serial monitor capture and compares each case's ns/op against the baseline.
+Exits with status 1 if any case is slower than its baseline by more than the
+configured threshold.
+
+Usage:
+  bench_check.py capture.txt baseline.json [--threshold 10] [--update]
+"""
+
+import argparse
+import json
+import sys
+
+
+def load_results(path):
+    """Return the last benchmark result object found in a capture file."""
+    result = None
+    with open(path, encoding="ascii", errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith('{"hclk"'):
+                result = json.loads(line)
+    if result is None:
+        sys.exit(f"{path}: no benchmark result line found")
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="serial monitor capture")
+    parser.add_argument("baseline", help="baseline JSON file")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="default allowed slowdown in percent")
+    parser.add_argument("--update", action="store_true",
+                        help="store capture results as new baseline")
+    args = parser.parse_args()
+
+    current = load_results(args.capture)
+    if args.update:
+        with open(args.baseline, "w", encoding="ascii") as f:
+            json.dump(current, f, indent=2, sort_keys=True)
+            f.write("\n")
+        print(f"Baseline written to {args.baseline}")
+        return 0
+
+    with open(args.baseline, encoding="ascii") as f:
+        baseline = json.load(f)
+    if baseline.get("hclk") != current.get("hclk"):
+        print(f"warning: HCLK differs (baseline {baseline.get('hclk')}, "
+              f"current {current.get('hclk')})")
+
+    # Per-case thresholds may be stored in the baseline as "threshold"
+    failed = False
+    for name, base in sorted(baseline["results"].items()):
+        cur = current["results"].get(name)
+        if cur is None:
+            print(f"{name:14s} missing from capture")
+            failed = True
+            continue
+        limit = base.get("threshold", args.threshold)
+        delta = 100.0 * (cur["ns_op"] - base["ns_op"]) / max(base["ns_op"], 1)
+        status = "FAIL" if delta > limit else "ok"
+        failed |= status == "FAIL"
+        print(f"{name:14s} {base['ns_op']:10d} -> {cur['ns_op']:10d} ns/op "
+              f"{delta:+7.1f}% (limit {limit:.1f}%) {status}")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
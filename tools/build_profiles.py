@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Build all build profiles and report the application size against its area.
+
+Configures and builds the firmware in build-<profile>[-core] for every build
+profile (see cmake-variants.yaml), with all optional modules and without them
+(USE_BENCH, USE_SPECTRUM), and prints the size of the sealed application image
+and of the installer code next to their flash areas (see flash_layout.h):
+
+  build_profiles.py [--cross /opt/gcc-riscv-none-elf/bin/riscv-none-elf-]
+                    [-o size_report.txt]
+
+The linker fails a build whose application does not fit FLASH_APP_SIZE; such
+builds are listed as failed. Exits with a non-zero status if any build fails.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+TARGET = "hello-ch32v103"
+PROFILES = ["debug", "release-speed", "release-size", "release-ramfunc"]
+MODULES = {"all": ["-DUSE_BENCH=ON", "-DUSE_SPECTRUM=ON"],
+           "core": ["-DUSE_BENCH=OFF", "-DUSE_SPECTRUM=OFF"]}
+
+# Flash areas, see flash_layout.h
+INSTALLER_SIZE = 0x0800
+APP_SIZE = 0x6C00
+TRAILER_SIZE = 16
+
+
+def build(args, profile, modules):
+    build_dir = os.path.join(ROOT, "build-%s%s" % (profile, "" if modules == "all" else "-" + modules))
+    configure = ["cmake", "-S", ROOT, "-B", build_dir,
+                 "-DCMAKE_SYSTEM_NAME=Generic",
+                 "-DCMAKE_C_COMPILER=" + args.cross + "gcc",
+                 "-DCMAKE_ASM_COMPILER=" + args.cross + "gcc",
+                 "-DCMAKE_SIZE_UTIL=" + args.cross + "size",
+                 "-DBUILD_PROFILE=" + profile, *MODULES[modules]]
+    for command in (configure, ["cmake", "--build", build_dir]):
+        if subprocess.run(command, stdout=subprocess.DEVNULL).returncode != 0:
+            return None
+    return os.path.join(build_dir, TARGET + ".elf")
+
+
+def symbols(nm, elf):
+    """Return {name: (address, size)} of the ELF symbols."""
+    out = subprocess.run([nm, "-S", elf], check=True, capture_output=True, text=True).stdout
+    result = {}
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 4:
+            result[fields[3]] = (int(fields[0], 16), int(fields[1], 16))
+        elif len(fields) == 3:
+            result[fields[2]] = (int(fields[0], 16), 0)
+    return result
+
+
+def image_sizes(nm, elf):
+    """Return application image size and installer code size in bytes."""
+    syms = symbols(nm, elf)
+    app = syms["_image_trailer"][0] + TRAILER_SIZE - syms["_start"][0]
+    installer = max((addr + size for addr, size in syms.values() if addr < INSTALLER_SIZE), default=0)
+    return app, installer
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--cross", default="/opt/gcc-riscv-none-elf/bin/riscv-none-elf-",
+                        help="target toolchain prefix")
+    parser.add_argument("-o", "--output", help="also write report to file")
+    args = parser.parse_args()
+
+    lines = ["%-16s %-8s %10s %10s %8s" % ("Profile", "Modules", "App bytes", "App free", "Inst."),
+             "%-16s %-8s %10d %10s %8d" % ("(area)", "", APP_SIZE, "", INSTALLER_SIZE)]
+    failed = False
+    for profile in PROFILES:
+        for modules in MODULES:
+            elf = build(args, profile, modules)
+            if elf is None:
+                lines.append("%-16s %-8s %10s" % (profile, modules, "failed"))
+                failed = True
+                continue
+            app, installer = image_sizes(args.cross + "nm", elf)
+            lines.append("%-16s %-8s %10d %10d %8d" % (profile, modules, app, APP_SIZE - app, installer))
+
+    report = "\n".join(lines) + "\n"
+    print(report, end="")
+    if args.output:
+        with open(args.output, "w", encoding="ascii") as f:
+            f.write(report)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""Host codec for the firmware compression stage (see compress.c).
+
+Blocks on a channel with compression enabled start with the encoding used:
+
+  0  none   uncompressed data
+  1  delta  16-bit samples; first value and differences zig-zag mapped and
+            written as LEB128 varints
+  2  lz     LZSS, 256-byte window: a flag byte per group of 8 items, bit n
+            (LSB first) set for a match (distance - 1, length - 3), else a
+            literal byte
+
+The encoders mirror the firmware, including its match finder, so compression
+ratios of recorded traces can be compared without a device:
+
+  compress.py bench trace.bin [--block 128] [--samples]
+  compress.py bench log.txt --hex
+
+With --samples, the trace is treated as little-endian 16-bit samples; with
+--hex, as lines of hex records as written by log_export.py.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+MODE_NONE = 0
+MODE_DELTA = 1
+MODE_LZ = 2
+MODE_NAMES = {MODE_NONE: "none", MODE_DELTA: "delta", MODE_LZ: "lz"}
+
+LZ_MIN_MATCH = 3
+LZ_MAX_MATCH = LZ_MIN_MATCH + 255
+LZ_WINDOW = 256
+LZ_HASH_BITS = 6
+
+
+def encode_delta(data):
+    out = bytearray()
+    prev = 0
+    for (sample,) in struct.iter_unpack("<H", data[:len(data) & ~1]):
+        delta = sample - prev
+        prev = sample
+        value = ((delta << 1) ^ (delta >> 31)) & 0xFFFFFFFF
+        while True:
+            byte = value & 0x7F
+            value >>= 7
+            out.append(byte | 0x80 if value else byte)
+            if not value:
+                break
+    return bytes(out)
+
+
+def decode_delta(data):
+    out = bytearray()
+    prev = 0
+    value = shift = 0
+    for byte in data:
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte & 0x80:
+            continue
+        prev = (prev + ((value >> 1) ^ -(value & 1))) & 0xFFFF
+        out += struct.pack("<H", prev)
+        value = shift = 0
+    return bytes(out)
+
+
+def _hash(data, pos):
+    key = data[pos] | data[pos + 1] << 8 | data[pos + 2] << 16
+    return ((key * 2654435761) & 0xFFFFFFFF) >> (32 - LZ_HASH_BITS)
+
+
+def encode_lz(data):
+    head = [0] * (1 << LZ_HASH_BITS)
+    out = bytearray()
+    flag_pos = 0
+    item = 8
+    pos = 0
+    while pos < len(data):
+        if item == 8:
+            flag_pos = len(out)
+            out.append(0)
+            item = 0
+        length = dist = 0
+        if pos + LZ_MIN_MATCH <= len(data):
+            h = _hash(data, pos)
+            cand = head[h]
+            head[h] = pos + 1
+            if cand and pos - (cand - 1) <= LZ_WINDOW:
+                cand -= 1
+                limit = min(len(data) - pos, LZ_MAX_MATCH)
+                while length < limit and data[cand + length] == data[pos + length]:
+                    length += 1
+                dist = pos - cand
+        if length >= LZ_MIN_MATCH:
+            out[flag_pos] |= 1 << item
+            out += bytes([dist - 1, length - LZ_MIN_MATCH])
+            for i in range(1, length):
+                if pos + i + LZ_MIN_MATCH > len(data):
+                    break
+                head[_hash(data, pos + i)] = pos + i + 1
+            pos += length
+        else:
+            out.append(data[pos])
+            pos += 1
+        item += 1
+    return bytes(out)
+
+
+def decode_lz(data):
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        flags = data[pos]
+        pos += 1
+        for item in range(8):
+            if pos >= len(data):
+                break
+            if flags & (1 << item):
+                dist = data[pos] + 1
+                length = data[pos + 1] + LZ_MIN_MATCH
+                pos += 2
+                for _ in range(length):
+                    out.append(out[-dist])
+            else:
+                out.append(data[pos])
+                pos += 1
+    return bytes(out)
+
+
+ENCODERS = {MODE_DELTA: encode_delta, MODE_LZ: encode_lz}
+DECODERS = {MODE_NONE: bytes, MODE_DELTA: decode_delta, MODE_LZ: decode_lz}
+
+
+def encode_block(data, mode):
+    """Code a block as the firmware does, incl. fallback to uncompressed."""
+    if mode == MODE_NONE:
+        return bytes(data)
+    coded = ENCODERS[mode](data) if mode != MODE_DELTA or len(data) % 2 == 0 else data
+    if len(coded) >= len(data):
+        return bytes([MODE_NONE]) + bytes(data)
+    return bytes([mode]) + coded
+
+
+def decode_block(data):
+    """Decode a block from a channel with compression enabled."""
+    if not data:
+        return b""
+    if data[0] not in DECODERS:
+        raise ValueError("unknown encoding %d" % data[0])
+    return DECODERS[data[0]](data[1:])
+
+
+def load_trace(path, hex_records):
+    if hex_records:
+        with open(path) as f:
+            return b"".join(bytes.fromhex(line.split()[-1]) for line in f if line.strip())
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def run_bench(data, block, modes):
+    print("%d bytes, %d-byte blocks" % (len(data), block))
+    blocks = [data[ofs:ofs + block] for ofs in range(0, len(data), block)]
+    for mode in modes:
+        start = time.monotonic()
+        coded = [encode_block(b, mode) for b in blocks]
+        elapsed = time.monotonic() - start
+        if any(decode_block(c) != b for c, b in zip(coded, blocks)):
+            print("%-6s round trip FAILED" % MODE_NAMES[mode])
+            return 1
+        size = sum(len(c) for c in coded)
+        stored = sum(1 for c in coded if c[0] == MODE_NONE)
+        print("%-6s %8d bytes  ratio %5.1f %%  %d blocks stored  host encode %.1f ms" %
+              (MODE_NAMES[mode], size, 100.0 * size / max(len(data), 1), stored, elapsed * 1000))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    p = sub.add_parser("bench", help="compression ratio of a recorded trace")
+    p.add_argument("trace")
+    p.add_argument("--block", type=int, default=128, help="block size in bytes")
+    group = p.add_mutually_exclusive_group()
+    group.add_argument("--samples", action="store_true", help="trace of 16-bit samples")
+    group.add_argument("--hex", action="store_true", help="trace of hex records")
+    args = parser.parse_args()
+
+    data = load_trace(args.trace, args.hex)
+    modes = [MODE_DELTA, MODE_LZ] if args.samples else [MODE_LZ]
+    return run_bench(data, args.block, modes)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Symbolise a crash report printed by the firmware.
+
+Reads a serial monitor capture containing a "-- Crash report --" block (as
+printed at boot or by the "c" shell command), and resolves mepc, ra and all
+stack words that look like code addresses against the firmware ELF file using
+addr2line.
+
+Usage:
+  crash_decode.py capture.txt build/hello-ch32v103.elf \\
+                  [--addr2line riscv-none-elf-addr2line] [--flash-size 0x10000]
+"""
+
+import argparse
+import re
+import subprocess
+import sys
+
+CSR_RE = re.compile(r"^(mcause|mepc|mtval):\s+0x([0-9a-fA-F]{8})")
+REG_RE = re.compile(r"x(\d+)\s+(\w+)\s+0x([0-9a-fA-F]{8})")
+STACK_RE = re.compile(r"^([0-9a-fA-F]{8})((?:\s+[0-9a-fA-F]{8})+)\s*$")
+
+
+def parse_report(path):
+    """Return (csrs, regs, stack) of the last crash report in a capture."""
+    csrs, regs, stack = {}, {}, []
+    in_report = False
+    with open(path, encoding="ascii", errors="replace") as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("-- Crash report"):
+                csrs, regs, stack = {}, {}, []
+                in_report = True
+                continue
+            if not in_report:
+                continue
+            if line.startswith("--") or line.startswith(">"):
+                in_report = False
+                continue
+            match = CSR_RE.match(line)
+            if match:
+                csrs[match.group(1)] = int(match.group(2), 16)
+                continue
+            regs_in_line = REG_RE.findall(line)
+            if regs_in_line:
+                for _, name, value in regs_in_line:
+                    regs[name] = int(value, 16)
+                continue
+            match = STACK_RE.match(line)
+            if match:
+                base = int(match.group(1), 16)
+                for i, word in enumerate(match.group(2).split()):
+                    stack.append((base + 4 * i, int(word, 16)))
+    if not csrs:
+        sys.exit(f"{path}: no crash report found")
+    return csrs, regs, stack
+
+
+def symbolise(addr2line, elf, addresses):
+    """Return {address: "function at file:line"} using addr2line."""
+    if not addresses:
+        return {}
+    cmd = [addr2line, "-e", elf, "-f", "-p", "-C"] + [hex(a) for a in addresses]
+    output = subprocess.run(cmd, check=True, capture_output=True, text=True)
+    return dict(zip(addresses, output.stdout.splitlines()))
+
+
+def is_code(address, flash_size):
+    # Flash is mapped at 0x00000000 and aliased at 0x08000000
+    offset = address - 0x08000000 if address >= 0x08000000 else address
+    return 0 < offset < flash_size and address % 2 == 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="serial monitor capture")
+    parser.add_argument("elf", help="firmware ELF file of the crashed build")
+    parser.add_argument("--addr2line", default="riscv-none-elf-addr2line")
+    parser.add_argument("--flash-size", type=lambda x: int(x, 0),
+                        default=0x10000)
+    args = parser.parse_args()
+
+    csrs, regs, stack = parse_report(args.capture)
+    candidates = [csrs.get("mepc", 0), regs.get("ra", 0)]
+    candidates += [word for _, word in stack]
+    addresses = sorted({a for a in candidates if is_code(a, args.flash_size)})
+    symbols = symbolise(args.addr2line, args.elf, addresses)
+
+    print(f"mcause 0x{csrs.get('mcause', 0):08x}")
+    print(f"mtval  0x{csrs.get('mtval', 0):08x}")
+    for name, value in (("mepc", csrs.get("mepc", 0)), ("ra", regs.get("ra", 0))):
+        print(f"{name:6} 0x{value:08x}  {symbols.get(value, '')}")
+    print("Possible return addresses on stack:")
+    for address, word in stack:
+        if word in symbols:
+            print(f"  [{address:08x}] 0x{word:08x}  {symbols[word]}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
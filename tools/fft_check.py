@@ -0,0 +1,200 @@
+#!/usr/bin/env python3
+"""Accuracy check of the firmware Q15 FFT (see fft.c).
+
+Runs a bit-exact model of vFftQ15(), vApplyHannQ15(), vCalcMagnitudeQ15()
+and uFindPeaks() on test signals and compares the spectrum against a
+double-precision DFT of the same input, scaled by 1/N like the firmware:
+
+  fft_check.py [--log2n 9] [--signals sine,two-tone,noise,ripple]
+  fft_check.py --trace samples.bin [--log2n 9]
+
+A trace holds little-endian 16-bit ADC counts (e.g. from rpc_client.py
+adc-capture); each block is converted like the firmware spectrum module
+(mean removed, shifted up to the full Q15 range). The report gives signal-to-quantisation-noise
+ratio and maximum bin error per block and the error of the interpolated
+peak frequency. Cycles per block are measured on the target by the fft_q15
+benchmark cases and reported by the `s` shell command.
+"""
+
+import argparse
+import cmath
+import math
+import random
+import struct
+import sys
+
+MAX_LOG2 = 9
+MAX_POINTS = 1 << MAX_LOG2
+QUARTER = MAX_POINTS // 4
+PEAK_FRAC_ONE = 256
+
+SIN_TABLE = [min(32767, round(32768 * math.sin(2 * math.pi * i / MAX_POINTS)))
+             for i in range(QUARTER + 1)]
+
+
+def twiddle(index):
+    rem = index % QUARTER
+    quadrant = index // QUARTER
+    if quadrant == 0:
+        return SIN_TABLE[QUARTER - rem], SIN_TABLE[rem]
+    if quadrant == 1:
+        return -SIN_TABLE[rem], SIN_TABLE[QUARTER - rem]
+    if quadrant == 2:
+        return -SIN_TABLE[QUARTER - rem], -SIN_TABLE[rem]
+    return SIN_TABLE[rem], -SIN_TABLE[QUARTER - rem]
+
+
+def sat16(value):
+    return max(-32768, min(32767, value))
+
+
+def q15(value):
+    return (value + 0x4000) >> 15
+
+
+def bit_reverse(re, im):
+    n = len(re)
+    j = 0
+    for i in range(1, n):
+        bit = n >> 1
+        while j & bit:
+            j ^= bit
+            bit >>= 1
+        j ^= bit
+        if i < j:
+            re[i], re[j] = re[j], re[i]
+            im[i], im[j] = im[j], im[i]
+
+
+def butterfly4(re, im, i, h, t2, t1, t3):
+    ar, ai = re[i] + t2[0], im[i] + t2[1]
+    br, bi = re[i] - t2[0], im[i] - t2[1]
+    cr, ci = t1[0] + t3[0], t1[1] + t3[1]
+    dr, di = t1[0] - t3[0], t1[1] - t3[1]
+    re[i], im[i] = sat16((ar + cr + 2) >> 2), sat16((ai + ci + 2) >> 2)
+    re[i + h], im[i + h] = sat16((br + di + 2) >> 2), sat16((bi - dr + 2) >> 2)
+    re[i + 2 * h], im[i + 2 * h] = sat16((ar - cr + 2) >> 2), sat16((ai - ci + 2) >> 2)
+    re[i + 3 * h], im[i + 3 * h] = sat16((br - di + 2) >> 2), sat16((bi + dr + 2) >> 2)
+
+
+def fft_q15(re, im):
+    """In-place model of vFftQ15()."""
+    n = len(re)
+    log2n = n.bit_length() - 1
+    bit_reverse(re, im)
+    h = 1
+    if log2n & 1:
+        for i in range(0, n, 2):
+            r, m = re[i + 1], im[i + 1]
+            re[i + 1], im[i + 1] = (re[i] - r + 1) >> 1, (im[i] - m + 1) >> 1
+            re[i], im[i] = (re[i] + r + 1) >> 1, (im[i] + m + 1) >> 1
+        h = 2
+    while h < n:
+        step = MAX_POINTS // (4 * h)
+        for j in range(h):
+            w = [twiddle(j * step), twiddle(2 * j * step), twiddle(3 * j * step)]
+            for i in range(j, n, 4 * h):
+                t = []
+                for ofs, (c, s) in zip((h, 2 * h, 3 * h), (w[1], w[0], w[2])):
+                    xr, xi = re[i + ofs], im[i + ofs]
+                    t.append((xr, xi) if j == 0 else (q15(xr * c + xi * s), q15(xi * c - xr * s)))
+                butterfly4(re, im, i, h, t[0], t[1], t[2])
+        h *= 4
+
+
+def hann_q15(data):
+    step = MAX_POINTS // len(data)
+    for i, x in enumerate(data):
+        weight = (32767 - twiddle(i * step)[0]) >> 1
+        data[i] = q15(x * weight)
+
+
+def magnitude(re, im, count):
+    return [math.isqrt(re[k] * re[k] + im[k] * im[k]) for k in range(count)]
+
+
+def find_peaks(mag, max_peaks):
+    peaks = []
+    for k in range(1, len(mag) - 1):
+        a, b, c = mag[k - 1], mag[k], mag[k + 1]
+        if b <= a or b < c:
+            continue
+        num = (a - c) * (PEAK_FRAC_ONE // 2)
+        den = a - 2 * b + c
+        frac = int(num / den)  # C division truncates towards zero
+        peaks.append((b, k, frac))
+    peaks.sort(key=lambda p: -p[0])
+    return peaks[:max_peaks]
+
+
+def adc_block_to_q15(counts):
+    """Model of the spectrum module input stage, returns samples and shift."""
+    mean = sum(counts) // len(counts)
+    data = [c - mean for c in counts]
+    peak = max(max(data), -min(data))
+    shift = 0
+    while shift < 15 and (peak << (shift + 1)) <= 32767:
+        shift += 1
+    return [d << shift for d in data], shift
+
+
+def analyse(counts, label):
+    n = len(counts)
+    data, _ = adc_block_to_q15(counts)
+    hann_q15(data)
+    ref = [sum(data[t] * cmath.exp(-2j * math.pi * k * t / n) for t in range(n)) / n
+           for k in range(n // 2)]
+    re, im = list(data), [0] * n
+    fft_q15(re, im)
+    err = [abs(complex(re[k], im[k]) - ref[k]) for k in range(n // 2)]
+    sig = sum(abs(r) ** 2 for r in ref)
+    noise = sum(e * e for e in err)
+    sqnr = 10 * math.log10(sig / noise) if noise > 0 else float("inf")
+    peaks = find_peaks(magnitude(re, im, n // 2), 4)
+    ref_mag = [abs(r) for r in ref]
+    ref_peak = max(range(1, n // 2 - 1), key=lambda k: ref_mag[k])
+    line = "%-10s SQNR %6.1f dB  max bin error %5.2f LSB" % (label, sqnr, max(err))
+    if peaks:
+        mag, bin_, frac = peaks[0]
+        line += "  peak bin %7.2f (ref %d, |X| %d vs %.1f)" % (
+            bin_ + frac / PEAK_FRAC_ONE, ref_peak, mag, ref_mag[ref_peak])
+    print(line)
+    return sqnr
+
+
+def test_signals(n, names):
+    rnd = random.Random(1)
+    signals = {
+        "sine": lambda t: 2048 + 1500 * math.sin(2 * math.pi * 37.3 * t / n),
+        "two-tone": lambda t: 2048 + 1000 * math.sin(2 * math.pi * 20.5 * t / n)
+                              + 100 * math.sin(2 * math.pi * 91.2 * t / n),
+        "noise": lambda t: 2048 + rnd.gauss(0, 300),
+        "ripple": lambda t: 1490 + 4 * math.sin(2 * math.pi * 12.7 * t / n) + rnd.gauss(0, 0.5),
+    }
+    for name in names:
+        yield name, [max(0, min(4095, round(signals[name](t)))) for t in range(n)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--log2n", type=int, default=MAX_LOG2, choices=range(1, MAX_LOG2 + 1))
+    parser.add_argument("--signals", default="sine,two-tone,noise,ripple")
+    parser.add_argument("--trace", help="file of 16-bit ADC counts")
+    args = parser.parse_args()
+
+    n = 1 << args.log2n
+    if args.trace:
+        with open(args.trace, "rb") as f:
+            data = f.read()
+        counts = [c for (c,) in struct.iter_unpack("<H", data[:len(data) & ~1])]
+        blocks = [("block %d" % (i // n), counts[i:i + n]) for i in range(0, len(counts) - n + 1, n)]
+    else:
+        blocks = list(test_signals(n, args.signals.split(",")))
+    print("%d-point Q15 FFT, Hann window" % n)
+    for label, counts in blocks:
+        analyse(counts, label)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""Send a firmware image to the device over the binary RPC protocol.
+
+Reads the sealed HEX file (see image_trailer.py), extracts the image from its
+start address up to and including the image trailer, and transfers it in
+128-byte pages into the staging slot. Transfers interrupted by a reset or a
+lost connection are resumed from the last device checkpoint when the same
+image is sent again. After all data has been written, the device verifies the
+staged image, installs it and resets.
+
+Usage:
+  fw_update.py /dev/ttyACM0 build/hello-ch32v103.hex [--window 3] [--no-commit]
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import image_trailer
+from rpc_client import RpcClient, RpcError
+
+OP_FWUPD_BEGIN = 0x40
+OP_FWUPD_DATA = 0x41
+OP_FWUPD_STATUS = 0x42
+OP_FWUPD_COMMIT = 0x43
+
+PAGE_SIZE = 128
+MAX_RETRIES = 5
+
+
+def load_image(path):
+    """Return image bytes (start .. end of trailer) and the image CRC-32."""
+    memory = image_trailer.read_hex(path)
+    address, start, length, crc = image_trailer.find_trailer(memory)
+    if image_trailer.image_crc(memory, start, length) != crc:
+        raise ValueError("%s: image CRC does not match trailer" % path)
+    size = length + 16
+    image = bytes(memory.get(start + i, image_trailer.GAP_FILL) for i in range(size))
+    return image, image_trailer.crc32_words(image)
+
+
+def status(client):
+    state, size, crc, next_ofs = struct.unpack("<BIII", client.call(OP_FWUPD_STATUS))
+    return state, size, crc, next_ofs
+
+
+def send_image(client, image, offset):
+    """Send pages from offset; on error, resynchronise to the device offset."""
+    retries = 0
+    while offset < len(image):
+        batch = []
+        for ofs in range(offset, min(len(image), offset + PAGE_SIZE * client.window * 4), PAGE_SIZE):
+            batch.append((OP_FWUPD_DATA, struct.pack("<I", ofs) + image[ofs:ofs + PAGE_SIZE]))
+        try:
+            client.call_many(batch)
+            offset += sum(len(args) - 4 for _, args in batch)
+            retries = 0
+        except RpcError as err:
+            retries += 1
+            if retries > MAX_RETRIES:
+                raise
+            offset = status(client)[3]
+            print("\n%s, resuming at offset %d" % (err, offset))
+        print("\r%6d / %d bytes" % (offset, len(image)), end="", flush=True)
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="serial port, e.g. /dev/ttyACM0")
+    parser.add_argument("hex", help="sealed firmware HEX file")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--window", type=int, default=3,
+                        help="max. outstanding data requests (RX buffer holds 3 pages)")
+    parser.add_argument("--timeout", type=float, default=2.0, help="response timeout in s")
+    parser.add_argument("--no-commit", action="store_true", help="stage image without installing")
+    args = parser.parse_args()
+
+    try:
+        image, crc = load_image(args.hex)
+    except (OSError, ValueError) as err:
+        print("error: %s" % err, file=sys.stderr)
+        return 1
+    print("Image: %d bytes, CRC-32 %08X" % (len(image), crc))
+
+    client = RpcClient(args.port, args.baud, args.timeout, args.window)
+    try:
+        offset = struct.unpack("<I", client.call(OP_FWUPD_BEGIN, struct.pack("<II", len(image), crc)))[0]
+        if offset > 0:
+            print("Resuming at offset %d" % offset)
+
+        start = time.monotonic()
+        sent = len(image) - offset
+        send_image(client, image, offset)
+        elapsed = time.monotonic() - start
+        if sent > 0:
+            print("Transferred %d bytes in %.2f s (%.0f B/s)" % (sent, elapsed, sent / elapsed))
+
+        if not args.no_commit:
+            client.call(OP_FWUPD_COMMIT)
+            print("Image verified, installing. The device resets when done.")
+    except RpcError as err:
+        print("error: %s" % err, file=sys.stderr)
+        return 1
+    finally:
+        client.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+"""Seal and verify the firmware image trailer.
+
+The linker places a 16-byte trailer behind the last flash contents (see
+Controller/app_sections.ld and image.h):
+
+  magic "IMG1" | image start address | image length | CRC-32
+
+all little-endian 32-bit words. The CRC-32 uses the conventions of the
+CH32V103 CRC unit (polynomial 0x04C11DB7, initial value 0xFFFFFFFF, no
+reflection, no final XOR, little-endian 32-bit words). Gaps between sections
+are counted as 0xFF, matching the HEX file generated with --gap-fill 0xFF.
+
+"seal" computes the CRC of a linked ELF file and writes it into the
+.imgtrailer section in place. "verify" checks a HEX file against its trailer.
+
+Usage:
+  image_trailer.py seal build/hello-ch32v103.elf [--objcopy riscv-none-elf-objcopy]
+  image_trailer.py verify build/hello-ch32v103.hex
+"""
+
+import argparse
+import os
+import struct
+import subprocess
+import sys
+import tempfile
+
+TRAILER_MAGIC = 0x31474D49
+TRAILER_SECTION = ".imgtrailer"
+GAP_FILL = 0xFF
+
+
+def make_crc_table():
+    table = []
+    for i in range(256):
+        crc = i << 24
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x04C11DB7) if crc & 0x80000000 else (crc << 1)
+        table.append(crc & 0xFFFFFFFF)
+    return table
+
+
+CRC_TABLE = make_crc_table()
+
+
+def crc32_words(data, crc=0xFFFFFFFF):
+    """CRC-32 as calculated by the CRC unit, zero-padding a partial last word."""
+    data = bytes(data) + bytes(-len(data) % 4)
+    for ofs in range(0, len(data), 4):
+        for byte in reversed(data[ofs:ofs + 4]):
+            crc = ((crc << 8) & 0xFFFFFFFF) ^ CRC_TABLE[(crc >> 24) ^ byte]
+    return crc
+
+
+def read_hex(path):
+    """Return {address: byte} of an Intel HEX file."""
+    memory = {}
+    base = 0
+    with open(path, encoding="ascii") as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.strip()
+            if not line:
+                continue
+            if not line.startswith(":"):
+                raise ValueError("%s:%d: not an Intel HEX record" % (path, lineno))
+            record = bytes.fromhex(line[1:])
+            if sum(record) & 0xFF:
+                raise ValueError("%s:%d: checksum error" % (path, lineno))
+            count, address, rtype = record[0], (record[1] << 8) | record[2], record[3]
+            data = record[4:4 + count]
+            if rtype == 0x00:
+                for i, byte in enumerate(data):
+                    memory[base + address + i] = byte
+            elif rtype == 0x01:
+                break
+            elif rtype == 0x02:
+                base = ((data[0] << 8) | data[1]) << 4
+            elif rtype == 0x04:
+                base = ((data[0] << 8) | data[1]) << 16
+    return memory
+
+
+def find_trailer(memory):
+    """Return (address, start, length, crc) of the image trailer."""
+    for address in sorted(a for a in memory if a % 4 == 0):
+        word = bytes(memory.get(address + i, 0) for i in range(16))
+        magic, start, length, crc = struct.unpack("<4I", word)
+        if magic == TRAILER_MAGIC and start + length == address:
+            return address, start, length, crc
+    raise ValueError("image trailer not found")
+
+
+def image_crc(memory, start, length):
+    data = bytes(memory.get(start + i, GAP_FILL) for i in range(length))
+    return crc32_words(data)
+
+
+def seal(args):
+    with tempfile.TemporaryDirectory() as tmp:
+        hexfile = os.path.join(tmp, "image.hex")
+        subprocess.run([args.objcopy, "-O", "ihex", "--gap-fill", "0x%02X" % GAP_FILL,
+                        args.elf, hexfile], check=True)
+        memory = read_hex(hexfile)
+        address, start, length, _ = find_trailer(memory)
+        crc = image_crc(memory, start, length)
+
+        binfile = os.path.join(tmp, "trailer.bin")
+        with open(binfile, "wb") as f:
+            f.write(struct.pack("<4I", TRAILER_MAGIC, start, length, crc))
+        subprocess.run([args.objcopy, "--update-section", "%s=%s" % (TRAILER_SECTION, binfile),
+                        args.elf], check=True)
+    print("Image 0x%08X, %d bytes, CRC-32 %08X (trailer at 0x%08X)" % (start, length, crc, address))
+    return 0
+
+
+def verify(args):
+    memory = read_hex(args.hex)
+    address, start, length, crc = find_trailer(memory)
+    actual = image_crc(memory, start, length)
+    if actual != crc:
+        print("%s: CRC-32 mismatch: trailer %08X, image %08X" % (args.hex, crc, actual), file=sys.stderr)
+        return 1
+    print("%s: image 0x%08X, %d bytes, CRC-32 %08X OK" % (args.hex, start, length, crc))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    p = sub.add_parser("seal", help="write image CRC into ELF trailer")
+    p.add_argument("elf")
+    p.add_argument("--objcopy", default="riscv-none-elf-objcopy")
+    p = sub.add_parser("verify", help="check HEX file against its trailer")
+    p.add_argument("hex")
+    args = parser.parse_args()
+    try:
+        return seal(args) if args.cmd == "seal" else verify(args)
+    except (OSError, ValueError, subprocess.CalledProcessError) as err:
+        print("error: %s" % err, file=sys.stderr)
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+"""Export the internal-flash data log over the binary RPC protocol.
+
+Pending records are committed first, then all retained log pages are read
+with several requests outstanding, so the transfer runs at the serial line
+rate. Each page is checked against its CRC-32 and split into records.
+
+Records are written one per line as hex, prefixed with the page sequence
+number, or as raw length-prefixed records with --raw.
+
+With --compress, pages are LZ-compressed on the device for the transfer (see
+compress.py) and the log channel is switched back to uncompressed afterwards.
+
+Usage:
+  log_export.py /dev/ttyACM0 [-o log.txt] [--raw] [--window 3] [--compress]
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import compress
+from image_trailer import crc32_words
+from rpc_client import RpcClient, RpcError
+
+OP_LOG_INFO = 0x50
+OP_LOG_READ = 0x51
+OP_LOG_FLUSH = 0x52
+
+HDR_FORMAT = "<III"
+HDR_SIZE = struct.calcsize(HDR_FORMAT)
+
+
+def parse_page(page, seq):
+    """Return the records of a raw log page, or None if the page is invalid."""
+    check, page_seq, length = struct.unpack_from(HDR_FORMAT, page)
+    if page_seq != seq or length > len(page) - HDR_SIZE or crc32_words(page[4:]) != check:
+        return None
+    payload = page[HDR_SIZE:HDR_SIZE + length]
+    records = []
+    ofs = 0
+    while ofs < len(payload):
+        size = payload[ofs]
+        records.append(payload[ofs + 1:ofs + 1 + size])
+        ofs += 1 + size
+    return records
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="serial port, e.g. /dev/ttyACM0")
+    parser.add_argument("-o", "--output", help="output file (default: stdout)")
+    parser.add_argument("--raw", action="store_true", help="write length-prefixed binary records")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--window", type=int, default=3, help="max. outstanding requests")
+    parser.add_argument("--timeout", type=float, default=2.0, help="response timeout in s")
+    parser.add_argument("--compress", action="store_true", help="compress pages for the transfer")
+    args = parser.parse_args()
+
+    client = RpcClient(args.port, args.baud, args.timeout, args.window)
+    try:
+        client.call(OP_LOG_FLUSH)
+        if args.compress:
+            client.set_compress("log", compress.MODE_LZ)
+        first, next_seq, page_size, num_pages, _ = struct.unpack("<IIHHH", client.call(OP_LOG_INFO))
+        seqs = list(range(first, next_seq))
+        start = time.monotonic()
+        pages = client.call_many([(OP_LOG_READ, struct.pack("<I", seq)) for seq in seqs])
+        elapsed = time.monotonic() - start
+        if args.compress:
+            client.set_compress("log", compress.MODE_NONE)
+    except RpcError as err:
+        print("error: %s" % err, file=sys.stderr)
+        return 1
+    finally:
+        client.close()
+
+    size = sum(len(page) for page in pages)
+    if args.compress:
+        pages = [compress.decode_block(page) for page in pages]
+
+    out = open(args.output, "wb" if args.raw else "w") if args.output else \
+        (sys.stdout.buffer if args.raw else sys.stdout)
+    count = 0
+    missing = 0
+    for seq, page in zip(seqs, pages):
+        records = parse_page(page, seq) if len(page) == page_size else None
+        if records is None:
+            missing += 1
+            continue
+        for record in records:
+            if args.raw:
+                out.write(bytes([len(record)]) + record)
+            else:
+                out.write("%d %s\n" % (seq, record.hex()))
+            count += 1
+    if args.output:
+        out.close()
+
+    rate = size / elapsed if elapsed > 0 else 0
+    print("%d records from %d of %d pages (%d missing), %d bytes in %.2f s (%.0f B/s)" %
+          (count, len(seqs) - missing, num_pages, missing, size, elapsed, rate), file=sys.stderr)
+    if args.compress:
+        total = sum(len(page) for page in pages)
+        print("compressed to %.1f %% of %d bytes" % (100.0 * size / max(total, 1), total),
+              file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
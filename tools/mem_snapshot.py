@@ -0,0 +1,160 @@
+#!/usr/bin/env python3
+"""Save memory snapshots of the target through the binary protocol (see memregion.c).
+
+Reads are streamed with MEM_DUMP requests and limited to the readable
+regions reported by the target, which are given by name or address:
+
+  mem_snapshot.py regions /dev/ttyACM0
+  mem_snapshot.py dump /dev/ttyACM0 sram [-o sram.bin]
+  mem_snapshot.py dump /dev/ttyACM0 0x20000000 0x800 -o part.bin [--resume]
+  mem_snapshot.py snapshot /dev/ttyACM0 DIR [REGION ...] [--resume]
+  mem_snapshot.py esig /dev/ttyACM0
+  mem_snapshot.py esig DIR/esig.bin
+
+`snapshot` saves each region (default: all) as DIR/<name>.bin, and writes
+their addresses and CRC-32 values to DIR/manifest.json. With --resume, a
+shorter existing output file is continued from its end instead of being
+read again, e.g. after the link was interrupted.
+
+`esig` prints the flash size and unique ID like the firmware's startup
+banner, read from the target or from a saved esig snapshot.
+
+Requires pyserial.
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+import time
+
+from image_trailer import crc32_words
+from rpc_client import RpcClient, RpcError
+
+ESIG_ADDR = 0x1FFFF7E0
+ESIG_LEN = 0x20
+ESIG_FLASH_SIZE_OFS = 0x00
+ESIG_UID_OFS = 0x08
+
+
+def find_region(regions, name):
+    for region in regions:
+        if region["name"] == name:
+            return region
+    sys.exit("unknown region '%s', see 'regions'" % name)
+
+
+def progress(offset, length):
+    print("\r%7d / %d bytes" % (offset, length), end="", file=sys.stderr, flush=True)
+
+
+def dump_to_file(client, path, address, length, resume=False, word=False):
+    """Stream a range into a file; return (CRC-32 of the file, bytes read, seconds)."""
+    offset = 0
+    if resume and os.path.exists(path):
+        offset = min(os.path.getsize(path), length)
+        # Word-access regions are resumed at a word boundary
+        if word:
+            offset &= ~3
+    start = time.monotonic()
+    data = client.mem_dump(address, length, offset, progress=progress)
+    elapsed = time.monotonic() - start
+    print(file=sys.stderr)
+    with open(path, "r+b" if offset else "wb") as f:
+        f.seek(offset)
+        f.write(data)
+        f.truncate(length)
+    with open(path, "rb") as f:
+        return crc32_words(f.read()), len(data), elapsed
+
+
+def decode_esig(data):
+    flash_kb, = struct.unpack_from("<H", data, ESIG_FLASH_SIZE_OFS)
+    uid = struct.unpack_from("<3I", data, ESIG_UID_OFS)
+    return "FLASH Size: %d KB\nUnique ID: %08X %08X %08X" % (flash_kb, uid[2], uid[1], uid[0])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=1.0, help="data frame timeout in s")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    p = sub.add_parser("regions")
+    p.add_argument("port")
+    p = sub.add_parser("dump")
+    p.add_argument("port")
+    p.add_argument("region", help="region name or start address")
+    p.add_argument("length", nargs="?", type=lambda x: int(x, 0),
+                   help="length in bytes (default: to end of region)")
+    p.add_argument("-o", "--output", help="output file (default: <region>.bin)")
+    p.add_argument("--resume", action="store_true", help="continue existing output file")
+    p = sub.add_parser("snapshot")
+    p.add_argument("port")
+    p.add_argument("directory")
+    p.add_argument("regions", nargs="*", help="region names (default: all)")
+    p.add_argument("--resume", action="store_true", help="continue existing output files")
+    p = sub.add_parser("esig")
+    p.add_argument("source", help="serial port, or esig snapshot file")
+    args = parser.parse_args()
+
+    if args.cmd == "esig" and os.path.isfile(args.source):
+        with open(args.source, "rb") as f:
+            print(decode_esig(f.read()))
+        return 0
+
+    client = RpcClient(getattr(args, "port", None) or args.source, args.baud, args.timeout)
+    try:
+        if args.cmd == "esig":
+            print(decode_esig(client.mem_dump(ESIG_ADDR, ESIG_LEN)))
+            return 0
+
+        regions = client.mem_regions()
+        if args.cmd == "regions":
+            for region in regions:
+                print("%-8s 0x%08X %6d bytes%s" % (region["name"], region["start"],
+                      region["length"], ", 32-bit access" if region["word"] else ""))
+
+        elif args.cmd == "dump":
+            try:
+                address = int(args.region, 0)
+                region = next((r for r in regions if r["start"] <= address < r["start"] + r["length"]),
+                              None)
+                if region is None:
+                    sys.exit("0x%08X is not in a readable region" % address)
+                name = "%08x" % address
+            except ValueError:
+                region = find_region(regions, args.region)
+                address, name = region["start"], region["name"]
+            length = args.length or region["start"] + region["length"] - address
+            path = args.output or name + ".bin"
+            crc, size, elapsed = dump_to_file(client, path, address, length, args.resume,
+                                              region["word"])
+            print("%s: %d bytes at 0x%08X, CRC-32 %08X (%d bytes read, %.0f B/s)" %
+                  (path, length, address, crc, size, size / elapsed if elapsed else 0))
+
+        elif args.cmd == "snapshot":
+            os.makedirs(args.directory, exist_ok=True)
+            selected = [find_region(regions, name) for name in args.regions] or regions
+            manifest = {"time": time.strftime("%Y-%m-%dT%H:%M:%S"), "regions": {}}
+            for region in selected:
+                path = os.path.join(args.directory, region["name"] + ".bin")
+                print(region["name"], file=sys.stderr)
+                crc, size, elapsed = dump_to_file(client, path, region["start"], region["length"],
+                                                  args.resume, region["word"])
+                manifest["regions"][region["name"]] = {
+                    "start": region["start"], "length": region["length"], "crc32": crc}
+                print("%-8s %6d bytes, CRC-32 %08X, %.0f B/s" %
+                      (region["name"], region["length"], crc, size / elapsed if elapsed else 0))
+            with open(os.path.join(args.directory, "manifest.json"), "w") as f:
+                json.dump(manifest, f, indent=2)
+    except RpcError as err:
+        print("error: %s" % err, file=sys.stderr)
+        return 1
+    finally:
+        client.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Correctness fuzzing and code size of the firmware memory functions (see memfunc.c).
+
+Builds memfunc.c with the host compiler as a shared library and calls
+pvFastMemCpy(), pvFastMemSet() and uFastStrLen() with random lengths,
+alignments and data. Each destination buffer is surrounded by guard bytes,
+which must not be written:
+
+  memfunc_check.py [--iterations 20000] [--seed 1] [--cc cc] [--lib memfunc.so]
+
+With --lib, a library built from memfunc.c beforehand is loaded instead, as
+by the memfunc host test (see tests/CMakeLists.txt).
+
+Results are reported per length bucket. Strings are made of bytes which
+catch false zero-byte matches of the word scan (0x01, 0x80, 0xFF).
+
+With --size, memfunc.c is compiled for the target in the size and speed
+build profiles, and the code size of each function is listed next to the
+newlib-nano version from the toolchain:
+
+  memfunc_check.py --size [--cross riscv-none-elf-]
+
+Throughput per length bucket is measured on the target by the memcpy_*,
+memset_* and strlen_* benchmark cases.
+"""
+
+import argparse
+import ctypes
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+SOURCE = os.path.join(ROOT, "memfunc.c")
+CFLAGS = ["-std=gnu17", "-fno-tree-loop-distribute-patterns", "-I" + ROOT,
+          "-I" + os.path.join(ROOT, "hw_layer")]
+TARGET_FLAGS = ["-march=rv32imac", "-mabi=ilp32", "-ffunction-sections"]
+PROFILES = {"release-size": ["-Os", "-msave-restore"], "release-speed": ["-O2"]}
+FUNCTIONS = [("memcpy", "pvFastMemCpy"), ("memset", "pvFastMemSet"), ("strlen", "uFastStrLen")]
+
+BUCKETS = [(0, 7), (8, 63), (64, 1023), (1024, 4096)]
+GUARD = 16
+ALIGN = 8
+STR_BYTES = [0x01, 0x7F, 0x80, 0x81, 0xFE, 0xFF] + list(range(0x20, 0x7F))
+
+
+def build_host(cc, outdir):
+    lib = os.path.join(outdir, "memfunc.so")
+    subprocess.run([cc, "-O2", "-shared", "-fPIC", *CFLAGS, SOURCE, "-o", lib], check=True)
+    return load_host(lib)
+
+
+def load_host(lib):
+    mem = ctypes.CDLL(os.path.abspath(lib))
+    mem.pvFastMemCpy.restype = ctypes.c_void_p
+    mem.pvFastMemCpy.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_size_t]
+    mem.pvFastMemSet.restype = ctypes.c_void_p
+    mem.pvFastMemSet.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_size_t]
+    mem.uFastStrLen.restype = ctypes.c_size_t
+    mem.uFastStrLen.argtypes = [ctypes.c_void_p]
+    return mem
+
+
+def random_length(rng):
+    low, high = rng.choice(BUCKETS)
+    return rng.randint(low, high)
+
+
+def bucket_of(length):
+    for i, (low, high) in enumerate(BUCKETS):
+        if low <= length <= high:
+            return i
+    return len(BUCKETS) - 1
+
+
+def new_buffer(size, rng):
+    """Buffer of random bytes; the C array address is at least 16-aligned."""
+    return (ctypes.c_uint8 * size).from_buffer_copy(rng.randbytes(size))
+
+
+def check_memcpy(mem, rng, length):
+    src_ofs, dst_ofs = rng.randrange(ALIGN), rng.randrange(ALIGN)
+    src = new_buffer(length + ALIGN, rng)
+    dst = new_buffer(length + ALIGN + 2 * GUARD, rng)
+    before = bytes(dst)
+    dst_addr = ctypes.addressof(dst) + GUARD + dst_ofs
+    ret = mem.pvFastMemCpy(dst_addr, ctypes.addressof(src) + src_ofs, length)
+    start = GUARD + dst_ofs
+    expected = before[:start] + bytes(src)[src_ofs:src_ofs + length] + before[start + length:]
+    if ret != dst_addr or bytes(dst) != expected:
+        return "memcpy(len=%d, src+%d, dst+%d)" % (length, src_ofs, dst_ofs)
+    return None
+
+
+def check_memset(mem, rng, length):
+    dst_ofs = rng.randrange(ALIGN)
+    value = rng.choice([0x00, 0x55, 0x80, 0xFF, rng.randrange(256), rng.randrange(-512, 512)])
+    dst = new_buffer(length + ALIGN + 2 * GUARD, rng)
+    before = bytes(dst)
+    dst_addr = ctypes.addressof(dst) + GUARD + dst_ofs
+    ret = mem.pvFastMemSet(dst_addr, value, length)
+    start = GUARD + dst_ofs
+    expected = before[:start] + bytes([value & 0xFF]) * length + before[start + length:]
+    if ret != dst_addr or bytes(dst) != expected:
+        return "memset(len=%d, value=%d, dst+%d)" % (length, value, dst_ofs)
+    return None
+
+
+def check_strlen(mem, rng, length):
+    ofs = rng.randrange(ALIGN)
+    tail = rng.randbytes(rng.randrange(8))
+    data = bytes(rng.choice(STR_BYTES) for _ in range(length)) + b"\0" + tail
+    buf = new_buffer(len(data) + 2 * ALIGN, rng)
+    ctypes.memmove(ctypes.addressof(buf) + ofs, data, len(data))
+    result = mem.uFastStrLen(ctypes.addressof(buf) + ofs)
+    if result != length:
+        return "strlen(len=%d, +%d) returned %d" % (length, ofs, result)
+    return None
+
+
+def run_fuzz(args):
+    rng = random.Random(args.seed)
+    with tempfile.TemporaryDirectory() as outdir:
+        mem = load_host(args.lib) if args.lib else build_host(args.cc, outdir)
+        checks = [("memcpy", check_memcpy), ("memset", check_memset), ("strlen", check_strlen)]
+        counts = {name: [0] * len(BUCKETS) for name, _ in checks}
+        failures = []
+        for _ in range(args.iterations):
+            for name, check in checks:
+                length = random_length(rng)
+                counts[name][bucket_of(length)] += 1
+                error = check(mem, rng, length)
+                if error:
+                    failures.append(error)
+
+    print("%-8s" % "" + "".join("%12s" % ("%d-%d" % b) for b in BUCKETS))
+    for name, _ in checks:
+        print("%-8s" % name + "".join("%12d" % n for n in counts[name]))
+    for error in failures[:20]:
+        print("FAILED: " + error)
+    print("%d failures" % len(failures))
+    return 1 if failures else 0
+
+
+def symbol_sizes(nm, path, names):
+    out = subprocess.run([nm, "-S", path], check=True, capture_output=True, text=True).stdout
+    sizes = {}
+    for line in out.splitlines():
+        fields = line.split()
+        if len(fields) == 4 and fields[3] in names and fields[2] in "tTW":
+            sizes[fields[3]] = int(fields[1], 16)
+    return sizes
+
+
+def run_size(args):
+    gcc, nm = args.cross + "gcc", args.cross + "nm"
+    libc = subprocess.run([gcc, *TARGET_FLAGS, "-specs=nano.specs", "-print-file-name=libc_nano.a"],
+                          check=True, capture_output=True, text=True).stdout.strip()
+    newlib = symbol_sizes(nm, libc, [name for name, _ in FUNCTIONS])
+    results = {}
+    with tempfile.TemporaryDirectory() as outdir:
+        for profile, options in PROFILES.items():
+            obj = os.path.join(outdir, profile + ".o")
+            subprocess.run([gcc, *TARGET_FLAGS, *options, *CFLAGS, "-c", SOURCE, "-o", obj], check=True)
+            results[profile] = symbol_sizes(nm, obj, [fast for _, fast in FUNCTIONS])
+
+    print("%-8s %12s" % ("", "newlib-nano") + "".join("%15s" % p for p in PROFILES))
+    for name, fast in FUNCTIONS:
+        print("%-8s %12s" % (name, newlib.get(name, "-")) +
+              "".join("%15s" % results[p].get(fast, "-") for p in PROFILES))
+    print("(code size in bytes)")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--iterations", type=int, default=20000, help="calls per function")
+    parser.add_argument("--seed", type=int, default=1)
+    parser.add_argument("--cc", default="cc", help="host compiler")
+    parser.add_argument("--lib", help="prebuilt host library of memfunc.c")
+    parser.add_argument("--size", action="store_true", help="compare target code size")
+    parser.add_argument("--cross", default="riscv-none-elf-", help="target toolchain prefix")
+    args = parser.parse_args()
+    return run_size(args) if args.size else run_fuzz(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
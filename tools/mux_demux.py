@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Demultiplex the firmware output channels onto pseudo-terminals (see mux.c).
+
+Enables multiplexed output with a MUX request, then splits the frames
+received on the serial port by channel. Each channel gets a pty, whose name
+is printed at startup:
+
+  shell      stdout and stderr of the firmware; input is forwarded to the
+             port, so a terminal program can be used on it as usual
+  rpc        binary protocol responses; requests are forwarded, so
+             rpc_client.py and the other tools can be run on this pty
+  log        flash log records (length-prefixed, as in the log pages)
+  telemetry  control loop samples (iteration u32, feedback mV u16,
+             output Q15 u16)
+
+With --telemetry-csv, telemetry records are also decoded into a CSV file.
+Frames with a bad CRC and gaps in the per-channel sequence numbers are
+counted and reported on exit, when multiplexing is disabled again.
+
+Input is not multiplexed: shell and rpc pty input share the port as without
+the multiplexer, so a binary request should not be sent while a shell line
+is being typed. Baud rate changes (--switch-baud) are not supported through
+the rpc pty.
+
+Usage:
+  mux_demux.py /dev/ttyACM0 [--baud 115200] [--telemetry-csv samples.csv]
+
+Requires pyserial.
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import tty
+
+from rpc_client import (MUX_CHANNELS, OP_MUX, RpcClient, RpcError, cobs_decode, cobs_encode,
+                        crc16)
+
+CH_ERROR = MUX_CHANNELS.index("error")
+CH_RPC = MUX_CHANNELS.index("rpc")
+CH_SHELL = MUX_CHANNELS.index("shell")
+CH_TELEMETRY = MUX_CHANNELS.index("telemetry")
+
+# Error output is shown on the shell pty in red, like the firmware does
+ERROR_START = b"\x1b[31m"
+ERROR_END = b"\x1b[0m"
+
+TELEMETRY_FORMAT = "<IHH"
+
+
+class Demux:
+    """Split multiplexer frames and keep per-channel statistics."""
+
+    def __init__(self):
+        self.rx = bytearray()
+        self.next_seq = {}
+        self.frames = [0] * len(MUX_CHANNELS)
+        self.payload = [0] * len(MUX_CHANNELS)
+        self.lost = [0] * len(MUX_CHANNELS)
+        self.bad = 0
+
+    def feed(self, data):
+        """Return list of (channel, payload) for the complete frames in `data`."""
+        out = []
+        self.rx += data
+        while b"\x00" in self.rx:
+            raw, _, rest = self.rx.partition(b"\x00")
+            self.rx = bytearray(rest)
+            if not raw:
+                continue
+            try:
+                frame = cobs_decode(raw)
+            except RpcError:
+                self.bad += 1
+                continue
+            if (len(frame) < 4 or frame[0] >= len(MUX_CHANNELS)
+                    or crc16(frame[:-2]) != struct.unpack("<H", frame[-2:])[0]):
+                self.bad += 1
+                continue
+            ch, seq = frame[0], frame[1]
+            expected = self.next_seq.get(ch, seq)
+            self.lost[ch] += (seq - expected) & 0xFF
+            self.next_seq[ch] = (seq + 1) & 0xFF
+            self.frames[ch] += 1
+            self.payload[ch] += len(frame) - 4
+            out.append((ch, frame[2:-2]))
+        return out
+
+
+def mux_request(seq, mode):
+    """MUX request frame incl. delimiters, sent without waiting for the response."""
+    frame = bytes([seq, OP_MUX, mode])
+    frame += struct.pack("<H", crc16(frame))
+    return b"\x00" + cobs_encode(frame) + b"\x00"
+
+
+def open_pty():
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    return master, slave, os.ttyname(slave)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="serial port, e.g. /dev/ttyACM0")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--telemetry-csv", help="decode telemetry records into CSV file")
+    args = parser.parse_args()
+
+    client = RpcClient(args.port, args.baud)
+    try:
+        client.set_mux(True)
+    except RpcError as err:
+        print("error: %s" % err, file=sys.stderr)
+        client.close()
+        return 1
+    ser = client.ser
+    demux = Demux()
+
+    ptys = {}
+    for ch, name in enumerate(MUX_CHANNELS):
+        if ch == CH_ERROR:
+            continue
+        ptys[ch] = open_pty()
+        print("%-10s %s" % (name, ptys[ch][2]))
+    inputs = {ptys[CH_SHELL][0]: CH_SHELL, ptys[CH_RPC][0]: CH_RPC}
+    csv = open(args.telemetry_csv, "w") if args.telemetry_csv else None
+    if csv:
+        csv.write("iteration,feedback_mv,output_q15\n")
+    # Records may be split across frames
+    telemetry = bytearray()
+    record_size = struct.calcsize(TELEMETRY_FORMAT)
+
+    def write_pty(ch, data):
+        try:
+            os.write(ptys[ch][0], data)
+        except OSError:
+            pass  # nobody reading, output buffer full
+
+    pending = bytes(client.rx)
+    client.rx.clear()
+    try:
+        while True:
+            frames = demux.feed(pending)
+            pending = b""
+            for ch, data in frames:
+                if ch == CH_ERROR:
+                    write_pty(CH_SHELL, ERROR_START + data + ERROR_END)
+                    continue
+                write_pty(ch, data)
+                if ch == CH_TELEMETRY and csv:
+                    telemetry += data
+                    while len(telemetry) >= record_size:
+                        csv.write("%d,%d,%d\n" % struct.unpack_from(TELEMETRY_FORMAT, telemetry))
+                        del telemetry[:record_size]
+
+            ready, _, _ = select.select([ser.fileno()] + list(inputs), [], [], 0.1)
+            for fd in ready:
+                if fd == ser.fileno():
+                    pending = ser.read(max(1, ser.in_waiting))
+                else:
+                    try:
+                        ser.write(os.read(fd, 256))
+                    except OSError:
+                        pass  # pty closed by client
+    except KeyboardInterrupt:
+        pass
+    finally:
+        # Response to the disable request arrives in multiplexed form
+        ser.write(mux_request(client.seq, 0))
+        ser.flush()
+        if csv:
+            csv.close()
+        client.close()
+        for master, slave, _ in ptys.values():
+            os.close(master)
+            os.close(slave)
+
+    print("channel       frames      bytes   lost", file=sys.stderr)
+    for ch, name in enumerate(MUX_CHANNELS):
+        print("%-10s %9d %10d %6d" % (name, demux.frames[ch], demux.payload[ch], demux.lost[ch]),
+              file=sys.stderr)
+    print("%d bad frames" % demux.bad, file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+"""Scheduling simulation of the firmware output multiplexer (see mux.c).
+
+Models the channel queues, the frame scheduler and a USART at the given baud
+rate, fed by a mixed workload:
+
+  shell      hexdump-style bursts of --dump bytes every --dump-period s
+  rpc        memory read responses (256 bytes) every 50 ms
+  error      short messages at random times, about 5 per second
+  log        16-byte records at 50 per second
+  telemetry  8-byte records every 10 ms
+
+and compares three policies:
+
+  fifo       all output in order of writing, as without the multiplexer
+  prio       strict priority with round robin, no rate limits
+  prio+rate  as in the firmware: priorities plus token bucket rate limits
+
+  mux_sim.py [--baud 115200] [--time 10] [--dump 4096] [--dump-period 2]
+
+Reported per channel: delivered bytes/s, latency from write until its last
+byte is on the line (p50, p99, max), and dropped bytes of the lossy
+channels. Fairness is Jain's index over the delivered share of the offered
+load per channel (1.0 = all channels get the same share of their demand).
+"""
+
+import argparse
+import collections
+import random
+import sys
+
+MAX_PAYLOAD = 64
+FRAME_OVERHEAD = 2 + 2 + 1 + 2     # header, CRC, COBS code, delimiters
+BITS_PER_BYTE = 10
+
+# name: (queue size, priority, lossless, rate B/s, burst, borrow), as in mux.c
+CHANNELS = {
+    "error":     (64,  0, True,  0,    0,   False),
+    "rpc":       (256, 1, True,  0,    0,   False),
+    "shell":     (256, 1, True,  3000, 256, True),
+    "log":       (256, 2, False, 1000, 256, False),
+    "telemetry": (128, 2, False, 2000, 128, False),
+}
+NAMES = list(CHANNELS)
+
+
+def workload(args, rng):
+    """Return sorted list of (time, channel, length) writes."""
+    writes = []
+    t = 0.05
+    while t < args.time:
+        writes += [(t + i * 0.0005, "shell", 80) for i in range(args.dump // 80)]
+        t += args.dump_period
+    writes += [(i * 0.05, "rpc", 256) for i in range(int(args.time / 0.05))]
+    t = rng.expovariate(5)
+    while t < args.time:
+        writes.append((t, "error", 40))
+        t += rng.expovariate(5)
+    writes += [(i * 0.02, "log", 16) for i in range(int(args.time / 0.02))]
+    writes += [(i * 0.01, "telemetry", 8) for i in range(int(args.time / 0.01))]
+    writes.sort()
+    return writes
+
+
+class Channel:
+    def __init__(self, name, cfg, rate_limit):
+        self.name = name
+        self.size, self.prio, self.lossless, rate, self.burst, self.borrow = cfg
+        self.rate = rate if rate_limit else 0
+        self.tokens = float(self.burst)
+        self.queue = []             # [write time, remaining bytes]
+        self.fill = 0
+        self.offered = 0
+        self.sent = 0
+        self.dropped = 0
+        self.latency = []
+
+    def write(self, t, length):
+        self.offered += length
+        # Lossless writers block; modelled as an unbounded queue
+        if not self.lossless and self.fill + length > self.size:
+            self.dropped += length
+            return
+        self.queue.append([t, length])
+        self.fill += length
+
+    def take(self, t_end, length):
+        """Remove `length` bytes; record latency of completed writes."""
+        self.fill -= length
+        self.sent += length
+        while length:
+            n = min(length, self.queue[0][1])
+            self.queue[0][1] -= n
+            length -= n
+            if self.queue[0][1] == 0:
+                self.latency.append(t_end - self.queue.pop(0)[0])
+
+
+def simulate(args, policy):
+    rng = random.Random(args.seed)
+    writes = workload(args, rng)
+    channels = [Channel(n, CHANNELS[n], policy == "prio+rate") for n in NAMES]
+    fifo = collections.deque()      # channel of each queued write, in order
+    byte_time = BITS_PER_BYTE / args.baud
+    t = 0.0
+    last = len(channels) - 1
+    i = 0
+    while i < len(writes) or any(ch.fill for ch in channels):
+        while i < len(writes) and writes[i][0] <= t:
+            wt, name, length = writes[i]
+            ch = channels[NAMES.index(name)]
+            before = ch.fill
+            ch.write(wt, length)
+            if ch.fill != before:
+                fifo.append(ch)
+            i += 1
+
+        if policy == "fifo":
+            best, length = (fifo[0], min(fifo[0].queue[0][1], MAX_PAYLOAD)) if fifo else (None, 0)
+        else:
+            best, best_class = None, 256
+            for k in range(1, len(channels) + 1):
+                ch = channels[(last + k) % len(channels)]
+                if not ch.fill:
+                    continue
+                cls = ch.prio
+                # Tokens for a whole frame, so frames are not fragmented
+                if ch.rate and ch.tokens < min(ch.fill, MAX_PAYLOAD):
+                    if not ch.borrow:
+                        continue
+                    cls = 255
+                if cls < best_class:
+                    best, best_class = ch, cls
+            length = 0
+            if best:
+                length = min(best.fill, MAX_PAYLOAD)
+                if best.rate and best_class != 255:
+                    best.tokens -= length
+                last = channels.index(best)
+
+        if best is None:
+            # Idle until next write or token refill
+            t_next = writes[i][0] if i < len(writes) else t + 0.001
+            dt = max(min(t_next, t + 0.001) - t, 1e-6)
+        else:
+            dt = (length + FRAME_OVERHEAD) * byte_time
+            pending = len(best.queue)
+            best.take(t + dt, length)
+            if policy == "fifo" and len(best.queue) < pending:
+                fifo.popleft()
+        t += dt
+        for ch in channels:
+            if ch.rate:
+                ch.tokens = min(ch.tokens + ch.rate * dt, ch.burst)
+    return channels, t
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[min(int(len(values) * p), len(values) - 1)]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--time", type=float, default=10.0, help="workload duration in s")
+    parser.add_argument("--dump", type=int, default=4096, help="shell burst size in bytes")
+    parser.add_argument("--dump-period", type=float, default=2.0, help="shell burst period in s")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    print("%d Bd (%d bytes/s), %.0f s workload" % (args.baud, args.baud // BITS_PER_BYTE, args.time))
+    for policy in ("fifo", "prio", "prio+rate"):
+        channels, duration = simulate(args, policy)
+        print("\n%s (drained after %.2f s)" % (policy, duration))
+        print("channel      B/s    p50 ms   p99 ms   max ms  dropped")
+        shares = []
+        for ch in channels:
+            print("%-10s %6.0f  %7.1f  %7.1f  %7.1f  %7d" %
+                  (ch.name, ch.sent / args.time, percentile(ch.latency, 0.5) * 1000,
+                   percentile(ch.latency, 0.99) * 1000, max(ch.latency or [0]) * 1000,
+                   ch.dropped))
+            shares.append(ch.sent / ch.offered if ch.offered else 1.0)
+        jain = sum(shares) ** 2 / (len(shares) * sum(s * s for s in shares))
+        print("fairness %.3f" % jain)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""Step response simulation of the firmware control loop (see control.c).
+
+Runs a bit-exact model of lStepPid() against an RC low-pass filter from the
+PA6 PWM output to the PA1 feedback input, including the PWM waveform, the
+12-bit ADC conversion and the one-iteration delay between sampling and use
+of the feedback value:
+
+  pid_sim.py [--kp 0.5] [--ki 50] [--kd 0] [--rate 500] [--sp 1650]
+             [--r 10000] [--c 1e-6] [--time 0.5]
+  pid_sim.py --sweep kp=0.1,0.2,0.5,1,2,5 [other options]
+
+The report gives rise time (10..90 %), overshoot, settling time (2 % band),
+steady-state error and output ripple at the sampling instant. With --sweep,
+one gain is varied and a line is printed per value, which shows where the
+loop becomes oscillating or unstable for the given plant.
+"""
+
+import argparse
+import math
+import sys
+
+GAIN_ONE = 1 << 16
+OUT_MAX = 32767
+INT_MAX = OUT_MAX << 8
+ADC_SHIFT = 3
+ADC_MAX = 4095
+VDDA_MV = 3300
+UPDATE_FREQ = 1000
+PWM_COUNTS = 100  # HW_TIM3_PWM_PERIOD
+SETTLE_BAND = 0.02
+
+
+def to_q16(value):
+    """Gain as entered in the shell, rounded to Q16.16 like bParseGain()."""
+    digits = int(round(value * 10000))
+    return ((digits // 10000) << 16) + (((digits % 10000) << 16) + 5000) // 10000
+
+
+class Pid:
+    """Model of ControlPidTypeDef / lStepPid()."""
+
+    def __init__(self, kp, ki, kd, rate):
+        self.kp = kp
+        self.ki = ki // rate
+        self.kd = kd * rate
+        self.integral = 0
+        self.last_feedback = 0
+        self.saturated = False
+
+    def step(self, setpoint, feedback):
+        error = setpoint - feedback
+        p = (self.kp * error) >> 16
+        d = (self.kd * (self.last_feedback - feedback)) >> 16
+        self.last_feedback = feedback
+        out = p + (self.integral >> 8) + d
+        if not ((out >= OUT_MAX and error > 0) or (out <= 0 and error < 0)):
+            self.integral = min(max(self.integral + ((self.ki * error) >> 8), 0), INT_MAX)
+            out = p + (self.integral >> 8) + d
+        self.saturated = out < 0 or out > OUT_MAX
+        return min(max(out, 0), OUT_MAX)
+
+
+def mv_to_value(mv):
+    return min((mv << 12) // VDDA_MV, ADC_MAX)
+
+
+def simulate(args, kp, ki, kd):
+    """Return lists of (time, pin voltage at sample, output) per iteration."""
+    pid = Pid(kp, ki, kd, args.rate)
+    setpoint = mv_to_value(args.sp) << ADC_SHIFT
+    divider = UPDATE_FREQ // args.rate
+    tau = args.r * args.c
+    t_count = 1.0 / (UPDATE_FREQ * PWM_COUNTS)
+    volt = 0.0
+    sample = None
+    compare = PWM_COUNTS
+    trace = []
+    steps = int(args.time * args.rate)
+    for step in range(steps):
+        # Conversion started by the previous iteration
+        feedback = 0 if sample is None else sample
+        sample = min(max(int(volt * 4096 / VDDA_MV), 0), ADC_MAX)
+        out = pid.step(setpoint, feedback << ADC_SHIFT)
+        compare = PWM_COUNTS - ((out * PWM_COUNTS + (1 << 14)) >> 15)
+        trace.append((step / args.rate, volt, out))
+
+        # Pin low for counts below compare value, then high
+        low = min(compare, PWM_COUNTS)
+        for _ in range(divider):
+            volt *= math.exp(-low * t_count / tau)
+            high = PWM_COUNTS - low
+            volt = VDDA_MV + (volt - VDDA_MV) * math.exp(-high * t_count / tau)
+    return trace
+
+
+def analyse(trace, target):
+    times = [t for t, _, _ in trace]
+    volts = [v for _, v, _ in trace]
+    tail = volts[-max(len(volts) // 10, 1):]
+    final = sum(tail) / len(tail)
+    peak = max(volts)
+
+    def first(cond):
+        return next((t for t, v in zip(times, volts) if cond(v)), None)
+
+    t10 = first(lambda v: v >= 0.1 * target)
+    t90 = first(lambda v: v >= 0.9 * target)
+    settle = None
+    for t, v in zip(reversed(times), reversed(volts)):
+        if abs(v - target) > SETTLE_BAND * target:
+            settle = t
+            break
+    settled = settle is None or settle < times[-1] - (times[-1] - times[0]) / 10
+    return {
+        "rise": (t90 - t10) if t10 is not None and t90 is not None else None,
+        "overshoot": max(peak - target, 0) * 100.0 / target,
+        "settle": (settle if settle is not None else 0.0) if settled else None,
+        "error": final - target,
+        "ripple": max(tail) - min(tail),
+    }
+
+
+def fmt_ms(value):
+    return "    -   " if value is None else "%6.1f ms" % (value * 1000)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--kp", type=float, default=0.5, help="proportional gain")
+    parser.add_argument("--ki", type=float, default=50.0, help="integral gain in 1/s")
+    parser.add_argument("--kd", type=float, default=0.0, help="derivative gain in s")
+    parser.add_argument("--rate", type=int, default=500, help="loop rate in Hz")
+    parser.add_argument("--sp", type=int, default=1650, help="setpoint in mV")
+    parser.add_argument("--r", type=float, default=10e3, help="filter resistor in ohms")
+    parser.add_argument("--c", type=float, default=1e-6, help="filter capacitor in F")
+    parser.add_argument("--time", type=float, default=0.5, help="simulated time in s")
+    parser.add_argument("--sweep", help="vary one gain, e.g. kp=0.1,0.5,1")
+    args = parser.parse_args()
+    if args.rate <= 0 or UPDATE_FREQ % args.rate != 0:
+        parser.error("rate must divide %d Hz" % UPDATE_FREQ)
+
+    gains = {"kp": args.kp, "ki": args.ki, "kd": args.kd}
+    if args.sweep:
+        name, _, values = args.sweep.partition("=")
+        if name not in gains or not values:
+            parser.error("sweep format: kp=1,2,3 (kp, ki or kd)")
+        runs = []
+        for value in values.split(","):
+            run = dict(gains)
+            run[name] = float(value)
+            runs.append(run)
+    else:
+        runs = [gains]
+
+    target = (mv_to_value(args.sp) << ADC_SHIFT) * VDDA_MV / 32768.0
+    print("RC %.1f ms, %d Hz loop, setpoint %d mV (%.1f mV after quantisation)" %
+          (args.r * args.c * 1000, args.rate, args.sp, target))
+    print("   kp       ki       kd    |   rise    | overshoot |  settling | ss error | ripple")
+    for run in runs:
+        trace = simulate(args, to_q16(run["kp"]), to_q16(run["ki"]), to_q16(run["kd"]))
+        res = analyse(trace, target)
+        print("%7.3f  %7.3f  %7.4f  | %s | %7.1f %% | %s | %5.1f mV | %4.1f mV%s" %
+              (run["kp"], run["ki"], run["kd"], fmt_ms(res["rise"]), res["overshoot"],
+               fmt_ms(res["settle"]), res["error"], res["ripple"],
+               "" if res["settle"] is not None else "  (not settled)"))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+"""Report static RAM usage per module from a GNU ld map file.
+
+Sums the sizes of all input sections placed in RAM (.data, .sdata, .bss,
+.sbss, COMMON, ...) per object file and prints them sorted by total size.
+
+Usage:
+  ram_report.py hello-ch32v103.map [--ram-start 0x20000000] [--ram-size 0x5000]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# Input section line, either on one line or with the address on the next line
+SECTION_RE = re.compile(r"^ (\S+)\s*$")
+ENTRY_RE = re.compile(r"^ (\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+
+def parse_map(path, ram_start, ram_end):
+    """Return {module: {"data": n, "bss": n}} for RAM input sections."""
+    usage = {}
+    in_memory_map = False
+    pending = None
+    with open(path, encoding="ascii", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if line.startswith("Linker script and memory map"):
+                in_memory_map = True
+                continue
+            if not in_memory_map:
+                continue
+
+            match = SECTION_RE.match(line)
+            if match:
+                pending = match.group(1)
+                continue
+            match = ENTRY_RE.match(line)
+            if not match:
+                pending = None
+                continue
+
+            section = match.group(1) or pending
+            pending = None
+            if section is None:
+                continue
+            addr = int(match.group(2), 16)
+            size = int(match.group(3), 16)
+            if size == 0 or not ram_start <= addr < ram_end:
+                continue
+
+            kind = "bss" if ("bss" in section or "COMMON" in section) else "data"
+            module = os.path.basename(match.group(4).strip())
+            entry = usage.setdefault(module, {"data": 0, "bss": 0})
+            entry[kind] += size
+    return usage
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("mapfile", help="linker map file")
+    parser.add_argument("--ram-start", type=lambda x: int(x, 0),
+                        default=0x20000000, help="RAM start address")
+    parser.add_argument("--ram-size", type=lambda x: int(x, 0),
+                        default=0x5000, help="RAM size in bytes")
+    args = parser.parse_args()
+
+    usage = parse_map(args.mapfile, args.ram_start,
+                      args.ram_start + args.ram_size)
+    rows = sorted(usage.items(), key=lambda kv: -(kv[1]["data"] + kv[1]["bss"]))
+
+    print(f"{'data':>7} {'bss':>7} {'total':>7}  module")
+    total_data = total_bss = 0
+    for module, entry in rows:
+        total_data += entry["data"]
+        total_bss += entry["bss"]
+        print(f"{entry['data']:7d} {entry['bss']:7d} "
+              f"{entry['data'] + entry['bss']:7d}  {module}")
+    print(f"{total_data:7d} {total_bss:7d} {total_data + total_bss:7d}  "
+          f"(total of {args.ram_size} bytes RAM)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
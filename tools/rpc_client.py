@@ -0,0 +1,447 @@
+#!/usr/bin/env python3
+"""Reference client for the firmware binary RPC protocol (see rpc.c).
+
+Frames are COBS-encoded and delimited by 0x00 bytes. Decoded layout, all
+multi-byte values little-endian:
+
+  request:  seq | op        | args...          | crc16
+  response: seq | op | 0x80 | status | data... | crc16
+
+The CRC is CRC-16/CCITT-FALSE over all preceding bytes. Up to `window`
+requests are kept outstanding; responses are matched by sequence number.
+
+Can be used as a library (RpcClient) or from the command line:
+
+  rpc_client.py /dev/ttyACM0 info
+  rpc_client.py /dev/ttyACM0 stats
+  rpc_client.py /dev/ttyACM0 adc
+  rpc_client.py /dev/ttyACM0 adc-capture [--input vref] [--count 127] [--compress delta]
+  rpc_client.py /dev/ttyACM0 compress log lz
+  rpc_client.py /dev/ttyACM0 mux [on|off]
+  rpc_client.py /dev/ttyACM0 mem-read 0x08000000 1024 [-o dump.bin] [--stream]
+  rpc_client.py /dev/ttyACM0 regions
+  rpc_client.py /dev/ttyACM0 ee-read 0x0000 256
+  rpc_client.py /dev/ttyACM0 ee-write 0x0000 48656c6c6f
+  rpc_client.py /dev/ttyACM0 bench [--size 240] [--count 200] [--window 4] [--stream]
+  rpc_client.py /dev/ttyACM0 --switch-baud 921600 bench
+
+Memory reads are limited to the regions listed by `regions`. With --stream,
+data is read with a MEM_DUMP request, which is answered by a stream of data
+frames instead of one response per request.
+
+With --switch-baud, the link rate is negotiated before running the command.
+The firmware restores its previous rate unless the new one is confirmed by a
+valid frame within one second.
+
+Requires pyserial.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import compress
+from image_trailer import crc32_words
+
+OP_PING = 0x00
+OP_INFO = 0x01
+OP_STATS = 0x02
+OP_BAUD = 0x03
+OP_COMPRESS = 0x04
+OP_MUX = 0x05
+OP_MEM_READ = 0x10
+OP_MEM_DUMP = 0x11
+OP_MEM_REGIONS = 0x12
+OP_EE_READ = 0x20
+OP_EE_WRITE = 0x21
+OP_ADC = 0x30
+OP_ADC_CAPTURE = 0x31
+OP_RESPONSE = 0x80
+
+STATUS_TEXT = {0: "ok", 1: "bad opcode", 2: "bad length", 3: "bad argument", 4: "failed"}
+
+EEPROM_PAGE_SIZE = 32
+RX_BUF_SIZE = 512
+
+COMPRESS_CHANNELS = ["log", "adc"]
+MODE_BY_NAME = {name: mode for mode, name in compress.MODE_NAMES.items()}
+ADC_INPUTS = ["temp", "vref"]
+ADC_MAX_SAMPLES = 127
+MUX_CHANNELS = ["error", "rpc", "shell", "log", "telemetry"]
+MEM_REGION_WORD = 0x01
+MEM_REGION_ENTRY = 16
+
+
+class RpcError(Exception):
+    """Raised on error status, timeout or protocol violation."""
+
+
+def crc16(data, crc=0xFFFF):
+    """CRC-16/CCITT-FALSE."""
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_encode(data):
+    out = bytearray()
+    block = bytearray()
+    for byte in data:
+        if byte == 0:
+            out.append(len(block) + 1)
+            out += block
+            block.clear()
+        else:
+            block.append(byte)
+            if len(block) == 254:
+                out.append(255)
+                out += block
+                block.clear()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            raise RpcError("malformed COBS frame")
+        out += data[i + 1:i + code]
+        i += code
+        if code != 255 and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+class RpcClient:
+    """Pipelined request/response client on a serial port."""
+
+    def __init__(self, port, baudrate=115200, timeout=1.0, window=4):
+        import serial  # pyserial
+        self.ser = serial.Serial(port, baudrate, timeout=0.05)
+        self.timeout = timeout
+        self.window = window
+        self.seq = 0
+        self.rx = bytearray()
+        # Leading delimiter switches the firmware into binary mode
+        self.ser.write(b"\x00")
+        self.ser.reset_input_buffer()
+
+    def close(self):
+        self.ser.close()
+
+    def _send(self, op, args=b""):
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        frame = bytes([seq, op]) + bytes(args)
+        frame += struct.pack("<H", crc16(frame))
+        self.ser.write(b"\x00" + cobs_encode(frame) + b"\x00")
+        return seq
+
+    def _receive(self):
+        """Return (seq, op, status, data) of the next valid response."""
+        deadline = time.monotonic() + self.timeout
+        while time.monotonic() < deadline:
+            while b"\x00" in self.rx:
+                raw, _, rest = self.rx.partition(b"\x00")
+                self.rx = bytearray(rest)
+                if not raw:
+                    continue
+                try:
+                    frame = cobs_decode(raw)
+                except RpcError:
+                    continue
+                if len(frame) < 5 or crc16(frame[:-2]) != struct.unpack("<H", frame[-2:])[0]:
+                    continue
+                return frame[0], frame[1], frame[2], frame[3:-2]
+            self.rx += self.ser.read(max(1, self.ser.in_waiting))
+        raise RpcError("response timeout")
+
+    def call_many(self, requests):
+        """Execute (op, args) requests pipelined, return list of response data."""
+        results = [None] * len(requests)
+        pending = {}
+        next_req = 0
+        while next_req < len(requests) or pending:
+            while next_req < len(requests) and len(pending) < self.window:
+                op, args = requests[next_req]
+                pending[self._send(op, args)] = (next_req, op)
+                next_req += 1
+            seq, op, status, data = self._receive()
+            if seq not in pending:
+                continue
+            index, req_op = pending.pop(seq)
+            if op != req_op | OP_RESPONSE:
+                raise RpcError("opcode mismatch in response")
+            if status != 0:
+                raise RpcError(STATUS_TEXT.get(status, "status %d" % status))
+            results[index] = data
+        return results
+
+    def call(self, op, args=b""):
+        return self.call_many([(op, args)])[0]
+
+    def _receive_seq(self, seq, op):
+        """Return (status, data) of the next response to request `seq`."""
+        while True:
+            rseq, rop, status, data = self._receive()
+            if rseq == seq and rop == op | OP_RESPONSE:
+                return status, data
+
+    def ping(self, data=b""):
+        return self.call(OP_PING, data)
+
+    def info(self):
+        version, max_data, rx_buf = struct.unpack("<BHH", self.call(OP_INFO))
+        return {"version": version, "max_data": max_data, "rx_buf": rx_buf}
+
+    def stats(self):
+        names = ("rx_frames", "tx_frames", "crc_errors", "frame_errors",
+                 "overruns", "stack_high_water", "heap_used")
+        return dict(zip(names, struct.unpack("<7I", self.call(OP_STATS))))
+
+    def set_baudrate(self, baudrate):
+        """Switch the link rate; return (actual rate, error in ppm) reported by the target."""
+        actual, error = struct.unpack("<Ii", self.call(OP_BAUD, struct.pack("<I", baudrate)))
+        old = self.ser.baudrate
+        # Let the target finish switching before confirming at the new rate
+        time.sleep(0.02)
+        self.ser.baudrate = baudrate
+        self.ser.reset_input_buffer()
+        self.rx.clear()
+        try:
+            self.ser.write(b"\x00")
+            self.ping()
+        except RpcError:
+            # Target falls back after its confirmation timeout
+            self.ser.baudrate = old
+            time.sleep(1.2)
+            self.ser.reset_input_buffer()
+            self.rx.clear()
+            raise RpcError("no response at %d Bd, reverted to %d Bd" % (baudrate, old))
+        return actual, error
+
+    def adc(self):
+        ts_mv, temp, vref_mv = struct.unpack("<HhH", self.call(OP_ADC))
+        return {"temp_sensor_mv": ts_mv, "temperature_c": temp, "vrefint_mv": vref_mv}
+
+    def set_compress(self, channel, mode=None):
+        """Select the encoding of a channel (None: keep) and return its statistics."""
+        channel = COMPRESS_CHANNELS.index(channel) if isinstance(channel, str) else channel
+        mode = 0xFF if mode is None else mode
+        data = self.call(OP_COMPRESS, struct.pack("<BB", channel, mode))
+        mode, blocks, size_in, size_out, time_us = struct.unpack("<B4I", data)
+        return {"mode": mode, "blocks": blocks, "bytes_in": size_in, "bytes_out": size_out,
+                "time_us": time_us}
+
+    def set_mux(self, enable=None):
+        """Enable or disable output multiplexing (None: keep) and return channel statistics.
+
+        The new mode applies after the response. While multiplexing is enabled,
+        responses are only readable through a mux_demux.py channel pty.
+        """
+        mode = 0xFF if enable is None else int(bool(enable))
+        data = self.call(OP_MUX, bytes([mode]))
+        enabled, count, max_payload = data[0], data[1], data[2]
+        channels = {}
+        for i in range(count):
+            size_out, frames, dropped = struct.unpack_from("<3I", data, 3 + 12 * i)
+            name = MUX_CHANNELS[i] if i < len(MUX_CHANNELS) else str(i)
+            channels[name] = {"bytes": size_out, "frames": frames, "dropped": dropped}
+        return {"enabled": bool(enabled), "max_payload": max_payload, "channels": channels}
+
+    def adc_capture(self, adc_input=0, count=ADC_MAX_SAMPLES, compressed=False):
+        """Capture ADC samples in mV; set `compressed` if the ADC channel has an encoding."""
+        data = self.call(OP_ADC_CAPTURE, struct.pack("<BH", adc_input, count))
+        if compressed:
+            data = compress.decode_block(data)
+        return list(struct.unpack("<%dH" % (len(data) // 2), data))
+
+    def mem_read(self, address, length, chunk=256):
+        requests = [(OP_MEM_READ, struct.pack("<IH", address + ofs, min(chunk, length - ofs)))
+                    for ofs in range(0, length, chunk)]
+        return b"".join(self.call_many(requests))
+
+    def mem_regions(self):
+        """Return the readable regions as list of dicts (name, start, length, word)."""
+        data = self.call(OP_MEM_REGIONS)
+        regions = []
+        for ofs in range(0, len(data) - MEM_REGION_ENTRY + 1, MEM_REGION_ENTRY):
+            start, length, flags = struct.unpack_from("<IIB", data, ofs)
+            name = data[ofs + 9:ofs + MEM_REGION_ENTRY].rstrip(b"\x00").decode()
+            regions.append({"name": name, "start": start, "length": length,
+                            "word": bool(flags & MEM_REGION_WORD)})
+        return regions
+
+    def mem_dump(self, address, length, offset=0, retries=5, progress=None):
+        """Read `length` bytes at `address` as a stream, from `offset` on.
+
+        Returns the data from `offset` to the end. Each data frame is checked by
+        its CRC-32; after a bad or missing frame, the stream is requested again
+        from the first missing byte. `progress(offset, length)` is called per frame.
+        """
+        data = bytearray()
+        failures = 0
+        while offset < length:
+            seq = self._send(OP_MEM_DUMP, struct.pack("<III", address, length, offset))
+            try:
+                status, _ = self._receive_seq(seq, OP_MEM_DUMP)
+                if status != 0:
+                    break
+                while offset < length:
+                    _, frame = self._receive_seq(seq, OP_MEM_DUMP)
+                    frame_ofs, = struct.unpack_from("<I", frame)
+                    chunk, crc = frame[4:-4], struct.unpack("<I", frame[-4:])[0]
+                    if frame_ofs != offset or crc32_words(chunk) != crc:
+                        raise RpcError("bad data frame at offset %d" % offset)
+                    data += chunk
+                    offset += len(chunk)
+                    if progress:
+                        progress(offset, length)
+            except RpcError:
+                failures += 1
+                if failures > retries:
+                    raise
+        if offset < length:
+            raise RpcError(STATUS_TEXT.get(status, "status %d" % status))
+        return bytes(data)
+
+    def ee_read(self, address, length, chunk=256):
+        requests = [(OP_EE_READ, struct.pack("<HH", address + ofs, min(chunk, length - ofs)))
+                    for ofs in range(0, length, chunk)]
+        return b"".join(self.call_many(requests))
+
+    def ee_write(self, address, data):
+        requests = []
+        ofs = 0
+        while ofs < len(data):
+            size = min(EEPROM_PAGE_SIZE - (address + ofs) % EEPROM_PAGE_SIZE, len(data) - ofs)
+            requests.append((OP_EE_WRITE, struct.pack("<H", address + ofs) + data[ofs:ofs + size]))
+            ofs += size
+        self.call_many(requests)
+
+
+def run_bench(client, size, count, stream=False):
+    """Measure memory read throughput over the serial link."""
+    start = time.monotonic()
+    if stream:
+        # Same amount of data, within the flash region
+        total = min(size * count, 0x10000)
+        client.mem_dump(0x08000000, total)
+        elapsed = time.monotonic() - start
+        print("stream of %d bytes: %.3f s, %.0f B/s" % (total, elapsed, total / elapsed))
+        return
+    client.call_many([(OP_MEM_READ, struct.pack("<IH", 0x08000000, size))] * count)
+    elapsed = time.monotonic() - start
+    total = size * count
+    print("%d requests x %d bytes, window %d: %.3f s, %.0f B/s, %.2f ms/request"
+          % (count, size, client.window, elapsed, total / elapsed, elapsed * 1000 / count))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("port", help="serial port, e.g. /dev/ttyACM0")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--window", type=int, default=4, help="max. outstanding requests")
+    parser.add_argument("--timeout", type=float, default=1.0, help="response timeout in s")
+    parser.add_argument("--switch-baud", type=int, metavar="RATE", help="negotiate link rate first")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    sub.add_parser("info")
+    sub.add_parser("stats")
+    sub.add_parser("adc")
+    p = sub.add_parser("adc-capture")
+    p.add_argument("--input", choices=ADC_INPUTS, default="temp")
+    p.add_argument("--count", type=int, default=ADC_MAX_SAMPLES)
+    p.add_argument("--compress", choices=list(compress.MODE_NAMES.values()), default="none")
+    p = sub.add_parser("compress")
+    p.add_argument("channel", choices=COMPRESS_CHANNELS)
+    p.add_argument("mode", nargs="?", choices=list(compress.MODE_NAMES.values()),
+                   help="encoding to select (default: keep)")
+    p = sub.add_parser("mux")
+    p.add_argument("mode", nargs="?", choices=["on", "off"], help="mode to select (default: keep)")
+    p = sub.add_parser("mem-read")
+    p.add_argument("address", type=lambda x: int(x, 0))
+    p.add_argument("length", type=lambda x: int(x, 0))
+    p.add_argument("-o", "--output", help="write data to file instead of hexdump")
+    p.add_argument("--stream", action="store_true", help="read as MEM_DUMP stream")
+    sub.add_parser("regions")
+    p = sub.add_parser("ee-read")
+    p.add_argument("address", type=lambda x: int(x, 0))
+    p.add_argument("length", type=lambda x: int(x, 0))
+    p.add_argument("-o", "--output", help="write data to file instead of hexdump")
+    p = sub.add_parser("ee-write")
+    p.add_argument("address", type=lambda x: int(x, 0))
+    p.add_argument("data", type=bytes.fromhex, help="hex string")
+    p = sub.add_parser("bench")
+    p.add_argument("--size", type=int, default=240)
+    p.add_argument("--count", type=int, default=200)
+    p.add_argument("--stream", action="store_true", help="read as MEM_DUMP stream")
+    args = parser.parse_args()
+
+    # Keep outstanding requests within the firmware RX buffer
+    window = max(1, min(args.window, RX_BUF_SIZE // 64))
+    client = RpcClient(args.port, args.baud, args.timeout, window)
+    try:
+        if args.switch_baud:
+            actual, error = client.set_baudrate(args.switch_baud)
+            print("switched to %d Bd (actual %d Bd, %+d ppm)" % (args.switch_baud, actual, error),
+                  file=sys.stderr)
+        if args.cmd in ("info", "stats", "adc"):
+            for key, value in getattr(client, args.cmd)().items():
+                print("%-18s %d" % (key, value))
+        elif args.cmd == "adc-capture":
+            mode = MODE_BY_NAME[args.compress]
+            client.set_compress("adc", mode)
+            samples = client.adc_capture(ADC_INPUTS.index(args.input), args.count, mode != 0)
+            stats = client.set_compress("adc")
+            print(" ".join(str(s) for s in samples))
+            print("%d samples, %d bytes in %d blocks -> %d bytes, %d us on target" %
+                  (len(samples), stats["bytes_in"], stats["blocks"], stats["bytes_out"],
+                   stats["time_us"]), file=sys.stderr)
+        elif args.cmd == "compress":
+            mode = MODE_BY_NAME[args.mode] if args.mode else None
+            for key, value in client.set_compress(args.channel, mode).items():
+                print("%-18s %d" % (key, value))
+        elif args.cmd == "mux":
+            res = client.set_mux(None if args.mode is None else args.mode == "on")
+            print("mode %s, max. %d bytes/frame" %
+                  ("multiplexed" if res["enabled"] else "direct", res["max_payload"]))
+            for name, ch in res["channels"].items():
+                print("%-10s %10d bytes %8d frames %8d dropped" %
+                      (name, ch["bytes"], ch["frames"], ch["dropped"]))
+        elif args.cmd == "regions":
+            for region in client.mem_regions():
+                print("%-8s 0x%08X %6d bytes%s" % (region["name"], region["start"],
+                      region["length"], ", 32-bit access" if region["word"] else ""))
+        elif args.cmd in ("mem-read", "ee-read"):
+            read = client.mem_read if args.cmd == "mem-read" else client.ee_read
+            if args.cmd == "mem-read" and args.stream:
+                read = client.mem_dump
+            data = read(args.address, args.length)
+            if args.output:
+                with open(args.output, "wb") as f:
+                    f.write(data)
+            else:
+                for ofs in range(0, len(data), 16):
+                    print("%08X  %s" % (args.address + ofs, data[ofs:ofs + 16].hex(" ")))
+        elif args.cmd == "ee-write":
+            client.ee_write(args.address, args.data)
+        elif args.cmd == "bench":
+            run_bench(client, args.size, args.count, args.stream)
+    except RpcError as err:
+        print("error: %s" % err, file=sys.stderr)
+        return 1
+    finally:
+        client.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
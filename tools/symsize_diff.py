@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Diff per-symbol sizes between two builds.
+
+Takes two symbol reports generated by the post-build step
+(<target>-<profile>.sym, "nm -S --size-sort -t d" output) and prints the size
+change of every symbol that differs, followed by per-section-type totals.
+
+Usage:
+  symsize_diff.py build-a/hello-ch32v103-debug.sym \\
+                  build-b/hello-ch32v103-release-size.sym [--all]
+"""
+
+import argparse
+import sys
+
+# nm symbol types grouped by memory region
+TYPE_GROUPS = {
+    "text": "tTwW",
+    "rodata": "rR",
+    "data": "dDgG",
+    "bss": "bBsSvV",
+}
+
+
+def load_symbols(path):
+    """Return {name: (type, size)} from an nm -S report."""
+    symbols = {}
+    with open(path, encoding="ascii", errors="replace") as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) < 4:
+                continue
+            _, size, sym_type, name = fields[:4]
+            symbols[name] = (sym_type, int(size, 10))
+    return symbols
+
+
+def group_of(sym_type):
+    for group, types in TYPE_GROUPS.items():
+        if sym_type in types:
+            return group
+    return "other"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("old", help="symbol report of reference build")
+    parser.add_argument("new", help="symbol report of compared build")
+    parser.add_argument("--all", action="store_true",
+                        help="also list unchanged symbols")
+    args = parser.parse_args()
+
+    old = load_symbols(args.old)
+    new = load_symbols(args.new)
+
+    rows = []
+    totals = {}
+    for name in sorted(set(old) | set(new)):
+        old_type, old_size = old.get(name, ("", 0))
+        new_type, new_size = new.get(name, ("", 0))
+        group = group_of(new_type or old_type)
+        old_total, new_total = totals.get(group, (0, 0))
+        totals[group] = (old_total + old_size, new_total + new_size)
+        if old_size != new_size or args.all:
+            rows.append((new_size - old_size, name, old_size, new_size, group))
+
+    print(f"{'delta':>8} {'old':>8} {'new':>8}  {'region':7} symbol")
+    for delta, name, old_size, new_size, group in sorted(rows, reverse=True):
+        print(f"{delta:+8d} {old_size:8d} {new_size:8d}  {group:7} {name}")
+
+    print()
+    for group, (old_total, new_total) in sorted(totals.items()):
+        print(f"{new_total - old_total:+8d} {old_total:8d} {new_total:8d}  "
+              f"{group:7} (total)")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())